@@ -1,4 +1,7 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Scheduler.h>
+#include <Format.h>
+#include <ADC_HAL.h>
 
 void initADC() {
     ADC14_enableModule();
@@ -11,9 +14,9 @@ void initADC() {
                      );
 
     // This configures the ADC to store output results
-    // in ADC_MEM0 up to ADC_MEM1. Each conversion will
-    // thus use two channels.
-    ADC14_configureMultiSequenceMode(ADC_MEM0, ADC_MEM1, true);
+    // in ADC_MEM0 up to ADC_MEM3. Each conversion will
+    // thus use four channels: the joystick, then the accelerometer.
+    ADC14_configureMultiSequenceMode(ADC_MEM0, ADC_MEM3, true);
 
     // This configures the ADC in manual conversion mode
     // Software will start each conversion.
@@ -60,8 +63,242 @@ void initJoyStick() {
                                                GPIO_TERTIARY_MODULE_FUNCTION);
 }
 
+void initAccelerometer() {
+
+    // ADC_MEM2 and ADC_MEM3 store the X and Y axes of the accelerometer, A14 on P6.1 and A13 on P4.0
+    ADC14_configureConversionMemory(ADC_MEM2,
+                                    ADC_VREFPOS_AVCC_VREFNEG_VSS,
+                                    ADC_INPUT_A14,                // accelerometer X
+                                    ADC_NONDIFFERENTIAL_INPUTS);
+    GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P6,
+                                               GPIO_PIN1,
+                                               GPIO_TERTIARY_MODULE_FUNCTION);
+
+    ADC14_configureConversionMemory(ADC_MEM3,
+                                    ADC_VREFPOS_AVCC_VREFNEG_VSS,
+                                    ADC_INPUT_A13,                // accelerometer Y
+                                    ADC_NONDIFFERENTIAL_INPUTS);
+    GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P4,
+                                               GPIO_PIN0,
+                                               GPIO_TERTIARY_MODULE_FUNCTION);
+}
+
 void getSampleJoyStick(unsigned *X, unsigned *Y) {
     // ADC runs in continuous mode, we just read the conversion buffers
     *X = ADC14_getResult(ADC_MEM0);
     *Y = ADC14_getResult(ADC_MEM1);
 }
+
+void getSampleAccelerometer(unsigned *X, unsigned *Y) {
+    *X = ADC14_getResult(ADC_MEM2);
+    *Y = ADC14_getResult(ADC_MEM3);
+}
+
+//------------------------------------------
+// Motion
+
+#define ADC_FULL_SCALE 16383
+
+typedef struct {
+    uint32_t xMemory;
+    uint32_t yMemory;
+    uint32_t window;
+} MotionChannels_t;
+
+static const MotionChannels_t channels[MOTION_SOURCES] = {
+    {ADC_MEM0, ADC_MEM1, ADC_COMP_WINDOW0},     // MOTION_JOYSTICK
+    {ADC_MEM2, ADC_MEM3, ADC_COMP_WINDOW1},     // MOTION_BOARD
+};
+
+static struct {
+    unsigned restX[MOTION_SOURCES];
+    unsigned restY[MOTION_SOURCES];
+    unsigned deadZone[MOTION_SOURCES];
+    Direction_t direction[MOTION_SOURCES];
+    uint32_t sumX[MOTION_SOURCES];
+    uint32_t sumY[MOTION_SOURCES];
+    unsigned samples;           // of the calibration so far
+    bool calibrated;
+    volatile bool armed;        // the comparator interrupts are on
+    uint32_t wakes;             // comparator interrupts
+    uint32_t moves;             // EVT_MOTION posted
+} motion = {
+    .deadZone = {JOYSTICK_DEAD_ZONE, BOARD_DEAD_ZONE},
+};
+
+// A window spans the rest positions of both axes of its source, so an axis that rests closer to the middle of
+// the window than the other leaves it a little later than its own dead-zone
+static void programWindows() {
+    MotionSource_t s;
+
+    // The windows and the memories can only be changed while no conversion is running
+    ADC14_disableConversion();
+    while (ADC14_isBusy())
+        ;
+
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        unsigned lowest = (motion.restX[s] < motion.restY[s]) ? motion.restX[s] : motion.restY[s];
+        unsigned highest = (motion.restX[s] > motion.restY[s]) ? motion.restX[s] : motion.restY[s];
+        int32_t low = (int32_t) lowest - (int32_t) motion.deadZone[s];
+        int32_t high = (int32_t) highest + (int32_t) motion.deadZone[s];
+
+        ADC14_setComparatorWindowValue(channels[s].window, (low < 0) ? 0 : low,
+                                       (high > ADC_FULL_SCALE) ? ADC_FULL_SCALE : high);
+        ADC14_enableComparatorWindow(channels[s].xMemory, channels[s].window);
+        ADC14_enableComparatorWindow(channels[s].yMemory, channels[s].window);
+    }
+
+    startADC();
+}
+
+void calibrateMotion() {
+    MotionSource_t s;
+
+    ADC14_disableInterrupt(ADC_HI_INT | ADC_LO_INT);
+    motion.armed = false;
+    motion.calibrated = false;
+    motion.samples = 0;
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        motion.sumX[s] = 0;
+        motion.sumY[s] = 0;
+        motion.direction[s] = DIR_CENTER;
+    }
+
+    Interrupt_enableInterrupt(INT_ADC14);
+}
+
+static void calibrationStep() {
+    MotionSource_t s;
+
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        motion.sumX[s] += ADC14_getResult(channels[s].xMemory);
+        motion.sumY[s] += ADC14_getResult(channels[s].yMemory);
+    }
+    if (++motion.samples < CALIBRATION_TICKS)
+        return;
+
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        motion.restX[s] = motion.sumX[s] / CALIBRATION_TICKS;
+        motion.restY[s] = motion.sumY[s] / CALIBRATION_TICKS;
+    }
+    programWindows();
+    motion.calibrated = true;
+}
+
+void setMotionDeadZone(MotionSource_t source, unsigned counts) {
+    motion.deadZone[source] = counts;
+    if (motion.calibrated)
+        programWindows();
+}
+
+Direction_t getMotionDirection(MotionSource_t source) {
+    return motion.direction[source];
+}
+
+// A source comes back to the center a quarter of the dead-zone closer to its rest position than it left it, so
+// that it does not go back and forth on the edge
+static Direction_t classify(MotionSource_t s) {
+    int32_t dx = (int32_t) ADC14_getResult(channels[s].xMemory) - (int32_t) motion.restX[s];
+    int32_t dy = (int32_t) ADC14_getResult(channels[s].yMemory) - (int32_t) motion.restY[s];
+    int32_t ax = (dx < 0) ? -dx : dx;
+    int32_t ay = (dy < 0) ? -dy : dy;
+    int32_t zone = motion.deadZone[s];
+
+    if (motion.direction[s] != DIR_CENTER)
+        zone -= zone / 4;
+
+    if (ax <= zone && ay <= zone)
+        return DIR_CENTER;
+    if (ax >= ay)
+        return (dx > 0) ? DIR_RIGHT : DIR_LEFT;
+    return (dy > 0) ? DIR_UP : DIR_DOWN;
+}
+
+// It returns true if both sources are at rest
+static bool postMotionChanges() {
+    bool atRest = true;
+    MotionSource_t s;
+
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        Direction_t direction = classify(s);
+
+        if (direction != motion.direction[s])
+        {
+            motion.direction[s] = direction;
+            motion.moves++;
+            PostEvent(EVT_MOTION, MOTION_ARG(s, direction), PRIO_NORMAL);
+        }
+        if (direction != DIR_CENTER)
+            atRest = false;
+    }
+    return atRest;
+}
+
+void MotionTask(const Event_t *event) {
+    if (!motion.calibrated)
+    {
+        calibrationStep();
+        return;
+    }
+    if (motion.armed)
+        return;
+
+    if (postMotionChanges())
+    {
+        // The flags may still hold a conversion from before the sources came back
+        motion.armed = true;
+        ADC14_clearInterruptFlag(ADC_HI_INT | ADC_LO_INT);
+        ADC14_enableInterrupt(ADC_HI_INT | ADC_LO_INT);
+    }
+}
+
+void ADC14_IRQHandler() {
+    uint_fast64_t status = ADC14_getEnabledInterruptStatus();
+
+    // Every conversion out of a window sets the flags again, so the interrupts stay off until MotionTask sees
+    // both sources back at rest
+    if (status & (ADC_HI_INT | ADC_LO_INT))
+    {
+        ADC14_disableInterrupt(ADC_HI_INT | ADC_LO_INT);
+        ADC14_clearInterruptFlag(ADC_HI_INT | ADC_LO_INT);
+        motion.armed = false;
+        motion.wakes++;
+        postMotionChanges();
+    }
+}
+
+// The lines are:
+//   Motion n            the number of EVT_MOTION posted
+//    wakes n            the number of comparator interrupts
+//    stick x y          the rest positions
+//    board x y
+uint32_t MotionDump(EmitLine_t emit) {
+    const char *names[MOTION_SOURCES] = {" stick ", " board "};
+    char line[20];
+    MotionSource_t s;
+    unsigned i;
+
+    i = AppendString(line, 0, "Motion ");
+    AppendNumber(line, i, motion.moves);
+    emit(line, 0);
+
+    i = AppendString(line, 0, " wakes ");
+    AppendNumber(line, i, motion.wakes);
+    emit(line, 1);
+
+    for (s = MOTION_JOYSTICK; s < MOTION_SOURCES; s++)
+    {
+        i = AppendString(line, 0, names[s]);
+        i = AppendNumber(line, i, motion.restX[s]);
+        i = AppendString(line, i, " ");
+        AppendNumber(line, i, motion.restY[s]);
+        emit(line, 2 + s);
+    }
+
+    return 2 + MOTION_SOURCES;
+}
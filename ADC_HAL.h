@@ -1,12 +1,73 @@
 #ifndef ADC_HAL_H_
 #define ADC_HAL_H_
 
+#include <stdint.h>
+#include <Scheduler.h>
+#include <Format.h>
+
 void initADC();
 void startADC();
 
 void initJoyStick();
+void initAccelerometer();
 
 unsigned sampleconv(unsigned v);
 void getSampleJoyStick(unsigned *X, unsigned *Y);
+void getSampleAccelerometer(unsigned *X, unsigned *Y);
+
+//------------------------------------------
+// Motion
+// The window comparator of ADC14 watches the X and Y axes of the joystick (window 0) and of the accelerometer
+// (window 1), so that nothing has to poll them while they rest. Each window spans the rest positions of its two
+// axes, plus a dead-zone on either side. A conversion out of a window raises ADC_HI_INT or ADC_LO_INT, whose ISR
+// posts an EVT_MOTION for each source whose direction changed, and turns the comparator interrupts off: they
+// would come after every conversion. MotionTask then follows the sources on the ticks, and turns them on again
+// once both are back at rest. The timestamp of an event is thus that of the interrupt for the first change, and
+// that of the tick that saw it, at most TICK_PERIOD_MS late, for the others.
+// The Z axis of the accelerometer is left out, since it carries gravity when the board lies flat.
+
+typedef enum {MOTION_JOYSTICK, MOTION_BOARD, MOTION_SOURCES} MotionSource_t;
+
+// The direction of the stick, or the one the board is tilted towards, along the axes printed on the BoosterPack.
+// It is that of the axis that is furthest from its rest position.
+typedef enum {DIR_CENTER, DIR_RIGHT, DIR_UP, DIR_LEFT, DIR_DOWN} Direction_t;
+
+// The argument of EVT_MOTION holds the source in its upper 16 bits and the new direction in its lower 16 bits
+#define MOTION_ARG(source, direction)   (((uint32_t) (source) << 16) | (direction))
+#define MOTION_SOURCE(arg)              ((MotionSource_t) ((arg) >> 16))
+#define MOTION_DIRECTION(arg)           ((Direction_t) ((arg) & 0xFFFF))
+
+// The default dead-zones, in ADC counts from the rest position. The full scale is 16384 counts; 1 g tilts the
+// accelerometer by about 3300.
+#define JOYSTICK_DEAD_ZONE  2000
+#define BOARD_DEAD_ZONE     800
+
+// The number of ticks whose samples are averaged into the rest positions
+#define CALIBRATION_TICKS   16
+
+/*
+ * This function starts a calibration: MotionTask takes the average of the samples of the next CALIBRATION_TICKS
+ * ticks as the rest positions, and sets up the windows. The joystick and the board must not move meanwhile.
+ * main calls it at boot, after startADC; no EVT_MOTION is posted until the calibration is done.
+ */
+void calibrateMotion();
+
+/*
+ * This function changes the dead-zone of a source, in ADC counts. The conversions stop while the window is set.
+ */
+void setMotionDeadZone(MotionSource_t source, unsigned counts);
+
+Direction_t getMotionDirection(MotionSource_t source);
+
+/*
+ * This task carries the calibration on, then follows the sources on EVT_TICK while one of them is away from rest,
+ * and arms the comparator again when none is. It must subscribe to EVT_TICK.
+ */
+void MotionTask(const Event_t *event);
+
+/*
+ * This function formats the rest positions and the number of wake-ups and events (see EmitLine_t)
+ */
+uint32_t MotionDump(EmitLine_t emit);
 
 #endif /* ADC_HAL_H_ */
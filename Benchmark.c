@@ -0,0 +1,401 @@
+//------------------------------------------
+// BENCHMARK API (Application Programming Interface)
+// The primitives are called directly and through the display driver's function table, with interrupts still
+// disabled, so that nothing else is counted. The cycles include the wait for the SPI, which is the same
+// wherever the code runs from; what changes between SRAM and flash is the time spent around it.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <Timer_HAL.h>
+#include <Display_HAL.h>
+#include <RamFunc.h>
+#include <Image.h>
+#include <Crypto_HAL.h>
+#include <RamUsage.h>
+#include <Format.h>
+#include <Benchmark.h>
+#include "bsp/BSP.h"
+#include "bsp/Profile.h"
+#include "assets/Swatches.h"
+
+#if BENCHMARK_ENABLE
+
+// The name of each benchmark on the diagnostics screen, how many times it runs, and whether the dump shows its
+// SPI bytes, its rate in bytes per second and its stack. The text row, the images, the transfers of bsp/BSP.c and
+// the shapes take milliseconds of SPI each and hardly vary, so they run once to keep boot short, and so do the AES
+// in software and PrintString. When the hardware is not used (see CryptoUseHardware), the hardware CRC and AES do
+// not run at all and have no line.
+// The rate is of the SPI bytes, or of dataBytes for the benchmarks that do not draw.
+typedef struct {
+    const char *name;
+    uint8_t     runs;
+    bool        showBytes;
+    bool        showRate;
+    uint16_t    dataBytes;
+    bool        showStack;
+} BenchmarkInfo_t;
+
+static const BenchmarkInfo_t benchmarkInfo[BENCHMARKS] = {
+    {"WrData",   BENCHMARK_RUNS, false, false},     // BENCH_WRITE_DATA
+    {"Pix1bpp",  BENCHMARK_RUNS, false, false},     // BENCH_PIXELS_1BPP
+    {"TextRow",  1,              false, false},     // BENCH_TEXT_ROW
+    {"LineH",    BENCHMARK_RUNS, false, false},     // BENCH_LINE_H
+    {"RectFill", BENCHMARK_RUNS, false, false},     // BENCH_RECT_FILL
+    {"SWTimer",  BENCHMARK_RUNS, false, false},     // BENCH_SWTIMER
+    {"LoopSRAM", BENCHMARK_RUNS, false, false},     // BENCH_LOOP_SRAM
+    {"LoopFlsh", BENCHMARK_RUNS, false, false},     // BENCH_LOOP_FLASH
+    {"ImageRLE", 1,              true,  true},      // BENCH_IMAGE_RLE
+    {"Bitmap",   1,              true,  true},      // BENCH_BITMAP_RAW
+    {"BSPRect",  1,              true,  true},      // BENCH_BSP_RECT
+    {"BSPText",  1,              true,  true},      // BENCH_BSP_STRING
+    {"Line",     1,              true,  false},     // BENCH_LINE_SPANS
+    {"LinePix",  1,              true,  false},     // BENCH_LINE_PIXELS
+    {"Circle",   1,              true,  false},     // BENCH_CIRCLE_SPANS
+    {"CircPix",  1,              true,  false},     // BENCH_CIRCLE_PIXELS
+    {"FillCirc", 1,              true,  false},     // BENCH_FILL_CIRCLE
+    {"Triangle", 1,              true,  false},     // BENCH_FILL_TRIANGLE
+    {"CRC HW",   BENCHMARK_RUNS, false, true,  CRYPTO_BENCH_BYTES},  // BENCH_CRC_HW
+    {"CRC SW",   BENCHMARK_RUNS, false, true,  CRYPTO_BENCH_BYTES},  // BENCH_CRC_SW
+    {"AES HW",   BENCHMARK_RUNS, false, true,  CRYPTO_BENCH_BYTES},  // BENCH_AES_HW
+    {"AES SW",   1,              false, true,  CRYPTO_BENCH_BYTES},  // BENCH_AES_SW
+    {"PrintStr", 1,              true,  false, 0, true},             // BENCH_PRINT_STRING
+};
+
+// HAL_LCD_writeData is timed over this many bytes and the result is divided back
+#define WRITE_DATA_BYTES 64
+
+static BenchmarkResult_t results[BENCHMARKS];
+
+// A 1 bpp test pattern of 64 pixels, and the two colors it is drawn with
+static const uint8_t stripes[8] = {0xF0, 0xF0, 0xCC, 0xCC, 0xAA, 0xAA, 0xFF, 0x00};
+
+// The lines of a row of text are 128 pixels, 16 glyphs of 8, taken 3 pixels into a 17 byte line of glyph bits
+#define TEXT_ROW_LINES  16
+#define TEXT_ROW_OFFSET 3
+static const uint8_t glyphLine[17] = {0x3C, 0x66, 0x60, 0x7E, 0x66, 0x3C, 0x18, 0x7C,
+                                      0x66, 0x3C, 0x00, 0x18, 0x3C, 0x66, 0x7E, 0x66, 0x66};
+static uint32_t palette[2];
+
+// The loop of BENCH_LOOP_SRAM and BENCH_LOOP_FLASH, built once in each place. It expands 1 bpp pixels into 16-bit
+// ones in RAM, which is what PixelDrawMultiple does between the bytes it sends, without the SPI: the wait for the SPI
+// is the same from anywhere and would hide the wait states of the flash. The copies are not inlined, so that each
+// runs where it is placed. With RAMFUNC_ENABLE=0 both are in flash.
+#define EXPANSION_LOOP(name)                                                                          \
+    static __attribute__((noinline)) void name(const uint8_t *bits, unsigned count, uint16_t *pixels) \
+    {                                                                                                 \
+        unsigned bit;                                                                                 \
+                                                                                                      \
+        for (; count; count--, bits++)                                                                \
+            for (bit = 0; bit < 8; bit++)                                                             \
+                *pixels++ = palette[(*bits >> (7 - bit)) & 1];                                        \
+    }
+
+RAMFUNC EXPANSION_LOOP(ExpandFromSRAM)
+EXPANSION_LOOP(ExpandFromFlash)
+
+static uint16_t expanded[8 * sizeof(stripes)];
+
+// The row of BENCH_PRINT_STRING, a full row of the screen
+static char textRow[] = "PrintString 0123";
+
+// The string of BENCH_BSP_STRING, 20 of the 21 columns of a row of bsp/BSP.c
+static char bspString[] = "BSP_LCD_DrawString 0";
+
+// The crypto benchmarks read the bitmap of the images and encrypt it into cipherText with benchKey
+static const uint8_t benchKey[AES_BLOCK_BYTES] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                                  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+static uint8_t cipherText[CRYPTO_BENCH_BYTES];
+
+// This function returns the cycles of one call of a primitive
+static uint32_t RunOnce(Benchmark_t benchmark)
+{
+    const Graphics_Display *display = &g_sCrystalfontz128x128;
+    const Graphics_Display_Functions *functions = &g_sCrystalfontz128x128_funcs;
+    Graphics_Rectangle rect = {0, 0, 31, 31};
+    OneShotSWTimer_t timer;
+    uint32_t start, cycles, i;
+
+    switch (benchmark)
+    {
+    case BENCH_WRITE_DATA:
+        Crystalfontz128x128_SetDrawFrame(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
+        HAL_LCD_writeCommand(CM_RAMWR);
+        start = DWTCYCCNT;
+        for (i = 0; i < WRITE_DATA_BYTES; i++)
+            HAL_LCD_writeData(0);
+        cycles = (DWTCYCCNT - start) / WRITE_DATA_BYTES;
+        break;
+
+    case BENCH_PIXELS_1BPP:
+        start = DWTCYCCNT;
+        functions->pfnPixelDrawMultiple(display, 0, 40, 0, 64, 1, stripes, palette);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_TEXT_ROW:
+        start = DWTCYCCNT;
+        for (i = 0; i < TEXT_ROW_LINES; i++)
+            functions->pfnPixelDrawMultiple(display, 0, 40 + i, TEXT_ROW_OFFSET, LCD_HORIZONTAL_MAX, 1, glyphLine,
+                                            palette);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_LINE_H:
+        start = DWTCYCCNT;
+        functions->pfnLineDrawH(display, 0, LCD_HORIZONTAL_MAX - 1, 48, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_RECT_FILL:
+        start = DWTCYCCNT;
+        functions->pfnRectFill(display, &rect, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_SWTIMER:
+        InitOneShotSWTimer(&timer, TIMER32_1_BASE, 1000);
+        StartOneShotSWTimer(&timer);
+        start = DWTCYCCNT;
+        OneShotSWTimerExpired(&timer);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_LOOP_SRAM:
+        start = DWTCYCCNT;
+        ExpandFromSRAM(stripes, sizeof(stripes), expanded);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_LOOP_FLASH:
+        start = DWTCYCCNT;
+        ExpandFromFlash(stripes, sizeof(stripes), expanded);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_IMAGE_RLE:
+        start = DWTCYCCNT;
+        DrawImage(&ImageSwatches, 0, 0);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_BITMAP_RAW:
+        start = DWTCYCCNT;
+        BSP_LCD_DrawBitmap(0, ImageSwatches.height - 1, ImageSwatchesRaw, ImageSwatches.width,
+                           ImageSwatches.height);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_BSP_RECT:
+        start = DWTCYCCNT;
+        BSP_LCD_FillRect(0, 0, 32, 32, (uint16_t) palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_BSP_STRING:
+        start = DWTCYCCNT;
+        BSP_LCD_DrawString(0, 4, bspString, (int16_t) palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_LINE_SPANS:
+        start = DWTCYCCNT;
+        Crystalfontz128x128_DrawLine(0, 20, LCD_HORIZONTAL_MAX - 1, 107, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_LINE_PIXELS:
+        start = DWTCYCCNT;
+        Graphics_drawLine(&g_sContext, 0, 20, LCD_HORIZONTAL_MAX - 1, 107);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_CIRCLE_SPANS:
+        start = DWTCYCCNT;
+        Crystalfontz128x128_DrawCircle(64, 64, 40, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_CIRCLE_PIXELS:
+        start = DWTCYCCNT;
+        Graphics_drawCircle(&g_sContext, 64, 64, 40);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_FILL_CIRCLE:
+        start = DWTCYCCNT;
+        Crystalfontz128x128_FillCircle(64, 64, 20, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_FILL_TRIANGLE:
+        start = DWTCYCCNT;
+        Crystalfontz128x128_FillTriangle(32, 100, 64, 36, 96, 100, palette[1]);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_CRC_HW:
+    case BENCH_CRC_SW:
+        CryptoUseHardware(benchmark == BENCH_CRC_HW);
+        start = DWTCYCCNT;
+        CrcCompute(ImageSwatchesRaw, CRYPTO_BENCH_BYTES);
+        cycles = DWTCYCCNT - start;
+        CryptoUseHardware(true);
+        break;
+
+    case BENCH_PRINT_STRING:
+        start = DWTCYCCNT;
+        PrintString(textRow, 3, 0);
+        cycles = DWTCYCCNT - start;
+        break;
+
+    case BENCH_AES_HW:
+    case BENCH_AES_SW:
+    default:
+        CryptoUseHardware(benchmark == BENCH_AES_HW);
+        start = DWTCYCCNT;
+        AesEncryptECB((const uint8_t *) ImageSwatchesRaw, cipherText, CRYPTO_BENCH_BYTES / AES_BLOCK_BYTES);
+        cycles = DWTCYCCNT - start;
+        CryptoUseHardware(true);
+        break;
+    }
+
+    return cycles;
+}
+
+void RunBenchmark()
+{
+    const Graphics_Display *display = &g_sCrystalfontz128x128;
+    const Graphics_Display_Functions *functions = &g_sCrystalfontz128x128_funcs;
+    unsigned b, run;
+
+    // The profiler may be compiled out, so the cycle counter is started here too
+    DEMCR |= DEMCR_TRCENA;
+    DWTCTRL |= DWTCTRL_CYCCNTENA;
+
+    palette[0] = functions->pfnColorTranslate(display, GRAPHICS_COLOR_BLACK);
+    palette[1] = functions->pfnColorTranslate(display, MY_GREEN);
+
+    results[BENCH_WRITE_DATA].inSRAM = RUNS_FROM_SRAM(HAL_LCD_writeData);
+    results[BENCH_PIXELS_1BPP].inSRAM = RUNS_FROM_SRAM(functions->pfnPixelDrawMultiple);
+    results[BENCH_TEXT_ROW].inSRAM = RUNS_FROM_SRAM(functions->pfnPixelDrawMultiple);
+    results[BENCH_LINE_H].inSRAM = RUNS_FROM_SRAM(functions->pfnLineDrawH);
+    results[BENCH_RECT_FILL].inSRAM = RUNS_FROM_SRAM(functions->pfnRectFill);
+    results[BENCH_SWTIMER].inSRAM = RUNS_FROM_SRAM(OneShotSWTimerExpired);
+    results[BENCH_LOOP_SRAM].inSRAM = RUNS_FROM_SRAM(ExpandFromSRAM);
+    results[BENCH_LOOP_FLASH].inSRAM = RUNS_FROM_SRAM(ExpandFromFlash);
+    results[BENCH_IMAGE_RLE].inSRAM = RUNS_FROM_SRAM(DrawImage);
+    results[BENCH_BITMAP_RAW].inSRAM = RUNS_FROM_SRAM(BSP_LCD_DrawBitmap);
+    results[BENCH_BSP_RECT].inSRAM = RUNS_FROM_SRAM(BSP_LCD_FillRect);
+    results[BENCH_BSP_STRING].inSRAM = RUNS_FROM_SRAM(BSP_LCD_DrawString);
+    results[BENCH_LINE_SPANS].inSRAM = RUNS_FROM_SRAM(Crystalfontz128x128_DrawLine);
+    results[BENCH_LINE_PIXELS].inSRAM = RUNS_FROM_SRAM(Graphics_drawLine);
+    results[BENCH_CIRCLE_SPANS].inSRAM = RUNS_FROM_SRAM(Crystalfontz128x128_DrawCircle);
+    results[BENCH_CIRCLE_PIXELS].inSRAM = RUNS_FROM_SRAM(Graphics_drawCircle);
+    results[BENCH_FILL_CIRCLE].inSRAM = RUNS_FROM_SRAM(Crystalfontz128x128_FillCircle);
+    results[BENCH_FILL_TRIANGLE].inSRAM = RUNS_FROM_SRAM(Crystalfontz128x128_FillTriangle);
+    results[BENCH_CRC_HW].inSRAM = RUNS_FROM_SRAM(CrcCompute);
+    results[BENCH_CRC_SW].inSRAM = RUNS_FROM_SRAM(CrcCompute);
+    results[BENCH_AES_HW].inSRAM = RUNS_FROM_SRAM(AesEncryptECB);
+    results[BENCH_AES_SW].inSRAM = RUNS_FROM_SRAM(AesEncryptECB);
+    results[BENCH_PRINT_STRING].inSRAM = RUNS_FROM_SRAM(PrintString);
+
+    // The key is expanded, and loaded in the AES256 module, before the first timed run
+    AesSetKey(benchKey, 128);
+    AesEncryptECB(benchKey, cipherText, 1);
+
+    for (b = 0; b < BENCHMARKS; b++)
+    {
+        results[b].cycles = UINT32_MAX;
+        if ((b == BENCH_CRC_HW || b == BENCH_AES_HW) && !CryptoUseHardware(true))
+            continue;
+        for (run = 0; run < benchmarkInfo[b].runs; run++)
+        {
+            uint32_t bytes = HAL_LCD_byteCount + BSP_LCD_ByteCount;
+            uint32_t cycles;
+
+            if (benchmarkInfo[b].showStack)
+                StackMark();
+            cycles = RunOnce((Benchmark_t) b);
+            if (cycles < results[b].cycles)
+                results[b].cycles = cycles;
+            results[b].bytes = HAL_LCD_byteCount + BSP_LCD_ByteCount - bytes;
+            if (benchmarkInfo[b].showStack)
+                results[b].stackBytes = StackHighWater();
+        }
+    }
+}
+
+BenchmarkResult_t GetBenchmarkResult(Benchmark_t benchmark)
+{
+    return results[benchmark];
+}
+
+// One line per primitive that ran, then the boot time:
+//   name S|F cycles      S if it runs from SRAM, F if from flash
+//     flash +|-cycles    after LoopFlsh, how many more cycles the loop took from flash than from SRAM
+//     bytes bytes        for the images, the BSP rectangle and string and the shapes, the SPI bytes of one call
+//     rate B/s           for the images and the BSP rectangle and string, the SPI bytes per second of the call,
+//                        and for the crypto, the data bytes
+//     stack n B          for PrintString, how deep the stack went, unless it is not known (on the host)
+//   1stPixel ms          from InitHWTimers to the display showing the opening screen
+uint32_t BenchmarkDump(EmitLine_t emit)
+{
+    char line[20];
+    uint32_t n = 0;
+    unsigned b, i;
+
+    for (b = 0; b < BENCHMARKS; b++)
+    {
+        if (results[b].cycles == UINT32_MAX)
+            continue;
+
+        i = AppendString(line, 0, benchmarkInfo[b].name);
+        i = AppendString(line, i, results[b].inSRAM ? " S " : " F ");
+        AppendShortNumber(line, i, results[b].cycles, "k");
+        emit(line, n++);
+
+        if (b == BENCH_LOOP_FLASH)
+        {
+            uint32_t sram = results[BENCH_LOOP_SRAM].cycles, flash = results[BENCH_LOOP_FLASH].cycles;
+            i = AppendString(line, 0, (flash >= sram) ? "  flash +" : "  flash -");
+            AppendShortNumber(line, i, (flash >= sram) ? flash - sram : sram - flash, "k");
+            emit(line, n++);
+        }
+
+        if (benchmarkInfo[b].showBytes)
+        {
+            i = AppendString(line, 0, "  ");
+            i = AppendShortNumber(line, i, results[b].bytes, "k");
+            AppendString(line, i, " bytes");
+            emit(line, n++);
+        }
+
+        if (benchmarkInfo[b].showRate)
+        {
+            uint32_t us = CyclesToMicroseconds(results[b].cycles);
+            uint32_t bytes = benchmarkInfo[b].dataBytes ? benchmarkInfo[b].dataBytes : results[b].bytes;
+            i = AppendString(line, 0, "  ");
+            i = AppendShortNumber(line, i, us ? (uint32_t) ((uint64_t) bytes * 1000000 / us) : 0, "k");
+            AppendString(line, i, " B/s");
+            emit(line, n++);
+        }
+
+        if (benchmarkInfo[b].showStack && results[b].stackBytes)
+        {
+            i = AppendString(line, 0, "  stack ");
+            i = AppendShortNumber(line, i, results[b].stackBytes, "k");
+            AppendString(line, i, " B");
+            emit(line, n++);
+        }
+    }
+
+    i = AppendString(line, 0, "1stPixel ");
+    i = AppendShortNumber(line, i, FirstPixelMicroseconds() / 1000, "k");
+    AppendString(line, i, "ms");
+    emit(line, n++);
+    return n;
+}
+
+#endif // BENCHMARK_ENABLE
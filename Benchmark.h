@@ -0,0 +1,98 @@
+//------------------------------------------
+// BENCHMARK API (Application Programming Interface)
+// This module measures primitives of the display, the timers and the crypto with the DWT cycle counter. It runs
+// once at boot, before interrupts are enabled and before the opening screen, because it draws on the LCD.
+// Each benchmark of Benchmark_t keeps the fewest cycles of its runs, BENCHMARK_RUNS or a single one for those that
+// take milliseconds, and the diagnostics screen shows a line for each:
+//   - the cycles, with an S (SRAM) or F (flash) for where the primitive runs from (see RamFunc.h). One loop, the
+//     1 bpp expansion of PixelDrawMultiple without the SPI, is built in both places and timed from each in the same
+//     build, and the line after them gives the cycles that flash costs it. The primitives only exist in one place:
+//     their gain is the difference with the same line of a build with RAMFUNC_ENABLE=0.
+//   - for the images, the BSP rectangle and string, the shapes and PrintString, the SPI bytes of one call: the image
+//     of the asset pipeline (Image.h) against the raw bitmap of bsp/BSP.c, and the shapes of the driver
+//     (Crystalfontz128x128_DrawLine and the others) against grlib's pixel by pixel drawing.
+//   - for the two images and the rectangle and string of bsp/BSP.c, the rate in bytes per second at which their
+//     transport keeps the SPI busy, and for the CRC and AES, run with the hardware modules and in software (see
+//     Crypto_HAL.h), the rate of data processed.
+//     Where the hardware is not used, with CRYPTO_HARDWARE=0 or once InitCrypto or CryptoSelfTest gave it up, only
+//     the software ones run and are shown.
+//   - for PrintString, which prints a row of text through grlib and its font, how deep the stack went in it (see
+//     RamUsage.h).
+// The dump ends with the boot time measured by Display_HAL, from InitHWTimers to the first frame on the display.
+// Build with BENCHMARK_ENABLE=0 (the Release configuration does) and it compiles out.
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+#ifndef BENCHMARK_ENABLE
+#define BENCHMARK_ENABLE 1
+#endif
+
+typedef enum {
+    BENCH_WRITE_DATA,       // HAL_LCD_writeData, one byte
+    BENCH_PIXELS_1BPP,      // PixelDrawMultiple, a row of 64 pixels of a 1 bpp image
+    BENCH_TEXT_ROW,         // PixelDrawMultiple, a row of text: 16 lines of 128 pixels that start mid-byte
+    BENCH_LINE_H,           // LineDrawH, 128 pixels
+    BENCH_RECT_FILL,        // RectFill, 32 x 32 pixels
+    BENCH_SWTIMER,          // OneShotSWTimerExpired
+    BENCH_LOOP_SRAM,        // the expansion of 64 pixels of 1 bpp into a buffer, from SRAM
+    BENCH_LOOP_FLASH,       // the same loop, from flash
+    BENCH_IMAGE_RLE,        // DrawImage of assets/Swatches, 128 x 48 pixels compressed
+    BENCH_BITMAP_RAW,       // BSP_LCD_DrawBitmap of the same pixels, uncompressed
+    BENCH_BSP_RECT,         // BSP_LCD_FillRect, 32 x 32 pixels
+    BENCH_BSP_STRING,       // BSP_LCD_DrawString of 20 characters
+    BENCH_LINE_SPANS,       // Crystalfontz128x128_DrawLine, a diagonal across the screen, in spans
+    BENCH_LINE_PIXELS,      // Graphics_drawLine, the same line pixel by pixel
+    BENCH_CIRCLE_SPANS,     // Crystalfontz128x128_DrawCircle, radius 40, in spans
+    BENCH_CIRCLE_PIXELS,    // Graphics_drawCircle, the same circle pixel by pixel
+    BENCH_FILL_CIRCLE,      // Crystalfontz128x128_FillCircle, radius 20
+    BENCH_FILL_TRIANGLE,    // Crystalfontz128x128_FillTriangle, 64 pixels wide and high
+    BENCH_CRC_HW,           // CrcCompute of CRYPTO_BENCH_BYTES, in the CRC32 module fed by DMA
+    BENCH_CRC_SW,           // CrcCompute of the same bytes in software
+    BENCH_AES_HW,           // AesEncryptECB of CRYPTO_BENCH_BYTES with a 128-bit key, in the AES256 module
+    BENCH_AES_SW,           // AesEncryptECB of the same bytes in software
+    BENCH_PRINT_STRING,     // PrintString of 16 characters
+    BENCHMARKS
+} Benchmark_t;
+
+#define BENCHMARK_RUNS 8
+
+#define CRYPTO_BENCH_BYTES 1024
+
+typedef struct {
+    uint32_t cycles;        // fewest cycles of one call
+    bool     inSRAM;        // the primitive runs from the SRAM_CODE alias
+    uint32_t bytes;         // bytes sent to the LCD by one call, through its HAL or the BSP
+    uint32_t stackBytes;    // the deepest the stack went in the last call, from its top, 0 on the host
+} BenchmarkResult_t;
+
+#if BENCHMARK_ENABLE
+
+/*
+ * This function runs all the benchmarks. It draws on the LCD, so it has to be called after InitGraphics and
+ * before anything that the user should see. It needs the hardware timers of InitHWTimers and InitCrypto.
+ */
+void RunBenchmark();
+
+/*
+ * This function returns the result of one benchmark
+ */
+BenchmarkResult_t GetBenchmarkResult(Benchmark_t benchmark);
+
+/*
+ * This function formats the results (see EmitLine_t)
+ */
+uint32_t BenchmarkDump(EmitLine_t emit);
+
+#else
+
+#define RunBenchmark()
+static inline uint32_t BenchmarkDump(EmitLine_t emit) { return 0; }
+
+#endif // BENCHMARK_ENABLE
+
+#endif /* BENCHMARK_H_ */
@@ -4,26 +4,104 @@
 // HAL is a specific form of API that designs the interface with a certain hardware
 
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
-#include <TIMER_HAL.h>
+#include <Timer_HAL.h>
 #include <Buttons_HAL.h>
+#include <Scheduler.h>
+#include "bsp/Profile.h"
+#include <Latency.h>
 
 #define DEBOUNCE_TIMING 100 // 100 ms
 typedef enum {stable0, trans0To1, stable1, trans1To0} DebounceState_t;
 
+//------------------------------------------
+// Press edges
+// The ISRs only take an edge while the button has none, and the debounce FSM only drops one that was taken, so
+// they never write the same edge at the same time.
+
+typedef struct {
+    volatile bool taken;
+    bool valid;                 // validated by the debounce FSM
+    uint32_t timestamp;
+} PressEdge_t;
+
+static PressEdge_t edges[BUTTONS];
+static volatile bool edgesArmed;
+
+void ArmPressEdges()
+{
+    bool wasDisabled = Interrupt_disableMaster();
+    button_t button;
+
+    for (button = BOOSTER_TOP; button < BUTTONS; button++)
+    {
+        edges[button].taken = false;
+        edges[button].valid = false;
+    }
+    edgesArmed = true;
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+void DisarmPressEdges()
+{
+    edgesArmed = false;
+}
+
+bool GetPressEdge(button_t button, uint32_t *timestamp)
+{
+    if (!edges[button].valid)
+        return false;
+    *timestamp = edges[button].timestamp;
+    return true;
+}
+
+// This function is called from the port ISRs, with the time they were entered, when the pin reads pressed
+static void TakePressEdge(button_t button, uint32_t now)
+{
+    if (edgesArmed && !edges[button].taken)
+    {
+        edges[button].timestamp = now;
+        edges[button].taken = true;
+    }
+}
+
+// The debounce FSM calls this function when the press it saw is stable
+static void ValidatePressEdge(button_t button)
+{
+    if (edges[button].taken)
+        edges[button].valid = true;
+}
+
+// The debounce FSM calls this function when the button is released and was never seen stable. It drops the edge
+// if it is older than the debounce: an edge that is newer may be a press the FSM has not seen yet, since a
+// bouncing pin can still read released.
+static void DropPressEdge(button_t button)
+{
+    if (edges[button].taken && !edges[button].valid &&
+        CyclesToMicroseconds(edges[button].timestamp - GetTimerValue(TIMER32_0_BASE)) > DEBOUNCE_TIMING * 1000)
+        edges[button].taken = false;
+}
+
 //------------------------------------------
 // Debounce FSM
 // This FSM has two inputs the raw button status (rawBtn), which is an input to this funciton
 // The other input is the status of the timer that can be directly checked here.
 // The FSM also has two outputs. One is the debounced button status (debouncedBtn), which is also the output of this function
 // The other output is a boolean that decides whether to start a new timer or not
+// The press edge of the button, if one was taken, is validated when the FSM reaches stable1 and dropped when it
+// falls back to stable0 (see Press edges).
+
+bool Debounce_Button(button_t button, DebounceState_t *S, OneShotSWTimer_t *timer, bool rawBtn) {
 
-bool Debounce_Button(DebounceState_t *S, OneShotSWTimer_t *timer, bool rawBtn) {
+    // Default outputs of the FSM
+    bool debouncedBtn = false;
+
+    PROFILE_ZONE_BEGIN(PROFILE_DEBOUNCE_BUTTON)
 
     // The second input of the FSM
     bool timerExpired = false;
 
-    // Default outputs of the FSM
-    bool debouncedBtn = false;
     bool startTimer = false;
 
     switch (*S)
@@ -37,6 +115,8 @@ bool Debounce_Button(DebounceState_t *S, OneShotSWTimer_t *timer, bool rawBtn) {
             // Update outputs, if different from default
             startTimer = 1;
         }
+        else
+            DropPressEdge(button);
         break;
 
     case trans0To1:
@@ -47,11 +127,12 @@ bool Debounce_Button(DebounceState_t *S, OneShotSWTimer_t *timer, bool rawBtn) {
            {
                 //Change state
                 *S = stable1;
-
+                ValidatePressEdge(button);
             }
             else
             {
                 *S = stable0;
+                DropPressEdge(button);
             }
         }
         break;
@@ -81,11 +162,39 @@ bool Debounce_Button(DebounceState_t *S, OneShotSWTimer_t *timer, bool rawBtn) {
     if (startTimer)
         StartOneShotSWTimer(timer);
 
+    PROFILE_ZONE_END(PROFILE_DEBOUNCE_BUTTON)
+
     return debouncedBtn;
 }
 
 
 
+//------------------------------------------
+// Button interrupts
+// A GPIO pin can only interrupt on one edge. To see both the press and the release, every ISR
+// flips the edge select of the pin to the opposite of its current level.
+// The debouncing is still done by the Debounce FSM. The interrupts only make sure the FSMs get to run
+// when something happened, and take the press edges. The time is read first thing, so that the edge is not late
+// by the time it takes to find the pin.
+
+static void SelectNextEdge(uint_fast8_t port, uint_fast16_t pin)
+{
+    if (GPIO_getInputPinValue(port, pin) == GPIO_INPUT_PIN_LOW)
+        GPIO_interruptEdgeSelect(port, pin, GPIO_LOW_TO_HIGH_TRANSITION);
+    else
+        GPIO_interruptEdgeSelect(port, pin, GPIO_HIGH_TO_LOW_TRANSITION);
+
+    // Changing the edge select may set the flag, so it is cleared afterwards
+    GPIO_clearInterruptFlag(port, pin);
+}
+
+static void EnableButtonInterrupt(uint_fast8_t port, uint_fast16_t pins)
+{
+    GPIO_interruptEdgeSelect(port, pins, GPIO_HIGH_TO_LOW_TRANSITION);
+    GPIO_clearInterruptFlag(port, pins);
+    GPIO_enableInterrupt(port, pins);
+}
+
 void InitButtons() {
     GPIO_setAsInputPin (GPIO_PORT_P5, GPIO_PIN1); // upper switch S1 on BoostXL
 
@@ -97,6 +206,62 @@ void InitButtons() {
     GPIO_setAsInputPin (GPIO_PORT_P1, GPIO_PIN4); // right button on Launchpad
     GPIO_setAsInputPinWithPullUpResistor (GPIO_PORT_P1, GPIO_PIN4);
 
+    // All the buttons are active low, so the first edge we wait for is the press (high to low)
+    EnableButtonInterrupt(GPIO_PORT_P5, GPIO_PIN1);
+    EnableButtonInterrupt(GPIO_PORT_P3, GPIO_PIN5);
+    EnableButtonInterrupt(GPIO_PORT_P1, GPIO_PIN1 | GPIO_PIN4);
+
+    Interrupt_enableInterrupt(INT_PORT5);
+    Interrupt_enableInterrupt(INT_PORT3);
+    Interrupt_enableInterrupt(INT_PORT1);
+}
+
+void PORT5_IRQHandler() {
+    uint32_t now = GetTimerValue(TIMER32_0_BASE);
+
+    if (GPIO_getEnabledInterruptStatus(GPIO_PORT_P5) & GPIO_PIN1)
+    {
+        if (Booster_Top_Button_Pressed())
+            TakePressEdge(BOOSTER_TOP, now);
+        SelectNextEdge(GPIO_PORT_P5, GPIO_PIN1);
+        PostEvent(EVT_BUTTON, BOOSTER_TOP, PRIO_HIGH);
+    }
+}
+
+void PORT3_IRQHandler() {
+    uint32_t now = GetTimerValue(TIMER32_0_BASE);
+
+    if (GPIO_getEnabledInterruptStatus(GPIO_PORT_P3) & GPIO_PIN5)
+    {
+        if (Booster_Bottom_Button_Pressed())
+            TakePressEdge(BOOSTER_BOTTOM, now);
+        SelectNextEdge(GPIO_PORT_P3, GPIO_PIN5);
+        PostEvent(EVT_BUTTON, BOOSTER_BOTTOM, PRIO_HIGH);
+
+        // A release edge starts a new input-to-photon latency sample
+        if (!Booster_Bottom_Button_Pressed())
+            LATENCY_MARK(LATENCY_EDGE);
+    }
+}
+
+void PORT1_IRQHandler() {
+    uint32_t now = GetTimerValue(TIMER32_0_BASE);
+    uint_fast16_t status = GPIO_getEnabledInterruptStatus(GPIO_PORT_P1);
+
+    if (status & GPIO_PIN1)
+    {
+        if (Launchpad_Left_Button_Pressed())
+            TakePressEdge(LAUNCHPAD_LEFT, now);
+        SelectNextEdge(GPIO_PORT_P1, GPIO_PIN1);
+        PostEvent(EVT_BUTTON, LAUNCHPAD_LEFT, PRIO_HIGH);
+    }
+    if (status & GPIO_PIN4)
+    {
+        if (Launchpad_Right_Button_Pressed())
+            TakePressEdge(LAUNCHPAD_RIGHT, now);
+        SelectNextEdge(GPIO_PORT_P1, GPIO_PIN4);
+        PostEvent(EVT_BUTTON, LAUNCHPAD_RIGHT, PRIO_HIGH);
+    }
 }
 
 bool Booster_Top_Button_Pressed() {
@@ -132,7 +297,7 @@ bool Booster_Top_Button_Pushed() {
     }
 
     bool rawStatus = Booster_Top_Button_Pressed();
-    bool curStatus = Debounce_Button(&debounceState, &timer, rawStatus);
+    bool curStatus = Debounce_Button(BOOSTER_TOP, &debounceState, &timer, rawStatus);
     bool pushed = (!curStatus && prevStatus);
     prevStatus = curStatus;
     return pushed;
@@ -155,12 +320,58 @@ bool Booster_Bottom_Button_Pushed() {
     }
 
     bool rawStatus = Booster_Bottom_Button_Pressed();
-    bool curStatus = Debounce_Button(&debounceState, &timer, rawStatus);
+    bool curStatus = Debounce_Button(BOOSTER_BOTTOM, &debounceState, &timer, rawStatus);
     bool pushed = (!curStatus && prevStatus);
     prevStatus = curStatus;
+
+    if (pushed)
+        LATENCY_MARK(LATENCY_PUSHED);
+
     return pushed;
 }
 
+bool Launchpad_Left_Button_Pushed() {
 
+    static bool prevStatus = false;
+    static DebounceState_t debounceState = stable0;
+    static OneShotSWTimer_t timer;
+    static bool initTimer = false;
 
+    // The timer needs to be initialized only once when the button is used for the first time
+    if (!initTimer) {
 
+        InitOneShotSWTimer(&timer,
+                           TIMER32_1_BASE,
+                           DEBOUNCE_TIMING);
+        initTimer = true;
+    }
+
+    bool rawStatus = Launchpad_Left_Button_Pressed();
+    bool curStatus = Debounce_Button(LAUNCHPAD_LEFT, &debounceState, &timer, rawStatus);
+    bool pushed = (!curStatus && prevStatus);
+    prevStatus = curStatus;
+    return pushed;
+}
+
+bool Launchpad_Right_Button_Pushed() {
+
+    static bool prevStatus = false;
+    static DebounceState_t debounceState = stable0;
+    static OneShotSWTimer_t timer;
+    static bool initTimer = false;
+
+    // The timer needs to be initialized only once when the button is used for the first time
+    if (!initTimer) {
+
+        InitOneShotSWTimer(&timer,
+                           TIMER32_1_BASE,
+                           DEBOUNCE_TIMING);
+        initTimer = true;
+    }
+
+    bool rawStatus = Launchpad_Right_Button_Pressed();
+    bool curStatus = Debounce_Button(LAUNCHPAD_RIGHT, &debounceState, &timer, rawStatus);
+    bool pushed = (!curStatus && prevStatus);
+    prevStatus = curStatus;
+    return pushed;
+}
@@ -8,6 +8,10 @@
 
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 
+// InitButtons also enables an interrupt on both edges of every button.
+// Each edge posts an EVT_BUTTON to the scheduler with the button_t below as the argument.
+typedef enum {BOOSTER_TOP, BOOSTER_BOTTOM, LAUNCHPAD_LEFT, LAUNCHPAD_RIGHT, BUTTONS} button_t;
+
 void InitButtons();
 
 // The below functions return true if the button mentioned in the function name is pressed
@@ -22,6 +26,33 @@ bool Launchpad_Right_Button_Pressed();
 // These functions use debounced button status
 bool Booster_Top_Button_Pushed();
 bool Booster_Bottom_Button_Pushed();
+bool Launchpad_Left_Button_Pushed();
+bool Launchpad_Right_Button_Pushed();
 bool Joystick_Pushed();
 
+//------------------------------------------
+// Press edges
+// The debounced status is only known DEBOUNCE_TIMING after the press, and only when something polls it, so it
+// cannot tell when a button went down. Once ArmPressEdges is called, the port ISRs timestamp the first press edge
+// of every button with GetTimerValue(TIMER32_0_BASE) instead, within the few microseconds it takes to enter them.
+// Contact bounce and glitches make edges too, so the debounce FSM checks the edge after the fact: it validates it
+// when it sees the press become stable, and drops it when the press turns out to be a glitch, so that the next
+// edge is taken instead. The edges are thus only validated while the Pushed function of the button is polled.
+
+/*
+ * This function forgets the edges taken so far and takes the next press edge of every button.
+ */
+void ArmPressEdges();
+
+/*
+ * This function stops taking edges. The ones taken so far are kept.
+ */
+void DisarmPressEdges();
+
+/*
+ * This function returns true, with the timestamp of the edge, once the debounce FSM validated the press edge of
+ * the button taken since ArmPressEdges.
+ */
+bool GetPressEdge(button_t button, uint32_t *timestamp);
+
 #endif // BUTTONS_H_
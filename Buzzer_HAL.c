@@ -0,0 +1,193 @@
+//------------------------------------------
+// BUZZER API (Application Programming Interface)
+// Also known as BUZZER HAL (Hardware Abstraction Layer)
+// HAL is a specific form of API that designs the interface with a certain hardware
+// ACLK does not change with the clock governor, so only the pitch has to follow SMCLK. Between sounds Timer_A0 is
+// stopped and P2.7 is a GPIO held low, so that the buzzer does not sit at a DC level.
+
+#include <stddef.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Format.h>
+#include <Buzzer_HAL.h>
+
+#define ACLK_HZ 32768
+
+static const Timer_A_UpModeConfig toneConfig = {
+    TIMER_A_CLOCKSOURCE_SMCLK,
+    TIMER_A_CLOCKSOURCE_DIVIDER_1,
+    0xFFFF,                                 // set by each note
+    TIMER_A_TAIE_INTERRUPT_DISABLE,
+    TIMER_A_CCIE_CCR0_INTERRUPT_DISABLE,
+    TIMER_A_DO_CLEAR
+};
+
+static const Timer_A_CompareModeConfig dutyConfig = {
+    TIMER_A_CAPTURECOMPARE_REGISTER_4,      // TA0.4 is P2.7
+    TIMER_A_CAPTURECOMPARE_INTERRUPT_DISABLE,
+    TIMER_A_OUTPUTMODE_RESET_SET,
+    0
+};
+
+static const Timer_A_UpModeConfig noteConfig = {
+    TIMER_A_CLOCKSOURCE_ACLK,
+    TIMER_A_CLOCKSOURCE_DIVIDER_1,
+    0xFFFF,                                 // set by each note
+    TIMER_A_TAIE_INTERRUPT_DISABLE,
+    TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE,
+    TIMER_A_DO_CLEAR
+};
+
+static struct {
+    const Sound_t *sound;       // NULL when silent
+    uint8_t next;               // the note that comes after the one playing
+    uint16_t hz;                // of the note playing
+    uint32_t smclkHz;
+    uint32_t played;
+    uint32_t cut;               // by a sound of the same or a higher priority
+    uint32_t dropped;           // because one of a higher priority was playing
+} buzzer;
+
+static void Silence()
+{
+    buzzer.hz = 0;
+    Timer_A_stopTimer(TIMER_A0_BASE);
+    GPIO_setOutputLowOnPin(GPIO_PORT_P2, GPIO_PIN7);
+    GPIO_setAsOutputPin(GPIO_PORT_P2, GPIO_PIN7);
+}
+
+static void Tone(uint16_t hz)
+{
+    uint32_t period;
+
+    if (hz < BUZZER_MIN_HZ)
+    {
+        Silence();
+        return;
+    }
+
+    buzzer.hz = hz;
+    period = buzzer.smclkHz / hz;
+    if (period > 0x10000)
+        period = 0x10000;
+
+    Timer_A_stopTimer(TIMER_A0_BASE);
+    Timer_A_setCompareValue(TIMER_A0_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0, period - 1);
+    Timer_A_setCompareValue(TIMER_A0_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_4, period / 2);
+    Timer_A_clearTimer(TIMER_A0_BASE);
+    GPIO_setAsPeripheralModuleFunctionOutputPin(GPIO_PORT_P2, GPIO_PIN7, GPIO_PRIMARY_MODULE_FUNCTION);
+    Timer_A_startCounter(TIMER_A0_BASE, TIMER_A_UP_MODE);
+}
+
+// This function is called with interrupts disabled, or from the ISR
+static void NextNote()
+{
+    const Note_t *N;
+    uint32_t ticks;
+
+    Timer_A_stopTimer(TIMER_A3_BASE);
+    if (buzzer.next == buzzer.sound->count)
+    {
+        buzzer.sound = NULL;
+        Silence();
+        return;
+    }
+
+    N = &buzzer.sound->notes[buzzer.next++];
+    Tone(N->hz);
+
+    ticks = (uint32_t) N->ms * ACLK_HZ / 1000;
+    if (ticks > 0x10000)
+        ticks = 0x10000;
+    if (ticks == 0)
+        ticks = 1;
+    Timer_A_setCompareValue(TIMER_A3_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0, ticks - 1);
+    Timer_A_clearTimer(TIMER_A3_BASE);
+    Timer_A_startCounter(TIMER_A3_BASE, TIMER_A_UP_MODE);
+}
+
+void InitBuzzer()
+{
+    buzzer.smclkHz = CS_getSMCLK();
+
+    Timer_A_configureUpMode(TIMER_A0_BASE, &toneConfig);
+    Timer_A_initCompare(TIMER_A0_BASE, &dutyConfig);
+    Timer_A_configureUpMode(TIMER_A3_BASE, &noteConfig);
+    Silence();
+
+    Interrupt_enableInterrupt(INT_TA3_0);
+}
+
+bool PlaySound(const Sound_t *sound)
+{
+    bool wasDisabled = Interrupt_disableMaster();
+    bool play = !buzzer.sound || sound->priority >= buzzer.sound->priority;
+
+    if (play)
+    {
+        if (buzzer.sound)
+            buzzer.cut++;
+        buzzer.played++;
+        buzzer.sound = sound;
+        buzzer.next = 0;
+        NextNote();
+    }
+    else
+        buzzer.dropped++;
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+    return play;
+}
+
+void StopSound()
+{
+    bool wasDisabled = Interrupt_disableMaster();
+
+    Timer_A_stopTimer(TIMER_A3_BASE);
+    buzzer.sound = NULL;
+    Silence();
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+bool SoundPlaying()
+{
+    return buzzer.sound != NULL;
+}
+
+void BuzzerClockChanged(uint32_t smclkHz)
+{
+    buzzer.smclkHz = smclkHz;
+    if (buzzer.hz)
+        Tone(buzzer.hz);
+}
+
+void TA3_0_IRQHandler()
+{
+    Timer_A_clearCaptureCompareInterrupt(TIMER_A3_BASE, TIMER_A_CAPTURECOMPARE_REGISTER_0);
+    if (buzzer.sound)
+        NextNote();
+    else
+        Timer_A_stopTimer(TIMER_A3_BASE);
+}
+
+// The lines are:
+//   Sounds n            the number of sounds started
+//    cut n drop n       cut short by another, and dropped for one of a higher priority
+uint32_t BuzzerDump(EmitLine_t emit) {
+    char line[20];
+    unsigned i;
+
+    i = AppendString(line, 0, "Sounds ");
+    AppendNumber(line, i, buzzer.played);
+    emit(line, 0);
+
+    i = AppendString(line, 0, " cut ");
+    i = AppendNumber(line, i, buzzer.cut);
+    i = AppendString(line, i, " drop ");
+    AppendNumber(line, i, buzzer.dropped);
+    emit(line, 1);
+
+    return 2;
+}
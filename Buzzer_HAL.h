@@ -0,0 +1,61 @@
+//------------------------------------------
+// BUZZER API
+// Also known as BUZZER HAL (Hardware Abstraction Layer)
+// HAL is a specific form of API that designs the interface with a certain hardware
+// The buzzer of the BoosterPack is on P2.7, which is TA0.4. Timer_A0 counts SMCLK in up mode: CCR0 sets the pitch
+// and CCR4, in reset/set mode, a duty of one half. A sound is a table of notes, which Timer_A3 plays in the
+// background: it counts ACLK in up mode with the length of the note in its CCR0, and its ISR loads the next note
+// into Timer_A0 when it expires. A sound thus costs one interrupt per note, and no task waits on it.
+// Only one sound plays at a time. A sound of the same or a higher priority than the one playing cuts it short; one
+// of a lower priority is dropped.
+// BSP_Buzzer_Init and BSP_RGB_Init also use Timer_A0, so they must not be called.
+
+#ifndef BUZZER_HAL_H_
+#define BUZZER_HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+typedef struct {
+    uint16_t hz;            // 0 is a rest
+    uint16_t ms;            // at most BUZZER_MAX_MS
+} Note_t;
+
+typedef struct {
+    const Note_t *notes;
+    uint8_t       count;
+    uint8_t       priority; // the higher, the more important
+} Sound_t;
+
+// The lowest pitch CCR0 can hold at SMCLK 12 MHz, and the longest note CCR0 of Timer_A3 can hold
+#define BUZZER_MIN_HZ 200
+#define BUZZER_MAX_MS 2000
+
+/*
+ * This function sets up both timers and leaves the buzzer silent. It must be called after InitClock.
+ */
+void InitBuzzer();
+
+/*
+ * This function starts a sound and returns right away, or returns false if a sound of a higher priority is playing.
+ * The sound must stay in memory until it ends. It can be called from tasks and ISRs.
+ */
+bool PlaySound(const Sound_t *sound);
+
+void StopSound();
+
+bool SoundPlaying();
+
+/*
+ * The clock governor calls this function with interrupts disabled, right after it changed SMCLK. The note that is
+ * playing keeps its pitch.
+ */
+void BuzzerClockChanged(uint32_t smclkHz);
+
+/*
+ * This function formats the number of sounds played, cut short and dropped (see EmitLine_t)
+ */
+uint32_t BuzzerDump(EmitLine_t emit);
+
+#endif /* BUZZER_HAL_H_ */
@@ -0,0 +1,131 @@
+//------------------------------------------
+// CLOCK API (Application Programming Interface)
+// Also known as CLOCK HAL (Hardware Abstraction Layer)
+// HAL is a specific form of API that designs the interface with a certain hardware
+// The dividers of each level are those of CS_initClockSignal. MCLK and SMCLK both come from HFXT, as
+// BSP_Clock_InitFastest leaves them. The LCD is only written from tasks, which wait for the SPI before they
+// return, so the SPI is always idle when the governor runs; the trace UART may still be sending.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <Timer_HAL.h>
+#include <Trace.h>
+#include <Buzzer_HAL.h>
+#include <Format.h>
+#include <Clock_HAL.h>
+
+#define HFXT_HZ 48000000
+#define LFXT_HZ 32768
+
+typedef struct {
+    uint32_t mclkDivider;
+    uint32_t smclkDivider;
+} ClockDividers_t;
+
+static const ClockDividers_t dividers[CLOCK_LEVELS] = {
+    {CS_CLOCK_DIVIDER_1, CS_CLOCK_DIVIDER_4},       // CLOCK_FAST
+    {CS_CLOCK_DIVIDER_8, CS_CLOCK_DIVIDER_8},       // CLOCK_SLOW
+};
+
+static struct {
+    ClockLevel_t level;
+    uint32_t idleTicks;         // since the last button or motion event, or ClockKeepFast
+    uint32_t ticks;
+    uint32_t slowTicks;         // the ticks that found the clock at CLOCK_SLOW
+    uint32_t drops;             // the number of times it went down
+} governor;
+
+void InitClock()
+{
+    CS_setExternalClockSourceFrequency(LFXT_HZ, HFXT_HZ);
+    governor.level = CLOCK_FAST;
+}
+
+void SetClockLevel(ClockLevel_t level)
+{
+    uint32_t mclkHz, smclkHz;
+    bool wasDisabled;
+
+    if (level == governor.level)
+        return;
+
+    while (!TraceIdle())
+        ;
+
+    wasDisabled = Interrupt_disableMaster();
+
+    CS_initClockSignal(CS_MCLK, CS_HFXTCLK_SELECT, dividers[level].mclkDivider);
+    CS_initClockSignal(CS_SMCLK, CS_HFXTCLK_SELECT, dividers[level].smclkDivider);
+    governor.level = level;
+
+    mclkHz = CS_getMCLK();
+    smclkHz = CS_getSMCLK();
+    TimerClockChanged(mclkHz);
+    HAL_LCD_SpiClockChanged(smclkHz);
+    TraceClockChanged(smclkHz);
+    BuzzerClockChanged(smclkHz);
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+ClockLevel_t GetClockLevel()
+{
+    return governor.level;
+}
+
+void ClockKeepFast()
+{
+    governor.idleTicks = 0;
+    SetClockLevel(CLOCK_FAST);
+}
+
+// The clock only goes down while no record is being sent, so that the governor never waits on the trace
+void ClockGovernorTask(const Event_t *event)
+{
+    if (event->type == EVT_BUTTON || event->type == EVT_MOTION)
+    {
+        ClockKeepFast();
+        return;
+    }
+
+    governor.ticks++;
+    if (governor.level == CLOCK_SLOW)
+    {
+        governor.slowTicks++;
+        return;
+    }
+
+#if CLOCK_GOVERNOR_ENABLE
+    governor.idleTicks++;
+    if (governor.idleTicks >= CLOCK_IDLE_MS / TICK_PERIOD_MS && TraceIdle())
+    {
+        SetClockLevel(CLOCK_SLOW);
+        governor.drops++;
+    }
+#endif
+}
+
+// The lines are:
+//   Clock m/s MHz      MCLK and SMCLK now
+//    slow n p%         the number of times the clock went down, and the share of the ticks it was down
+uint32_t ClockDump(EmitLine_t emit) {
+    char line[20];
+    unsigned i;
+
+    i = AppendString(line, 0, "Clock ");
+    i = AppendNumber(line, i, CS_getMCLK() / 1000000);
+    i = AppendString(line, i, "/");
+    i = AppendNumber(line, i, CS_getSMCLK() / 1000000);
+    AppendString(line, i, " MHz");
+    emit(line, 0);
+
+    i = AppendString(line, 0, " slow ");
+    i = AppendNumber(line, i, governor.drops);
+    i = AppendString(line, i, " ");
+    i = AppendNumber(line, i, governor.ticks ? (uint32_t) ((uint64_t) governor.slowTicks * 100 / governor.ticks) : 0);
+    AppendString(line, i, "%");
+    emit(line, 1);
+
+    return 2;
+}
@@ -0,0 +1,68 @@
+//------------------------------------------
+// CLOCK API
+// Also known as CLOCK HAL (Hardware Abstraction Layer)
+// HAL is a specific form of API that designs the interface with a certain hardware
+// BSP_Clock_InitFastest runs MCLK at 48 MHz and SMCLK at 12 MHz from the 48 MHz crystal (HFXT). The clock governor
+// divides both when the UI is idle: after CLOCK_IDLE_MS without a button or motion event or a call to ClockKeepFast,
+// it goes down to CLOCK_SLOW, and the next such event brings it back to CLOCK_FAST before any other task runs.
+// The tasks that draw on their own, not in answer to a button, call ClockKeepFast while they do.
+// Only the dividers change: HFXT, the core voltage and the flash wait states stay as they are, so a change takes
+// effect at once. Everything that counts MCLK or SMCLK is told right away, with interrupts disabled:
+//   - Timer_HAL keeps the timers at the rate of the fastest MCLK (see GetTimerValue) and the tick at its period,
+//     so the software timers, the debounce, the timestamps and the run times stay exact,
+//   - the LCD recomputes its SPI divider, the trace UART its baud rate dividers and the buzzer its pitch.
+// Build with CLOCK_GOVERNOR_ENABLE=0 and the clock stays at CLOCK_FAST.
+
+#ifndef CLOCK_HAL_H_
+#define CLOCK_HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Scheduler.h>
+#include <Format.h>
+
+#ifndef CLOCK_GOVERNOR_ENABLE
+#define CLOCK_GOVERNOR_ENABLE 1
+#endif
+
+typedef enum {
+    CLOCK_FAST,             // MCLK 48 MHz, SMCLK 12 MHz, as BSP_Clock_InitFastest sets them up
+    CLOCK_SLOW,             // MCLK 6 MHz, SMCLK 6 MHz
+    CLOCK_LEVELS
+} ClockLevel_t;
+
+// The time without a button or motion event before the clock goes down
+#define CLOCK_IDLE_MS 2000
+
+/*
+ * This function tells driverlib the frequency of HFXT, so that CS_getMCLK and CS_getSMCLK are right. It must be
+ * called after BSP_Clock_InitFastest and before InitHWTimers and the modules that compute dividers from SMCLK.
+ */
+void InitClock();
+
+/*
+ * This function changes the dividers of MCLK and SMCLK, and tells the modules that depend on them. It waits for
+ * the trace UART to be idle, so it must not be called with interrupts disabled.
+ */
+void SetClockLevel(ClockLevel_t level);
+
+ClockLevel_t GetClockLevel();
+
+/*
+ * This function brings the clock back to CLOCK_FAST if it is slow, and restarts the idle time. A task calls it
+ * before it draws when it was not woken up by a button.
+ */
+void ClockKeepFast();
+
+/*
+ * This task counts the idle time on EVT_TICK and raises the clock on EVT_BUTTON and EVT_MOTION. It must subscribe
+ * to all three and be added before the other tasks, so that it runs first.
+ */
+void ClockGovernorTask(const Event_t *event);
+
+/*
+ * This function formats the clocks now and the share of the ticks spent at CLOCK_SLOW (see EmitLine_t)
+ */
+uint32_t ClockDump(EmitLine_t emit);
+
+#endif /* CLOCK_HAL_H_ */
@@ -0,0 +1,573 @@
+//------------------------------------------
+// CRYPTO API
+// Also known as CRYPTO HAL (Hardware Abstraction Layer)
+// The AES256 module holds one key at a time, and a key to decrypt with is worked out from a key to encrypt with
+// by the module itself, so the key is kept here and loaded again only when the direction changes.
+// The software AES is the plain one of FIPS-197, with tables for the S-box and its inverse only. The software
+// CRC takes a nibble at a time, with a table of 16 words.
+// The CRC32 module takes the bits of a byte in one order through CRC32DI and in the other through CRC32DIRB, and
+// its result can be read as it is or bit-reversed. Rather than rest on a reading of the reference manual, InitCrypto
+// tries the four ways and keeps the one whose CRC is that of the software, both written by the CPU and by DMA.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <string.h>
+#include <Crypto_HAL.h>
+#include <Format.h>
+#include <DMA_HAL.h>
+
+// DMA channel 7, source 0 is reserved for software requests: a transfer runs as soon as it is requested
+#define CRC_DMA_CHANNEL 7
+#define CRC_DMA_CHUNK   1024
+
+#define AES_MAX_ROUNDS  14
+
+static bool useHardware = CRYPTO_HARDWARE;
+
+// Whether the hardware can be used: set by InitCrypto, cleared if CryptoSelfTest finds it failing
+static bool hardwareWorks = CRYPTO_HARDWARE;
+
+static struct {
+    uint8_t  key[32];
+    unsigned bits;                                  // 0 while there is no key
+    uint8_t  roundKeys[(AES_MAX_ROUNDS + 1) * AES_BLOCK_BYTES];
+    unsigned rounds;
+#if CRYPTO_HARDWARE
+    enum {LOADED_NONE, LOADED_ENCRYPT, LOADED_DECRYPT} loaded;
+#endif
+} aes;
+
+static enum {SELF_TEST_NOT_RUN, SELF_TEST_PASSED, SELF_TEST_FAILED} selfTest;
+
+// The module of the hardware that failed, if it was given up
+static const char *hardwareFailed;
+
+//------------------------------------------
+// CRC-32
+
+static const uint32_t crcNibbles[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t CrcSoftware(const uint8_t *bytes, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (length--)
+    {
+        crc ^= *bytes++;
+        crc = (crc >> 4) ^ crcNibbles[crc & 0xF];
+        crc = (crc >> 4) ^ crcNibbles[crc & 0xF];
+    }
+    return ~crc;
+}
+
+#if CRYPTO_HARDWARE
+
+// The order of the bits found by InitCrypto
+static struct {
+    bool reversedInput;         // the bytes are written to CRC32DIRB rather than CRC32DI
+    bool reversedResult;        // the result is read bit-reversed
+} crcOrder;
+
+// The seed and the result are inverted, as the CRC-32 wants; the seed of all ones reads the same either way round
+static uint32_t CrcHardware(const uint8_t *bytes, uint32_t length)
+{
+    uint32_t result;
+
+    CRC32_setSeed(0xFFFFFFFF, CRC32_MODE);
+
+    if (length < CRYPTO_CRC_DMA_MIN)
+    {
+        while (length--)
+        {
+            if (crcOrder.reversedInput)
+                CRC32_set8BitDataReversed(*bytes++, CRC32_MODE);
+            else
+                CRC32_set8BitData(*bytes++, CRC32_MODE);
+        }
+    }
+    else
+    {
+        // In auto mode, one request moves the whole transfer, a byte at a time into the data input register
+        while (length)
+        {
+            uint32_t count = (length < CRC_DMA_CHUNK) ? length : CRC_DMA_CHUNK;
+
+            DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH7_RESERVED0, UDMA_MODE_AUTO, (void *) bytes,
+                                   (void *) (CRC32_BASE + (crcOrder.reversedInput ? OFS_CRC32DIRB : OFS_CRC32DI)),
+                                   count);
+            DMA_enableChannel(CRC_DMA_CHANNEL);
+            DMA_requestSoftwareTransfer(CRC_DMA_CHANNEL);
+            while (DMA_isChannelEnabled(CRC_DMA_CHANNEL))
+                ;
+            bytes += count;
+            length -= count;
+        }
+    }
+
+    result = crcOrder.reversedResult ? CRC32_getResultReversed(CRC32_MODE) : CRC32_getResult(CRC32_MODE);
+    return ~result;
+}
+
+// This function tries the four orders of the bits, and returns true once the CRC32 module gives the check value of
+// the CRC-32, and the CRC of the software for the table of the software CRC, which is fed by DMA
+static bool FindCrcOrder()
+{
+    unsigned order;
+
+    for (order = 0; order < 4; order++)
+    {
+        crcOrder.reversedInput = order & 2;
+        crcOrder.reversedResult = !(order & 1);
+        if (CrcHardware((const uint8_t *) "123456789", 9) == 0xCBF43926
+            && CrcHardware((const uint8_t *) crcNibbles, sizeof(crcNibbles))
+               == CrcSoftware((const uint8_t *) crcNibbles, sizeof(crcNibbles)))
+            return true;
+    }
+    return false;
+}
+
+#endif // CRYPTO_HARDWARE
+
+uint32_t CrcCompute(const void *data, uint32_t length)
+{
+#if CRYPTO_HARDWARE
+    if (useHardware)
+        return CrcHardware((const uint8_t *) data, length);
+#endif
+    return CrcSoftware((const uint8_t *) data, length);
+}
+
+//------------------------------------------
+// AES in software
+
+static const uint8_t sbox[256] = {
+    0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+    0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+    0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+    0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+    0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+    0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+    0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+    0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+    0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+    0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+    0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+    0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+    0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+    0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+    0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+    0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+static const uint8_t inverseSbox[256] = {
+    0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38, 0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
+    0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87, 0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB,
+    0x54, 0x7B, 0x94, 0x32, 0xA6, 0xC2, 0x23, 0x3D, 0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
+    0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2, 0x76, 0x5B, 0xA2, 0x49, 0x6D, 0x8B, 0xD1, 0x25,
+    0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92,
+    0x6C, 0x70, 0x48, 0x50, 0xFD, 0xED, 0xB9, 0xDA, 0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
+    0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A, 0xF7, 0xE4, 0x58, 0x05, 0xB8, 0xB3, 0x45, 0x06,
+    0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02, 0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B,
+    0x3A, 0x91, 0x11, 0x41, 0x4F, 0x67, 0xDC, 0xEA, 0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
+    0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85, 0xE2, 0xF9, 0x37, 0xE8, 0x1C, 0x75, 0xDF, 0x6E,
+    0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89, 0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B,
+    0xFC, 0x56, 0x3E, 0x4B, 0xC6, 0xD2, 0x79, 0x20, 0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
+    0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31, 0xB1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xEC, 0x5F,
+    0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D, 0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF,
+    0xA0, 0xE0, 0x3B, 0x4D, 0xAE, 0x2A, 0xF5, 0xB0, 0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
+    0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26, 0xE1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0C, 0x7D
+};
+
+static uint8_t Xtime(uint8_t x)
+{
+    return (x << 1) ^ ((x & 0x80) ? 0x1B : 0);
+}
+
+static uint8_t Multiply(uint8_t x, uint8_t y)
+{
+    uint8_t product = 0;
+
+    while (y)
+    {
+        if (y & 1)
+            product ^= x;
+        x = Xtime(x);
+        y >>= 1;
+    }
+    return product;
+}
+
+static void ExpandKey()
+{
+    unsigned words = aes.bits / 32;
+    unsigned total = (aes.rounds + 1) * 4;
+    uint8_t rcon = 1;
+    unsigned i;
+
+    memcpy(aes.roundKeys, aes.key, words * 4);
+    for (i = words; i < total; i++)
+    {
+        uint8_t *w = &aes.roundKeys[i * 4];
+        const uint8_t *previous = w - 4;
+        const uint8_t *back = w - words * 4;
+        uint8_t t[4] = {previous[0], previous[1], previous[2], previous[3]};
+        unsigned j;
+
+        if (i % words == 0)
+        {
+            uint8_t first = t[0];
+            t[0] = sbox[t[1]] ^ rcon;
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[first];
+            rcon = Xtime(rcon);
+        }
+        else if (words > 6 && i % words == 4)
+        {
+            for (j = 0; j < 4; j++)
+                t[j] = sbox[t[j]];
+        }
+        for (j = 0; j < 4; j++)
+            w[j] = back[j] ^ t[j];
+    }
+}
+
+static void AddRoundKey(uint8_t *state, unsigned round)
+{
+    const uint8_t *key = &aes.roundKeys[round * AES_BLOCK_BYTES];
+    unsigned i;
+
+    for (i = 0; i < AES_BLOCK_BYTES; i++)
+        state[i] ^= key[i];
+}
+
+// The state is stored column by column, as the block is: byte 4c + r is row r of column c.
+// Row r is rotated left by r, and the S-box applied on the way.
+static void SubShiftRows(uint8_t *state)
+{
+    uint8_t old[AES_BLOCK_BYTES];
+    unsigned c, r;
+
+    memcpy(old, state, AES_BLOCK_BYTES);
+    for (c = 0; c < 4; c++)
+        for (r = 0; r < 4; r++)
+            state[4 * c + r] = sbox[old[4 * ((c + r) % 4) + r]];
+}
+
+static void InverseSubShiftRows(uint8_t *state)
+{
+    uint8_t old[AES_BLOCK_BYTES];
+    unsigned c, r;
+
+    memcpy(old, state, AES_BLOCK_BYTES);
+    for (c = 0; c < 4; c++)
+        for (r = 0; r < 4; r++)
+            state[4 * ((c + r) % 4) + r] = inverseSbox[old[4 * c + r]];
+}
+
+static void MixColumns(uint8_t *state)
+{
+    unsigned c;
+
+    for (c = 0; c < 4; c++)
+    {
+        uint8_t *s = &state[4 * c];
+        uint8_t all = s[0] ^ s[1] ^ s[2] ^ s[3];
+        uint8_t first = s[0];
+
+        s[0] ^= all ^ Xtime(s[0] ^ s[1]);
+        s[1] ^= all ^ Xtime(s[1] ^ s[2]);
+        s[2] ^= all ^ Xtime(s[2] ^ s[3]);
+        s[3] ^= all ^ Xtime(s[3] ^ first);
+    }
+}
+
+static void InverseMixColumns(uint8_t *state)
+{
+    unsigned c;
+
+    for (c = 0; c < 4; c++)
+    {
+        uint8_t *s = &state[4 * c];
+        uint8_t a0 = s[0], a1 = s[1], a2 = s[2], a3 = s[3];
+
+        s[0] = Multiply(a0, 14) ^ Multiply(a1, 11) ^ Multiply(a2, 13) ^ Multiply(a3, 9);
+        s[1] = Multiply(a0, 9) ^ Multiply(a1, 14) ^ Multiply(a2, 11) ^ Multiply(a3, 13);
+        s[2] = Multiply(a0, 13) ^ Multiply(a1, 9) ^ Multiply(a2, 14) ^ Multiply(a3, 11);
+        s[3] = Multiply(a0, 11) ^ Multiply(a1, 13) ^ Multiply(a2, 9) ^ Multiply(a3, 14);
+    }
+}
+
+static void EncryptBlockSoftware(const uint8_t *in, uint8_t *out)
+{
+    unsigned round;
+
+    memmove(out, in, AES_BLOCK_BYTES);
+    AddRoundKey(out, 0);
+    for (round = 1; round < aes.rounds; round++)
+    {
+        SubShiftRows(out);
+        MixColumns(out);
+        AddRoundKey(out, round);
+    }
+    SubShiftRows(out);
+    AddRoundKey(out, aes.rounds);
+}
+
+static void DecryptBlockSoftware(const uint8_t *in, uint8_t *out)
+{
+    unsigned round;
+
+    memmove(out, in, AES_BLOCK_BYTES);
+    AddRoundKey(out, aes.rounds);
+    for (round = aes.rounds - 1; round > 0; round--)
+    {
+        InverseSubShiftRows(out);
+        AddRoundKey(out, round);
+        InverseMixColumns(out);
+    }
+    InverseSubShiftRows(out);
+    AddRoundKey(out, 0);
+}
+
+//------------------------------------------
+// AES
+
+#if CRYPTO_HARDWARE
+
+static uint_fast16_t KeyLength()
+{
+    switch (aes.bits)
+    {
+    case 128:
+        return AES256_KEYLENGTH_128BIT;
+    case 192:
+        return AES256_KEYLENGTH_192BIT;
+    default:
+        return AES256_KEYLENGTH_256BIT;
+    }
+}
+
+static void LoadKey(bool decrypt)
+{
+    if (decrypt && aes.loaded != LOADED_DECRYPT)
+    {
+        AES256_setDecipherKey(AES256_BASE, aes.key, KeyLength());
+        aes.loaded = LOADED_DECRYPT;
+    }
+    else if (!decrypt && aes.loaded != LOADED_ENCRYPT)
+    {
+        AES256_setCipherKey(AES256_BASE, aes.key, KeyLength());
+        aes.loaded = LOADED_ENCRYPT;
+    }
+}
+
+#endif // CRYPTO_HARDWARE
+
+bool AesSetKey(const uint8_t *key, unsigned bits)
+{
+    if (bits != 128 && bits != 192 && bits != 256)
+        return false;
+
+    memcpy(aes.key, key, bits / 8);
+    aes.bits = bits;
+    aes.rounds = bits / 32 + 6;
+    ExpandKey();
+#if CRYPTO_HARDWARE
+    aes.loaded = LOADED_NONE;
+#endif
+    return true;
+}
+
+static void EncryptBlock(const uint8_t *in, uint8_t *out)
+{
+#if CRYPTO_HARDWARE
+    if (useHardware)
+    {
+        LoadKey(false);
+        AES256_encryptData(AES256_BASE, in, out);
+        return;
+    }
+#endif
+    EncryptBlockSoftware(in, out);
+}
+
+void AesEncryptECB(const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    while (blocks--)
+    {
+        EncryptBlock(in, out);
+        in += AES_BLOCK_BYTES;
+        out += AES_BLOCK_BYTES;
+    }
+}
+
+void AesDecryptECB(const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    while (blocks--)
+    {
+#if CRYPTO_HARDWARE
+        if (useHardware)
+        {
+            LoadKey(true);
+            AES256_decryptData(AES256_BASE, in, out);
+        }
+        else
+#endif
+            DecryptBlockSoftware(in, out);
+        in += AES_BLOCK_BYTES;
+        out += AES_BLOCK_BYTES;
+    }
+}
+
+void AesCTR(uint8_t counter[AES_BLOCK_BYTES], const uint8_t *in, uint8_t *out, uint32_t length)
+{
+    uint8_t keystream[AES_BLOCK_BYTES];
+
+    while (length)
+    {
+        uint32_t count = (length < AES_BLOCK_BYTES) ? length : AES_BLOCK_BYTES;
+        uint32_t i;
+
+        EncryptBlock(counter, keystream);
+        for (i = 0; i < count; i++)
+            out[i] = in[i] ^ keystream[i];
+
+        // The counter carries from its last byte up
+        i = AES_BLOCK_BYTES;
+        while (i-- && ++counter[i] == 0)
+            ;
+
+        in += count;
+        out += count;
+        length -= count;
+    }
+}
+
+//------------------------------------------
+// Setup and self-test
+
+void InitCrypto()
+{
+#if CRYPTO_HARDWARE
+    InitDMA();
+    DMA_assignChannel(DMA_CH7_RESERVED0);
+    DMA_disableChannelAttribute(DMA_CH7_RESERVED0,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | DMA_CH7_RESERVED0,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1024);
+
+    hardwareWorks = FindCrcOrder();
+    hardwareFailed = hardwareWorks ? NULL : "CRC";
+    useHardware = hardwareWorks;
+#endif
+}
+
+bool CryptoUseHardware(bool hardware)
+{
+    useHardware = hardwareWorks && hardware;
+    return useHardware;
+}
+
+static const uint8_t testPlain[AES_BLOCK_BYTES] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+static const uint8_t testCipher128[AES_BLOCK_BYTES] = {
+    0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+};
+static const uint8_t testCipher256[AES_BLOCK_BYTES] = {
+    0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF, 0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89
+};
+
+// SP 800-38A, F.5.1: the first block of CTR-AES128
+static const uint8_t ctrKey[AES_BLOCK_BYTES] = {
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+static const uint8_t ctrCounter[AES_BLOCK_BYTES] = {
+    0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
+};
+static const uint8_t ctrPlain[AES_BLOCK_BYTES] = {
+    0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A
+};
+static const uint8_t ctrCipher[AES_BLOCK_BYTES] = {
+    0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE
+};
+
+// The FIPS-197 examples encrypt and decrypt testPlain with the key 00 01 02 ... of their length
+static bool CheckBlockCipher(unsigned bits, const uint8_t *cipher)
+{
+    uint8_t key[32], block[AES_BLOCK_BYTES];
+    unsigned i;
+
+    for (i = 0; i < bits / 8; i++)
+        key[i] = i;
+    AesSetKey(key, bits);
+
+    AesEncryptECB(testPlain, block, 1);
+    if (memcmp(block, cipher, AES_BLOCK_BYTES) != 0)
+        return false;
+    AesDecryptECB(block, block, 1);
+    return memcmp(block, testPlain, AES_BLOCK_BYTES) == 0;
+}
+
+static bool CheckAll()
+{
+    uint8_t counter[AES_BLOCK_BYTES], block[AES_BLOCK_BYTES];
+    bool passed;
+
+    passed = CrcCompute("123456789", 9) == 0xCBF43926;
+    if (!passed && useHardware)
+        hardwareFailed = "CRC";
+    passed &= CheckBlockCipher(128, testCipher128);
+    passed &= CheckBlockCipher(256, testCipher256);
+
+    memcpy(counter, ctrCounter, AES_BLOCK_BYTES);
+    AesSetKey(ctrKey, 128);
+    AesCTR(counter, ctrPlain, block, AES_BLOCK_BYTES);
+    passed &= memcmp(block, ctrCipher, AES_BLOCK_BYTES) == 0 && counter[AES_BLOCK_BYTES - 1] == 0x00
+              && counter[AES_BLOCK_BYTES - 2] == 0xFF;
+    if (!passed && useHardware && !hardwareFailed)
+        hardwareFailed = "AES";
+    return passed;
+}
+
+bool CryptoSelfTest()
+{
+    bool passed = CheckAll();
+
+    if (!passed && useHardware)
+    {
+        hardwareWorks = false;
+        useHardware = false;
+        passed = CheckAll();
+    }
+    selfTest = passed ? SELF_TEST_PASSED : SELF_TEST_FAILED;
+    return passed;
+}
+
+// The lines are:
+//   Crypto ok|FAIL HW|SW   the result of the self-test and the implementation it checked
+//    HW CRC|AES failed     if the hardware was given up, and the module that failed first
+uint32_t CryptoDump(EmitLine_t emit) {
+    char line[20];
+    unsigned i;
+
+    if (selfTest == SELF_TEST_NOT_RUN)
+        AppendString(line, 0, "Crypto not run");
+    else
+    {
+        i = AppendString(line, 0, selfTest == SELF_TEST_PASSED ? "Crypto ok " : "Crypto FAIL ");
+        AppendString(line, i, useHardware ? "HW" : "SW");
+    }
+    emit(line, 0);
+
+    if (!hardwareFailed)
+        return 1;
+    i = AppendString(line, 0, " HW ");
+    i = AppendString(line, i, hardwareFailed);
+    AppendString(line, i, " failed");
+    emit(line, 1);
+    return 2;
+}
@@ -0,0 +1,77 @@
+//------------------------------------------
+// CRYPTO API
+// Also known as CRYPTO HAL (Hardware Abstraction Layer)
+// HAL is a specific form of API that designs the interface with a certain hardware
+// The CRC-32 is the one of ISO 3309 and zlib. AES encrypts and decrypts blocks of 16 bytes with 128, 192 or 256 bit
+// keys, in ECB mode or in CTR mode, where the blocks of a counter are encrypted into a keystream that the data is
+// XORed with. Both are computed in software, checked against known answers by host/test/cryptotest.
+// With CRYPTO_HARDWARE=1, the default on the target, they run in the CRC32 and AES256 modules, buffers of
+// CRYPTO_CRC_DMA_MIN bytes and more being fed to the CRC32 module by a DMA channel. InitCrypto finds the order in
+// which the CRC32 module must be given the bits and read, so that its CRC is the one of the software, and
+// CryptoSelfTest checks both modules: if either fails, everything goes back to the software, which the
+// diagnostics screen shows. The benchmark compares the two. CryptoUseHardware(false) also goes back to the software.
+
+#ifndef CRYPTO_HAL_H_
+#define CRYPTO_HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+#ifndef CRYPTO_HARDWARE
+#define CRYPTO_HARDWARE 1
+#endif
+
+#define CRYPTO_CRC_DMA_MIN  64
+#define AES_BLOCK_BYTES     16
+
+/*
+ * This function sets up the DMA channel of the CRC and finds the bit order of the CRC32 module. The hardware is
+ * used from then on if that order was found.
+ */
+void InitCrypto();
+
+/*
+ * This function chooses between the hardware and the software implementations. It returns true if the hardware
+ * is used, which it never is when CRYPTO_HARDWARE is 0 or when InitCrypto or CryptoSelfTest found it failing.
+ */
+bool CryptoUseHardware(bool hardware);
+
+/*
+ * This function returns the CRC-32 of length bytes
+ */
+uint32_t CrcCompute(const void *data, uint32_t length);
+
+/*
+ * This function sets the key of the following AES functions. bits is 128, 192 or 256; it returns false otherwise.
+ * The key is copied.
+ */
+bool AesSetKey(const uint8_t *key, unsigned bits);
+
+/*
+ * These functions encrypt and decrypt blocks of AES_BLOCK_BYTES bytes, in ECB mode. in and out can be the same.
+ */
+void AesEncryptECB(const uint8_t *in, uint8_t *out, uint32_t blocks);
+void AesDecryptECB(const uint8_t *in, uint8_t *out, uint32_t blocks);
+
+/*
+ * This function encrypts or decrypts, which is the same, length bytes in CTR mode. The counter is a block that is
+ * incremented as a 128-bit big-endian number after each block of data, the last one included even if it is only
+ * partly used: calling again goes on with a fresh block. in and out can be the same.
+ */
+void AesCTR(uint8_t counter[AES_BLOCK_BYTES], const uint8_t *in, uint8_t *out, uint32_t length);
+
+/*
+ * This function checks the CRC and AES against known answers (the check value of the CRC-32 and examples of
+ * FIPS-197 and SP 800-38A) with the implementation in use, and returns true if they all match. If the hardware
+ * fails them, it goes back to the software and checks it in turn.
+ */
+bool CryptoSelfTest();
+
+/*
+ * This function formats the result of the last CryptoSelfTest, and the module that failed if the hardware was given
+ * up (see EmitLine_t)
+ */
+uint32_t CryptoDump(EmitLine_t emit);
+
+#endif /* CRYPTO_HAL_H_ */
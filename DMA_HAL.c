@@ -0,0 +1,94 @@
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <stddef.h>
+#include <DMA_HAL.h>
+
+// The controller has 8 channels. Their primary and alternate control structures take 16 entries,
+// and the table must be aligned to its own size.
+#define DMA_TABLE_ENTRIES 16
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(controlTable, 256)
+static DMA_ControlTable controlTable[DMA_TABLE_ENTRIES];
+#else
+static DMA_ControlTable controlTable[DMA_TABLE_ENTRIES] __attribute__((aligned(256)));
+#endif
+
+// The holder of channel 0
+static volatile bool held;
+static volatile bool waiting;           // a caller of AcquireSharedDMA sleeps until the channel is free
+static void (*volatile sharedDone)(void);
+
+void InitDMA()
+{
+    static bool initialized = false;
+
+    if (initialized)
+        return;
+
+    DMA_enableModule();
+    DMA_setControlBase(controlTable);
+
+    // The attributes and the control word are those of both users, so only the mapping changes with the holder
+    DMA_disableChannelAttribute(DMA_SHARED_CHANNEL,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | DMA_SHARED_CHANNEL,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    DMA_assignInterrupt(DMA_INT2, DMA_SHARED_CHANNEL);
+    DMA_clearInterruptFlag(DMA_SHARED_CHANNEL);
+    Interrupt_enableInterrupt(INT_DMA_INT2);
+
+    initialized = true;
+}
+
+static void Hold(uint32_t mapping, void (*done)(void))
+{
+    held = true;
+    sharedDone = done;
+    DMA_assignChannel(mapping);
+}
+
+bool TryAcquireSharedDMA(uint32_t mapping, void (*done)(void))
+{
+    bool wasDisabled = Interrupt_disableMaster();
+    bool free = !held && !waiting;
+
+    if (free)
+        Hold(mapping, done);
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+    return free;
+}
+
+// The check is done with interrupts disabled, like RunScheduler does, so that the DMA interrupt that frees the
+// channel cannot come between the check and the sleep
+void AcquireSharedDMA(uint32_t mapping, void (*done)(void))
+{
+    Interrupt_disableMaster();
+    waiting = true;
+    while (held)
+    {
+        PCM_gotoLPM0();
+        Interrupt_enableMaster();
+        Interrupt_disableMaster();
+    }
+    waiting = false;
+    Hold(mapping, done);
+    Interrupt_enableMaster();
+}
+
+void ReleaseSharedDMA()
+{
+    sharedDone = NULL;
+    held = false;
+}
+
+// The last item of a transfer on channel 0 has been written
+void DMA_INT2_IRQHandler()
+{
+    void (*done)(void) = sharedDone;
+
+    DMA_clearInterruptFlag(DMA_SHARED_CHANNEL);
+    if (done)
+        done();
+}
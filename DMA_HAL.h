@@ -0,0 +1,49 @@
+//------------------------------------------
+// DMA API
+// Also known as DMA HAL (Hardware Abstraction Layer)
+// The MSP432 has a single DMA controller whose channel control table is shared by all the modules that
+// use a DMA channel. This HAL owns that table; each module then sets up its own channel with driverlib.
+//
+// Each channel has a fixed set of trigger sources, source 0 being reserved for software requests on every one
+// (see the DMA chapter of the datasheet). The channels are given out as follows:
+//   - channel 0, shared (see below), completion on DMA_INT2:
+//       source 2 (DMA_CH0_EUSCIB0TX0): Render, the SPI of the LCD, for the whole of RenderFrame;
+//       source 1 (DMA_CH0_EUSCIA0TX): Trace, the backchannel UART, one block of records at a time in between.
+//   - channel 7, source 0 (DMA_CH7_RESERVED0): Crypto_HAL, software requests to the CRC32 module, polled.
+// The transmit triggers of eUSCI_B0 and eUSCI_A0 are both on channel 0 only, so the channel is held by one user at
+// a time. This HAL sets it up for both (bytes from an incrementing source to a fixed register), maps it to the
+// trigger of the user that holds it, and calls that user back from the DMA_INT2 ISR at the end of each transfer.
+
+#ifndef DMA_HAL_H_
+#define DMA_HAL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DMA_SHARED_CHANNEL 0
+
+/*
+ * This function enables the DMA controller and points it to the channel control table, and sets up channel 0.
+ * Every module that uses DMA calls it from its own init function; only the first call does anything.
+ */
+void InitDMA();
+
+/*
+ * This function gives channel 0 to the caller unless it is held, or a caller of AcquireSharedDMA waits for it,
+ * and returns true if it did. mapping is the trigger source of the caller (DMA_CH0_...), and done is called from
+ * the DMA ISR at the end of each of its transfers, until ReleaseSharedDMA. It can be called from any context.
+ */
+bool TryAcquireSharedDMA(uint32_t mapping, void (*done)(void));
+
+/*
+ * This function sleeps in LPM0 until channel 0 is free, then gives it to the caller as TryAcquireSharedDMA does.
+ * It is called from the main loop only, with interrupts enabled; it wins over TryAcquireSharedDMA.
+ */
+void AcquireSharedDMA(uint32_t mapping, void (*done)(void));
+
+/*
+ * This function frees channel 0, once the last transfer of its holder is done. It can be called from done.
+ */
+void ReleaseSharedDMA();
+
+#endif /* DMA_HAL_H_ */
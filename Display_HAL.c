@@ -2,22 +2,73 @@
 #include "LcdDriver/Crystalfontz128x128_ST7735.h"
 #include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Timer_HAL.h>
+#include <Format.h>
+#include <Display_HAL.h>
 
 Graphics_Context g_sContext;
 
-void InitGraphics() {
-    Crystalfontz128x128_Init();
-    Crystalfontz128x128_SetOrientation(LCD_ORIENTATION_UP);
-    Graphics_initContext(&g_sContext,
-                         &g_sCrystalfontz128x128,
-                         &g_sCrystalfontz128x128_funcs);
-    Graphics_setForegroundColor(&g_sContext, GRAPHICS_COLOR_GREEN);
-    Graphics_setBackgroundColor(&g_sContext, GRAPHICS_COLOR_BLACK);
-    GrContextFontSet(&g_sContext, &g_sFontCmtt16);
-    Graphics_clearDisplay(&g_sContext);
+// Timer32_0 counted down from UINT32_MAX since InitHWTimers; 0 until the display is turned on
+static uint32_t firstPixelCycles;
+
+// The console, in text rows. The lines go round the rows: next is the one the next line is drawn on.
+static struct {
+    bool active;
+    unsigned firstRow;
+    unsigned rows;
+    unsigned lines;
+    unsigned next;
+} console;
+
+// The power manager. The modes are those last sent to the panel; partial is cleared by anything that sends NORON.
+static struct {
+    uint32_t sleepTicks;        // inactivity before the sleep, 0 for never
+    uint32_t idleTicks;         // ticks since the last button or motion event
+    bool asleep;                // asleep or waking up
+    bool waking;                // a button or motion event asked for the wake-up
+    bool wakePush;              // the push of wakeButton is not taken yet (see DisplayTakeWakePush)
+    button_t wakeButton;        // the button whose press woke the panel
+    bool idle;
+    bool partial;
+    unsigned firstRow, lastRow; // of the partial area
+    uint32_t wakeStart;         // Timer32_0 at the event that started the wake-up
+    uint32_t wakes;
+    uint32_t lastWakeUS, minWakeUS, maxWakeUS;
+} power = {DISPLAY_SLEEP_MS / TICK_PERIOD_MS};
+
+void StartGraphics() {
+    Crystalfontz128x128_InitStart();
+}
+
+bool GraphicsReady() {
+    static bool ready = false;
+
+    if (!ready && Crystalfontz128x128_InitStep())
+    {
+        Crystalfontz128x128_SetOrientation(LCD_ORIENTATION_UP);
+        Graphics_initContext(&g_sContext,
+                             &g_sCrystalfontz128x128,
+                             &g_sCrystalfontz128x128_funcs);
+        Graphics_setForegroundColor(&g_sContext, MY_GREEN);
+        Graphics_setBackgroundColor(&g_sContext, GRAPHICS_COLOR_BLACK);
+        GrContextFontSet(&g_sContext, &g_sFontCmtt16);
+        ready = true;
+    }
+    return ready;
+}
+
+void LCDDisplayOn() {
+    if (firstPixelCycles == 0)
+        firstPixelCycles = UINT32_MAX - GetTimerValue(TIMER32_0_BASE);
+    Crystalfontz128x128_DisplayOn();
+}
+
+uint32_t FirstPixelMicroseconds() {
+    return CyclesToMicroseconds(firstPixelCycles);
 }
 
 void LCDClearDisplay(int color) {
+    ConsoleStop();
     Graphics_setBackgroundColor(&g_sContext, color);
     Graphics_clearDisplay(&g_sContext);
 }
@@ -33,7 +84,7 @@ void LCDDrawChar(unsigned row, unsigned col, int8_t c) {
 }
 
 void PrintString(char *str, int row, int col) {
-    Graphics_setForegroundColor(&g_sContext, GRAPHICS_COLOR_GREEN);
+    Graphics_setForegroundColor(&g_sContext, MY_GREEN);
     int i;
     for (i = 0; str[i] != '\0'; i++) {
         LCDDrawChar(row,  col, str[i]);
@@ -48,3 +99,141 @@ void PrintString(char *str, int row, int col) {
     }
 }
 
+void ConsoleStart(unsigned firstRow, unsigned rows) {
+    console.active = true;
+    console.firstRow = firstRow;
+    console.rows = rows;
+    console.lines = 0;
+    console.next = 0;
+    Crystalfontz128x128_SetScrollArea(16 * firstRow, 16 * rows);
+}
+
+void ConsoleAppend(const char *str) {
+    unsigned col;
+
+    // Every column is drawn, so that nothing is left of the line that was there
+    Graphics_setForegroundColor(&g_sContext, MY_GREEN);
+    for (col = 0; col < 16; col++) {
+        LCDDrawChar(console.firstRow + console.next, col, *str ? *str : ' ');
+        if (*str)
+            str++;
+    }
+
+    console.next = (console.next + 1) % console.rows;
+
+    // Once every row has a line, the new one was drawn over the oldest, and the top is now the next row
+    if (console.lines < console.rows)
+        console.lines++;
+    else
+        Crystalfontz128x128_SetScrollStart(16 * (console.firstRow + console.next));
+}
+
+void ConsoleStop() {
+    if (console.active)
+    {
+        Crystalfontz128x128_StopScroll();
+        console.active = false;
+        power.partial = false;
+    }
+}
+
+void SetDisplaySleepTimeout(uint32_t ms) {
+    power.sleepTicks = ms / TICK_PERIOD_MS;
+}
+
+void DisplayScreenDrawn(unsigned firstRow, unsigned lastRow, bool fullColor) {
+    bool partial = (firstRow > 0 || lastRow < 7);
+
+    if (fullColor == power.idle)
+    {
+        power.idle = !fullColor;
+        Crystalfontz128x128_SetIdleMode(power.idle);
+    }
+
+    if (partial && (!power.partial || firstRow != power.firstRow || lastRow != power.lastRow))
+        Crystalfontz128x128_SetPartialArea(16 * firstRow, 16 * lastRow + 15);
+    else if (!partial && power.partial)
+        Crystalfontz128x128_SetNormalMode();
+    power.partial = partial;
+    power.firstRow = firstRow;
+    power.lastRow = lastRow;
+}
+
+static void RecordWake(uint32_t us) {
+    if (power.wakes == 0 || us < power.minWakeUS)
+        power.minWakeUS = us;
+    if (us > power.maxWakeUS)
+        power.maxWakeUS = us;
+    power.lastWakeUS = us;
+    power.wakes++;
+}
+
+void DisplayPowerTask(const Event_t *event) {
+    if (event->type == EVT_BUTTON || event->type == EVT_MOTION)
+    {
+        power.idleTicks = 0;
+        if (power.asleep && !power.waking)
+        {
+            power.waking = true;
+            power.wakeStart = event->timestamp;
+            power.wakePush = (event->type == EVT_BUTTON);
+            power.wakeButton = (button_t) event->arg;
+        }
+        // Both edges of a button are posted: only a press of another one forgets the push of the wake
+        else if (event->type == EVT_BUTTON && event->arg != power.wakeButton)
+            power.wakePush = false;
+    }
+    else if (!power.asleep)
+    {
+        power.idleTicks++;
+        if (power.sleepTicks && power.idleTicks >= power.sleepTicks)
+        {
+            Crystalfontz128x128_SleepIn();
+            power.asleep = true;
+            power.waking = false;
+            power.wakePush = false;
+        }
+    }
+
+    // Timer32_0 counts down
+    if (power.waking && Crystalfontz128x128_WakeStep())
+    {
+        RecordWake(CyclesToMicroseconds(power.wakeStart - GetTimerValue(TIMER32_0_BASE)));
+        power.asleep = false;
+        power.waking = false;
+    }
+}
+
+bool DisplayTakeWakePush(button_t button) {
+    if (!power.wakePush || button != power.wakeButton)
+        return false;
+    power.wakePush = false;
+    return true;
+}
+
+// The lines are:
+//   Wake wakes
+//    <min-max        in microseconds
+//    last            the last wake-up
+uint32_t DisplayPowerDump(EmitLine_t emit) {
+    char line[20];
+    unsigned i;
+
+    if (power.wakes == 0)
+        return 0;
+
+    i = AppendString(line, 0, "Wake ");
+    AppendNumber(line, i, power.wakes);
+    emit(line, 0);
+
+    i = AppendString(line, 0, " <");
+    i = AppendNumber(line, i, power.minWakeUS);
+    i = AppendString(line, i, "-");
+    AppendNumber(line, i, power.maxWakeUS);
+    emit(line, 1);
+
+    i = AppendString(line, 0, " ");
+    AppendNumber(line, i, power.lastWakeUS);
+    emit(line, 2);
+    return 3;
+}
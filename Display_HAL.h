@@ -7,15 +7,113 @@
 #define DISPLAY_H_
 
 #include <ti/grlib/grlib.h>
+#include <Scheduler.h>
+#include <Format.h>
+#include <Buttons_HAL.h>
 
 
 #define MY_BLACK GRAPHICS_COLOR_BLACK
 #define MY_WHITE GRAPHICS_COLOR_WHITE
 
-void InitGraphics();
+// The color of the text and the charts. It is a full green, one of the 8 colors of the idle mode (see
+// DisplayScreenDrawn), so that the screens look the same when the panel switches to that mode.
+#define MY_GREEN GRAPHICS_COLOR_LIME
+
+// The grlib context of the LCD, set up by GraphicsReady
+extern Graphics_Context g_sContext;
+
+/*
+ * This function starts the bring-up of the LCD and returns right away. It needs the hardware timers of
+ * InitHWTimers. The other modules can be initialized while the panel goes through its reset.
+ */
+void StartGraphics();
+
+/*
+ * This function carries the bring-up on and returns true once the LCD can be drawn on. It can be called any
+ * number of times. The display stays off until LCDDisplayOn, so the first frame can be drawn before it is seen.
+ */
+bool GraphicsReady();
+
+/*
+ * This function turns the display on. The first call records the time from InitHWTimers to that moment.
+ */
+void LCDDisplayOn();
+
+/*
+ * This function returns the time from InitHWTimers to the first LCDDisplayOn, or 0 if it has not happened
+ */
+uint32_t FirstPixelMicroseconds();
+
 void LCDClearDisplay(int color);
 void LCDDrawChar(unsigned row, unsigned col, int8_t c);
 void PrintString(char *str, int row, int col);
 
+//------------------------------------------
+// CONSOLE API
+// The console is a band of text rows that scrolls like a terminal, with the hardware scroll of the LCD. A new line
+// is drawn over the oldest one, in its place in the LCD memory, and the LCD is told to show the rows from the
+// next one on: each line costs one 16-pixel row on the SPI and a register write, however many lines are shown.
+// The rows outside the console do not move. Clearing the display ends the console.
+
+/*
+ * This function makes rows firstRow to firstRow + rows - 1 of the text grid a console, with no lines in it yet
+ */
+void ConsoleStart(unsigned firstRow, unsigned rows);
+
+/*
+ * This function adds a line under the others, scrolling the console up once it is full. Only the first 16
+ * characters are shown.
+ */
+void ConsoleAppend(const char *str);
+
+/*
+ * This function ends the console. The rows show again where they are drawn.
+ */
+void ConsoleStop();
+
+
+//------------------------------------------
+// DISPLAY POWER API
+// The power manager puts the panel in the cheapest mode that still shows the screen. Each screen tells it which
+// text rows it uses and whether it needs more than the 8 primary colors: a screen in the primary colors is shown in
+// idle mode, and only its rows are driven in partial mode. After DISPLAY_SLEEP_MS without a button or motion event
+// the panel goes to sleep, and the next one wakes it up: a push, or a move of the joystick or of the board. The
+// frame memory is kept, so nothing is redrawn. A press that wakes the panel only does that: the screens drop the
+// push of that button (see DisplayTakeWakePush).
+// The wake-up latency is measured from the timestamp of that event to the tick on which the panel is
+// awake again, so it is up to one TICK_PERIOD_MS longer than the wake-up itself.
+
+// The default inactivity time before the panel goes to sleep
+#define DISPLAY_SLEEP_MS 30000
+
+/*
+ * This function sets the inactivity time before the panel goes to sleep. 0 keeps it awake.
+ */
+void SetDisplaySleepTimeout(uint32_t ms);
+
+/*
+ * This function is called after a screen is drawn. The screen only has something on text rows firstRow to
+ * lastRow, and fullColor is false if it only uses the 8 colors in which red, green and blue are each fully on
+ * or off. A console needs the normal mode, so its screen must cover all the rows.
+ */
+void DisplayScreenDrawn(unsigned firstRow, unsigned lastRow, bool fullColor);
+
+/*
+ * This task counts the inactivity on EVT_TICK and wakes the panel on EVT_BUTTON and EVT_MOTION. It must subscribe
+ * to all three.
+ */
+void DisplayPowerTask(const Event_t *event);
+
+/*
+ * This function returns true, once, if the push of the button is that of the press that woke the panel. The
+ * screens call it on each push and ignore the push when it returns true. The press of another button, or the next
+ * sleep, forgets the wake push.
+ */
+bool DisplayTakeWakePush(button_t button);
+
+/*
+ * This function formats the wake-up statistics (see EmitLine_t)
+ */
+uint32_t DisplayPowerDump(EmitLine_t emit);
 
 #endif /* DISPLAY_H_ */
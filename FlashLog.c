@@ -0,0 +1,293 @@
+//------------------------------------------
+// FLASH LOG API (Application Programming Interface)
+// The sectors are kept protected, and unprotected only while a record is programmed or a sector erased, so that
+// nothing else can write to them by mistake. Programming and erasing block the CPU: a record takes tens of
+// microseconds, an erase a few milliseconds.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <FlashLog.h>
+#include <Format.h>
+#include <Crypto_HAL.h>
+
+// The log is read through this pointer. The host build points it to the flash of the simulator.
+#ifndef FLASH_LOG_MEMORY
+#define FLASH_LOG_MEMORY ((const uint8_t *) FLASH_LOG_START)
+#endif
+
+#define FLASH_LOG_SECTOR_MASK   (FLASH_SECTOR28 | FLASH_SECTOR29 | FLASH_SECTOR30 | FLASH_SECTOR31)
+
+typedef enum {RECORD_SUMMARY = 1, RECORD_RESULT, RECORD_SETTING, RECORD_ERASED = 0xFF} RecordType_t;
+
+typedef struct {
+    uint8_t  type;      // a RecordType_t
+    uint8_t  key;       // the setting, or 1 if the round was won
+    uint16_t sequence;  // of the sector, in its summary
+    uint32_t a;         // the rounds in a summary, the detail of a result, the value of a setting
+    uint32_t b;         // the rounds won in a summary, the number of the round in a result
+    uint32_t crc;       // of the bytes above
+} LogRecord_t;
+
+#define RECORDS_PER_SECTOR  (FLASH_LOG_SECTOR_SIZE / sizeof(LogRecord_t))
+
+static struct {
+    int sector;                 // the newest sector, -1 while the log is empty
+    uint16_t sequence;          // of its summary
+    unsigned next;              // its first free record
+    uint32_t rounds, won;
+    uint32_t settings[FLASH_LOG_SETTINGS];
+    uint8_t settingsWritten;    // a bit for each setting
+    uint32_t bootReads;         // records InitFlashLog read
+    uint32_t failures;          // records or erases that did not succeed
+} flashLog = {-1};
+
+static const LogRecord_t *Record(unsigned sector, unsigned n)
+{
+    return (const LogRecord_t *) (FLASH_LOG_MEMORY + sector * FLASH_LOG_SECTOR_SIZE) + n;
+}
+
+static uint32_t RecordCRC(const LogRecord_t *record)
+{
+    return CrcCompute(record, offsetof(LogRecord_t, crc));
+}
+
+static bool RecordValid(const LogRecord_t *record)
+{
+    flashLog.bootReads++;
+    return record->type != RECORD_ERASED && record->crc == RecordCRC(record);
+}
+
+// A record that was programmed, even partly, is not erased
+static bool RecordErased(const LogRecord_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *) record;
+    unsigned i;
+
+    flashLog.bootReads++;
+    for (i = 0; i < sizeof(LogRecord_t); i++)
+        if (bytes[i] != 0xFF)
+            return false;
+    return true;
+}
+
+//------------------------------------------
+// Writing
+
+static bool Program(const LogRecord_t *record)
+{
+    uint32_t address = FLASH_LOG_START + flashLog.sector * FLASH_LOG_SECTOR_SIZE
+                     + flashLog.next * sizeof(LogRecord_t);
+    bool done;
+
+    FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_LOG_SECTOR_MASK);
+    done = FlashCtl_programMemory((void *) record, (void *) (uintptr_t) address, sizeof(LogRecord_t));
+    FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_LOG_SECTOR_MASK);
+
+    // The record is skipped anyway if it is wrong, so the next one goes after it
+    flashLog.next++;
+    if (!done)
+        flashLog.failures++;
+    return done;
+}
+
+static bool Append(RecordType_t type, uint8_t key, uint16_t sequence, uint32_t a, uint32_t b)
+{
+    LogRecord_t record;
+
+    record.type = type;
+    record.key = key;
+    record.sequence = sequence;
+    record.a = a;
+    record.b = b;
+    record.crc = RecordCRC(&record);
+    return Program(&record);
+}
+
+// This function erases the oldest sector and starts it with the summary and the settings
+static bool NextSector()
+{
+    uint32_t address;
+    unsigned s;
+    bool done;
+
+    flashLog.sector = (flashLog.sector + 1) % FLASH_LOG_SECTORS;
+    flashLog.sequence++;
+    flashLog.next = 0;
+
+    address = FLASH_LOG_START + flashLog.sector * FLASH_LOG_SECTOR_SIZE;
+    FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_LOG_SECTOR_MASK);
+    done = FlashCtl_eraseSector(address);
+    FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_LOG_SECTOR_MASK);
+
+    // The sector is left full, so that the next append moves on to the one after it
+    if (!done)
+    {
+        flashLog.failures++;
+        flashLog.next = RECORDS_PER_SECTOR;
+        return false;
+    }
+
+    done = Append(RECORD_SUMMARY, 0, flashLog.sequence, flashLog.rounds, flashLog.won);
+    for (s = 0; s < FLASH_LOG_SETTINGS; s++)
+        if (flashLog.settingsWritten & (1 << s))
+            done &= Append(RECORD_SETTING, s, 0xFFFF, flashLog.settings[s], 0);
+    return done;
+}
+
+static bool AppendInSector(RecordType_t type, uint8_t key, uint32_t a, uint32_t b)
+{
+    if ((flashLog.sector < 0 || flashLog.next == RECORDS_PER_SECTOR) && !NextSector())
+        return false;
+    return Append(type, key, 0xFFFF, a, b);
+}
+
+//------------------------------------------
+// Reading
+
+static void Apply(const LogRecord_t *record)
+{
+    switch (record->type)
+    {
+    case RECORD_SUMMARY:
+        flashLog.rounds = record->a;
+        flashLog.won = record->b;
+        break;
+
+    case RECORD_RESULT:
+        flashLog.rounds++;
+        flashLog.won += record->key;
+        break;
+
+    case RECORD_SETTING:
+        if (record->key < FLASH_LOG_SETTINGS)
+        {
+            flashLog.settings[record->key] = record->a;
+            flashLog.settingsWritten |= 1 << record->key;
+        }
+        break;
+    }
+}
+
+void InitFlashLog()
+{
+    unsigned s, n, low, high;
+
+    memset(&flashLog, 0, sizeof(flashLog));
+    flashLog.sector = -1;
+
+    // The newest sector. The sequence numbers wrap around, so they are compared by their difference.
+    for (s = 0; s < FLASH_LOG_SECTORS; s++)
+    {
+        const LogRecord_t *summary = Record(s, 0);
+
+        if (!RecordValid(summary) || summary->type != RECORD_SUMMARY)
+            continue;
+        if (flashLog.sector < 0 || (int16_t) (summary->sequence - flashLog.sequence) > 0)
+        {
+            flashLog.sector = s;
+            flashLog.sequence = summary->sequence;
+        }
+    }
+    if (flashLog.sector < 0)
+        return;
+
+    // Its first free record: the records before it have all been programmed, and none of those after it
+    low = 1;
+    high = RECORDS_PER_SECTOR;
+    while (low < high)
+    {
+        unsigned middle = (low + high) / 2;
+
+        if (RecordErased(Record(flashLog.sector, middle)))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    flashLog.next = low;
+
+    for (n = 0; n < flashLog.next; n++)
+    {
+        const LogRecord_t *record = Record(flashLog.sector, n);
+
+        if (RecordValid(record))
+            Apply(record);
+    }
+}
+
+// The round is counted after the append, so that the summary of a new sector does not already hold it
+bool FlashLogResult(bool won, uint32_t detail)
+{
+    bool done = AppendInSector(RECORD_RESULT, won, detail, flashLog.rounds + 1);
+
+    flashLog.rounds++;
+    flashLog.won += won;
+    return done;
+}
+
+bool FlashLogSetting(unsigned setting, uint32_t value)
+{
+    if (setting >= FLASH_LOG_SETTINGS)
+        return false;
+    if ((flashLog.settingsWritten & (1 << setting)) && flashLog.settings[setting] == value)
+        return true;
+
+    flashLog.settings[setting] = value;
+    flashLog.settingsWritten |= 1 << setting;
+    return AppendInSector(RECORD_SETTING, setting, value, 0);
+}
+
+bool FlashLogGetSetting(unsigned setting, uint32_t *value)
+{
+    if (setting >= FLASH_LOG_SETTINGS || !(flashLog.settingsWritten & (1 << setting)))
+        return false;
+
+    *value = flashLog.settings[setting];
+    return true;
+}
+
+uint32_t FlashLogRounds(uint32_t *won)
+{
+    *won = flashLog.won;
+    return flashLog.rounds;
+}
+
+//------------------------------------------
+// State of the log
+
+// The lines are:
+//   Log won/rounds     shortened with a "k" from 100,000, and held at 9,999,999
+//    S sector.next   where the next record goes
+//    boot reads      records read by InitFlashLog
+//    fail failures   only if there were any
+uint32_t FlashLogDump(EmitLine_t emit) {
+    char line[20];
+    unsigned i;
+
+    i = AppendString(line, 0, "Log ");
+    i = AppendShortNumber(line, i, (flashLog.won < 9999999) ? flashLog.won : 9999999, "k");
+    i = AppendString(line, i, "/");
+    AppendShortNumber(line, i, (flashLog.rounds < 9999999) ? flashLog.rounds : 9999999, "k");
+    emit(line, 0);
+
+    if (flashLog.sector < 0)
+        return 1;
+
+    i = AppendString(line, 0, " S ");
+    i = AppendNumber(line, i, flashLog.sector);
+    i = AppendString(line, i, ".");
+    AppendNumber(line, i, flashLog.next);
+    emit(line, 1);
+
+    i = AppendString(line, 0, " boot ");
+    AppendNumber(line, i, flashLog.bootReads);
+    emit(line, 2);
+
+    if (flashLog.failures == 0)
+        return 3;
+
+    i = AppendString(line, 0, " fail ");
+    AppendNumber(line, i, flashLog.failures);
+    emit(line, 3);
+    return 4;
+}
@@ -0,0 +1,65 @@
+//------------------------------------------
+// FLASH LOG API (Application Programming Interface)
+// The results of the rounds and a few settings are kept in a log in flash, so that they survive a reset.
+// The log takes the last FLASH_LOG_SECTORS sectors of the main flash, which msp432p401r.cmd keeps out of the
+// program. Records of 16 bytes are appended to one sector at a time, each with the CRC-32 of CrcCompute (see
+// Crypto_HAL.h); a record whose CRC does not match, such as one cut short by a reset, is skipped.
+// When a sector is full, the oldest one is erased and the log goes on there: each sector is erased once every
+// FLASH_LOG_SECTORS turns of the log. A sector starts with a summary of everything before it, the rounds and the
+// rounds won, followed by the settings in force. So at boot only the first record of each sector and the records
+// of the newest sector are read, whatever the age of the log, and from then on the summary is kept in RAM:
+//   - the newest sector is the one whose summary has the highest sequence number (FLASH_LOG_SECTORS reads)
+//   - its first free record is found by bisection (8 reads)
+//   - the records before it are applied to the summary (at most 255 reads and CRCs)
+// An append programs one record, or erases a sector and rewrites the summary first once a sector is full.
+
+#ifndef FLASHLOG_H_
+#define FLASHLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+// Bank 1, sectors 28 to 31
+#define FLASH_LOG_START         0x0003C000
+#define FLASH_LOG_SECTORS       4
+#define FLASH_LOG_SECTOR_SIZE   4096
+
+// The settings are numbered from 0
+#define FLASH_LOG_SETTINGS      4
+
+/*
+ * This function finds the end of the log and reads the summary and the settings. It must be called after
+ * InitCrypto and before the other functions. Called again, it forgets what it knew and reads the flash again, as
+ * after a reset.
+ */
+void InitFlashLog();
+
+/*
+ * This function appends the result of a round. detail is stored with it for whoever reads the flash.
+ * It returns false if the flash could not be programmed.
+ */
+bool FlashLogResult(bool won, uint32_t detail);
+
+/*
+ * This function appends a setting, unless it already has that value. It returns false if the flash could not be
+ * programmed.
+ */
+bool FlashLogSetting(unsigned setting, uint32_t value);
+
+/*
+ * This function returns false if the setting was never written, and otherwise its last value in value
+ */
+bool FlashLogGetSetting(unsigned setting, uint32_t *value);
+
+/*
+ * This function returns the number of rounds played since the log was started, and of rounds won in won
+ */
+uint32_t FlashLogRounds(uint32_t *won);
+
+/*
+ * This function formats the state of the log (see EmitLine_t)
+ */
+uint32_t FlashLogDump(EmitLine_t emit);
+
+#endif /* FLASHLOG_H_ */
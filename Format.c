@@ -0,0 +1,52 @@
+//------------------------------------------
+// FORMAT API (Application Programming Interface)
+
+#include <Format.h>
+
+unsigned AppendString(char *line, unsigned i, const char *s)
+{
+    while (*s)
+        line[i++] = *s++;
+    line[i] = '\0';
+    return i;
+}
+
+unsigned AppendStringMax(char *line, unsigned i, const char *s, unsigned max)
+{
+    while (*s && max--)
+        line[i++] = *s++;
+    line[i] = '\0';
+    return i;
+}
+
+unsigned AppendNumber(char *line, unsigned i, uint32_t n)
+{
+    char digits[10];
+    unsigned count = 0;
+
+    do
+    {
+        digits[count++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+    while (count)
+        line[i++] = digits[--count];
+    line[i] = '\0';
+    return i;
+}
+
+unsigned AppendShortNumber(char *line, unsigned i, uint32_t n, const char *suffix)
+{
+    if (n < 100000)
+        return AppendNumber(line, i, n);
+    i = AppendNumber(line, i, n / 1000);
+    return AppendString(line, i, suffix);
+}
+
+unsigned AppendThousandths(char *line, unsigned i, uint32_t n, const char *unit)
+{
+    i = AppendNumber(line, i, n / 1000);
+    i = AppendString(line, i, ".");
+    i = AppendNumber(line, i, n / 100 % 10);
+    return AppendString(line, i, unit);
+}
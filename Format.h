@@ -0,0 +1,42 @@
+//------------------------------------------
+// FORMAT API (Application Programming Interface)
+// The Dump functions build the lines of the diagnostics screen with these functions. Each one appends to line at
+// position i, terminates it, and returns the new position. Nothing checks the length of line: the callers keep
+// their lines within the 16 characters of a row.
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+
+/*
+ * The Dump functions of the modules format their statistics as lines of at most 16 characters, one row of the LCD,
+ * and pass them one by one to an emit function like this one, with their index from 0. They return the number of
+ * lines. The lines can as well be sent to a serial port, like those of Profile_Dump.
+ */
+typedef void (*EmitLine_t)(char *line, uint32_t index);
+
+unsigned AppendString(char *line, unsigned i, const char *s);
+
+/*
+ * This function appends at most max characters of s.
+ */
+unsigned AppendStringMax(char *line, unsigned i, const char *s, unsigned max);
+
+/*
+ * This function appends the decimal digits of n.
+ */
+unsigned AppendNumber(char *line, unsigned i, uint32_t n);
+
+/*
+ * This function appends n like AppendNumber, but in thousands followed by suffix when it is 100,000 or more, so
+ * that it takes at most 6 characters up to 99,999,999.
+ */
+unsigned AppendShortNumber(char *line, unsigned i, uint32_t n, const char *suffix);
+
+/*
+ * This function appends a number of thousandths with one decimal, followed by unit: 312400 us is "312.4ms".
+ */
+unsigned AppendThousandths(char *line, unsigned i, uint32_t n, const char *unit);
+
+#endif /* FORMAT_H_ */
@@ -0,0 +1,40 @@
+//------------------------------------------
+// IMAGE API (Application Programming Interface)
+// The decoder writes the LCD through the HAL of the Crystalfontz driver, in the draw frame of the image.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <RamFunc.h>
+#include <Image.h>
+
+RAMFUNC void DrawImage(const Image_t *image, uint16_t x, uint16_t y)
+{
+    const uint8_t *p = image->data;
+    const uint8_t *end = image->data + image->size;
+
+    Crystalfontz128x128_SetDrawFrame(x, y, x + image->width - 1, y + image->height - 1);
+    HAL_LCD_writeCommand(CM_RAMWR);
+
+    while (p < end)
+    {
+        uint8_t header = *p++;
+        unsigned count;
+
+        if (header & IMAGE_RUN)
+        {
+            uint8_t high = p[0], low = p[1];
+            p += 2;
+            for (count = (header & 0x7F) + IMAGE_MIN_RUN; count; count--)
+            {
+                HAL_LCD_writeData(high);
+                HAL_LCD_writeData(low);
+            }
+        }
+        else
+        {
+            for (count = 2 * (header + 1); count; count--)
+                HAL_LCD_writeData(*p++);
+        }
+    }
+}
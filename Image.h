@@ -0,0 +1,35 @@
+//------------------------------------------
+// IMAGE API (Application Programming Interface)
+// Images are compiled on the host by host/assetc (see assets/) into RGB565 pixels compressed with a run length
+// code, and stored in flash. DrawImage decodes them straight into the RAMWR stream of the LCD: there is no
+// frame buffer, and a run of one color costs one packet in flash and no work per pixel but the SPI bytes.
+//
+// The data is a sequence of packets. Each packet starts with a header byte h:
+//   h < 0x80   literal: h + 1 pixels follow, 2 bytes each
+//   h >= 0x80  run: one pixel follows, 2 bytes, and is repeated (h & 0x7F) + 2 times
+// Pixels are stored high byte first, the order in which the LCD receives them, and cover the image row by row.
+// This header is also included by host/assetc, so it does not include driverlib.
+
+#ifndef IMAGE_H_
+#define IMAGE_H_
+
+#include <stdint.h>
+
+#define IMAGE_RUN           0x80
+#define IMAGE_MAX_LITERAL   128     // pixels in one literal packet
+#define IMAGE_MIN_RUN       2
+#define IMAGE_MAX_RUN       (0x7F + IMAGE_MIN_RUN)
+
+typedef struct {
+    uint16_t       width;
+    uint16_t       height;
+    uint32_t       size;            // bytes of data
+    const uint8_t *data;
+} Image_t;
+
+/*
+ * This function draws an image with its top left corner at (x, y). The image must be completely on the screen.
+ */
+void DrawImage(const Image_t *image, uint16_t x, uint16_t y);
+
+#endif /* IMAGE_H_ */
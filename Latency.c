@@ -0,0 +1,165 @@
+//------------------------------------------
+// LATENCY API (Application Programming Interface)
+// The marks are timestamped with the free running Timer32_0 (see Timer_HAL.h).
+// Marks come both from the port ISR and from the main loop, so they are recorded with interrupts disabled.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Timer_HAL.h>
+#include <Format.h>
+#include <Latency.h>
+
+#if LATENCY_ENABLE
+
+static const char *const stageNames[LATENCY_STAGES] = {
+    "Edge>Push",    // EDGE_TO_PUSHED
+    "Push>Draw",    // PUSHED_TO_DRAW
+    "Draw>SPI",     // DRAW_TO_PHOTON
+    "Total",        // EDGE_TO_PHOTON
+};
+
+// The sample being measured
+static uint32_t markTime[LATENCY_MARKS];
+static LatencyMark_t expectedMark = LATENCY_MARKS;     // LATENCY_MARKS means no sample is in progress
+
+// The rolling window of complete samples, in microseconds, and the histograms of the samples in the window
+static uint32_t window[LATENCY_WINDOW][LATENCY_STAGES];
+static uint32_t windowCount;                            // total number of samples ever recorded
+static uint16_t histogram[LATENCY_STAGES][LATENCY_BUCKETS];
+
+static unsigned Bucket(uint32_t us)
+{
+    unsigned b = 0;
+    while ((us > 1) && (b < LATENCY_BUCKETS - 1))
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+// This function moves a complete sample into the window. The oldest sample leaves the window,
+// so its buckets are decremented before the new ones are incremented.
+static void RecordSample()
+{
+    uint32_t *slot = window[windowCount % LATENCY_WINDOW];
+    unsigned s;
+
+    if (windowCount >= LATENCY_WINDOW)
+    {
+        for (s = 0; s < LATENCY_STAGES; s++)
+            histogram[s][Bucket(slot[s])]--;
+    }
+
+    // Timer32_0 counts down, so an earlier mark has a larger value
+    slot[EDGE_TO_PUSHED] = CyclesToMicroseconds(markTime[LATENCY_EDGE] - markTime[LATENCY_PUSHED]);
+    slot[PUSHED_TO_DRAW] = CyclesToMicroseconds(markTime[LATENCY_PUSHED] - markTime[LATENCY_DRAW]);
+    slot[DRAW_TO_PHOTON] = CyclesToMicroseconds(markTime[LATENCY_DRAW] - markTime[LATENCY_PHOTON]);
+    slot[EDGE_TO_PHOTON] = CyclesToMicroseconds(markTime[LATENCY_EDGE] - markTime[LATENCY_PHOTON]);
+
+    for (s = 0; s < LATENCY_STAGES; s++)
+        histogram[s][Bucket(slot[s])]++;
+
+    windowCount++;
+}
+
+void LatencyMark(LatencyMark_t mark)
+{
+    uint32_t now = GetTimerValue(TIMER32_0_BASE);
+    bool wasDisabled = Interrupt_disableMaster();
+
+    // Every release edge restarts the sample. When the contact bounces, the last edge is the one
+    // the debounce FSM waits on, so it is the one that counts.
+    if (mark == LATENCY_EDGE)
+    {
+        markTime[LATENCY_EDGE] = now;
+        expectedMark = LATENCY_PUSHED;
+    }
+    else if (mark == expectedMark)
+    {
+        markTime[mark] = now;
+        expectedMark++;
+        if (mark == LATENCY_PHOTON)
+        {
+            RecordSample();
+            expectedMark = LATENCY_MARKS;
+        }
+    }
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+LatencyStats_t GetLatencyStats(LatencyStage_t stage)
+{
+    LatencyStats_t stats;
+    uint64_t sum = 0;
+    unsigned i;
+
+    stats.samples = (windowCount < LATENCY_WINDOW) ? windowCount : LATENCY_WINDOW;
+    stats.minUS = UINT32_MAX;
+    stats.maxUS = 0;
+    for (i = 0; i < stats.samples; i++)
+    {
+        uint32_t us = window[i][stage];
+        sum += us;
+        if (us < stats.minUS)
+            stats.minUS = us;
+        if (us > stats.maxUS)
+            stats.maxUS = us;
+    }
+    stats.meanUS = stats.samples ? (uint32_t)(sum / stats.samples) : 0;
+
+    for (i = 0; i < LATENCY_BUCKETS; i++)
+        stats.histogram[i] = histogram[stage][i];
+
+    return stats;
+}
+
+// For every stage, the lines are:
+//   name samples
+//    <min-max        in microseconds, in milliseconds with an "m" from 100,000 us
+//    ~mean
+//    2^b:count       one line per non-empty histogram bucket
+uint32_t LatencyDump(EmitLine_t emit)
+{
+    char line[24];
+    uint32_t n = 0;
+    unsigned s, b, i;
+
+    for (s = 0; s < LATENCY_STAGES; s++)
+    {
+        LatencyStats_t stats = GetLatencyStats((LatencyStage_t) s);
+        if (stats.samples == 0)
+            continue;
+
+        i = AppendString(line, 0, stageNames[s]);
+        i = AppendString(line, i, " ");
+        AppendNumber(line, i, stats.samples);
+        emit(line, n++);
+
+        i = AppendString(line, 0, " <");
+        i = AppendShortNumber(line, i, stats.minUS, "m");
+        i = AppendString(line, i, "-");
+        AppendShortNumber(line, i, stats.maxUS, "m");
+        emit(line, n++);
+
+        i = AppendString(line, 0, " ~");
+        AppendShortNumber(line, i, stats.meanUS, "m");
+        emit(line, n++);
+
+        for (b = 0; b < LATENCY_BUCKETS; b++)
+        {
+            if (stats.histogram[b])
+            {
+                i = AppendString(line, 0, " 2^");
+                i = AppendNumber(line, i, b);
+                i = AppendString(line, i, ":");
+                AppendNumber(line, i, stats.histogram[b]);
+                emit(line, n++);
+            }
+        }
+    }
+    return n;
+}
+
+#endif // LATENCY_ENABLE
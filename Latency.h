@@ -0,0 +1,69 @@
+//------------------------------------------
+// LATENCY API (Application Programming Interface)
+// This module measures the input-to-photon latency of the test screen: the time from the release of the
+// bottom button to the moment the moved '>' arrow has been completely sent to the LCD.
+// The path is cut into stages by four marks:
+//   LATENCY_EDGE    the raw release edge on P3.5, timestamped in the port ISR
+//   LATENCY_PUSHED  Booster_Bottom_Button_Pushed returns true after debouncing
+//   LATENCY_DRAW    guess() calls LCDDrawChar to draw the new arrow
+//   LATENCY_PHOTON  LCDDrawChar returns, i.e. the last SPI byte of the glyph has been shifted out
+// A sample is complete only when the four marks happen in this order. The last LATENCY_WINDOW samples
+// are kept, together with a rolling histogram of each stage.
+// Build with LATENCY_ENABLE=0 (the Release configuration does) and the marks compile out.
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+#ifndef LATENCY_ENABLE
+#define LATENCY_ENABLE 1
+#endif
+
+typedef enum {LATENCY_EDGE, LATENCY_PUSHED, LATENCY_DRAW, LATENCY_PHOTON, LATENCY_MARKS} LatencyMark_t;
+
+// The stages are the intervals between consecutive marks, plus the total from the first to the last mark
+typedef enum {EDGE_TO_PUSHED, PUSHED_TO_DRAW, DRAW_TO_PHOTON, EDGE_TO_PHOTON, LATENCY_STAGES} LatencyStage_t;
+
+// Number of most recent samples in the rolling statistics. It must be a power of 2.
+#define LATENCY_WINDOW 32
+
+// Bucket b of a stage histogram counts the samples with 2^b <= microseconds < 2^(b+1)
+#define LATENCY_BUCKETS 20
+
+typedef struct {
+    uint32_t samples;                       // number of samples in the window
+    uint32_t minUS, meanUS, maxUS;
+    uint16_t histogram[LATENCY_BUCKETS];
+} LatencyStats_t;
+
+#if LATENCY_ENABLE
+
+#define LATENCY_MARK(mark) LatencyMark(mark)
+
+/*
+ * This function records a mark with the current value of the cycle counter.
+ * A LATENCY_EDGE starts a new sample and drops any incomplete one.
+ */
+void LatencyMark(LatencyMark_t mark);
+
+/*
+ * This function returns the rolling statistics of one stage.
+ */
+LatencyStats_t GetLatencyStats(LatencyStage_t stage);
+
+/*
+ * This function formats the statistics of all stages (see EmitLine_t)
+ */
+uint32_t LatencyDump(EmitLine_t emit);
+
+#else
+
+#define LATENCY_MARK(mark)
+static inline uint32_t LatencyDump(EmitLine_t emit) { return 0; }
+
+#endif // LATENCY_ENABLE
+
+#endif // LATENCY_H_
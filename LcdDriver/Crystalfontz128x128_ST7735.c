@@ -41,6 +41,8 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
 #include <stdint.h>
+#include <stdbool.h>
+#include <RamFunc.h>
 
 uint8_t Lcd_Orientation;
 uint16_t Lcd_ScreenWidth, Lcd_ScreenHeigth;
@@ -49,69 +51,149 @@ uint16_t Lcd_TouchTrim;
 
 //*****************************************************************************
 //
-//! Initializes the display driver.
+// The steps of the panel bring-up. Each one ends with a wait, timed with
+// HAL_LCD_startWait, that must be over before the next step. The waits are
+// the ones this driver always had, in microseconds, but for the sleep out:
+// the supplies take 5 ms to settle after it, as in
+// Crystalfontz128x128_WakeStep().
+//
+//*****************************************************************************
+typedef enum
+{
+    LCD_INIT_RESET,
+    LCD_INIT_RESET_RECOVERY,
+    LCD_INIT_SLEEP_OUT,
+    LCD_INIT_COLOR_MODE,
+    LCD_INIT_DONE
+} LcdInitState_t;
+
+static LcdInitState_t lcdInitState = LCD_INIT_DONE;
+
+//*****************************************************************************
+//
+//! Starts the initialization of the display driver.
 //!
-//! This function initializes the ST7735 display controller on the panel,
-//! preparing it to display data.
+//! This function starts the reset of the ST7735 display controller and
+//! returns right away. Crystalfontz128x128_InitStep() carries the
+//! initialization on, so that the caller can do other things during the
+//! waits. Timer32_0 must be running (see HAL_LCD_startWait).
 //!
 //! \return None.
 //
 //*****************************************************************************
-void Crystalfontz128x128_Init(void)
+void Crystalfontz128x128_InitStart(void)
 {
     HAL_LCD_PortInit();
     HAL_LCD_SpiInit();
 
     GPIO_setOutputLowOnPin(LCD_RST_PORT, LCD_RST_PIN);
-    HAL_LCD_delay(50);
-    GPIO_setOutputHighOnPin(LCD_RST_PORT, LCD_RST_PIN);
-    HAL_LCD_delay(120);
+    HAL_LCD_startWait(50);
+    lcdInitState = LCD_INIT_RESET;
+}
 
-    HAL_LCD_writeCommand(CM_SLPOUT);
-    HAL_LCD_delay(200);
+//*****************************************************************************
+//
+//! Carries on the initialization of the display driver.
+//!
+//! If the wait of the current step is over, this function does the next
+//! step. The display is left off, and its memory is not cleared: the first
+//! frame is drawn by the application before Crystalfontz128x128_DisplayOn().
+//!
+//! \return true once the controller accepts drawing commands.
+//
+//*****************************************************************************
+bool Crystalfontz128x128_InitStep(void)
+{
+    if (lcdInitState == LCD_INIT_DONE)
+        return true;
+    if (!HAL_LCD_waitDone())
+        return false;
 
-    HAL_LCD_writeCommand(CM_GAMSET);
-    HAL_LCD_writeData(0x04);
+    switch (lcdInitState)
+    {
+    case LCD_INIT_RESET:
+        GPIO_setOutputHighOnPin(LCD_RST_PORT, LCD_RST_PIN);
+        HAL_LCD_startWait(120);
+        lcdInitState = LCD_INIT_RESET_RECOVERY;
+        break;
 
-    HAL_LCD_writeCommand(CM_SETPWCTR);
-    HAL_LCD_writeData(0x0A);
-    HAL_LCD_writeData(0x14);
+    case LCD_INIT_RESET_RECOVERY:
+        HAL_LCD_writeCommand(CM_SLPOUT);
+        HAL_LCD_startWait(5000);
+        lcdInitState = LCD_INIT_SLEEP_OUT;
+        break;
 
-    HAL_LCD_writeCommand(CM_SETSTBA);
-    HAL_LCD_writeData(0x0A);
-    HAL_LCD_writeData(0x00);
+    case LCD_INIT_SLEEP_OUT:
+        HAL_LCD_writeCommand(CM_GAMSET);
+        HAL_LCD_writeData(0x04);
 
-    HAL_LCD_writeCommand(CM_COLMOD);
-    HAL_LCD_writeData(0x05);
-    HAL_LCD_delay(10);
+        HAL_LCD_writeCommand(CM_SETPWCTR);
+        HAL_LCD_writeData(0x0A);
+        HAL_LCD_writeData(0x14);
 
-    HAL_LCD_writeCommand(CM_MADCTL);
-    HAL_LCD_writeData(CM_MADCTL_BGR);
+        HAL_LCD_writeCommand(CM_SETSTBA);
+        HAL_LCD_writeData(0x0A);
+        HAL_LCD_writeData(0x00);
 
-    HAL_LCD_writeCommand(CM_NORON);
+        HAL_LCD_writeCommand(CM_COLMOD);
+        HAL_LCD_writeData(0x05);
+        HAL_LCD_startWait(10);
+        lcdInitState = LCD_INIT_COLOR_MODE;
+        break;
 
-    Lcd_ScreenWidth  = LCD_VERTICAL_MAX;
-    Lcd_ScreenHeigth = LCD_HORIZONTAL_MAX;
-    Lcd_PenSolid  = 0;
-    Lcd_FontSolid = 1;
-    Lcd_FlagRead  = 0;
-    Lcd_TouchTrim = 0;
+    case LCD_INIT_COLOR_MODE:
+    default:
+        HAL_LCD_writeCommand(CM_MADCTL);
+        HAL_LCD_writeData(CM_MADCTL_BGR);
 
-    Crystalfontz128x128_SetDrawFrame(0, 0, 127, 127);
-    HAL_LCD_writeCommand(CM_RAMWR);
-    int i;
-    for (i = 0; i < 16384; i++)
-    {
-        HAL_LCD_writeData(0xFF);
-        HAL_LCD_writeData(0xFF);
+        HAL_LCD_writeCommand(CM_NORON);
+
+        Lcd_ScreenWidth  = LCD_VERTICAL_MAX;
+        Lcd_ScreenHeigth = LCD_HORIZONTAL_MAX;
+        Lcd_PenSolid  = 0;
+        Lcd_FontSolid = 1;
+        Lcd_FlagRead  = 0;
+        Lcd_TouchTrim = 0;
+        lcdInitState = LCD_INIT_DONE;
+        break;
     }
 
-    HAL_LCD_delay(10);
+    return lcdInitState == LCD_INIT_DONE;
+}
+
+//*****************************************************************************
+//
+//! Turns the display on.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DisplayOn(void)
+{
     HAL_LCD_writeCommand(CM_DISPON);
 }
 
+//*****************************************************************************
+//
+//! Initializes the display driver.
+//!
+//! This function initializes the ST7735 display controller on the panel,
+//! preparing it to display data, and waits until it is done. The display is
+//! turned on with whatever is in its memory.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_Init(void)
+{
+    Crystalfontz128x128_InitStart();
+    while (!Crystalfontz128x128_InitStep())
+        ;
+    Crystalfontz128x128_DisplayOn();
+}
+
 
-void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+RAMFUNC void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
     switch (Lcd_Orientation) {
         case 0:
@@ -192,6 +274,228 @@ void Crystalfontz128x128_SetOrientation(uint8_t orientation)
 }
 
 
+//*****************************************************************************
+//
+// Vertical scrolling. The ST7735 can show the rows of a scroll area starting
+// from any of them, wrapping around at the end of the area: moving the
+// content of the area costs one VSCRSADD command, whatever its size. The
+// rows are those of the frame memory, so these functions work in the
+// orientations in which they are the rows of the screen, LCD_ORIENTATION_UP
+// and LCD_ORIENTATION_DOWN, and do nothing in the others. Drawing is not
+// affected: coordinates still address the frame memory, and a row drawn at
+// y shows wherever the scroll puts it.
+//
+//*****************************************************************************
+static bool Crystalfontz128x128_ScrollRowOffset(uint16_t *offset)
+{
+    switch (Lcd_Orientation) {
+        case LCD_ORIENTATION_UP:
+            *offset = 3;
+            return true;
+        case LCD_ORIENTATION_DOWN:
+            *offset = 1;
+            return true;
+        default:
+            return false;
+    }
+}
+
+//*****************************************************************************
+//
+//! Defines the scroll area.
+//!
+//! \param y0 is the first row of the scroll area.
+//! \param lines is the number of rows in it.
+//!
+//! The rows above and below the area stay where they are. The area starts
+//! scrolled to its first row, so the screen does not change.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetScrollArea(uint16_t y0, uint16_t lines)
+{
+    uint16_t offset, top, bottom;
+
+    if (!Crystalfontz128x128_ScrollRowOffset(&offset))
+    {
+        return;
+    }
+    top = y0 + offset;
+    bottom = LCD_FRAME_MEMORY_ROWS - top - lines;
+
+    HAL_LCD_writeCommand(CM_VSCRDEF);
+    HAL_LCD_writeData((uint8_t)(top >> 8));
+    HAL_LCD_writeData((uint8_t)(top));
+    HAL_LCD_writeData((uint8_t)(lines >> 8));
+    HAL_LCD_writeData((uint8_t)(lines));
+    HAL_LCD_writeData((uint8_t)(bottom >> 8));
+    HAL_LCD_writeData((uint8_t)(bottom));
+
+    Crystalfontz128x128_SetScrollStart(y0);
+}
+
+//*****************************************************************************
+//
+//! Scrolls the scroll area.
+//!
+//! \param y is the row of the scroll area that is shown at its top. The
+//! rows after it follow, then the rows from the top of the area.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetScrollStart(uint16_t y)
+{
+    uint16_t offset;
+
+    if (!Crystalfontz128x128_ScrollRowOffset(&offset))
+    {
+        return;
+    }
+    y += offset;
+
+    HAL_LCD_writeCommand(CM_VSCRSADD);
+    HAL_LCD_writeData((uint8_t)(y >> 8));
+    HAL_LCD_writeData((uint8_t)(y));
+}
+
+//*****************************************************************************
+//
+//! Leaves the scroll mode: every row shows again where it is drawn.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_StopScroll(void)
+{
+    HAL_LCD_writeCommand(CM_NORON);
+}
+
+
+//*****************************************************************************
+//
+// Power modes. Idle mode shows only the 8 colors whose red, green and blue
+// are each fully on or off, partial mode drives only a band of rows and
+// shows the others black, and sleep stops the panel altogether. The frame
+// memory is kept and can still be drawn in every mode, so leaving one shows
+// the screen as it was drawn.
+//
+//*****************************************************************************
+typedef enum
+{
+    LCD_AWAKE,
+    LCD_ASLEEP,
+    LCD_WAKING
+} LcdSleepState_t;
+
+static LcdSleepState_t lcdSleepState = LCD_AWAKE;
+
+//*****************************************************************************
+//
+//! Turns the idle mode (8 colors) on or off.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetIdleMode(bool idle)
+{
+    HAL_LCD_writeCommand(idle ? CM_IDMON : CM_IDMOFF);
+}
+
+//*****************************************************************************
+//
+//! Enters the partial mode: only rows y0 to y1 of the screen are shown.
+//!
+//! The partial mode ends the scroll mode, like Crystalfontz128x128_SetNormalMode
+//! does. It works in the orientations in which the rows of the frame memory
+//! are the rows of the screen, as the scroll does.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetPartialArea(uint16_t y0, uint16_t y1)
+{
+    uint16_t offset;
+
+    if (!Crystalfontz128x128_ScrollRowOffset(&offset))
+    {
+        return;
+    }
+    y0 += offset;
+    y1 += offset;
+
+    HAL_LCD_writeCommand(CM_PTLAR);
+    HAL_LCD_writeData((uint8_t)(y0 >> 8));
+    HAL_LCD_writeData((uint8_t)(y0));
+    HAL_LCD_writeData((uint8_t)(y1 >> 8));
+    HAL_LCD_writeData((uint8_t)(y1));
+    HAL_LCD_writeCommand(CM_PTLON);
+}
+
+//*****************************************************************************
+//
+//! Leaves the partial and the scroll modes: the whole screen is shown.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetNormalMode(void)
+{
+    HAL_LCD_writeCommand(CM_NORON);
+}
+
+//*****************************************************************************
+//
+//! Puts the panel to sleep.
+//!
+//! The panel must have been awake for 120 ms. The screen goes blank until
+//! Crystalfontz128x128_WakeStep() reports that the panel is awake again.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SleepIn(void)
+{
+    HAL_LCD_writeCommand(CM_SLPIN);
+
+    // A sleep out must wait 120 ms after the sleep in
+    HAL_LCD_startWait(120000);
+    lcdSleepState = LCD_ASLEEP;
+}
+
+//*****************************************************************************
+//
+//! Wakes the panel up without waiting.
+//!
+//! Like Crystalfontz128x128_InitStep(), this function does the next step if
+//! the wait of the current one is over: the sleep out command once 120 ms
+//! have passed since the sleep in, then the 5 ms the supplies take to
+//! settle. It must be called until it returns true.
+//!
+//! \return true once the panel shows the frame memory again.
+//
+//*****************************************************************************
+bool Crystalfontz128x128_WakeStep(void)
+{
+    if (lcdSleepState == LCD_AWAKE)
+        return true;
+    if (!HAL_LCD_waitDone())
+        return false;
+
+    if (lcdSleepState == LCD_ASLEEP)
+    {
+        HAL_LCD_writeCommand(CM_SLPOUT);
+        HAL_LCD_startWait(5000);
+        lcdSleepState = LCD_WAKING;
+        return false;
+    }
+
+    lcdSleepState = LCD_AWAKE;
+    return true;
+}
+
+
 //*****************************************************************************
 //
 //! Draws a pixel on the screen.
@@ -225,6 +529,36 @@ static void Crystalfontz128x128_PixelDraw(const Graphics_Display *pDisplay,
 }
 
 
+//*****************************************************************************
+//
+// The expansion of 1 bit per pixel data. Entry n holds the 8 pixels of the
+// data byte n, most significant bit first, as the 16 bytes that are sent to
+// the display. The table is built for the two colors of the palette it was
+// last used with, and rebuilt when PixelDrawMultiple gets another palette.
+//
+//*****************************************************************************
+static uint8_t Expansion1BPP[256][16];
+static uint32_t Expansion1BPPPalette[2];
+static bool Expansion1BPPValid = false;
+
+static void Crystalfontz128x128_BuildExpansion1BPP(const uint32_t *pucPalette)
+{
+    uint16_t ulByte, ulBit;
+
+    for(ulByte = 0; ulByte < 256; ulByte++)
+    {
+        for(ulBit = 0; ulBit < 8; ulBit++)
+        {
+            uint32_t ulColor = pucPalette[(ulByte >> (7 - ulBit)) & 1];
+            Expansion1BPP[ulByte][2 * ulBit] = ulColor >> 8;
+            Expansion1BPP[ulByte][2 * ulBit + 1] = ulColor;
+        }
+    }
+    Expansion1BPPPalette[0] = pucPalette[0];
+    Expansion1BPPPalette[1] = pucPalette[1];
+    Expansion1BPPValid = true;
+}
+
 //*****************************************************************************
 //
 //! Draws a horizontal sequence of pixels on the screen.
@@ -250,7 +584,7 @@ static void Crystalfontz128x128_PixelDraw(const Graphics_Display *pDisplay,
 //! \return None.
 //
 //*****************************************************************************
-static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDisplay,
+RAMFUNC static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDisplay,
                                                   int16_t lX,
                                                   int16_t lY,
                                                   int16_t lX0,
@@ -276,25 +610,38 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
         // The pixel data is in 1 bit per pixel format
         case 1:
         {
-            // Loop while there are more pixels to draw
-            while(lCount > 0)
+            uint16_t lPixels;
+
+            // Expand through the table of the two colors of the palette
+            if(!Expansion1BPPValid ||
+               (pucPalette[0] != Expansion1BPPPalette[0]) ||
+               (pucPalette[1] != Expansion1BPPPalette[1]))
             {
-                // Get the next byte of image data
-                Data = *pucData++;
+                Crystalfontz128x128_BuildExpansion1BPP(pucPalette);
+            }
 
-                // Loop through the pixels in this byte of image data
-                for(; (lX0 < 8) && lCount; lX0++, lCount--)
-                {
-                    // Draw this pixel in the appropriate color
-                    HAL_LCD_writeData((((uint32_t *)pucPalette)[(Data >>
-                                                             (7 - lX0)) & 1])>>8);
-                    HAL_LCD_writeData(((uint32_t *)pucPalette)[(Data >>
-                                                             (7 - lX0)) & 1]);
-                }
-
-                // Start at the beginning of the next byte of image data
-                lX0 = 0;
+            // Draw the pixels of a first byte that start at lX0
+            if(lX0)
+            {
+                lPixels = (lCount < 8 - lX0) ? lCount : 8 - lX0;
+                HAL_LCD_writeDataBurst(&Expansion1BPP[*pucData++][2 * lX0],
+                                       2 * lPixels);
+                lCount -= lPixels;
+            }
+
+            // Draw the whole bytes, 8 pixels in one burst of 16 bytes
+            while(lCount >= 8)
+            {
+                HAL_LCD_writeDataBurst(Expansion1BPP[*pucData++], 16);
+                lCount -= 8;
+            }
+
+            // Draw the first pixels of a last byte
+            if(lCount > 0)
+            {
+                HAL_LCD_writeDataBurst(Expansion1BPP[*pucData], 2 * lCount);
             }
+
             // The image data has been drawn
 
             break;
@@ -413,7 +760,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
 //! \return None.
 //
 //*****************************************************************************
-static void Crystalfontz128x128_LineDrawH(const Graphics_Display *pDisplay,
+RAMFUNC static void Crystalfontz128x128_LineDrawH(const Graphics_Display *pDisplay,
                                           int16_t lX1,
                                           int16_t lX2,
                                           int16_t lY,
@@ -453,7 +800,7 @@ static void Crystalfontz128x128_LineDrawH(const Graphics_Display *pDisplay,
 //! \return None.
 //
 //*****************************************************************************
-static void Crystalfontz128x128_LineDrawV(const Graphics_Display *pDisplay,
+RAMFUNC static void Crystalfontz128x128_LineDrawV(const Graphics_Display *pDisplay,
                                           int16_t lX,
                                           int16_t lY1,
                                           int16_t lY2,
@@ -491,7 +838,7 @@ static void Crystalfontz128x128_LineDrawV(const Graphics_Display *pDisplay,
 //! \return None.
 //
 //*****************************************************************************
-static void Crystalfontz128x128_RectFill(const Graphics_Display *pDisplay,
+RAMFUNC static void Crystalfontz128x128_RectFill(const Graphics_Display *pDisplay,
                                          const Graphics_Rectangle *pRect,
                                          uint16_t ulValue)
 {
@@ -515,6 +862,302 @@ static void Crystalfontz128x128_RectFill(const Graphics_Display *pDisplay,
     }
 }
 
+//*****************************************************************************
+//
+// Shape primitives. grlib draws diagonal lines and circle outlines one
+// PixelDraw at a time, and every pixel then costs a whole draw frame: 13
+// bytes on the SPI for 2 bytes of color. These functions walk the shape
+// first and send each run of pixels on one row or one column as a single
+// LineDrawH or LineDrawV span, 11 bytes plus 2 per pixel. Coordinates may be
+// off the screen: spans are clipped here, since grlib does not see them.
+// Colors are display colors, from Crystalfontz128x128_ColorTranslate.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_SpanH(int16_t lX1, int16_t lX2, int16_t lY,
+                                      uint16_t ulValue)
+{
+    if((lY < 0) || (lY >= LCD_VERTICAL_MAX))
+    {
+        return;
+    }
+    if(lX1 < 0)
+    {
+        lX1 = 0;
+    }
+    if(lX2 >= LCD_HORIZONTAL_MAX)
+    {
+        lX2 = LCD_HORIZONTAL_MAX - 1;
+    }
+    if(lX1 <= lX2)
+    {
+        Crystalfontz128x128_LineDrawH(&g_sCrystalfontz128x128, lX1, lX2, lY,
+                                      ulValue);
+    }
+}
+
+static void Crystalfontz128x128_SpanV(int16_t lX, int16_t lY1, int16_t lY2,
+                                      uint16_t ulValue)
+{
+    if((lX < 0) || (lX >= LCD_HORIZONTAL_MAX))
+    {
+        return;
+    }
+    if(lY1 < 0)
+    {
+        lY1 = 0;
+    }
+    if(lY2 >= LCD_VERTICAL_MAX)
+    {
+        lY2 = LCD_VERTICAL_MAX - 1;
+    }
+    if(lY1 <= lY2)
+    {
+        Crystalfontz128x128_LineDrawV(&g_sCrystalfontz128x128, lX, lY1, lY2,
+                                      ulValue);
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a line with Bresenham's algorithm.
+//!
+//! A line that is closer to horizontal has one run of pixels per row, and
+//! one that is closer to vertical one run per column: each run is sent as a
+//! single span.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawLine(int16_t lX1, int16_t lY1, int16_t lX2,
+                                  int16_t lY2, uint16_t ulValue)
+{
+    int16_t lDX = (lX2 > lX1) ? lX2 - lX1 : lX1 - lX2;
+    int16_t lDY = (lY2 > lY1) ? lY2 - lY1 : lY1 - lY2;
+    int16_t lError, lRunStart, lStep, i;
+    bool bSteep = (lDY > lDX);
+
+    //
+    // Walk along the major axis in increasing order.
+    //
+    if(bSteep ? (lY1 > lY2) : (lX1 > lX2))
+    {
+        int16_t lT;
+        lT = lX1; lX1 = lX2; lX2 = lT;
+        lT = lY1; lY1 = lY2; lY2 = lT;
+    }
+
+    if(!bSteep)
+    {
+        lStep = (lY2 > lY1) ? 1 : -1;
+        lError = lDX / 2;
+        lRunStart = lX1;
+        for(i = lX1; i <= lX2; i++)
+        {
+            lError -= lDY;
+            if((lError < 0) || (i == lX2))
+            {
+                Crystalfontz128x128_SpanH(lRunStart, i, lY1, ulValue);
+                lRunStart = i + 1;
+                lY1 += lStep;
+                lError += lDX;
+            }
+        }
+    }
+    else
+    {
+        lStep = (lX2 > lX1) ? 1 : -1;
+        lError = lDY / 2;
+        lRunStart = lY1;
+        for(i = lY1; i <= lY2; i++)
+        {
+            lError -= lDX;
+            if((lError < 0) || (i == lY2))
+            {
+                Crystalfontz128x128_SpanV(lX1, lRunStart, i, ulValue);
+                lRunStart = i + 1;
+                lX1 += lStep;
+                lError += lDY;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws the outline of a circle with the midpoint algorithm.
+//!
+//! The octant from the top of the circle has runs of pixels on one row, which
+//! are mirrored into the other three octants that touch the top and bottom;
+//! the same runs turned into columns make the four octants on the sides.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawCircle(int16_t lX, int16_t lY, int16_t lRadius,
+                                    uint16_t ulValue)
+{
+    int16_t x = 0, y = lRadius, lD = 1 - lRadius, lRunStart = 0, lNextY;
+    int16_t lInner;
+
+    while(x <= y)
+    {
+        lNextY = y;
+        if(lD < 0)
+        {
+            lD += 2 * x + 3;
+        }
+        else
+        {
+            lD += 2 * (x - y) + 5;
+            lNextY--;
+        }
+
+        //
+        // The run ends where y changes or the octant does. The center pixels
+        // of the first run are drawn by the right and bottom spans only.
+        //
+        if((lNextY != y) || (x + 1 > lNextY))
+        {
+            lInner = lRunStart ? lRunStart : 1;
+            Crystalfontz128x128_SpanH(lX + lRunStart, lX + x, lY - y, ulValue);
+            Crystalfontz128x128_SpanH(lX - x, lX - lInner, lY - y, ulValue);
+            Crystalfontz128x128_SpanH(lX + lRunStart, lX + x, lY + y, ulValue);
+            Crystalfontz128x128_SpanH(lX - x, lX - lInner, lY + y, ulValue);
+            Crystalfontz128x128_SpanV(lX - y, lY + lRunStart, lY + x, ulValue);
+            Crystalfontz128x128_SpanV(lX - y, lY - x, lY - lInner, ulValue);
+            Crystalfontz128x128_SpanV(lX + y, lY + lRunStart, lY + x, ulValue);
+            Crystalfontz128x128_SpanV(lX + y, lY - x, lY - lInner, ulValue);
+            lRunStart = x + 1;
+        }
+        x++;
+        y = lNextY;
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a circle, one span per row.
+//!
+//! The rows run between the pixels of the outline that
+//! Crystalfontz128x128_DrawCircle() draws, as grlib fills a circle: the
+//! steps of the midpoint algorithm give the rows next to the center and,
+//! each time the outline moves in, the row at the top and the bottom.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_FillCircle(int16_t lX, int16_t lY, int16_t lRadius,
+                                    uint16_t ulValue)
+{
+    int16_t lA = 0, lB = lRadius, lD = 3 - 2 * lRadius;
+
+    while(lA <= lB)
+    {
+        Crystalfontz128x128_SpanH(lX - lB, lX + lB, lY + lA, ulValue);
+        if(lA)
+        {
+            Crystalfontz128x128_SpanH(lX - lB, lX + lB, lY - lA, ulValue);
+        }
+        if((lD >= 0) && (lA != lB))
+        {
+            Crystalfontz128x128_SpanH(lX - lA, lX + lA, lY + lB, ulValue);
+            Crystalfontz128x128_SpanH(lX - lA, lX + lA, lY - lB, ulValue);
+        }
+
+        if(lD < 0)
+        {
+            lD += 4 * lA + 6;
+        }
+        else
+        {
+            lD += 4 * (lA - lB) + 10;
+            lB--;
+        }
+        lA++;
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a triangle, one span per row between its two edges.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_FillTriangle(int16_t lX1, int16_t lY1, int16_t lX2,
+                                      int16_t lY2, int16_t lX3, int16_t lY3,
+                                      uint16_t ulValue)
+{
+    int16_t lT, y, lA, lB;
+    int32_t lLong, lShort;
+
+    //
+    // Sort the corners from top to bottom.
+    //
+    if(lY1 > lY2)
+    {
+        lT = lX1; lX1 = lX2; lX2 = lT;
+        lT = lY1; lY1 = lY2; lY2 = lT;
+    }
+    if(lY2 > lY3)
+    {
+        lT = lX2; lX2 = lX3; lX3 = lT;
+        lT = lY2; lY2 = lY3; lY3 = lT;
+    }
+    if(lY1 > lY2)
+    {
+        lT = lX1; lX1 = lX2; lX2 = lT;
+        lT = lY1; lY1 = lY2; lY2 = lT;
+    }
+
+    if(lY1 == lY3)
+    {
+        lA = lX1;
+        lB = lX1;
+        if(lX2 < lA) lA = lX2;
+        if(lX2 > lB) lB = lX2;
+        if(lX3 < lA) lA = lX3;
+        if(lX3 > lB) lB = lX3;
+        Crystalfontz128x128_SpanH(lA, lB, lY1, ulValue);
+        return;
+    }
+
+    //
+    // Every row crosses the long edge from corner 1 to corner 3, and one of
+    // the two short edges. The x of each edge is interpolated with rounding.
+    //
+    for(y = lY1; y <= lY3; y++)
+    {
+        lLong = (int32_t)(lX3 - lX1) * (y - lY1);
+        lA = lX1 + (lLong + ((lLong < 0) ? -(lY3 - lY1) : (lY3 - lY1)) / 2) /
+             (lY3 - lY1);
+        if((y < lY2) || (lY2 == lY3))
+        {
+            if(lY2 == lY1)
+            {
+                lB = lX2;
+            }
+            else
+            {
+                lShort = (int32_t)(lX2 - lX1) * (y - lY1);
+                lB = lX1 + (lShort + ((lShort < 0) ? -(lY2 - lY1) :
+                                      (lY2 - lY1)) / 2) / (lY2 - lY1);
+            }
+        }
+        else
+        {
+            lShort = (int32_t)(lX3 - lX2) * (y - lY2);
+            lB = lX2 + (lShort + ((lShort < 0) ? -(lY3 - lY2) :
+                                  (lY3 - lY2)) / 2) / (lY3 - lY2);
+        }
+        if(lA > lB)
+        {
+            lT = lA; lA = lB; lB = lT;
+        }
+        Crystalfontz128x128_SpanH(lA, lB, y, ulValue);
+    }
+}
+
 //*****************************************************************************
 //
 //! Translates a 24-bit RGB color to a display driver-specific color.
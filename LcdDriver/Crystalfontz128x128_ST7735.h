@@ -73,6 +73,10 @@
 #define CM_RGBSET          0x2d
 #define CM_RAMRD           0x2E
 #define CM_PTLAR           0x30
+#define CM_VSCRDEF         0x33
+#define CM_VSCRSADD        0x37
+#define CM_IDMOFF          0x38
+#define CM_IDMON           0x39
 #define CM_MADCTL          0x36
 #define CM_COLMOD          0x3A
 #define CM_SETPWCTR        0xB1
@@ -92,6 +96,9 @@
 #define CM_MADCTL_BGR      0x08
 #define CM_MADCTL_MH       0x04
 
+// Rows of the ST7735 frame memory, of which the panel shows LCD_VERTICAL_MAX
+#define LCD_FRAME_MEMORY_ROWS              162
+
 extern uint8_t Lcd_Orientation;
 extern uint16_t Lcd_ScreenWidth, Lcd_ScreenHeigth;
 extern uint8_t Lcd_PenSolid, Lcd_FontSolid, Lcd_FlagRead;
@@ -103,10 +110,41 @@ extern const Graphics_Display_Functions g_sCrystalfontz128x128_funcs;
 
 extern void Crystalfontz128x128_Init(void);
 
+extern void Crystalfontz128x128_InitStart(void);
+
+extern bool Crystalfontz128x128_InitStep(void);
+
+extern void Crystalfontz128x128_DisplayOn(void);
+
 extern void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
 extern void Crystalfontz128x128_SetOrientation(uint8_t orientation);
 
+extern void Crystalfontz128x128_SetScrollArea(uint16_t y0, uint16_t lines);
+
+extern void Crystalfontz128x128_SetScrollStart(uint16_t y);
+
+extern void Crystalfontz128x128_StopScroll(void);
+
+extern void Crystalfontz128x128_SetIdleMode(bool idle);
+
+extern void Crystalfontz128x128_SetPartialArea(uint16_t y0, uint16_t y1);
+
+extern void Crystalfontz128x128_SetNormalMode(void);
+
+extern void Crystalfontz128x128_SleepIn(void);
+
+extern bool Crystalfontz128x128_WakeStep(void);
+
+extern void Crystalfontz128x128_DrawLine(int16_t lX1, int16_t lY1, int16_t lX2, int16_t lY2, uint16_t ulValue);
+
+extern void Crystalfontz128x128_DrawCircle(int16_t lX, int16_t lY, int16_t lRadius, uint16_t ulValue);
+
+extern void Crystalfontz128x128_FillCircle(int16_t lX, int16_t lY, int16_t lRadius, uint16_t ulValue);
+
+extern void Crystalfontz128x128_FillTriangle(int16_t lX1, int16_t lY1, int16_t lX2, int16_t lY2, int16_t lX3,
+                                             int16_t lY3, uint16_t ulValue);
+
 
 
 #endif /* __CRYSTALFONTZLCD_H__ */
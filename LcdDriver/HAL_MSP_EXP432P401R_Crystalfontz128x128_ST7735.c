@@ -41,6 +41,8 @@
 #include <ti/grlib/grlib.h>
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include <stdint.h>
+#include <RamFunc.h>
+#include <Timer_HAL.h>
 
 void HAL_LCD_PortInit(void)
 {
@@ -61,7 +63,7 @@ void HAL_LCD_SpiInit(void)
     eUSCI_SPI_MasterConfig config =
         {
             EUSCI_B_SPI_CLOCKSOURCE_SMCLK,
-            LCD_SYSTEM_CLOCK_SPEED,
+            CS_getSMCLK(),
             LCD_SPI_CLOCK_SPEED,
             EUSCI_B_SPI_MSB_FIRST,
             EUSCI_B_SPI_PHASE_DATA_CAPTURED_ONFIRST_CHANGED_ON_NEXT,
@@ -76,6 +78,28 @@ void HAL_LCD_SpiInit(void)
     GPIO_setOutputHighOnPin(LCD_DC_PORT, LCD_DC_PIN);
 }
 
+//*****************************************************************************
+//
+// Recomputes the SPI divider after the clock governor changed SMCLK (see
+// Clock_HAL.h). Every write waits for the SPI to be idle before it returns,
+// so no byte is on the wire when this is called between tasks.
+//
+//*****************************************************************************
+void HAL_LCD_SpiClockChanged(uint32_t clockSourceFrequency)
+{
+    while (UCB0STATW & UCBUSY);
+
+    SPI_changeMasterClock(LCD_EUSCI_BASE, clockSourceFrequency, LCD_SPI_CLOCK_SPEED);
+}
+
+
+//*****************************************************************************
+//
+// The number of bytes sent to the display, commands and data, so that drawing
+// code can be measured in SPI traffic (see Benchmark.c).
+//
+//*****************************************************************************
+uint32_t HAL_LCD_byteCount;
 
 //*****************************************************************************
 //
@@ -83,7 +107,7 @@ void HAL_LCD_SpiInit(void)
 // interface to the LCD display.
 //
 //*****************************************************************************
-void HAL_LCD_writeCommand(uint8_t command)
+RAMFUNC void HAL_LCD_writeCommand(uint8_t command)
 {
     // Set to command mode
     GPIO_setOutputLowOnPin(LCD_DC_PORT, LCD_DC_PIN);
@@ -93,6 +117,7 @@ void HAL_LCD_writeCommand(uint8_t command)
 
     // Transmit data
     UCB0TXBUF = command;
+    HAL_LCD_byteCount++;
 
     // USCI_B0 Busy? //
     while (UCB0STATW & UCBUSY);
@@ -108,18 +133,64 @@ void HAL_LCD_writeCommand(uint8_t command)
 // interface to the LCD display.
 //
 //*****************************************************************************
-void HAL_LCD_writeData(uint8_t data)
+RAMFUNC void HAL_LCD_writeData(uint8_t data)
 {
     // USCI_B0 Busy? //
     while (UCB0STATW & UCBUSY);
 
     // Transmit data
     UCB0TXBUF = data;
+    HAL_LCD_byteCount++;
 
     // USCI_B0 Busy? //
     while (UCB0STATW & UCBUSY);
 }
 
+//*****************************************************************************
+//
+// Writes count data bytes back to back. The next byte is loaded as soon as the
+// transmit buffer is free, while the previous one is still shifting out, so
+// the SPI clock does not stop between the bytes of a burst.
+//
+//*****************************************************************************
+RAMFUNC void HAL_LCD_writeDataBurst(const uint8_t *data, uint16_t count)
+{
+    // USCI_B0 Busy? //
+    while (UCB0STATW & UCBUSY);
+
+    HAL_LCD_byteCount += count;
+    while (count--)
+    {
+        // Transmit buffer free? //
+        while (!(UCB0IFG & UCTXIFG));
+
+        UCB0TXBUF = *data++;
+    }
+
+    // USCI_B0 Busy? //
+    while (UCB0STATW & UCBUSY);
+}
+
+//*****************************************************************************
+//
+// Non-blocking waits for the panel bring-up in Crystalfontz128x128_InitStep.
+// They are timed with the free running Timer32_0 (see GetTimerValue in
+// Timer_HAL.h), which keeps its rate whatever the clock governor does.
+//
+//*****************************************************************************
+static uint32_t waitStart, waitMicroseconds;
+
+void HAL_LCD_startWait(uint32_t microseconds)
+{
+    waitStart = GetTimerValue(TIMER32_0_BASE);
+    waitMicroseconds = microseconds;
+}
+
+bool HAL_LCD_waitDone(void)
+{
+    return CyclesToMicroseconds(waitStart - GetTimerValue(TIMER32_0_BASE)) >= waitMicroseconds;
+}
+
 //*****************************************************************************
 //
 //! Provides a small delay.
@@ -154,7 +225,7 @@ SysCtlDelay(uint32_t ui32Count)
           "    bx      lr");
 }
 #endif
-#if defined(codered) || defined( __GNUC__ ) || defined(sourcerygxx)
+#if defined(codered) || (defined( __GNUC__ ) && defined(__arm__)) || defined(sourcerygxx)
 void __attribute__((naked))
 SysCtlDelay(uint32_t ui32Count)
 {
@@ -49,9 +49,8 @@
 //
 //*****************************************************************************
 
-// System clock speed (in Hz)
-#define LCD_SYSTEM_CLOCK_SPEED                 48000000
-// SPI clock speed (in Hz)
+// SPI clock speed (in Hz). The divider is computed from SMCLK as it is, so the
+// SPI runs at SMCLK when SMCLK is slower (see HAL_LCD_SpiClockChanged).
 #define LCD_SPI_CLOCK_SPEED                    16000000
 
 // Ports from MSP432 connected to LCD
@@ -78,10 +77,15 @@
 // Prototypes for the globals exported by this driver.
 //
 //*****************************************************************************
+extern uint32_t HAL_LCD_byteCount;
 extern void HAL_LCD_writeCommand(uint8_t command);
 extern void HAL_LCD_writeData(uint8_t data);
+extern void HAL_LCD_writeDataBurst(const uint8_t *data, uint16_t count);
 extern void HAL_LCD_PortInit(void);
 extern void HAL_LCD_SpiInit(void);
+extern void HAL_LCD_SpiClockChanged(uint32_t clockSourceFrequency);
+extern void HAL_LCD_startWait(uint32_t microseconds);
+extern bool HAL_LCD_waitDone(void);
 
 // Custom __delay_cycles() for non CCS Compiler
 #if !defined( __TI_ARM__ )
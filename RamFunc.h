@@ -0,0 +1,34 @@
+//------------------------------------------
+// RAMFUNC
+// At 48 MHz the flash needs wait states, so a tight loop runs faster from SRAM. A function marked RAMFUNC is
+// placed in the .TI.ramfunc section. msp432p401r.cmd loads that section in flash and runs it from the
+// SRAM_CODE alias at 0x01000000, and the C startup code (_c_int00) copies it there through the BINIT table
+// before main() is called. Nothing has to be done at run time.
+// SRAM is also where the stack and the data live, so only the hot paths are marked: see Benchmark.h for
+// how much each of them gains.
+// Build with RAMFUNC_ENABLE=0 and every function stays in flash, to measure the difference for each primitive;
+// the benchmark also times one loop from both places in the same build.
+
+#ifndef RAMFUNC_H_
+#define RAMFUNC_H_
+
+#include <stdint.h>
+
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE 1
+#endif
+
+#if RAMFUNC_ENABLE && defined(__TI_ARM__)
+#define RAMFUNC __attribute__((ramfunc))
+#else
+#define RAMFUNC
+#endif
+
+// The SRAM_CODE alias of the 64 KB SRAM. A function whose address is in this range runs from SRAM.
+#define SRAM_CODE_START 0x01000000
+#define SRAM_CODE_END   0x01010000
+
+#define RUNS_FROM_SRAM(function) \
+    ((uintptr_t) (function) >= SRAM_CODE_START && (uintptr_t) (function) < SRAM_CODE_END)
+
+#endif /* RAMFUNC_H_ */
@@ -0,0 +1,133 @@
+//------------------------------------------
+// RAM USAGE API (Application Programming Interface)
+// The linker gives a size as the address of a symbol. The stack grows down from __STACK_END, so the high-water
+// mark is the distance from there to the lowest word that is no longer painted.
+
+#include <Format.h>
+#include <RamUsage.h>
+
+#if RAM_LINKER_SYMBOLS
+
+// See msp432p401r.cmd. .TI.ramfunc only exists with the versions of the TI compiler that RamFunc.h uses.
+extern uint8_t ramVtableSize, ramDataSize, ramBssSize, ramNoinitSize, ramHeapSize;
+#if defined(__TI_COMPILER_VERSION__) && __TI_COMPILER_VERSION__ >= 15009000
+extern uint8_t ramFuncSize;
+#define RAMFUNC_SIZE ((uint32_t) &ramFuncSize)
+#else
+#define RAMFUNC_SIZE 0
+#endif
+
+extern uint32_t __stack, __STACK_END;
+
+#define STACK_BOTTOM ((uint32_t *) &__stack)
+#define STACK_TOP    ((uint32_t *) &__STACK_END)
+
+typedef struct {
+    const char *name;
+    uint32_t    bytes;
+} RamSection_t;
+
+uint32_t StackHighWater()
+{
+    const uint32_t *word = STACK_BOTTOM;
+
+    while (word < STACK_TOP && *word == STACK_PAINT)
+        word++;
+    return (STACK_TOP - word) * sizeof(uint32_t);
+}
+
+// An ISR that comes in the middle only uses the stack below this frame until it returns, so the painting does
+// not need interrupts disabled
+void StackMark()
+{
+    volatile uint32_t frame;
+    uint32_t *word;
+
+    for (word = STACK_BOTTOM; word < (uint32_t *) &frame - 8; word++)
+        *word = STACK_PAINT;
+}
+
+#else
+
+uint32_t StackHighWater()
+{
+    return 0;
+}
+
+void StackMark()
+{
+}
+
+#endif // RAM_LINKER_SYMBOLS
+
+// The lines are:
+//   Stack used/size     the high-water mark of the stack and its size, in bytes
+//   SRAM used/65536     the sections and the stack
+//    section bytes      for each section that is not empty
+//   RAM map n           the modules of the linker map
+//    host estimate      if the table was made from a host build, and then the largest first:
+//    module bytes
+uint32_t RamUsageDump(EmitLine_t emit) {
+    char line[20];
+    uint32_t n = 0;
+    unsigned i, k;
+
+#if RAM_LINKER_SYMBOLS
+    uint32_t stackSize = (STACK_TOP - STACK_BOTTOM) * sizeof(uint32_t);
+    const RamSection_t sections[] = {
+        {".vtable",  (uint32_t) &ramVtableSize},
+        {".data",    (uint32_t) &ramDataSize},
+        {".bss",     (uint32_t) &ramBssSize},
+        {".noinit",  (uint32_t) &ramNoinitSize},
+        {".sysmem",  (uint32_t) &ramHeapSize},
+        {"ramfunc",  RAMFUNC_SIZE},
+    };
+    uint32_t used = stackSize;
+
+    for (k = 0; k < sizeof(sections) / sizeof(sections[0]); k++)
+        used += sections[k].bytes;
+
+    i = AppendString(line, 0, "Stack ");
+    i = AppendNumber(line, i, StackHighWater());
+    i = AppendString(line, i, "/");
+    AppendNumber(line, i, stackSize);
+    emit(line, n++);
+
+    i = AppendString(line, 0, "SRAM ");
+    i = AppendNumber(line, i, used);
+    i = AppendString(line, i, "/");
+    AppendNumber(line, i, SRAM_SIZE);
+    emit(line, n++);
+
+    for (k = 0; k < sizeof(sections) / sizeof(sections[0]); k++)
+    {
+        if (sections[k].bytes == 0)
+            continue;
+        i = AppendString(line, 0, " ");
+        i = AppendStringMax(line, i, sections[k].name, 16);
+        i = AppendString(line, i, " ");
+        AppendNumber(line, i, sections[k].bytes);
+        emit(line, n++);
+    }
+#endif
+
+    i = AppendString(line, 0, "RAM map ");
+    AppendNumber(line, i, RamModuleCount);
+    emit(line, n++);
+    if (RamModulesEstimated)
+    {
+        AppendString(line, 0, " host estimate");
+        emit(line, n++);
+    }
+
+    for (k = 0; k < RamModuleCount; k++)
+    {
+        i = AppendString(line, 0, " ");
+        i = AppendStringMax(line, i, RamModules[k].name, 9);
+        i = AppendString(line, i, " ");
+        AppendNumber(line, i, RamModules[k].bytes);
+        emit(line, n++);
+    }
+
+    return n;
+}
@@ -0,0 +1,64 @@
+//------------------------------------------
+// RAM USAGE API (Application Programming Interface)
+// This module shows where the 64 KB of SRAM go, so that buffers and caches can be sized with a known margin.
+//   - The stack is painted with STACK_PAINT by Reset_Handler (ccs/startup_msp432p401r_ccs.c) before anything
+//     runs on it. The words the stack ever reached are no longer painted, so its high-water mark is found by
+//     scanning up from the bottom for the first word that changed. StackMark paints again what is free at the time,
+//     to measure how deep one call goes, such as PrintString in the benchmark.
+//   - The size of each SRAM section comes from symbols that msp432p401r.cmd defines, so it is always that of the
+//     running build. The functions of .TI.ramfunc count too: they run from the same SRAM through its code alias.
+//   - The RAM of each module comes from the module summary of the linker map, turned into assets/RamMap.c by
+//     host/rammap with make -C host rammap MAP=<the .map>, after which the project is built again. This is done
+//     by hand, on a machine with make and a C compiler for the host. Without a CCS build, make -C host rammap-host
+//     makes the table from a 32-bit build of the application on the host instead, which is the one checked in:
+//     the diagnostics screen marks it as a host estimate until it is regenerated from the map of a CCS build.
+// The host build has none of the target's sections and runs on the host's stack: RAM_LINKER_SYMBOLS is 0 there
+// and only the module table is shown.
+
+#ifndef RAMUSAGE_H_
+#define RAMUSAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+#ifndef RAM_LINKER_SYMBOLS
+#define RAM_LINKER_SYMBOLS 1
+#endif
+
+#define STACK_PAINT 0xDEADBEEF
+
+#define SRAM_SIZE 0x10000
+
+// A module of the linker map and the bytes of SRAM its data takes, .data and .bss
+typedef struct {
+    const char *name;
+    uint32_t    bytes;
+} RamModule_t;
+
+// The modules, the largest first (assets/RamMap.c). RamModulesEstimated is true if the table was made from a host
+// build, which has neither the BSP, driverlib and the run-time library nor the stack and the heap, and lays the
+// data of the other modules out for the host.
+extern const RamModule_t RamModules[];
+extern const unsigned RamModuleCount;
+extern const bool RamModulesEstimated;
+
+/*
+ * This function returns the number of bytes of stack ever used since the reset or the last StackMark, 0 on the
+ * host
+ */
+uint32_t StackHighWater();
+
+/*
+ * This function paints the free part of the stack again, below the caller, so that the next StackHighWater
+ * returns how deep the stack has been since. It must be called from a function that stays on the stack until
+ * then.
+ */
+void StackMark();
+
+/*
+ * This function formats the stack, the sections and the modules (see EmitLine_t)
+ */
+uint32_t RamUsageDump(EmitLine_t emit);
+
+#endif /* RAMUSAGE_H_ */
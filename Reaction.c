@@ -0,0 +1,287 @@
+//------------------------------------------
+// REACTION API (Application Programming Interface)
+// All the arithmetic is on integers: the parabola of P2 is computed over a common denominator in 64 bits, which
+// holds its products for heights of up to a turn of Timer32_0 and REACTION_MAX_SAMPLES positions.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Timer_HAL.h>
+#include <Buttons_HAL.h>
+#include <Format.h>
+#include <Reaction.h>
+
+#define MARKERS 5
+#define Q16_ONE 65536
+
+// p50 and p95 in 1/65536
+#define P50_Q16 32768
+#define P95_Q16 62259
+
+typedef struct {
+    int32_t height[MARKERS];        // us
+    int32_t position[MARKERS];      // from 1
+    int32_t desired[MARKERS];       // in 1/65536
+    int32_t increment[MARKERS];     // in 1/65536
+} Quantile_t;
+
+typedef struct {
+    uint32_t samples;
+    int32_t meanQ4;                 // in 1/16 us
+    uint32_t lastUS;
+    int32_t first[REACTION_EXACT];  // the first samples, sorted
+    Quantile_t p50, p95;
+} Player_t;
+
+static Player_t players[REACTION_PLAYERS];
+
+static struct {
+    unsigned player;
+    bool measuring;                 // from the light-up to the first validated press
+    bool measured;
+    uint32_t lightUp;
+    uint32_t us;
+} measure;
+
+// The markers start at the order statistics of the first samples that are nearest to their desired positions,
+// one sample apart at least
+static void QuantileStart(Quantile_t *Q, int32_t p, const int32_t *first)
+{
+    int i;
+
+    Q->increment[0] = 0;
+    Q->increment[1] = p / 2;
+    Q->increment[2] = p;
+    Q->increment[3] = (Q16_ONE + p) / 2;
+    Q->increment[4] = Q16_ONE;
+
+    for (i = 0; i < MARKERS; i++)
+    {
+        Q->desired[i] = Q16_ONE + (REACTION_EXACT - 1) * Q->increment[i];
+        Q->position[i] = (Q->desired[i] + Q16_ONE / 2) / Q16_ONE;
+    }
+    for (i = 1; i < MARKERS; i++)
+        if (Q->position[i] <= Q->position[i - 1])
+            Q->position[i] = Q->position[i - 1] + 1;
+    for (i = MARKERS - 2; i >= 0; i--)
+        if (Q->position[i] >= Q->position[i + 1])
+            Q->position[i] = Q->position[i + 1] - 1;
+    for (i = 0; i < MARKERS; i++)
+        Q->height[i] = first[Q->position[i] - 1];
+}
+
+// The height marker i gets when it moves by step, which is 1 or -1, along the parabola through it and its
+// neighbours
+static int32_t Parabolic(const Quantile_t *Q, unsigned i, int32_t step)
+{
+    const int32_t *n = Q->position, *q = Q->height;
+    int64_t numerator, denominator;
+
+    numerator = (int64_t) (n[i] - n[i - 1] + step) * (q[i + 1] - q[i]) * (n[i] - n[i - 1]) +
+                (int64_t) (n[i + 1] - n[i] - step) * (q[i] - q[i - 1]) * (n[i + 1] - n[i]);
+    denominator = (int64_t) (n[i + 1] - n[i - 1]) * (n[i + 1] - n[i]) * (n[i] - n[i - 1]);
+    return q[i] + (int32_t) (step * numerator / denominator);
+}
+
+static int32_t Linear(const Quantile_t *Q, unsigned i, int32_t step)
+{
+    return Q->height[i] + step * (Q->height[i + step] - Q->height[i]) / (Q->position[i + step] - Q->position[i]);
+}
+
+static void QuantileAdd(Quantile_t *Q, int32_t x)
+{
+    unsigned i, cell;
+    int32_t drift, step, height;
+
+    // The cell of x, between the markers cell and cell + 1. The extreme markers follow the minimum and maximum.
+    if (x < Q->height[0])
+    {
+        Q->height[0] = x;
+        cell = 0;
+    }
+    else if (x >= Q->height[MARKERS - 1])
+    {
+        Q->height[MARKERS - 1] = x;
+        cell = MARKERS - 2;
+    }
+    else
+        for (cell = 0; x >= Q->height[cell + 1]; cell++)
+            ;
+
+    for (i = cell + 1; i < MARKERS; i++)
+        Q->position[i]++;
+    for (i = 0; i < MARKERS; i++)
+        Q->desired[i] += Q->increment[i];
+
+    for (i = 1; i < MARKERS - 1; i++)
+    {
+        drift = Q->desired[i] - Q->position[i] * Q16_ONE;
+        if ((drift >= Q16_ONE && Q->position[i + 1] - Q->position[i] > 1) ||
+            (drift <= -Q16_ONE && Q->position[i - 1] - Q->position[i] < -1))
+        {
+            step = (drift > 0) ? 1 : -1;
+            height = Parabolic(Q, i, step);
+            if (height <= Q->height[i - 1] || height >= Q->height[i + 1])
+                height = Linear(Q, i, step);
+            Q->height[i] = height;
+            Q->position[i] += step;
+        }
+    }
+}
+
+static uint32_t QuantileValue(const Player_t *P, const Quantile_t *Q, int32_t p)
+{
+    if (P->samples == 0)
+        return 0;
+    if (P->samples <= REACTION_EXACT)
+        return P->first[((P->samples - 1) * p + Q16_ONE / 2) / Q16_ONE];
+    return Q->height[2];
+}
+
+static void AddSample(Player_t *P, uint32_t us)
+{
+    unsigned i;
+
+    P->lastUS = us;
+    if (P->samples == REACTION_MAX_SAMPLES)
+        return;
+
+    P->samples++;
+    P->meanQ4 += ((int32_t) (us << 4) - P->meanQ4) / (int32_t) P->samples;
+
+    if (P->samples > REACTION_EXACT)
+    {
+        QuantileAdd(&P->p50, us);
+        QuantileAdd(&P->p95, us);
+        return;
+    }
+
+    for (i = P->samples - 1; i > 0 && P->first[i - 1] > (int32_t) us; i--)
+        P->first[i] = P->first[i - 1];
+    P->first[i] = us;
+    if (P->samples == REACTION_EXACT)
+    {
+        QuantileStart(&P->p50, P50_Q16, P->first);
+        QuantileStart(&P->p95, P95_Q16, P->first);
+    }
+}
+
+void SetReactionPlayer(unsigned player)
+{
+    if (player > REACTION_PLAYERS)
+        player = REACTION_OFF;
+    measure.player = player;
+    measure.measuring = false;
+    DisarmPressEdges();
+}
+
+unsigned GetReactionPlayer()
+{
+    return measure.player;
+}
+
+// The light-up is timestamped before the edges are armed, with the interrupts disabled, so that no press can come
+// between the two: the port ISR of a press takes its timestamp after both, never one earlier than the light-up
+void ReactionLightUp()
+{
+    bool wasDisabled;
+
+    measure.measured = false;
+    if (measure.player == REACTION_OFF)
+        return;
+
+    wasDisabled = Interrupt_disableMaster();
+    measure.lightUp = GetTimerValue(TIMER32_0_BASE);
+    ArmPressEdges();
+    measure.measuring = true;
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+// Either button answers. Both debounce FSMs are polled by guess(), so the first press is the first validated.
+bool ReactionPoll()
+{
+    static const button_t answers[] = {BOOSTER_TOP, BOOSTER_BOTTOM};
+    uint32_t edge, cycles, first = UINT32_MAX;
+    unsigned i;
+
+    if (!measure.measuring)
+        return false;
+
+    for (i = 0; i < sizeof(answers) / sizeof(answers[0]); i++)
+    {
+        if (GetPressEdge(answers[i], &edge))
+        {
+            cycles = measure.lightUp - edge;
+            if (cycles < first)
+                first = cycles;
+        }
+    }
+    if (first == UINT32_MAX)
+        return false;
+
+    DisarmPressEdges();
+    measure.measuring = false;
+    measure.measured = true;
+    measure.us = CyclesToMicroseconds(first);
+    AddSample(&players[measure.player - 1], measure.us);
+    return true;
+}
+
+bool ReactionRoundTime(uint32_t *us)
+{
+    if (!measure.measured)
+        return false;
+    *us = measure.us;
+    return true;
+}
+
+ReactionStats_t GetReactionStats(unsigned player)
+{
+    const Player_t *P = &players[player - 1];
+    ReactionStats_t stats;
+
+    stats.samples = P->samples;
+    stats.meanUS = (P->meanQ4 + 8) >> 4;
+    stats.p50US = QuantileValue(P, &P->p50, P50_Q16);
+    stats.p95US = QuantileValue(P, &P->p95, P95_Q16);
+    stats.lastUS = P->lastUS;
+    return stats;
+}
+
+// The lines of each player who has samples are:
+//   Player p n          the number of rounds measured
+//    mean 312.4ms
+//    p50 301.2ms
+//    p95 410.0ms
+uint32_t ReactionDump(EmitLine_t emit) {
+    char line[20];
+    uint32_t lines = 0;
+    ReactionStats_t stats;
+    unsigned player, i;
+
+    for (player = 1; player <= REACTION_PLAYERS; player++)
+    {
+        stats = GetReactionStats(player);
+        if (stats.samples == 0)
+            continue;
+
+        i = AppendString(line, 0, "Player ");
+        i = AppendNumber(line, i, player);
+        i = AppendString(line, i, " ");
+        AppendNumber(line, i, stats.samples);
+        emit(line, lines++);
+
+        i = AppendString(line, 0, " mean ");
+        AppendThousandths(line, i, stats.meanUS, "ms");
+        emit(line, lines++);
+
+        i = AppendString(line, 0, " p50 ");
+        AppendThousandths(line, i, stats.p50US, "ms");
+        emit(line, lines++);
+
+        i = AppendString(line, 0, " p95 ");
+        AppendThousandths(line, i, stats.p95US, "ms");
+        emit(line, lines++);
+    }
+
+    return lines;
+}
@@ -0,0 +1,76 @@
+//------------------------------------------
+// REACTION API (Application Programming Interface)
+// In the reaction-time mode, every round of the color test also measures how fast the player answers: from the
+// moment testFSM has turned the LEDs on to the first press edge of the top or the bottom button. Both ends are
+// timestamps of Timer32_0, the edge taken in the port ISR and validated by the debounce FSM after the fact (see
+// Press edges in Buttons_HAL.h), so the time is exact to a few microseconds, whatever the debounce and the ticks.
+// A round longer than a turn of Timer32_0, about 89 s, wraps around.
+// Each player has statistics that every sample updates in place, in fixed point, and that keep no more samples than
+// the first REACTION_EXACT:
+//   - the mean is a running mean in 1/16 of a microsecond,
+//   - p50 and p95 are exact over the first REACTION_EXACT samples, which are kept sorted, and P2 estimates
+//     (Jain and Chlamtac, 1985) after them. Five markers follow the minimum, p/2, p, (1 + p)/2 and the maximum;
+//     every sample moves the positions of the markers above it, and the markers that drift off their desired
+//     position by a sample or more are moved by one, their heights along a parabola through their neighbours.
+//     The markers start at the order statistics of the sorted samples: P2 is slow to settle when it starts from
+//     five samples, and a player seldom plays many rounds. The heights are in microseconds and the desired
+//     positions in 1/65536 of a sample, so a player can have up to REACTION_MAX_SAMPLES samples.
+// The statistics are in RAM: they start over at every reset.
+
+#ifndef REACTION_H_
+#define REACTION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+// The players are numbered from 1 to REACTION_PLAYERS. REACTION_OFF turns the mode off.
+#define REACTION_PLAYERS 4
+#define REACTION_OFF 0
+
+#define REACTION_EXACT 16
+#define REACTION_MAX_SAMPLES 32767
+
+typedef struct {
+    uint32_t samples;
+    uint32_t meanUS, p50US, p95US;
+    uint32_t lastUS;
+} ReactionStats_t;
+
+/*
+ * This function selects the player whose rounds are measured, or turns the mode off with REACTION_OFF.
+ * A round that is being measured is dropped.
+ */
+void SetReactionPlayer(unsigned player);
+
+unsigned GetReactionPlayer();
+
+/*
+ * testFSM calls this function right after it turned the LEDs on. It starts the measure of the round, unless the
+ * mode is off.
+ */
+void ReactionLightUp();
+
+/*
+ * testFSM calls this function after every guess() of the round. It returns true on the call that found the first
+ * validated press, and added it to the statistics of the player.
+ */
+bool ReactionPoll();
+
+/*
+ * This function returns true, with the reaction time, if the last round started with ReactionLightUp was
+ * measured.
+ */
+bool ReactionRoundTime(uint32_t *us);
+
+/*
+ * This function returns the statistics of a player, from 1 to REACTION_PLAYERS.
+ */
+ReactionStats_t GetReactionStats(unsigned player);
+
+/*
+ * This function formats the statistics of the players who have samples (see EmitLine_t)
+ */
+uint32_t ReactionDump(EmitLine_t emit);
+
+#endif /* REACTION_H_ */
@@ -0,0 +1,366 @@
+//------------------------------------------
+// RENDER API (Application Programming Interface)
+// The bands are composed through a grlib display whose functions write into the band buffer instead of the
+// LCD, with the clipping region of its context set to the rows of the band. Fills and images are written
+// into the band directly. The DMA moves at most 1024 items per transfer, so a band goes out in chunks that
+// the DMA ISR chains. Channel 0 is shared with the trace UART (see DMA_HAL.h): RenderFrame holds it from the
+// first band to the last.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <stddef.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <DMA_HAL.h>
+#include <Render.h>
+
+// DMA channel 0, source 2 is the transmit trigger of eUSCI_B0 (DMA_CH0_EUSCIB0TX0), the SPI of the LCD
+#define RENDER_DMA_CHUNK   1024
+
+#define RENDER_BANDS       (LCD_VERTICAL_MAX / RENDER_BAND_LINES)
+#define RENDER_BAND_BYTES  (RENDER_BAND_LINES * LCD_HORIZONTAL_MAX * 2)
+
+typedef enum {ITEM_FILL, ITEM_LINE, ITEM_TEXT, ITEM_IMAGE} RenderItemType_t;
+
+typedef struct {
+    RenderItemType_t type;
+    int16_t          x1, y1;        // the top left corner, or the start of the line
+    int16_t          x2, y2;        // the bottom right corner of a fill, or the end of the line
+    uint32_t         color;         // 24-bit RGB
+    const void      *data;          // the text or the image
+} RenderItem_t;
+
+static RenderItem_t items[RENDER_MAX_ITEMS];
+static unsigned itemCount;
+static uint32_t background;
+
+// Pixels are stored as the LCD receives them: row by row, high byte first
+static uint8_t bands[2][RENDER_BAND_BYTES];
+static uint8_t *band;                           // the band being composed
+static int16_t bandTop;                         // the screen row of its first line
+
+// The chunks of the band that the DMA is sending
+static const uint8_t *nextChunk;
+static uint32_t remainingBytes;
+static volatile bool sending;
+
+//------------------------------------------
+// The band as a grlib display
+
+static uint32_t TranslateColor(uint32_t color)
+{
+    return g_sCrystalfontz128x128_funcs.pfnColorTranslate(&g_sCrystalfontz128x128, color);
+}
+
+// This function fills a rectangle of the screen, corners included, with what of it falls in the band
+static void BandFill(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t value)
+{
+    int16_t x, y;
+
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 > LCD_HORIZONTAL_MAX - 1)
+        x2 = LCD_HORIZONTAL_MAX - 1;
+    if (y1 < bandTop)
+        y1 = bandTop;
+    if (y2 > bandTop + RENDER_BAND_LINES - 1)
+        y2 = bandTop + RENDER_BAND_LINES - 1;
+
+    for (y = y1; y <= y2; y++)
+    {
+        uint8_t *at = band + ((y - bandTop) * LCD_HORIZONTAL_MAX + x1) * 2;
+        for (x = x1; x <= x2; x++)
+        {
+            *at++ = value >> 8;
+            *at++ = value;
+        }
+    }
+}
+
+static void BandPixelDraw(const Graphics_Display *display, int16_t x, int16_t y, uint16_t value)
+{
+    BandFill(x, y, x, y, value);
+}
+
+// grlib draws text with 1 bpp pixels; images are drawn with RenderImage rather than grlib
+static void BandPixelDrawMultiple(const Graphics_Display *display, int16_t x, int16_t y, int16_t x0,
+                                  int16_t count, int16_t bpp, const uint8_t *data, const uint32_t *palette)
+{
+    if (bpp != 1)
+        return;
+
+    for (; count > 0; x++, x0++, count--)
+    {
+        if (x0 == 8)
+        {
+            x0 = 0;
+            data++;
+        }
+        BandFill(x, y, x, y, palette[(*data >> (7 - x0)) & 1]);
+    }
+}
+
+static void BandLineDrawH(const Graphics_Display *display, int16_t x1, int16_t x2, int16_t y, uint16_t value)
+{
+    BandFill(x1, y, x2, y, value);
+}
+
+static void BandLineDrawV(const Graphics_Display *display, int16_t x, int16_t y1, int16_t y2, uint16_t value)
+{
+    BandFill(x, y1, x, y2, value);
+}
+
+static void BandRectFill(const Graphics_Display *display, const Graphics_Rectangle *rect, uint16_t value)
+{
+    BandFill(rect->xMin, rect->yMin, rect->xMax, rect->yMax, value);
+}
+
+static uint32_t BandColorTranslate(const Graphics_Display *display, uint32_t value)
+{
+    return TranslateColor(value);
+}
+
+static void BandFlush(const Graphics_Display *display)
+{
+}
+
+static void BandClearDisplay(const Graphics_Display *display, uint16_t value)
+{
+    BandFill(0, bandTop, LCD_HORIZONTAL_MAX - 1, bandTop + RENDER_BAND_LINES - 1, value);
+}
+
+static const Graphics_Display_Functions bandFunctions = {
+    BandPixelDraw,
+    BandPixelDrawMultiple,
+    BandLineDrawH,
+    BandLineDrawV,
+    BandRectFill,
+    BandColorTranslate,
+    BandFlush,
+    BandClearDisplay
+};
+
+static Graphics_Display bandDisplay = {sizeof(Graphics_Display), NULL, LCD_HORIZONTAL_MAX, LCD_VERTICAL_MAX};
+static Graphics_Context bandContext;
+
+// This function decodes the rows of an image (see Image.h) that fall in the band
+static void BandImage(const Image_t *image, int16_t x, int16_t y)
+{
+    const uint8_t *p = image->data;
+    const uint8_t *end = image->data + image->size;
+    int16_t top = (y > bandTop) ? y : bandTop;
+    int16_t bottom = y + image->height - 1;
+    uint32_t first, last, pixel = 0, i;
+
+    if (bottom > bandTop + RENDER_BAND_LINES - 1)
+        bottom = bandTop + RENDER_BAND_LINES - 1;
+    if (top > bottom)
+        return;
+
+    // The pixels of the image, counted row by row, that are in the band
+    first = (uint32_t) (top - y) * image->width;
+    last = (uint32_t) (bottom - y + 1) * image->width;
+
+    while (p < end && pixel < last)
+    {
+        uint8_t header = *p++;
+        bool run = header & IMAGE_RUN;
+        uint32_t count = run ? (header & 0x7F) + IMAGE_MIN_RUN : header + 1u;
+        const uint8_t *colors = p;
+
+        p += run ? 2 : 2 * count;
+        for (i = (pixel > first) ? pixel : first; i < pixel + count && i < last; i++)
+        {
+            int16_t column = x + i % image->width;
+            const uint8_t *color = run ? colors : colors + 2 * (i - pixel);
+
+            if (column >= 0 && column < LCD_HORIZONTAL_MAX)
+                BandFill(column, y + i / image->width, column, y + i / image->width, (color[0] << 8) | color[1]);
+        }
+        pixel += count;
+    }
+}
+
+static void ComposeBand(uint8_t *buffer, int16_t top)
+{
+    Graphics_Rectangle clip = {0, top, LCD_HORIZONTAL_MAX - 1, top + RENDER_BAND_LINES - 1};
+    int16_t bottom = top + RENDER_BAND_LINES - 1;
+    unsigned i;
+
+    band = buffer;
+    bandTop = top;
+    Graphics_setClipRegion(&bandContext, &clip);
+    BandFill(0, top, LCD_HORIZONTAL_MAX - 1, bottom, TranslateColor(background));
+
+    for (i = 0; i < itemCount; i++)
+    {
+        const RenderItem_t *item = &items[i];
+
+        switch (item->type)
+        {
+        case ITEM_FILL:
+            BandFill(item->x1, item->y1, item->x2, item->y2, TranslateColor(item->color));
+            break;
+
+        case ITEM_LINE:
+            Graphics_setForegroundColor(&bandContext, item->color);
+            Graphics_drawLine(&bandContext, item->x1, item->y1, item->x2, item->y2);
+            break;
+
+        case ITEM_TEXT:
+            if (item->y1 <= bottom && item->y1 + bandContext.font->height > top)
+            {
+                const int8_t *text = item->data;
+                unsigned c;
+
+                Graphics_setForegroundColor(&bandContext, item->color);
+                for (c = 0; text[c] != '\0'; c++)
+                    Graphics_drawString(&bandContext, (int8_t *) &text[c], 1, item->x1 + RENDER_CHAR_WIDTH * c,
+                                        item->y1, TRANSPARENT_TEXT);
+            }
+            break;
+
+        case ITEM_IMAGE:
+            BandImage(item->data, item->x1, item->y1);
+            break;
+        }
+    }
+}
+
+//------------------------------------------
+// Sending the bands
+
+// This function starts the DMA transfer of the next chunk of the band. It is called when the DMA is idle, from
+// RenderFrame or from the DMA ISR, while RenderFrame holds the channel.
+static void StartChunk()
+{
+    uint32_t bytes = (remainingBytes < RENDER_DMA_CHUNK) ? remainingBytes : RENDER_DMA_CHUNK;
+
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH0_EUSCIB0TX0, UDMA_MODE_BASIC, (void *) nextChunk,
+                           (void *) (uintptr_t) SPI_getTransmitBufferAddressForDMA(EUSCI_B0_BASE), bytes);
+    nextChunk += bytes;
+    remainingBytes -= bytes;
+    DMA_enableChannel(DMA_SHARED_CHANNEL);
+
+    // The DMA is triggered by the rising edge of UCTXIFG, as for the trace UART. Once the last byte before is
+    // on its way out, the flag is set and is toggled to request the first byte.
+    while (!(UCB0IFG & UCTXIFG));
+    UCB0IFG &= ~UCTXIFG;
+    UCB0IFG |= UCTXIFG;
+}
+
+static void SendBand(const uint8_t *buffer)
+{
+    nextChunk = buffer;
+    remainingBytes = RENDER_BAND_BYTES;
+    sending = true;
+    HAL_LCD_byteCount += RENDER_BAND_BYTES;
+    StartChunk();
+}
+
+// This function sleeps until the band being sent is done. The check is done with interrupts disabled, like
+// RunScheduler does, so that the DMA interrupt cannot come between the check and the sleep.
+static void WaitForBand()
+{
+    Interrupt_disableMaster();
+    while (sending)
+    {
+        PCM_gotoLPM0();
+        Interrupt_enableMaster();
+        Interrupt_disableMaster();
+    }
+    Interrupt_enableMaster();
+}
+
+// The last byte of a chunk has been written to UCB0TXBUF. This is called from the DMA ISR.
+static void ChunkDone()
+{
+    if (remainingBytes)
+        StartChunk();
+    else
+        sending = false;
+}
+
+//------------------------------------------
+// Display list
+
+void InitRender()
+{
+    Graphics_initContext(&bandContext, &bandDisplay, &bandFunctions);
+    Graphics_setFont(&bandContext, &g_sFontCmtt16);
+    RenderClear(GRAPHICS_COLOR_BLACK);
+
+    InitDMA();
+}
+
+void RenderClear(uint32_t color)
+{
+    background = color;
+    itemCount = 0;
+}
+
+static bool AddItem(RenderItemType_t type, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t color,
+                    const void *data)
+{
+    RenderItem_t *item = &items[itemCount];
+
+    if (itemCount == RENDER_MAX_ITEMS)
+        return false;
+
+    item->type = type;
+    item->x1 = x1;
+    item->y1 = y1;
+    item->x2 = x2;
+    item->y2 = y2;
+    item->color = color;
+    item->data = data;
+    itemCount++;
+    return true;
+}
+
+bool RenderFill(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color)
+{
+    return AddItem(ITEM_FILL, x, y, x + width - 1, y + height - 1, color, NULL);
+}
+
+bool RenderLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t color)
+{
+    return AddItem(ITEM_LINE, x1, y1, x2, y2, color, NULL);
+}
+
+bool RenderText(const char *text, int16_t x, int16_t y, uint32_t color)
+{
+    return AddItem(ITEM_TEXT, x, y, 0, 0, color, text);
+}
+
+bool RenderImage(const Image_t *image, int16_t x, int16_t y)
+{
+    return AddItem(ITEM_IMAGE, x, y, 0, 0, 0, image);
+}
+
+void RenderFrame()
+{
+    unsigned b;
+
+    Crystalfontz128x128_SetDrawFrame(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
+    HAL_LCD_writeCommand(CM_RAMWR);
+
+    // Each band is composed while the one before it, in the other buffer, is being sent
+    for (b = 0; b < RENDER_BANDS; b++)
+    {
+        uint8_t *buffer = bands[b % 2];
+
+        ComposeBand(buffer, b * RENDER_BAND_LINES);
+
+        // A block of trace records may still be on its way while the first band is composed
+        if (b == 0)
+            AcquireSharedDMA(DMA_CH0_EUSCIB0TX0, ChunkDone);
+        WaitForBand();
+        SendBand(buffer);
+    }
+    WaitForBand();
+    ReleaseSharedDMA();
+
+    // The last byte must be out before the next command changes the D/C line
+    while (UCB0STATW & UCBUSY);
+}
@@ -0,0 +1,46 @@
+//------------------------------------------
+// RENDER API (Application Programming Interface)
+// This module composes whole screens without a frame buffer. A screen is described as a display list of
+// fills, lines, text and images. RenderFrame replays the list once for each band of RENDER_BAND_LINES rows,
+// into one of two band buffers, while the DMA sends the other band to the LCD. Every pixel goes over the SPI
+// once, however much the items overlap, and the RAM used is the two bands: 8 KB instead of the 32 KB of a
+// frame buffer of the whole screen.
+// Text and lines are drawn into the band by grlib, clipped to the band, so they look the same as on the LCD.
+
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Image.h>
+
+#define RENDER_BAND_LINES   16
+#define RENDER_MAX_ITEMS    24      // items in the display list
+#define RENDER_CHAR_WIDTH   8       // text is drawn in character cells, like PrintString does
+
+/*
+ * This function sets up the display list and the DMA. It must be called after GraphicsReady.
+ */
+void InitRender();
+
+/*
+ * This function starts a new display list, for a screen filled with color (a 24-bit RGB color, as in grlib)
+ */
+void RenderClear(uint32_t color);
+
+/*
+ * These functions add an item to the display list, on top of the ones already in it. They return false if the
+ * list is full. The text and the image are not copied and must stay where they are until RenderFrame.
+ */
+bool RenderFill(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color);
+bool RenderLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t color);
+bool RenderText(const char *text, int16_t x, int16_t y, uint32_t color);
+bool RenderImage(const Image_t *image, int16_t x, int16_t y);
+
+/*
+ * This function draws the display list on the whole screen and returns when the last band has been sent.
+ * The band transfers end with an interrupt, so interrupts must be enabled.
+ */
+void RenderFrame();
+
+#endif /* RENDER_H_ */
@@ -0,0 +1,233 @@
+//------------------------------------------
+// SCHEDULER API (Application Programming Interface)
+// Each priority level has its own ready queue, which is a ring buffer of events.
+// ISRs are the producers and RunScheduler is the only consumer. Posting is done with interrupts
+// disabled for a few instructions, because several ISRs of different priorities may post to the same queue.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Scheduler.h>
+#include <Timer_HAL.h>
+#include <Trace.h>
+#include <Watchdog.h>
+#include <Format.h>
+
+typedef struct {
+    Event_t  events[EVENT_QUEUE_SIZE];
+    uint32_t head;          // index of the next event to dispatch
+    uint32_t tail;          // index of the next free slot
+    uint32_t maxDepth;
+    uint32_t dropped;
+} EventQueue_t;
+
+typedef struct {
+    TaskFunction_t function;
+    uint32_t       subscriptions;
+    TaskStats_t    stats;
+} Task_t;
+
+static EventQueue_t queues[PRIO_LEVELS];
+static Task_t tasks[MAX_TASKS];
+static int taskCount;
+
+
+void InitScheduler()
+{
+    int i;
+    for (i = 0; i < PRIO_LEVELS; i++)
+    {
+        queues[i].head = 0;
+        queues[i].tail = 0;
+        queues[i].maxDepth = 0;
+        queues[i].dropped = 0;
+    }
+    taskCount = 0;
+}
+
+int AddTask(TaskFunction_t function, uint32_t subscriptions)
+{
+    if (taskCount >= MAX_TASKS)
+        return -1;
+
+    tasks[taskCount].function = function;
+    tasks[taskCount].subscriptions = subscriptions;
+    tasks[taskCount].stats.runs = 0;
+    tasks[taskCount].stats.lastCycles = 0;
+    tasks[taskCount].stats.maxCycles = 0;
+    tasks[taskCount].stats.totalCycles = 0;
+
+    return taskCount++;
+}
+
+bool PostEvent(EventType_t type, uint32_t arg, EventPriority_t priority)
+{
+    EventQueue_t *Q = &queues[priority];
+    bool posted = false;
+
+    // The timestamp is taken before the critical section so that it is as close to the event as possible
+    uint32_t timestamp = GetTimerValue(TIMER32_0_BASE);
+
+    bool wasDisabled = Interrupt_disableMaster();
+
+    uint32_t depth = Q->tail - Q->head;
+    if (depth < EVENT_QUEUE_SIZE)
+    {
+        Event_t *E = &Q->events[Q->tail % EVENT_QUEUE_SIZE];
+        E->type = type;
+        E->arg = arg;
+        E->timestamp = timestamp;
+        Q->tail++;
+
+        depth++;
+        if (depth > Q->maxDepth)
+            Q->maxDepth = depth;
+        posted = true;
+    }
+    else
+        Q->dropped++;
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+
+    if (posted)
+        TRACE(TRACE_EVENT_POSTED, type, arg);
+
+    return posted;
+}
+
+// This function removes the oldest event from the highest priority non-empty queue.
+// It returns false if all the queues are empty.
+static bool NextEvent(Event_t *E)
+{
+    int p;
+    for (p = 0; p < PRIO_LEVELS; p++)
+    {
+        EventQueue_t *Q = &queues[p];
+        if (Q->head != Q->tail)
+        {
+            *E = Q->events[Q->head % EVENT_QUEUE_SIZE];
+
+            // Only the consumer moves head, so this does not need a critical section
+            Q->head++;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void RunTask(int taskId, const Event_t *E)
+{
+    Task_t *T = &tasks[taskId];
+    TRACE(TRACE_TASK_BEGIN, taskId, E->type);
+    SUPERVISOR_BEGIN(taskId);
+
+    // Timer32_0 counts cycles of the fastest MCLK down, so the elapsed time is start - end
+    uint32_t start = GetTimerValue(TIMER32_0_BASE);
+    T->function(E);
+    uint32_t cycles = start - GetTimerValue(TIMER32_0_BASE);
+
+    SUPERVISOR_END(taskId, cycles);
+    TRACE(TRACE_TASK_END, taskId, cycles);
+
+    T->stats.runs++;
+    T->stats.lastCycles = cycles;
+    T->stats.totalCycles += cycles;
+    if (cycles > T->stats.maxCycles)
+        T->stats.maxCycles = cycles;
+}
+
+void RunScheduler()
+{
+    Event_t E;
+    int i;
+
+    // The queues are checked with interrupts disabled. Otherwise, an event posted right after the check
+    // would not wake us up until the next interrupt. The processor still wakes up from sleep for a
+    // pending interrupt when interrupts are disabled, and the ISR runs as soon as they are enabled again.
+    Interrupt_disableMaster();
+    if (!NextEvent(&E))
+    {
+        PCM_gotoLPM0();
+        Interrupt_enableMaster();
+        return;
+    }
+    Interrupt_enableMaster();
+
+    for (i = 0; i < taskCount; i++)
+    {
+        if (tasks[i].subscriptions & EVENT_MASK(E.type))
+            RunTask(i, &E);
+    }
+    SUPERVISOR_EVENT_DONE(&E);
+}
+
+QueueStats_t GetQueueStats(EventPriority_t priority)
+{
+    QueueStats_t stats;
+    EventQueue_t *Q = &queues[priority];
+
+    bool wasDisabled = Interrupt_disableMaster();
+    stats.depth = Q->tail - Q->head;
+    stats.maxDepth = Q->maxDepth;
+    stats.dropped = Q->dropped;
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+
+    return stats;
+}
+
+TaskStats_t GetTaskStats(int taskId)
+{
+    static const TaskStats_t none;
+
+    if (taskId < 0 || taskId >= taskCount)
+        return none;
+    return tasks[taskId].stats;
+}
+
+// The lines are:
+//   Queues now/max x
+//    hi d/m xn          for each priority, the events waiting now and at most, and those lost, up to 999
+//   Task t runs         for each task, in the order they were added
+//    ~avg ^max          the mean and the longest run time in microseconds, in milliseconds with an "m"
+uint32_t SchedulerDump(EmitLine_t emit)
+{
+    static const char *const priorityNames[PRIO_LEVELS] = {" hi ", " no ", " lo "};
+    char line[20];
+    uint32_t n = 0;
+    QueueStats_t queue;
+    TaskStats_t task;
+    unsigned i;
+    int p, t;
+
+    AppendString(line, 0, "Queues now/max x");
+    emit(line, n++);
+    for (p = 0; p < PRIO_LEVELS; p++)
+    {
+        queue = GetQueueStats((EventPriority_t) p);
+        i = AppendString(line, 0, priorityNames[p]);
+        i = AppendNumber(line, i, queue.depth);
+        i = AppendString(line, i, "/");
+        i = AppendNumber(line, i, queue.maxDepth);
+        i = AppendString(line, i, " x");
+        AppendNumber(line, i, (queue.dropped < 999) ? queue.dropped : 999);
+        emit(line, n++);
+    }
+
+    for (t = 0; t < taskCount; t++)
+    {
+        task = GetTaskStats(t);
+        i = AppendString(line, 0, "Task ");
+        i = AppendNumber(line, i, t);
+        i = AppendString(line, i, " ");
+        AppendShortNumber(line, i, task.runs, "k");
+        emit(line, n++);
+
+        i = AppendString(line, 0, " ~");
+        i = AppendShortNumber(line, i, task.runs ? CyclesToMicroseconds(task.totalCycles / task.runs) : 0, "m");
+        i = AppendString(line, i, " ^");
+        AppendShortNumber(line, i, CyclesToMicroseconds(task.maxCycles), "m");
+        emit(line, n++);
+    }
+
+    return n;
+}
@@ -0,0 +1,96 @@
+//------------------------------------------
+// SCHEDULER API (Application Programming Interface)
+// This is a run-to-completion, event-driven cooperative scheduler.
+// Interrupt service routines (ISRs) post events to it. Tasks subscribe to the event types they need
+// and are only called when one of those events has happened. When nothing is pending, the CPU sleeps.
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Format.h>
+
+// The types of events that can be posted to the scheduler
+typedef enum {
+    EVT_TICK,       // the periodic system tick, every TICK_PERIOD_MS (see Timer_HAL.h)
+    EVT_BUTTON,     // an edge on one of the buttons; the argument tells which button (see Buttons_HAL.h)
+    EVT_MOTION,     // the joystick or the board changed direction; the argument tells which (see ADC_HAL.h)
+    EVT_TYPE_COUNT
+} EventType_t;
+
+// Tasks subscribe to a set of event types. The set is a bit mask built with this macro.
+#define EVENT_MASK(type) (1u << (type))
+
+// Every event goes into one of these ready queues. Higher priority queues are always emptied first.
+typedef enum {PRIO_HIGH, PRIO_NORMAL, PRIO_LOW, PRIO_LEVELS} EventPriority_t;
+
+// The number of events each ready queue can hold. It must be a power of 2.
+#define EVENT_QUEUE_SIZE 16
+
+// The maximum number of tasks that can subscribe to events
+#define MAX_TASKS 8
+
+typedef struct {
+    EventType_t type;
+    uint32_t    arg;        // event specific argument
+    uint32_t    timestamp;  // value of the free running Timer32_0 when the event was posted
+} Event_t;
+
+// A task is a function that runs to completion every time an event it subscribed to is dispatched
+typedef void (*TaskFunction_t)(const Event_t *event);
+
+// Statistics the scheduler keeps for each ready queue
+typedef struct {
+    uint32_t depth;         // number of events currently waiting
+    uint32_t maxDepth;      // highest number of events ever waiting at once
+    uint32_t dropped;       // number of events lost because the queue was full
+} QueueStats_t;
+
+// Statistics the scheduler keeps for each task. Run times are in cycles of Timer32_0 (see GetTimerValue).
+typedef struct {
+    uint32_t runs;
+    uint32_t lastCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+} TaskStats_t;
+
+/*
+ * This function empties the ready queues and removes all the tasks. It should be called before
+ * any interrupt that posts events is enabled.
+ */
+void InitScheduler();
+
+/*
+ * This function adds a task that is called for every event whose type is in subscriptions.
+ * It returns the id of the task that can be used to get its statistics, or -1 if there is no room.
+ */
+int AddTask(TaskFunction_t function, uint32_t subscriptions);
+
+/*
+ * This function posts an event with the given priority. It is safe to call from any ISR and from tasks.
+ * It returns false if the ready queue of that priority was full and the event was dropped.
+ */
+bool PostEvent(EventType_t type, uint32_t arg, EventPriority_t priority);
+
+/*
+ * This function dispatches the highest priority pending event to all the tasks subscribed to it.
+ * If no event is pending, the CPU sleeps until an interrupt arrives. It never blocks for longer than that.
+ */
+void RunScheduler();
+
+/*
+ * These functions give access to the statistics of a ready queue and of a task
+ */
+QueueStats_t GetQueueStats(EventPriority_t priority);
+
+/*
+ * This function returns the statistics of a task, or all zeros if taskId is not that of a task.
+ */
+TaskStats_t GetTaskStats(int taskId);
+
+/*
+ * This function formats the depth of the ready queues and the run times of the tasks (see EmitLine_t)
+ */
+uint32_t SchedulerDump(EmitLine_t emit);
+
+#endif // SCHEDULER_H_
@@ -0,0 +1,184 @@
+//------------------------------------------
+// STRIP CHART API (Application Programming Interface)
+// A slice is composed in a buffer in the order the LCD receives its pixels, from the top of a column or the left
+// of a row, high byte first, and sent with HAL_LCD_writeDataBurst. Each trace is drawn in the slice as the run of
+// pixels from where it was in the last slice to where it is now, so that fast changes stay connected.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <StripChart.h>
+
+// The longest slice, a column or a row of the whole screen. StripChartStart fits the chart to the screen.
+#define STRIP_CHART_MAX_SLICE ((LCD_VERTICAL_MAX > LCD_HORIZONTAL_MAX) ? LCD_VERTICAL_MAX : LCD_HORIZONTAL_MAX)
+
+static uint8_t slice[STRIP_CHART_MAX_SLICE * 2];
+
+static uint16_t TranslateColor(uint32_t color)
+{
+    return g_sCrystalfontz128x128_funcs.pfnColorTranslate(&g_sCrystalfontz128x128, color);
+}
+
+static int16_t Clamp(int16_t value, int16_t low, int16_t high)
+{
+    if (value < low)
+        return low;
+    return (value > high) ? high : value;
+}
+
+// This function keeps the chart on the screen, and so its slices within the buffer. The scroll moves whole rows,
+// so a chart in STRIP_CHART_SCROLL mode takes the full width.
+static void FitChart(StripChart_t *chart)
+{
+    if (chart->mode == STRIP_CHART_SCROLL)
+    {
+        chart->x = 0;
+        chart->width = LCD_HORIZONTAL_MAX;
+    }
+    chart->x = Clamp(chart->x, 0, LCD_HORIZONTAL_MAX - 1);
+    chart->y = Clamp(chart->y, 0, LCD_VERTICAL_MAX - 1);
+    chart->width = Clamp(chart->width, 1, LCD_HORIZONTAL_MAX - chart->x);
+    chart->height = Clamp(chart->height, 1, LCD_VERTICAL_MAX - chart->y);
+    if (chart->traces > STRIP_CHART_MAX_TRACES)
+        chart->traces = STRIP_CHART_MAX_TRACES;
+}
+
+// The number of pixels in a slice, and the number of slices in the chart
+static int16_t SliceLength(const StripChart_t *chart)
+{
+    return (chart->mode == STRIP_CHART_SWEEP) ? chart->height : chart->width;
+}
+
+static int16_t SliceCount(const StripChart_t *chart)
+{
+    return (chart->mode == STRIP_CHART_SWEEP) ? chart->width : chart->height;
+}
+
+static void FillSlice(int16_t from, int16_t to, uint16_t value)
+{
+    int16_t i;
+
+    for (i = from; i <= to; i++)
+    {
+        slice[2 * i] = value >> 8;
+        slice[2 * i + 1] = value;
+    }
+}
+
+// This function returns the pixel of the slice that shows value: the bottom of a column is the minimum, and so
+// is the left of a row
+static int16_t SlicePosition(const StripChart_t *chart, int32_t value, int16_t length)
+{
+    int32_t position;
+
+    if (value <= chart->min)
+        position = 0;
+    else if (value >= chart->max)
+        position = length - 1;
+    else
+        position = (value - chart->min) * (length - 1) / (chart->max - chart->min);
+
+    return (chart->mode == STRIP_CHART_SWEEP) ? length - 1 - position : position;
+}
+
+// This function sets the draw frame of slice n and starts the memory write
+static void StartSlice(const StripChart_t *chart, int16_t n)
+{
+    if (chart->mode == STRIP_CHART_SWEEP)
+        Crystalfontz128x128_SetDrawFrame(chart->x + n, chart->y, chart->x + n, chart->y + chart->height - 1);
+    else
+        Crystalfontz128x128_SetDrawFrame(chart->x, chart->y + n, chart->x + chart->width - 1, chart->y + n);
+    HAL_LCD_writeCommand(CM_RAMWR);
+}
+
+void StripChartStart(StripChart_t *chart)
+{
+    int16_t length;
+    int16_t n;
+    unsigned t;
+
+    FitChart(chart);
+    length = SliceLength(chart);
+    chart->written = 0;
+    chart->drawn = 0;
+    chart->dropped = 0;
+    chart->slice = 0;
+    chart->displayBackground = TranslateColor(chart->background);
+    for (t = 0; t < chart->traces; t++)
+    {
+        chart->displayColors[t] = TranslateColor(chart->colors[t]);
+        chart->last[t] = -1;
+    }
+
+    // The whole area in one window, a slice at a time
+    FillSlice(0, length - 1, chart->displayBackground);
+    Crystalfontz128x128_SetDrawFrame(chart->x, chart->y, chart->x + chart->width - 1, chart->y + chart->height - 1);
+    HAL_LCD_writeCommand(CM_RAMWR);
+    for (n = 0; n < SliceCount(chart); n++)
+        HAL_LCD_writeDataBurst(slice, 2 * length);
+
+    if (chart->mode == STRIP_CHART_SCROLL)
+        Crystalfontz128x128_SetScrollArea(chart->y, chart->height);
+}
+
+void StripChartAddSample(StripChart_t *chart, const int32_t *values)
+{
+    uint32_t written = chart->written;
+    int32_t *sample = chart->samples[written % STRIP_CHART_SAMPLES];
+    unsigned t;
+
+    if (written - chart->drawn >= STRIP_CHART_SAMPLES)
+    {
+        chart->dropped++;
+        return;
+    }
+    for (t = 0; t < chart->traces; t++)
+        sample[t] = values[t];
+    chart->written = written + 1;
+}
+
+unsigned StripChartRender(StripChart_t *chart)
+{
+    uint32_t written = chart->written;
+    int16_t length = SliceLength(chart);
+    unsigned slices = 0;
+    unsigned t;
+
+    while (chart->drawn != written)
+    {
+        const int32_t *sample = chart->samples[chart->drawn % STRIP_CHART_SAMPLES];
+
+        FillSlice(0, length - 1, chart->displayBackground);
+        for (t = 0; t < chart->traces; t++)
+        {
+            int16_t now = SlicePosition(chart, sample[t], length);
+            int16_t last = (chart->last[t] < 0) ? now : chart->last[t];
+
+            if (last < now)
+                FillSlice(last, now, chart->displayColors[t]);
+            else
+                FillSlice(now, last, chart->displayColors[t]);
+            chart->last[t] = now;
+        }
+
+        StartSlice(chart, chart->slice);
+        HAL_LCD_writeDataBurst(slice, 2 * length);
+
+        chart->slice = (chart->slice + 1) % SliceCount(chart);
+        chart->drawn++;
+        slices++;
+    }
+
+    // The oldest row, the one after the newest, goes to the top of the area
+    if (slices && chart->mode == STRIP_CHART_SCROLL)
+        Crystalfontz128x128_SetScrollStart(chart->y + chart->slice);
+
+    return slices;
+}
+
+void StripChartStop(StripChart_t *chart)
+{
+    if (chart->mode == STRIP_CHART_SCROLL)
+        Crystalfontz128x128_StopScroll();
+}
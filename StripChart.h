@@ -0,0 +1,70 @@
+//------------------------------------------
+// STRIP CHART API (Application Programming Interface)
+// A strip chart plots a few traces of samples taken at a fixed rate. The samples go into a ring buffer as they
+// are taken, which is cheap enough for a tick or an ISR, and StripChartRender draws the ones not yet drawn.
+// Each sample is drawn as one slice of the chart, a line of pixels across it: the slice is composed in RAM,
+// background and traces together, and sent in a single address window, 11 + 2 * length bytes on the SPI.
+// Nothing else of the chart is sent again, so the cost of a sample does not depend on the size of the chart.
+// There are two modes:
+//   STRIP_CHART_SWEEP   time runs from left to right. Each sample is a column, drawn over the oldest one,
+//                       and the columns wrap around at the right edge, like the sweep of an oscilloscope.
+//   STRIP_CHART_SCROLL  time runs from top to bottom. Each sample is a row, drawn over the oldest one, and the
+//                       hardware scroll of the LCD moves the rows so that the newest is always at the bottom.
+//                       The ST7735 scrolls rows of the screen, not columns, which is why time runs downwards.
+//                       The scroll moves whole rows, so the chart is as wide as the screen.
+
+#ifndef STRIPCHART_H_
+#define STRIPCHART_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STRIP_CHART_MAX_TRACES  4
+#define STRIP_CHART_SAMPLES     64      // samples the ring buffer can hold before they are drawn; a power of 2
+
+typedef enum {STRIP_CHART_SWEEP, STRIP_CHART_SCROLL} StripChartMode_t;
+
+typedef struct {
+    // The settings, filled in by the caller before StripChartStart
+    int16_t          x, y, width, height;
+    StripChartMode_t mode;
+    int32_t          min, max;                          // the sample values at the two edges of the chart
+    uint32_t         background;                        // 24-bit RGB colors, as in grlib
+    uint32_t         colors[STRIP_CHART_MAX_TRACES];
+    unsigned         traces;
+
+    // The state, managed by the functions below
+    int32_t          samples[STRIP_CHART_SAMPLES][STRIP_CHART_MAX_TRACES];
+    volatile uint32_t written;                          // samples added so far
+    uint32_t         drawn;                             // samples drawn so far
+    uint32_t         dropped;                           // samples not added because the ring buffer was full
+    uint16_t         slice;                             // the next slice drawn, from the left or the top
+    int16_t          last[STRIP_CHART_MAX_TRACES];      // where each trace was in the last slice
+    uint16_t         displayBackground;
+    uint16_t         displayColors[STRIP_CHART_MAX_TRACES];
+} StripChart_t;
+
+/*
+ * This function clears the area of the chart and, in STRIP_CHART_SCROLL mode, makes it the scroll area of the LCD.
+ * It first fits the settings to the screen: the area is cut at its edges, a chart in STRIP_CHART_SCROLL mode
+ * takes its full width, and traces is at most STRIP_CHART_MAX_TRACES.
+ */
+void StripChartStart(StripChart_t *chart);
+
+/*
+ * This function adds one sample, a value for each trace. It can be called from an ISR. If the ring buffer is
+ * full, the sample is dropped and counted in dropped.
+ */
+void StripChartAddSample(StripChart_t *chart, const int32_t *values);
+
+/*
+ * This function draws the samples added since the last call, one slice each. It returns the number of slices.
+ */
+unsigned StripChartRender(StripChart_t *chart);
+
+/*
+ * This function ends the chart. In STRIP_CHART_SCROLL mode the LCD leaves the scroll mode.
+ */
+void StripChartStop(StripChart_t *chart);
+
+#endif /* STRIPCHART_H_ */
@@ -0,0 +1,400 @@
+//------------------------------------------
+// TILES API (Application Programming Interface)
+// The text of a cell is rendered once, when it is printed, through a grlib display of the size of the screen whose
+// functions set the bits of the patterns of the cells: a frame never calls grlib. A run of cells is sent a pixel
+// line at a time, the line composed in a buffer from the patterns and the sprites that cross it, in the order the
+// LCD receives its pixels.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <stddef.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include <Timer_HAL.h>
+#include <Format.h>
+#include <Tiles.h>
+
+#define TILE_WIDTH      8
+#define TILE_HEIGHT     16
+#define TILE_COLUMNS    (LCD_HORIZONTAL_MAX / TILE_WIDTH)
+#define TILE_ROWS       (LCD_VERTICAL_MAX / TILE_HEIGHT)
+
+typedef struct {
+    uint8_t  pattern[TILE_HEIGHT];  // a byte per pixel line, the most significant bit on the left
+    uint16_t color;                 // the colors as the LCD takes them
+    uint16_t background;
+} Tile_t;
+
+typedef struct {
+    const SpriteImage_t *image;     // NULL when hidden
+    uint16_t             color;
+    int16_t              x, y;
+} Sprite_t;
+
+static Tile_t tiles[TILE_ROWS][TILE_COLUMNS];
+
+// The sprites as they are now, and as they were drawn by the last frame
+static Sprite_t sprites[TILES_MAX_SPRITES];
+static Sprite_t drawnSprites[TILES_MAX_SPRITES];
+
+// A bit for each cell to send, bit c for column c
+static uint16_t dirty[TILE_ROWS];
+
+// A pixel line of a run of cells, as the LCD receives it: high byte first
+static uint8_t pixels[LCD_HORIZONTAL_MAX * 2];
+
+// The frame counters
+static uint32_t frames;
+static uint32_t lastBytes, maxBytes;
+static uint32_t lastUS, maxUS;
+
+//------------------------------------------
+// The pattern of a cell as a grlib display
+
+static void PatternPixelDraw(const Graphics_Display *display, int16_t x, int16_t y, uint16_t value)
+{
+    uint8_t *bits = &tiles[y / TILE_HEIGHT][x / TILE_WIDTH].pattern[y % TILE_HEIGHT];
+
+    if (value)
+        *bits |= 0x80 >> (x % TILE_WIDTH);
+    else
+        *bits &= ~(0x80 >> (x % TILE_WIDTH));
+}
+
+static void PatternPixelDrawMultiple(const Graphics_Display *display, int16_t x, int16_t y, int16_t x0,
+                                     int16_t count, int16_t bpp, const uint8_t *data, const uint32_t *palette)
+{
+    if (bpp != 1)
+        return;
+
+    for (; count > 0; x++, x0++, count--)
+    {
+        if (x0 == 8)
+        {
+            x0 = 0;
+            data++;
+        }
+        PatternPixelDraw(display, x, y, palette[(*data >> (7 - x0)) & 1]);
+    }
+}
+
+static void PatternLineDrawH(const Graphics_Display *display, int16_t x1, int16_t x2, int16_t y, uint16_t value)
+{
+    for (; x1 <= x2; x1++)
+        PatternPixelDraw(display, x1, y, value);
+}
+
+static void PatternLineDrawV(const Graphics_Display *display, int16_t x, int16_t y1, int16_t y2, uint16_t value)
+{
+    for (; y1 <= y2; y1++)
+        PatternPixelDraw(display, x, y1, value);
+}
+
+static void PatternRectFill(const Graphics_Display *display, const Graphics_Rectangle *rect, uint16_t value)
+{
+    int16_t y;
+
+    for (y = rect->yMin; y <= rect->yMax; y++)
+        PatternLineDrawH(display, rect->xMin, rect->xMax, y, value);
+}
+
+// The pattern only tells the foreground from the background: the colors are 1 and 0
+static uint32_t PatternColorTranslate(const Graphics_Display *display, uint32_t value)
+{
+    return value;
+}
+
+static void PatternFlush(const Graphics_Display *display)
+{
+}
+
+static void PatternClearDisplay(const Graphics_Display *display, uint16_t value)
+{
+    unsigned row, column, y;
+
+    for (row = 0; row < TILE_ROWS; row++)
+        for (column = 0; column < TILE_COLUMNS; column++)
+            for (y = 0; y < TILE_HEIGHT; y++)
+                tiles[row][column].pattern[y] = value ? 0xFF : 0;
+}
+
+static const Graphics_Display_Functions patternFunctions = {
+    PatternPixelDraw,
+    PatternPixelDrawMultiple,
+    PatternLineDrawH,
+    PatternLineDrawV,
+    PatternRectFill,
+    PatternColorTranslate,
+    PatternFlush,
+    PatternClearDisplay
+};
+
+static Graphics_Display patternDisplay = {sizeof(Graphics_Display), NULL, LCD_HORIZONTAL_MAX, LCD_VERTICAL_MAX};
+static Graphics_Context patternContext;
+
+static uint16_t TranslateColor(uint32_t color)
+{
+    return g_sCrystalfontz128x128_funcs.pfnColorTranslate(&g_sCrystalfontz128x128, color);
+}
+
+//------------------------------------------
+// Dirty cells
+
+// This function marks the cells that a rectangle of the screen touches
+static void MarkArea(int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    int16_t first = x / TILE_WIDTH, last = (x + width - 1) / TILE_WIDTH;
+    int16_t top = y / TILE_HEIGHT, bottom = (y + height - 1) / TILE_HEIGHT;
+    int16_t row;
+    uint16_t columns;
+
+    if (x + width <= 0 || y + height <= 0 || x >= LCD_HORIZONTAL_MAX || y >= LCD_VERTICAL_MAX)
+        return;
+    if (x < 0)
+        first = 0;
+    if (y < 0)
+        top = 0;
+    if (last > TILE_COLUMNS - 1)
+        last = TILE_COLUMNS - 1;
+    if (bottom > TILE_ROWS - 1)
+        bottom = TILE_ROWS - 1;
+
+    columns = (uint16_t) (((1u << (last + 1)) - 1) & ~((1u << first) - 1));
+    for (row = top; row <= bottom; row++)
+        dirty[row] |= columns;
+}
+
+static void MarkSprite(const Sprite_t *sprite)
+{
+    if (sprite->image)
+        MarkArea(sprite->x, sprite->y, sprite->image->width, sprite->image->height);
+}
+
+static bool SpriteChanged(const Sprite_t *now, const Sprite_t *drawn)
+{
+    return now->image != drawn->image || now->color != drawn->color || now->x != drawn->x || now->y != drawn->y;
+}
+
+//------------------------------------------
+// Sending the cells
+
+// This function composes pixel line y of the screen, from column first to column last of the grid
+static void ComposeLine(int16_t y, int16_t first, int16_t last)
+{
+    const Tile_t *tile = &tiles[y / TILE_HEIGHT][first];
+    int16_t left = first * TILE_WIDTH, right = (last + 1) * TILE_WIDTH - 1;
+    uint8_t *at = pixels;
+    int16_t c, x;
+    unsigned n;
+
+    for (c = first; c <= last; c++, tile++)
+    {
+        uint8_t bits = tile->pattern[y % TILE_HEIGHT];
+
+        for (x = 0; x < TILE_WIDTH; x++, bits <<= 1)
+        {
+            uint16_t value = (bits & 0x80) ? tile->color : tile->background;
+
+            *at++ = value >> 8;
+            *at++ = value;
+        }
+    }
+
+    for (n = 0; n < TILES_MAX_SPRITES; n++)
+    {
+        const Sprite_t *sprite = &sprites[n];
+        uint16_t bits;
+
+        if (!sprite->image || y < sprite->y || y >= sprite->y + sprite->image->height)
+            continue;
+
+        bits = sprite->image->rows[y - sprite->y];
+        for (x = sprite->x; bits; x++, bits <<= 1)
+        {
+            if ((bits & 0x8000) && x >= left && x <= right)
+            {
+                at = pixels + (x - left) * 2;
+                at[0] = sprite->color >> 8;
+                at[1] = sprite->color;
+            }
+        }
+    }
+}
+
+// This function sends cells first to last of a row of the grid in one window
+static void SendRun(int16_t row, int16_t first, int16_t last)
+{
+    int16_t y;
+
+    Crystalfontz128x128_SetDrawFrame(first * TILE_WIDTH, row * TILE_HEIGHT,
+                                     (last + 1) * TILE_WIDTH - 1, (row + 1) * TILE_HEIGHT - 1);
+    HAL_LCD_writeCommand(CM_RAMWR);
+
+    for (y = row * TILE_HEIGHT; y < (row + 1) * TILE_HEIGHT; y++)
+    {
+        ComposeLine(y, first, last);
+        HAL_LCD_writeDataBurst(pixels, (last - first + 1) * TILE_WIDTH * 2);
+    }
+}
+
+//------------------------------------------
+// Tilemap and sprites
+
+void InitTiles()
+{
+    Graphics_initContext(&patternContext, &patternDisplay, &patternFunctions);
+    Graphics_setFont(&patternContext, &g_sFontCmtt16);
+    Graphics_setForegroundColor(&patternContext, 1);
+    Graphics_setBackgroundColor(&patternContext, 0);
+}
+
+void TilesClear(uint32_t color)
+{
+    uint16_t value = TranslateColor(color);
+    unsigned row, column;
+
+    Graphics_clearDisplay(&patternContext);
+    for (row = 0; row < TILE_ROWS; row++)
+    {
+        for (column = 0; column < TILE_COLUMNS; column++)
+            tiles[row][column].background = value;
+        dirty[row] = (1u << TILE_COLUMNS) - 1;
+    }
+
+    for (row = 0; row < TILES_MAX_SPRITES; row++)
+    {
+        sprites[row].image = NULL;
+        drawnSprites[row].image = NULL;
+    }
+}
+
+void TilesPrint(const char *text, unsigned row, unsigned column, uint32_t color, uint32_t background)
+{
+    uint16_t value = TranslateColor(color);
+    uint16_t backgroundValue = TranslateColor(background);
+
+    row %= TILE_ROWS;
+    column %= TILE_COLUMNS;
+
+    for (; *text != '\0'; text++)
+    {
+        Tile_t *tile = &tiles[row][column];
+        Graphics_Rectangle cell = {column * TILE_WIDTH, row * TILE_HEIGHT,
+                                   (column + 1) * TILE_WIDTH - 1, (row + 1) * TILE_HEIGHT - 1};
+        unsigned y;
+
+        // The glyphs of the font are 9 pixels wide: their last column must not clear the first one of the next cell
+        for (y = 0; y < TILE_HEIGHT; y++)
+            tile->pattern[y] = 0;
+        Graphics_setClipRegion(&patternContext, &cell);
+        Graphics_drawString(&patternContext, (int8_t *) text, 1, column * TILE_WIDTH, row * TILE_HEIGHT,
+                            OPAQUE_TEXT);
+        tile->color = value;
+        tile->background = backgroundValue;
+        dirty[row] |= 1u << column;
+
+        if (++column == TILE_COLUMNS)
+        {
+            column = 0;
+            row = (row + 1) % TILE_ROWS;
+        }
+    }
+}
+
+void SpriteShow(unsigned n, const SpriteImage_t *image, uint32_t color, int16_t x, int16_t y)
+{
+    sprites[n].image = image;
+    sprites[n].color = TranslateColor(color);
+    sprites[n].x = x;
+    sprites[n].y = y;
+}
+
+void SpriteMove(unsigned n, int16_t x, int16_t y)
+{
+    sprites[n].x = x;
+    sprites[n].y = y;
+}
+
+void SpriteHide(unsigned n)
+{
+    sprites[n].image = NULL;
+}
+
+uint32_t TilesFrame()
+{
+    uint32_t startBytes = HAL_LCD_byteCount;
+    uint32_t start = GetTimerValue(TIMER32_0_BASE);
+    int16_t row, first, last;
+    unsigned n;
+
+    // A sprite that changed uncovers the cells it was on and covers the ones it is on now
+    for (n = 0; n < TILES_MAX_SPRITES; n++)
+    {
+        if (SpriteChanged(&sprites[n], &drawnSprites[n]))
+        {
+            MarkSprite(&drawnSprites[n]);
+            MarkSprite(&sprites[n]);
+            drawnSprites[n] = sprites[n];
+        }
+    }
+
+    for (row = 0; row < TILE_ROWS; row++)
+    {
+        for (first = 0; first < TILE_COLUMNS; first = last + 1)
+        {
+            if (!(dirty[row] & (1u << first)))
+            {
+                last = first;
+                continue;
+            }
+            for (last = first; last + 1 < TILE_COLUMNS && (dirty[row] & (1u << (last + 1))); last++)
+                ;
+            SendRun(row, first, last);
+        }
+        dirty[row] = 0;
+    }
+
+    // The last byte must be out before the next command changes the D/C line
+    while (UCB0STATW & UCBUSY);
+
+    frames++;
+    lastBytes = HAL_LCD_byteCount - startBytes;
+    lastUS = CyclesToMicroseconds(start - GetTimerValue(TIMER32_0_BASE));
+    if (lastBytes > maxBytes)
+        maxBytes = lastBytes;
+    if (lastUS > maxUS)
+        maxUS = lastUS;
+    return lastBytes;
+}
+
+//------------------------------------------
+// Frame counters
+
+// The lines are:
+//   Frames frames
+//    B last <max     bytes sent
+//    us last <max    time taken, in microseconds
+uint32_t TilesDump(EmitLine_t emit) {
+    char text[20];
+    unsigned i;
+
+    if (frames == 0)
+        return 0;
+
+    i = AppendString(text, 0, "Frames ");
+    AppendNumber(text, i, frames);
+    emit(text, 0);
+
+    i = AppendString(text, 0, " B ");
+    i = AppendNumber(text, i, lastBytes);
+    i = AppendString(text, i, " <");
+    AppendNumber(text, i, maxBytes);
+    emit(text, 1);
+
+    i = AppendString(text, 0, " us ");
+    i = AppendNumber(text, i, lastUS);
+    i = AppendString(text, i, " <");
+    AppendNumber(text, i, maxUS);
+    emit(text, 2);
+    return 3;
+}
@@ -0,0 +1,64 @@
+//------------------------------------------
+// TILES API (Application Programming Interface)
+// This module draws screens made of a background tilemap and a few sprites over it, without a frame buffer.
+// The tilemap is the 16 x 8 grid of text cells of PrintString: each cell is an 8 x 16 pattern of 1 bpp pixels in
+// a foreground and a background color. The sprites are 1 bpp images, up to 16 pixels wide, drawn in one color on
+// top of the tiles, where their pixels are set. They can be anywhere, partly off the screen.
+// The changes are only recorded until TilesFrame, which works out the cells they touched: the cells printed on,
+// and those a sprite covered in the last frame or covers now. Only those cells are sent, each run of them on a
+// row of the grid in one address window, 11 + 256 bytes per cell on the SPI. A 16 x 16 sprite moving by a few
+// pixels touches at most 6 cells where it was and 6 where it is, about 3 KB and 6 ms at 4 MHz: a frame rate of
+// 30 per second leaves most of the SPI free.
+// Nothing is read back from the LCD, so anything else drawn on the screen is lost when a cell under it is sent.
+
+#ifndef TILES_H_
+#define TILES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Format.h>
+
+#define TILES_MAX_SPRITES   8
+
+// The rows of the image, top first. The most significant bit of a row is its leftmost pixel.
+typedef struct {
+    uint8_t         width;      // at most 16
+    uint8_t         height;
+    const uint16_t *rows;
+} SpriteImage_t;
+
+/*
+ * This function sets up the grlib context that renders the text of the tiles. It must be called after GraphicsReady.
+ */
+void InitTiles();
+
+/*
+ * This function starts a new screen: every cell blank in color (a 24-bit RGB color, as in grlib) and every
+ * sprite hidden. The whole screen is sent by the next TilesFrame.
+ */
+void TilesClear(uint32_t color);
+
+/*
+ * This function prints text from cell (row, column) on, in the font of PrintString, wrapping at the end of the row
+ */
+void TilesPrint(const char *text, unsigned row, unsigned column, uint32_t color, uint32_t background);
+
+/*
+ * These functions place sprite n over the tiles, move it and hide it. The image is not copied and must stay
+ * where it is while the sprite is shown. The sprites are drawn in order, so sprite n is over the ones before it.
+ */
+void SpriteShow(unsigned n, const SpriteImage_t *image, uint32_t color, int16_t x, int16_t y);
+void SpriteMove(unsigned n, int16_t x, int16_t y);
+void SpriteHide(unsigned n);
+
+/*
+ * This function sends the cells changed since the last frame and returns the number of bytes it sent
+ */
+uint32_t TilesFrame();
+
+/*
+ * This function formats the frame counters, none before the first frame (see EmitLine_t)
+ */
+uint32_t TilesDump(EmitLine_t emit);
+
+#endif /* TILES_H_ */
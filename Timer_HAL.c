@@ -3,23 +3,38 @@
 // Also known as BUTTON HAL (Hardware Abstraction Layer)
 // HAL is a specific form of API that designs the interface with a certain hardware
 
-#include <TIMER_HAL.h>
+#include <Timer_HAL.h>
+#include <Scheduler.h>
+#include "bsp/Profile.h"
+#include <RamFunc.h>
 
 #define TIMER0_PRESCALER TIMER32_PRESCALER_1
 #define TIMER1_PRESCALER TIMER32_PRESCALER_256
-#define SYS_CLOCK_F 48000000
+
+// Timer32 counts MCLK, which the clock governor divides (see Clock_HAL.h). GetTimerValue scales the counts back to
+// the rate of the fastest MCLK, hz, so that wait cycles, timestamps and run times mean the same at every level.
+// At each change of MCLK, the values of both timers are recorded with what GetTimerValue returned then, and the
+// counts from there on are shifted left by log2(hz / MCLK). The dividers are powers of 2, so this is exact.
+static struct {
+    uint32_t hz;                // MCLK when InitHWTimers is called, the rate of GetTimerValue
+    uint32_t mclk;              // MCLK now
+    unsigned shift;
+    bool     ticking;           // InitTickTimer was called
+    uint32_t counted[2];        // the values of Timer32_0 and Timer32_1 at the last change
+    uint32_t scaled[2];         // and those of GetTimerValue
+} timebase;
 
 /* This function gets the hardware timer (since it needs its prescaler value) and time in milliseconds
  * and returns the number of wait cycles associated with that time.
  * For example, if the system clock is 3 MHz, the prescaler is 1 and TimeInMS is 1000, then the
  * returned value is going to be 3000,000
- * If the number of wait cycles is too big for this software timer to be used, it returns -1
+ * If the number of wait cycles is too big for this software timer to be used, or hwtimer is not one of the
+ * Timer32 modules, it returns -1
  */
 int64_t WaitCycles(uint32_t hwtimer, uint64_t TimeInMS)
 {
-     // This function returns the system clock
-    //uint64_t sysClock = CS_getSMCLK();
-    uint64_t sysClock = SYS_CLOCK_F;
+    // The timers are read through GetTimerValue, which counts at the fastest MCLK whatever the clock now
+    uint64_t sysClock = timebase.hz;
 
     uint8_t  prescalerFlag;
     uint64_t prescalerValue;
@@ -29,6 +44,8 @@ int64_t WaitCycles(uint32_t hwtimer, uint64_t TimeInMS)
         prescalerFlag = TIMER0_PRESCALER;
     else if (hwtimer == TIMER32_1_BASE)
         prescalerFlag = TIMER1_PRESCALER;
+    else
+        return -1;
 
     // The prescaler we get in the previous section is simply a flag. "Control click" on it to see what I mean.
     // We need to turn that into the actual value of the prescaler
@@ -43,6 +60,8 @@ int64_t WaitCycles(uint32_t hwtimer, uint64_t TimeInMS)
     case TIMER32_PRESCALER_256:
         prescalerValue = 256;
         break;
+    default:
+        return -1;
     }
 
     int64_t waitCycles;
@@ -67,18 +86,21 @@ void InitOneShotSWTimer(
 
 void StartOneShotSWTimer(OneShotSWTimer_t* OST)
 {
-    OST->startCounter = Timer32_getValue(OST->hwtimer);
+    OST->startCounter = GetTimerValue(OST->hwtimer);
 }
 
-bool OneShotSWTimerExpired(OneShotSWTimer_t* OST)
+// Every FSM that waits on a software timer polls it, so it runs from SRAM
+RAMFUNC bool OneShotSWTimerExpired(OneShotSWTimer_t* OST)
 {
     bool expired = false;
 
+    PROFILE_ZONE_BEGIN(PROFILE_SWTIMER_EXPIRED)
+
     // HW timer period
     int64_t HWTimerPeriod = UINT32_MAX+ 1;
 
     //This is C2 from notes, while OST->startCounter is C1
-    uint32_t currentCounter = Timer32_getValue(OST->hwtimer);
+    uint32_t currentCounter = GetTimerValue(OST->hwtimer);
 
     int64_t ElapsedCycles =  OST->startCounter - currentCounter;
     if (ElapsedCycles < 0)
@@ -89,11 +111,32 @@ bool OneShotSWTimerExpired(OneShotSWTimer_t* OST)
     else
         expired = false;
 
+    PROFILE_ZONE_END(PROFILE_SWTIMER_EXPIRED)
+
     return expired;
 }
 
 
+// The timers, the scheduler and the ISRs read the timers through this function, so it runs from SRAM
+RAMFUNC uint32_t GetTimerValue(uint32_t hwtimer)
+{
+    unsigned t = (hwtimer == TIMER32_1_BASE);
+
+    return timebase.scaled[t] - ((timebase.counted[t] - Timer32_getValue(hwtimer)) << timebase.shift);
+}
+
+uint32_t CyclesToMicroseconds(uint32_t cycles)
+{
+    return cycles / (timebase.hz / 1000000);
+}
+
 void InitHWTimers() {
+    timebase.hz = CS_getMCLK();
+    timebase.mclk = timebase.hz;
+    timebase.shift = 0;
+    timebase.counted[0] = timebase.scaled[0] = UINT32_MAX;
+    timebase.counted[1] = timebase.scaled[1] = UINT32_MAX;
+
     // The prescaler for each of the timers is defined as a macro
     Timer32_initModule(TIMER32_0_BASE, TIMER0_PRESCALER, TIMER32_32BIT, TIMER32_PERIODIC_MODE);
     Timer32_setCount(TIMER32_0_BASE, UINT32_MAX);
@@ -104,6 +147,45 @@ void InitHWTimers() {
     Timer32_startTimer(TIMER32_1_BASE, false);
 }
 
+// SysTick is a 24-bit down counter clocked by MCLK. At 48 MHz, 10 ms is 480,000 cycles, which fits.
+// Writing VAL clears the count, so that the next period starts from the new reload value.
+static void StartTick()
+{
+    SysTick_disableModule();
+    SysTick_setPeriod(timebase.mclk / 1000 * TICK_PERIOD_MS);
+    SysTick->VAL = 0;
+    SysTick_enableModule();
+}
+
+void TimerClockChanged(uint32_t mclkHz)
+{
+    const uint32_t hwtimers[2] = {TIMER32_0_BASE, TIMER32_1_BASE};
+    unsigned t;
+
+    for (t = 0; t < 2; t++)
+    {
+        uint32_t counted = Timer32_getValue(hwtimers[t]);
 
+        timebase.scaled[t] -= (timebase.counted[t] - counted) << timebase.shift;
+        timebase.counted[t] = counted;
+    }
+
+    timebase.mclk = mclkHz;
+    timebase.shift = 0;
+    while ((mclkHz << timebase.shift) < timebase.hz)
+        timebase.shift++;
+
+    if (timebase.ticking)
+        StartTick();
+}
 
+void InitTickTimer() {
+    timebase.ticking = true;
+    StartTick();
+    SysTick_enableInterrupt();
+}
 
+// The tick has the lowest priority. A button edge that happens in the same period is dispatched first.
+void SysTick_Handler() {
+    PostEvent(EVT_TICK, 0, PRIO_LOW);
+}
@@ -37,6 +37,33 @@ bool OneShotSWTimerExpired(OneShotSWTimer_t* OST);
  */
 void InitHWTimers();
 
+/*
+ * This function returns the value of a hardware timer, scaled to the rate of the fastest MCLK, the one set up
+ * when InitHWTimers was called, whatever MCLK is now (see Clock_HAL.h). The timers must only be read through it.
+ * Timer32_0 has no prescaler and is never reloaded, so it also serves as a free running cycle counter. It counts
+ * down: the cycles elapsed between two readings are earlier - later.
+ */
+uint32_t GetTimerValue(uint32_t hwtimer);
+
+/*
+ * This function converts a number of cycles of Timer32_0, as read with GetTimerValue, into microseconds
+ */
+uint32_t CyclesToMicroseconds(uint32_t cycles);
+
+/*
+ * The clock governor calls this function with interrupts disabled, right after it changed MCLK. The timers go on
+ * at the same scaled rate, and the tick at the same period; the tick that was counting starts over.
+ */
+void TimerClockChanged(uint32_t mclkHz);
+
+// The period of the system tick that drives the scheduler
+#define TICK_PERIOD_MS 10
+
+/*
+ * This function starts the SysTick timer. Every TICK_PERIOD_MS, its ISR posts an EVT_TICK to the scheduler.
+ */
+void InitTickTimer();
+
 
 
 #endif // TIMERS_H_
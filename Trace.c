@@ -0,0 +1,201 @@
+//------------------------------------------
+// TRACE API (Application Programming Interface)
+// Writers reserve a slot by advancing head with an exclusive load/store (LDREX/STREX), so an ISR that
+// preempts a writer simply takes the next slot. The sync field is written last and marks the record as
+// complete. A transfer takes the complete records from tail on, up to TRACE_BLOCK_RECORDS and the end of the
+// ring, and the DMA moves them to UCA0TXBUF; at its end, the DMA ISR clears their sync fields, advances tail and
+// starts the next transfer. A record that is still being written stops the transfer in front of it, so the
+// records leave in the order their slots were reserved.
+// The transmit trigger of eUSCI_A0 is on DMA channel 0, which Render holds while it draws a frame (see
+// DMA_HAL.h). A transfer only starts when the channel is free, and the records wait in the ring meanwhile.
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <DMA_HAL.h>
+#include <Timer_HAL.h>
+#include <Trace.h>
+
+#if TRACE_ENABLE
+
+// The records of a transfer: 256 bytes, 5.6 ms at TRACE_BAUD_RATE, are as long as a frame waits for the channel
+#define TRACE_BLOCK_RECORDS 16
+
+static volatile TraceRecord_t ring[TRACE_RING_SIZE];
+static volatile uint32_t head;          // number of slots ever reserved by writers
+static volatile uint32_t tail;          // number of slots ever sent
+static volatile uint32_t sending;       // number of slots in the running transfer, 0 when the DMA is idle
+static volatile uint32_t dropped;       // number of records lost because the ring was full
+static uint32_t reportedDrops;          // the value of dropped in the last TRACE_DROPPED record
+
+// This function sets *p to desired if it still holds expected. It returns false if *p was changed
+// in the meantime, including by an ISR that ran between the load and the store.
+static bool CompareAndSwap(volatile uint32_t *p, uint32_t expected, uint32_t desired)
+{
+#if defined(__TI_COMPILER_VERSION__)
+    if (__ldrex((void *) p) != expected)
+        return false;
+    return __strex(desired, (void *) p) == 0;
+#else
+    return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static bool WriteRecord(TraceId_t id, uint32_t arg0, uint32_t arg1)
+{
+    uint32_t timestamp = GetTimerValue(TIMER32_0_BASE);
+    uint32_t slot, count;
+    volatile TraceRecord_t *R;
+
+    do
+    {
+        slot = head;
+        if (slot - tail >= TRACE_RING_SIZE)
+        {
+            do
+                count = dropped;
+            while (!CompareAndSwap(&dropped, count, count + 1));
+            return false;
+        }
+    } while (!CompareAndSwap(&head, slot, slot + 1));
+
+    R = &ring[slot % TRACE_RING_SIZE];
+    R->id = id;
+    R->timestamp = timestamp;
+    R->arg0 = arg0;
+    R->arg1 = arg1;
+    R->sync = TRACE_SYNC;
+    return true;
+}
+
+static void TransferDone();
+
+// This function starts a transfer of the complete records from tail on, if DMA channel 0 is free.
+// It is called only when no transfer is going on, with interrupts disabled or from the DMA ISR.
+static void StartTransfer()
+{
+    uint32_t first = tail % TRACE_RING_SIZE;
+    uint32_t count = 0;
+
+    while ((count < TRACE_BLOCK_RECORDS) && (first + count < TRACE_RING_SIZE) &&
+           (ring[first + count].sync == TRACE_SYNC))
+        count++;
+
+    if (count == 0 || !TryAcquireSharedDMA(DMA_CH0_EUSCIA0TX, TransferDone))
+        return;
+
+    sending = count;
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH0_EUSCIA0TX, UDMA_MODE_BASIC, (void *) &ring[first],
+                           (void *) (uintptr_t) UART_getTransmitBufferAddressForDMA(EUSCI_A0_BASE),
+                           count * sizeof(TraceRecord_t));
+    DMA_enableChannel(DMA_SHARED_CHANNEL);
+
+    // As for the SPI of the LCD, the DMA is triggered by the rising edge of UCTXIFG. Once the last byte of the
+    // block before is on its way out, the flag is set and is toggled to request the first byte.
+    while (!(UCA0IFG & UCTXIFG));
+    UCA0IFG &= ~UCTXIFG;
+    UCA0IFG |= UCTXIFG;
+}
+
+// The last byte of the transfer has been written to UCA0TXBUF: the records are free again, and the channel too,
+// unless there are more records and RenderFrame does not wait for it. This is called from the DMA ISR.
+static void TransferDone()
+{
+    uint32_t first = tail % TRACE_RING_SIZE;
+    uint32_t i;
+
+    for (i = 0; i < sending; i++)
+        ring[first + i].sync = 0;
+    tail += sending;
+    sending = 0;
+
+    ReleaseSharedDMA();
+    StartTransfer();
+}
+
+// The UCBRS modulation patterns for the fractional part of the divider N = SMCLK / baud, in ten-thousandths: the
+// last entry whose fraction is not above that of N applies (see the eUSCI chapter of the technical reference
+// manual, "Setting a Baud Rate")
+static const struct {
+    uint16_t fraction;
+    uint8_t  ucbrs;
+} modulation[] = {
+    {0, 0x00},    {529, 0x01},  {715, 0x02},  {835, 0x04},  {1001, 0x08}, {1252, 0x10}, {1430, 0x20},
+    {1670, 0x11}, {2147, 0x21}, {2224, 0x22}, {2503, 0x44}, {3000, 0x25}, {3335, 0x49}, {3575, 0x4A},
+    {3753, 0x52}, {4003, 0x92}, {4286, 0x53}, {4378, 0x55}, {5002, 0xAA}, {5715, 0x6B}, {6003, 0xAD},
+    {6254, 0xB5}, {6432, 0xB6}, {6667, 0xD6}, {7001, 0xB7}, {7147, 0xBB}, {7503, 0xDD}, {7861, 0xED},
+    {8004, 0xEE}, {8333, 0xBF}, {8464, 0xDF}, {8572, 0xEF}, {8751, 0xF7}, {9004, 0xFB}, {9170, 0xFD},
+    {9288, 0xFE},
+};
+
+// Above 16 clocks per bit, the UART oversamples: UCBR is N / 16 and UCBRF the rest. 12 MHz gives N = 26.04, so
+// UCBR = 1, UCBRF = 10 and UCBRS = 0x00; 6 MHz gives N = 13.02, so UCBR = 13 without oversampling.
+static void InitUART(uint32_t smclkHz)
+{
+    uint32_t n = smclkHz / TRACE_BAUD_RATE;
+    uint32_t fraction = (uint64_t) (smclkHz % TRACE_BAUD_RATE) * 10000 / TRACE_BAUD_RATE;
+    unsigned m = 0;
+
+    while (m + 1 < sizeof(modulation) / sizeof(modulation[0]) && modulation[m + 1].fraction <= fraction)
+        m++;
+
+    eUSCI_UART_Config uartConfig =
+    {
+        EUSCI_A_UART_CLOCKSOURCE_SMCLK,
+        (n > 16) ? n / 16 : n,                          // clockPrescalar (UCBR)
+        (n > 16) ? n % 16 : 0,                          // firstModReg (UCBRF)
+        modulation[m].ucbrs,                            // secondModReg (UCBRS)
+        EUSCI_A_UART_NO_PARITY,
+        EUSCI_A_UART_LSB_FIRST,
+        EUSCI_A_UART_ONE_STOP_BIT,
+        EUSCI_A_UART_MODE,
+        (n > 16) ? EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION : EUSCI_A_UART_LOW_FREQUENCY_BAUDRATE_GENERATION
+    };
+
+    UART_initModule(EUSCI_A0_BASE, &uartConfig);
+    UART_enableModule(EUSCI_A0_BASE);
+}
+
+void InitTrace()
+{
+    head = 0;
+    tail = 0;
+    sending = 0;
+    dropped = 0;
+    reportedDrops = 0;
+
+    GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P1, GPIO_PIN2 | GPIO_PIN3,
+                                               GPIO_PRIMARY_MODULE_FUNCTION);
+    InitUART(CS_getSMCLK());
+    InitDMA();
+}
+
+void TraceRecord(TraceId_t id, uint32_t arg0, uint32_t arg1)
+{
+    WriteRecord(id, arg0, arg1);
+}
+
+void TraceFlush()
+{
+    uint32_t lost = dropped;
+
+    if ((lost != reportedDrops) && WriteRecord(TRACE_DROPPED, lost, 0))
+        reportedDrops = lost;
+
+    bool wasDisabled = Interrupt_disableMaster();
+    if (sending == 0)
+        StartTransfer();
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+// The transfer is done with the last byte when it is written to UCA0TXBUF, but the UART is still sending it
+bool TraceIdle()
+{
+    return sending == 0 && !(UCA0STATW & UCBUSY);
+}
+
+// UART_initModule resets the UART, which is idle
+void TraceClockChanged(uint32_t smclkHz)
+{
+    InitUART(smclkHz);
+}
+
+#endif // TRACE_ENABLE
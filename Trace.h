@@ -0,0 +1,99 @@
+//------------------------------------------
+// TRACE API (Application Programming Interface)
+// This module records what the application does as a stream of small binary records in a RAM ring.
+// Each record has a timestamp, an event id and two arguments. Records can be written from any context,
+// ISRs included, without disabling interrupts. The ring is drained by DMA into eUSCI_A0, which is the UART of the
+// LaunchPad backchannel (the XDS110 "Application/User UART" on the host), a block of records at a time.
+// On the host, host/tracedecode turns the stream back into a timeline.
+// Build with TRACE_ENABLE=0 (the Release configuration does) and the trace points compile out.
+//
+// This header is also included by the host decoder, so it must not depend on driverlib.
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+// The trace events: X(id, name). New events are added at the end, so that old recordings still decode.
+#define TRACE_EVENTS(X)                                                         \
+    X(TRACE_DROPPED,       "dropped")      /* arg0: records lost so far       */ \
+    X(TRACE_EVENT_POSTED,  "post")         /* arg0: EventType_t, arg1: arg     */ \
+    X(TRACE_TASK_BEGIN,    "task+")        /* arg0: task id, arg1: EventType_t */ \
+    X(TRACE_TASK_END,      "task-")        /* arg0: task id, arg1: cycles      */ \
+    X(TRACE_SCREEN,        "screen")       /* arg0: old state, arg1: new state */ \
+    X(TRACE_COLOR_MIX,     "mix")          /* arg0: red|green<<1|blue<<2       */ \
+    X(TRACE_GUESS,         "guess")        /* arg0: arrow position, arg1: choice */ \
+    X(TRACE_OVERRUN,       "overrun")      /* arg0: task id, arg1: microseconds */
+
+#define TRACE_ENUM(id, name) id,
+typedef enum {TRACE_EVENTS(TRACE_ENUM) TRACE_ID_COUNT} TraceId_t;
+#undef TRACE_ENUM
+
+// Every record starts with these two bytes (0xA5 0x5A on the wire), so the decoder can find the
+// record boundaries in the middle of a stream
+#define TRACE_SYNC 0x5AA5
+
+// A record is 16 bytes, little endian, in the same layout in RAM and on the wire
+typedef struct {
+    uint16_t sync;          // TRACE_SYNC once the record is complete
+    uint16_t id;            // TraceId_t
+    uint32_t timestamp;     // value of the free running Timer32_0 (see Timer_HAL.h), it counts down
+    uint32_t arg0;
+    uint32_t arg1;
+} TraceRecord_t;
+
+// The number of records in the ring. It must be a power of 2.
+#define TRACE_RING_SIZE 64
+
+// The backchannel UART speed, 8N1. The ring drains at about 2880 records per second at this speed.
+// The dividers are computed from SMCLK, at init and at every change of the clock (see Clock_HAL.h).
+#define TRACE_BAUD_RATE 460800
+
+#if TRACE_ENABLE
+
+#define TRACE(id, arg0, arg1) TraceRecord((id), (arg0), (arg1))
+
+/*
+ * This function configures eUSCI_A0 as a UART on P1.2/P1.3, and the DMA that feeds it.
+ */
+void InitTrace();
+
+/*
+ * This function returns true if no record is being sent, so that the clock of the UART can be changed
+ */
+bool TraceIdle();
+
+/*
+ * The clock governor calls this function with interrupts disabled, once TraceIdle, right after it changed SMCLK.
+ * It sets the dividers of the UART for TRACE_BAUD_RATE at the new clock.
+ */
+void TraceClockChanged(uint32_t smclkHz);
+
+/*
+ * This function writes one record into the ring. It can be called from any context.
+ * If the ring is full, the record is dropped and counted; the count is sent in a TRACE_DROPPED record.
+ */
+void TraceRecord(TraceId_t id, uint32_t arg0, uint32_t arg1);
+
+/*
+ * This function starts sending the complete records of the ring, unless a transfer is already going on or
+ * RenderFrame holds the DMA channel. The DMA ISR keeps the transfers going while there are records and the
+ * channel is not wanted, so this only needs to be called once in a while, e.g. on every tick.
+ */
+void TraceFlush();
+
+#else
+
+#define TRACE(id, arg0, arg1)
+#define InitTrace()
+#define TraceFlush()
+#define TraceIdle() true
+#define TraceClockChanged(smclkHz)
+
+#endif // TRACE_ENABLE
+
+#endif // TRACE_H_
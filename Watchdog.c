@@ -0,0 +1,234 @@
+//------------------------------------------
+// WATCHDOG API (Application Programming Interface)
+// The records live in retained, which is not initialized by the C startup code: the TI compiler puts it in
+// .TI.noinit, which msp432p401r.cmd places in SRAM, and GCC in .noinit. The SRAM keeps its content through the
+// hard reset of the watchdog, but holds anything after a power-up, so the records are only trusted if both check
+// words are right. WDT_A is set up for a hard reset, which also resets the eUSCI that may have caused the hang.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Timer_HAL.h>
+#include <Trace.h>
+#include <Format.h>
+#include <Watchdog.h>
+
+#if WATCHDOG_ENABLE
+
+#define RETAINED_MAGIC  0x57444F47      // "WDOG"
+
+// The task that was running is one of the tasks, or one of these
+#define RUNNING_NONE    -1              // between tasks: the scheduler, an ISR or the boot
+#define RUNNING_UNKNOWN -2              // the records were lost, or the last reset was not the watchdog's
+
+typedef struct {
+    uint8_t  taskId;
+    uint16_t boot;                      // the number of the boot it happened in
+    uint32_t uptimeMS;                  // since that boot
+    uint32_t us;                        // the run time
+} Overrun_t;
+
+typedef struct {
+    uint32_t  magic;                    // RETAINED_MAGIC
+    uint16_t  boots;
+    uint16_t  resets;                   // by the watchdog
+    int8_t    running;                  // the task running now
+    int8_t    hung;                     // the task that was running at the last reset, if it was the watchdog's
+    uint32_t  runningSinceMS;
+    uint32_t  hungSinceMS;              // since the boot before that reset
+    uint32_t  overruns;                 // since the records were started; the last WATCHDOG_LOG_SIZE are in log
+    Overrun_t log[WATCHDOG_LOG_SIZE];
+    uint32_t  check;                    // ~RETAINED_MAGIC
+} Retained_t;
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma NOINIT(retained)
+static Retained_t retained;
+#else
+static Retained_t retained __attribute__((section(".noinit")));
+#endif
+
+// The supervised tasks, of this boot only
+static struct {
+    const char *names[MAX_TASKS];
+    uint32_t budgetUS[MAX_TASKS];
+    uint32_t supervised;                // a bit for each supervised task
+    uint32_t checkedIn;                 // and for each that completed a run since the last kick
+    uint32_t uptimeMS;                  // counted in ticks
+} supervisor;
+
+void InitWatchdog()
+{
+    bool watchdogReset = ResetCtl_getHardResetSource() & RESET_SRC_1;
+
+    ResetCtl_clearHardResetSource(RESET_SRC_1);
+
+    if (retained.magic != RETAINED_MAGIC || retained.check != ~RETAINED_MAGIC)
+    {
+        retained.magic = RETAINED_MAGIC;
+        retained.check = ~RETAINED_MAGIC;
+        retained.boots = 0;
+        retained.resets = 0;
+        retained.overruns = 0;
+        retained.running = RUNNING_NONE;
+        retained.hung = RUNNING_UNKNOWN;
+    }
+
+    if (watchdogReset)
+    {
+        retained.resets++;
+        retained.hung = retained.running;
+        retained.hungSinceMS = retained.runningSinceMS;
+    }
+    else
+        retained.hung = RUNNING_UNKNOWN;
+
+    retained.boots++;
+    retained.running = RUNNING_NONE;
+}
+
+void SuperviseTask(int taskId, const char *name, uint32_t budgetUS)
+{
+    if (taskId < 0 || taskId >= MAX_TASKS)
+        return;
+
+    supervisor.names[taskId] = name;
+    supervisor.budgetUS[taskId] = budgetUS;
+    supervisor.supervised |= 1 << taskId;
+}
+
+void StartWatchdog()
+{
+    WDT_A_initWatchdogTimer(WDT_A_CLOCKSOURCE_ACLK, WDT_A_CLOCKITERATIONS_32K);
+    WDT_A_setTimeoutReset(WDT_A_HARD_RESET);
+    WDT_A_startTimer();
+}
+
+void SupervisorBegin(int taskId)
+{
+    retained.running = taskId;
+    retained.runningSinceMS = supervisor.uptimeMS;
+}
+
+void SupervisorEnd(int taskId, uint32_t cycles)
+{
+    uint32_t us;
+
+    retained.running = RUNNING_NONE;
+    if (!(supervisor.supervised & (1 << taskId)))
+        return;
+
+    supervisor.checkedIn |= 1 << taskId;
+
+    us = CyclesToMicroseconds(cycles);
+    if (us > supervisor.budgetUS[taskId])
+    {
+        Overrun_t *O = &retained.log[retained.overruns % WATCHDOG_LOG_SIZE];
+
+        O->taskId = taskId;
+        O->boot = retained.boots;
+        O->uptimeMS = supervisor.uptimeMS;
+        O->us = us;
+        retained.overruns++;
+        TRACE(TRACE_OVERRUN, taskId, us);
+    }
+}
+
+// The kick is in the scheduler loop rather than in an ISR, so that it also proves that the loop goes round
+void SupervisorEventDone(const Event_t *event)
+{
+    if (event->type == EVT_TICK)
+        supervisor.uptimeMS += TICK_PERIOD_MS;
+
+    if (supervisor.supervised && supervisor.checkedIn == supervisor.supervised)
+    {
+        WDT_A_clearTimer();
+        supervisor.checkedIn = 0;
+    }
+}
+
+//------------------------------------------
+// Records
+
+// The tasks are added in the same order at every boot, so the names of this boot are those of the records
+static unsigned AppendTask(char *line, unsigned i, int taskId)
+{
+    if (taskId == RUNNING_NONE)
+        return AppendString(line, i, "no task");
+    if (supervisor.names[taskId])
+        return AppendStringMax(line, i, supervisor.names[taskId], 7);
+    i = AppendString(line, i, "task ");
+    return AppendNumber(line, i, taskId);
+}
+
+// This function appends a run time of at most 7 characters: in milliseconds, or in seconds from 1 s
+static unsigned AppendRunTime(char *line, unsigned i, uint32_t us)
+{
+    if (us < 1000000)
+        return AppendThousandths(line, i, us, "ms");
+    return AppendThousandths(line, i, us / 1000, "s");
+}
+
+// This function appends an uptime of at most 7 characters: in seconds, or in whole hours from 10,000 s
+static unsigned AppendUptime(char *line, unsigned i, uint32_t ms)
+{
+    if (ms < 10000000)
+        return AppendThousandths(line, i, ms, "s");
+    i = AppendNumber(line, i, ms / 3600000);
+    return AppendString(line, i, "h");
+}
+
+// The lines are:
+//   WDT #b r n          the number of this boot, and of the resets by the watchdog, up to 999
+//    hung task          the task running at the last reset, if it was the watchdog's
+//    @seconds           since the boot before it, when that task started
+//   Overruns n          and then the last ones, newest first:
+//    task ms            the run time
+//    #boot @seconds     when it happened
+// The names of the tasks are cut to 7 characters, so that every line fits in 16.
+uint32_t WatchdogDump(EmitLine_t emit) {
+    char line[20];
+    uint32_t n = 0;
+    unsigned i, k, count;
+
+    i = AppendString(line, 0, "WDT #");
+    i = AppendNumber(line, i, retained.boots);
+    i = AppendString(line, i, " r ");
+    AppendNumber(line, i, (retained.resets < 999) ? retained.resets : 999);
+    emit(line, n++);
+
+    if (retained.hung != RUNNING_UNKNOWN)
+    {
+        i = AppendString(line, 0, " hung ");
+        AppendTask(line, i, retained.hung);
+        emit(line, n++);
+
+        i = AppendString(line, 0, " @");
+        AppendUptime(line, i, retained.hungSinceMS);
+        emit(line, n++);
+    }
+
+    i = AppendString(line, 0, "Overruns ");
+    AppendShortNumber(line, i, (retained.overruns < 99999999) ? retained.overruns : 99999999, "k");
+    emit(line, n++);
+
+    count = (retained.overruns < WATCHDOG_LOG_SIZE) ? retained.overruns : WATCHDOG_LOG_SIZE;
+    for (k = 1; k <= count; k++)
+    {
+        const Overrun_t *O = &retained.log[(retained.overruns - k) % WATCHDOG_LOG_SIZE];
+
+        i = AppendString(line, 0, " ");
+        i = AppendTask(line, i, O->taskId);
+        i = AppendString(line, i, " ");
+        AppendRunTime(line, i, O->us);
+        emit(line, n++);
+
+        i = AppendString(line, 0, " #");
+        i = AppendNumber(line, i, O->boot);
+        i = AppendString(line, i, " @");
+        AppendUptime(line, i, O->uptimeMS);
+        emit(line, n++);
+    }
+
+    return n;
+}
+
+#endif // WATCHDOG_ENABLE
@@ -0,0 +1,81 @@
+//------------------------------------------
+// WATCHDOG API (Application Programming Interface)
+// This module supervises the tasks of the scheduler with WDT_A. Each supervised task has a budget in
+// microseconds. The scheduler reports every run of a task, and the watchdog is kicked after an event only once
+// every supervised task has completed a run since the last kick. A task stuck in a busy loop, such as a wait on
+// UCBUSY that never ends, or an ISR that never returns, stops the kicks, and WDT_A resets the MCU after
+// WATCHDOG_TIMEOUT_MS. The tasks that subscribe to EVT_TICK run at least every TICK_PERIOD_MS, so they are the
+// ones to supervise; a task that only runs on button events would starve the watchdog.
+// A run that takes longer than its budget is an overrun. It does not stop the kicks, but it is recorded, with the
+// boot it happened in and the time since that boot, in a region of RAM that the C startup code leaves alone and
+// that survives the reset. So does the task that was running when the watchdog reset the MCU. The diagnostics
+// screen shows them after the reset, and so does a debugger, in the variable retained of Watchdog.c.
+// Build with WATCHDOG_ENABLE=0 to stop at breakpoints without being reset, and the supervision compiles out.
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Scheduler.h>
+#include <Format.h>
+
+#ifndef WATCHDOG_ENABLE
+#define WATCHDOG_ENABLE 1
+#endif
+
+// WDT_A counts 32K periods of ACLK, which BSP_Clock_InitFastest leaves on the 32768 Hz REFO
+#define WATCHDOG_TIMEOUT_MS 1000
+
+// The number of most recent overruns kept across resets
+#define WATCHDOG_LOG_SIZE 8
+
+#if WATCHDOG_ENABLE
+
+#define SUPERVISOR_BEGIN(taskId)        SupervisorBegin(taskId)
+#define SUPERVISOR_END(taskId, cycles)  SupervisorEnd((taskId), (cycles))
+#define SUPERVISOR_EVENT_DONE(event)    SupervisorEventDone(event)
+
+/*
+ * This function reads the records of the previous boots, and finds out whether the watchdog caused the reset.
+ * It must be called at the start of main, before anything that could hang.
+ */
+void InitWatchdog();
+
+/*
+ * This function supervises a task of the scheduler, unless taskId is -1. name is shown on the diagnostics
+ * screen, at most 7 characters, and must stay where it is.
+ */
+void SuperviseTask(int taskId, const char *name, uint32_t budgetUS);
+
+/*
+ * This function starts WDT_A. It must be called once the supervised tasks are added, when the slow boot steps
+ * such as the benchmark are done.
+ */
+void StartWatchdog();
+
+/*
+ * The scheduler calls these functions around each run of a task, and after all the tasks of an event have run
+ */
+void SupervisorBegin(int taskId);
+void SupervisorEnd(int taskId, uint32_t cycles);
+void SupervisorEventDone(const Event_t *event);
+
+/*
+ * This function formats the records (see EmitLine_t)
+ */
+uint32_t WatchdogDump(EmitLine_t emit);
+
+#else
+
+#define SUPERVISOR_BEGIN(taskId)
+#define SUPERVISOR_END(taskId, cycles)
+#define SUPERVISOR_EVENT_DONE(event)
+#define InitWatchdog()
+#define SuperviseTask(taskId, name, budgetUS) ((void) (taskId))
+#define StartWatchdog()
+static inline uint32_t WatchdogDump(EmitLine_t emit) { return 0; }
+
+#endif // WATCHDOG_ENABLE
+
+#endif /* WATCHDOG_H_ */
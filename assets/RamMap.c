@@ -0,0 +1,33 @@
+// Generated by host/rammap from colorTest.size. Do not edit.
+// The SRAM of each module of the application, .data and .bss, the largest first, as a 32-bit build
+// of the host lays it out. Regenerate it from the linker map of the CCS build for the exact one.
+
+#include <RamUsage.h>
+
+const RamModule_t RamModules[] = {
+    {"Render", 8780},
+    {"Crystalfontz128x128_ST7735", 4148},
+    {"Tiles", 3116},
+    {"Benchmark", 1377},
+    {"colorTest_main", 1261},
+    {"Trace", 1056},
+    {"Reaction", 976},
+    {"Scheduler", 880},
+    {"Latency", 724},
+    {"DMA_HAL", 512},
+    {"Profile", 476},
+    {"Crypto_HAL", 313},
+    {"StripChart", 256},
+    {"Watchdog", 200},
+    {"Buttons_HAL", 128},
+    {"Display_HAL", 100},
+    {"ADC_HAL", 64},
+    {"FlashLog", 48},
+    {"Timer_HAL", 32},
+    {"Buzzer_HAL", 24},
+    {"Clock_HAL", 20},
+    {"HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735", 12},
+};
+
+const unsigned RamModuleCount = 22;
+const bool RamModulesEstimated = true;
@@ -0,0 +1,11 @@
+// Generated by host/assetc from Swatches.txt. Do not edit.
+
+#ifndef SWATCHES_H_
+#define SWATCHES_H_
+
+#include <Image.h>
+
+extern const Image_t ImageSwatches;
+extern const uint16_t ImageSwatchesRaw[];
+
+#endif /* SWATCHES_H_ */
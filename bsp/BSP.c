@@ -811,9 +811,12 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_GMCTRP1 0xE0
 #define ST7735_GMCTRN1 0xE1
 
+// host/test/bsptest.c includes this file with pins of its own
+#ifndef TFT_CS
 #define TFT_CS                  (*((volatile uint8_t *)(0x42000000+32*0x4C42+4*0)))  /* Port 5 Output, bit 0 is TFT CS */
 #define DC                      (*((volatile uint8_t *)(0x42000000+32*0x4C22+4*7)))  /* Port 3 Output, bit 7 is DC */
 #define RESET                   (*((volatile uint8_t *)(0x42000000+32*0x4C42+4*7)))  /* Port 5 Output, bit 7 is RESET*/
+#endif
 
 // standard ascii 5x7 font
 // originally from glcdfont.c from Adafruit project
@@ -1087,37 +1090,78 @@ static int16_t _height = ST7735_TFTHEIGHT;
 // sent.  The eUSCI module has no hardware input or output
 // FIFOs, so this implementation is much simpler than it was
 // for the Tiva LaunchPads.
-// All operations wait until all data has been sent,
-// configure the Data/Command pin, queue the message, and
-// return the reply once it comes in.
+// The LCD is driven in transactions.  lcdBegin() pulls TFT_CS
+// low, and it stays low for a whole sequence of commands and
+// data until lcdEnd(), which puts it back the way lcdBegin()
+// found it.  After BSP_LCD_Init() that is high; a program that
+// drives the LCD with the Crystalfontz HAL, which keeps the
+// same pin (LCD_CS) low all the time, finds it selected again.
+// Each data byte only waits for room in UCB0TXBUF, whose double
+// buffer keeps the shift register busy, so the bytes go out
+// back to back.  The replies of the LCD are not needed:
+// UCB0RXBUF is read once, in lcdEnd(), which clears UCRXIFG and
+// the overrun flag.  Only a command waits for the bus to be
+// idle, before and after its byte, because the Data/Command pin
+// changes around it.
+// At 4 MHz, one byte takes 96 bus clocks of 48 MHz: the
+// transport runs the SPI at its 500,000 bytes/s, where waiting
+// for the reply of each byte and toggling TFT_CS left gaps
+// between them.
+
+// Bytes sent to the LCD, for the benchmarks
+uint32_t BSP_LCD_ByteCount;
+
+// TFT_CS before the transaction, restored by lcdEnd()
+static uint8_t IdleCS;
+
+// This is a helper function that starts a transaction.
+// Assumes: UCB0 and ports have already been initialized and enabled
+void static lcdBegin(void) {
+  IdleCS = TFT_CS;
+  TFT_CS = 0x00;
+}
 
 // This is a helper function that sends an 8-bit command to the LCD.
 // Inputs: c  8-bit code to transmit
-// Outputs: 8-bit reply
-// Assumes: UCB0 and ports have already been initialized and enabled
-uint8_t static writecommand(uint8_t c) {
-  while((UCB0IFG&0x0002)==0x0000){};    // wait until UCB0TXBUF empty
+// Outputs: none
+void static lcdCommand(uint8_t c) {
+  while(UCB0STATW&0x0001){};            // wait until the bytes before are shifted out (UCBUSY)
   DC = 0x00;
-  TFT_CS = 0x00;
   UCB0TXBUF = c;                        // command out
-  while((UCB0IFG&0x0001)==0x0000){};    // wait until UCB0RXBUF full
-  TFT_CS = 0x01;
-  return UCB0RXBUF;                     // return the response
+  while(UCB0STATW&0x0001){};            // wait until it is shifted out
+  DC = 0x01;
+  BSP_LCD_ByteCount = BSP_LCD_ByteCount + 1;
 }
 
-
 // This is a helper function that sends a piece of 8-bit data to the LCD.
 // Inputs: c  8-bit data to transmit
-// Outputs: 8-bit reply
-// Assumes: UCB0 and ports have already been initialized and enabled
-uint8_t static writedata(uint8_t c) {
+// Outputs: none
+void static lcdData(uint8_t c) {
   while((UCB0IFG&0x0002)==0x0000){};    // wait until UCB0TXBUF empty
-  DC = 0x01;
-  TFT_CS = 0x00;
   UCB0TXBUF = c;                        // data out
-  while((UCB0IFG&0x0001)==0x0000){};    // wait until UCB0RXBUF full
-  TFT_CS = 0x01;
-  return UCB0RXBUF;                     // return the response
+  BSP_LCD_ByteCount = BSP_LCD_ByteCount + 1;
+}
+
+// This is a helper function that sends count pixels of one color,
+// most significant byte first.
+// Requires 2*count bytes of transmission
+void static lcdColor(uint16_t color, uint32_t count) {
+  uint8_t hi = color >> 8, lo = color;
+  BSP_LCD_ByteCount = BSP_LCD_ByteCount + 2*count;
+  while(count--){
+    while((UCB0IFG&0x0002)==0x0000){};  // wait until UCB0TXBUF empty
+    UCB0TXBUF = hi;
+    while((UCB0IFG&0x0002)==0x0000){};
+    UCB0TXBUF = lo;
+  }
+}
+
+// This is a helper function that ends a transaction once its
+// last byte has been sent.
+void static lcdEnd(void) {
+  while(UCB0STATW&0x0001){};            // wait until the last byte is shifted out (UCBUSY)
+  (void)UCB0RXBUF;                      // drop the replies; this clears UCRXIFG and UCOE
+  TFT_CS = IdleCS;
 }
 
 
@@ -1144,7 +1188,7 @@ uint8_t static writedata(uint8_t c) {
 #endif
 
 
-// Rather than a bazillion writecommand() and writedata() calls, screen
+// Rather than a bazillion lcdCommand() and lcdData() calls, screen
 // initialization commands and arguments are organized in these tables
 // stored in ROM.  The table may look bulky, but that's mostly the
 // formatting -- storage-wise this is hundreds of bytes more compact
@@ -1292,13 +1336,15 @@ void static commandList(const uint8_t *addr) {
 
   numCommands = *(addr++);               // Number of commands to follow
   while(numCommands--) {                 // For each command...
-    writecommand(*(addr++));             //   Read, issue command
+    lcdBegin();
+    lcdCommand(*(addr++));               //   Read, issue command
     numArgs  = *(addr++);                //   Number of args to follow
     ms       = numArgs & DELAY;          //   If hibit set, delay follows args
     numArgs &= ~DELAY;                   //   Mask out delay bit
     while(numArgs--) {                   //   For each argument...
-      writedata(*(addr++));              //     Read, issue argument
+      lcdData(*(addr++));                //     Read, issue argument
     }
+    lcdEnd();
 
     if(ms) {
       ms = *(addr++);             // Read post-command delay time (ms)
@@ -1390,8 +1436,10 @@ void static ST7735_InitR(enum initRFlags option) {
 
   // if black, change MADCTL color filter
   if (option == INITR_BLACKTAB) {
-    writecommand(ST7735_MADCTL);
-    writedata(0xC0);
+    lcdBegin();
+    lcdCommand(ST7735_MADCTL);
+    lcdData(0xC0);
+    lcdEnd();
   }
 //  TabColor = option;
   BSP_LCD_SetCursor(0,0);
@@ -1414,30 +1462,25 @@ void BSP_LCD_Init(void){
 // Set the region of the screen RAM to be modified
 // Pixel colors are sent left to right, top to bottom
 // (same as Font table is encoded; different from regular bitmap)
+// This starts a transaction: the caller sends the pixels and
+// then calls lcdEnd().
 // Requires 11 bytes of transmission
 void static setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
 
-  writecommand(ST7735_CASET); // Column addr set
-  writedata(0x00);
-  writedata(x0+ColStart);     // XSTART
-  writedata(0x00);
-  writedata(x1+ColStart);     // XEND
+  lcdBegin();
+  lcdCommand(ST7735_CASET); // Column addr set
+  lcdData(0x00);
+  lcdData(x0+ColStart);     // XSTART
+  lcdData(0x00);
+  lcdData(x1+ColStart);     // XEND
 
-  writecommand(ST7735_RASET); // Row addr set
-  writedata(0x00);
-  writedata(y0+RowStart);     // YSTART
-  writedata(0x00);
-  writedata(y1+RowStart);     // YEND
+  lcdCommand(ST7735_RASET); // Row addr set
+  lcdData(0x00);
+  lcdData(y0+RowStart);     // YSTART
+  lcdData(0x00);
+  lcdData(y1+RowStart);     // YEND
 
-  writecommand(ST7735_RAMWR); // write to RAM
-}
-
-
-// Send two bytes of data, most significant byte first
-// Requires 2 bytes of transmission
-void static pushColor(uint16_t color) {
-  writedata((uint8_t)(color >> 8));
-  writedata((uint8_t)color);
+  lcdCommand(ST7735_RAMWR); // write to RAM
 }
 
 
@@ -1459,7 +1502,8 @@ void BSP_LCD_DrawPixel(int16_t x, int16_t y, uint16_t color) {
 //  setAddrWindow(x,y,x+1,y+1); // original code, bug???
   setAddrWindow(x,y,x,y);
 
-  pushColor(color);
+  lcdColor(color, 1);
+  lcdEnd();
 }
 
 
@@ -1473,17 +1517,15 @@ void BSP_LCD_DrawPixel(int16_t x, int16_t y, uint16_t color) {
 //        color 16-bit color, which can be produced by BSP_LCD_Color565()
 // Output: none
 void BSP_LCD_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
   if((x >= _width) || (y >= _height)) return;
   if((y+h-1) >= _height) h = _height-y;
+  if(h <= 0) return;
   setAddrWindow(x, y, x, y+h-1);
 
-  while (h--) {
-    writedata(hi);
-    writedata(lo);
-  }
+  lcdColor(color, h);
+  lcdEnd();
 }
 
 
@@ -1497,17 +1539,15 @@ void BSP_LCD_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 //        color 16-bit color, which can be produced by BSP_LCD_Color565()
 // Output: none
 void BSP_LCD_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
   if((x >= _width) || (y >= _height)) return;
   if((x+w-1) >= _width)  w = _width-x;
+  if(w <= 0) return;
   setAddrWindow(x, y, x+w-1, y);
 
-  while (w--) {
-    writedata(hi);
-    writedata(lo);
-  }
+  lcdColor(color, w);
+  lcdEnd();
 }
 
 
@@ -1532,21 +1572,17 @@ void BSP_LCD_FillScreen(uint16_t color) {
 //        color 16-bit color, which can be produced by BSP_LCD_Color565()
 // Output: none
 void BSP_LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
 
   // rudimentary clipping (drawChar w/big text requires this)
   if((x >= _width) || (y >= _height)) return;
   if((x + w - 1) >= _width)  w = _width  - x;
   if((y + h - 1) >= _height) h = _height - y;
+  if((w <= 0) || (h <= 0)) return;   // lcdColor would take the negative count for billions of pixels
 
   setAddrWindow(x, y, x+w-1, y+h-1);
 
-  for(y=h; y>0; y--) {
-    for(x=w; x>0; x--) {
-      writedata(hi);
-      writedata(lo);
-    }
-  }
+  lcdColor(color, (uint32_t)w*h);
+  lcdEnd();
 }
 
 
@@ -1629,25 +1665,69 @@ void BSP_LCD_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w,
   for(y=0; y<h; y=y+1){
     for(x=0; x<w; x=x+1){
                                         // send the top 8 bits
-      writedata((uint8_t)(image[i] >> 8));
+      lcdData((uint8_t)(image[i] >> 8));
                                         // send the bottom 8 bits
-      writedata((uint8_t)image[i]);
+      lcdData((uint8_t)image[i]);
       i = i + 1;                        // go to the next pixel
     }
     i = i + skipC;
     i = i - 2*originalWidth;
   }
+  lcdEnd();
+}
+
+
+// Send one row of pixels of a glyph: the 5 columns of bits of the
+// font, then the blank column, each column size pixels wide.
+// Columns of the same color are sent as one run.
+// Requires 2*6*size bytes of transmission
+void static streamGlyphRow(const uint8_t *glyph, uint8_t line, uint16_t textColor, uint16_t bgColor, uint8_t size){
+  int32_t col, run = 0;
+  uint16_t color = bgColor, next;
+  for(col=0; col<6; col=col+1){
+    next = ((col < 5) && (glyph[col]&line)) ? textColor : bgColor;
+    if((next != color) && run){
+      lcdColor(color, run*size);
+      run = 0;
+    }
+    color = next;
+    run = run + 1;
+  }
+  lcdColor(color, run*size);
+}
+
+
+// Fill a rectangle that may be partly off the screen on any side
+void static fillClipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  if(x < 0){
+    w = w + x;
+    x = 0;
+  }
+  if(y < 0){
+    h = h + y;
+    y = 0;
+  }
+  if((w > 0) && (h > 0)){
+    BSP_LCD_FillRect(x, y, w, h, color);
+  }
 }
 
 
 //------------BSP_LCD_DrawCharS------------
 // Simple character draw function.  This is the same function from
-// Adafruit_GFX.c but adapted for this processor.  However, each call
-// to BSP_LCD_DrawPixel() calls setAddrWindow(), which needs to send
-// many extra data and commands.  If the background color is the same
-// as the text color, no background will be printed, and text can be
-// drawn right over existing images without covering them with a box.
-// Requires (11 + 2*size*size)*6*8 bytes of transmission (image fully on screen; textcolor != bgColor)
+// Adafruit_GFX.c but adapted for this processor.  If the background
+// color is the same as the text color, no background will be
+// printed, and text can be drawn right over existing images without
+// covering them with a box.
+// A character that is fully on the screen and has a background is
+// drawn like BSP_LCD_DrawChar(), in one address window. Otherwise
+// each vertical run of pixels of one color in a column of the font
+// is drawn as one rectangle, clipped to the screen.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (image fully on screen; textcolor != bgColor)
+//   size 1: 107 bytes, where one BSP_LCD_DrawPixel() per pixel took (11 + 2)*6*8 = 624
+//   size 2: 395 bytes, where one BSP_LCD_FillRect() per pixel took (11 + 2*4)*6*8 = 912
+// Requires (11 + 2*size*size*n) bytes for each vertical run of n pixels otherwise
+//   'A' in size 1, transparent: 8 runs of 16 pixels, 120 bytes, where one BSP_LCD_DrawPixel() per pixel took 16*13 = 208
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -1657,33 +1737,35 @@ void BSP_LCD_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w,
 // Output: none
 void BSP_LCD_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
   uint8_t line; // vertical column of pixels of character in font
-  int32_t i, j;
+  int32_t i, j, start;
   if((x >= _width)            || // Clip right
      (y >= _height)           || // Clip bottom
      ((x + 6 * size - 1) < 0) || // Clip left
      ((y + 8 * size - 1) < 0))   // Clip top
     return;
 
+  if((bgColor != textColor) && (x >= 0) && (y >= 0) &&
+     ((x + 6*size - 1) < _width) && ((y + 8*size - 1) < _height)){
+    BSP_LCD_DrawChar(x, y, c, textColor, bgColor, size);
+    return;
+  }
+
   for (i=0; i<6; i++ ) {
     if (i == 5)
       line = 0x0;
     else
       line = Font[(c*5)+i];
-    for (j = 0; j<8; j++) {
-      if (line & 0x1) {
-        if (size == 1) // default size
-          BSP_LCD_DrawPixel(x+i, y+j, textColor);
-        else {  // big size
-          BSP_LCD_FillRect(x+(i*size), y+(j*size), size, size, textColor);
-        }
-      } else if (bgColor != textColor) {
-        if (size == 1) // default size
-          BSP_LCD_DrawPixel(x+i, y+j, bgColor);
-        else {  // big size
-          BSP_LCD_FillRect(x+i*size, y+j*size, size, size, bgColor);
+    // j walks down the column; a run ends where the bit changes
+    start = 0;
+    for (j = 1; j<=8; j++) {
+      if ((j == 8) || (((line >> j) ^ (line >> start)) & 0x1)) {
+        if ((line >> start) & 0x1) {
+          fillClipped(x+i*size, y+start*size, size, (j-start)*size, textColor);
+        } else if (bgColor != textColor) {
+          fillClipped(x+i*size, y+start*size, size, (j-start)*size, bgColor);
         }
+        start = j;
       }
-      line >>= 1;
     }
   }
 }
@@ -1693,8 +1775,10 @@ void BSP_LCD_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t
 // Advanced character draw function.  This is similar to the function
 // from Adafruit_GFX.c but adapted for this processor.  However, this
 // function only uses one call to setAddrWindow(), which allows it to
-// run at least twice as fast.
-// Requires (11 + size*size*6*8) bytes of transmission (assuming image fully on screen)
+// run at least twice as fast, and streams the expanded glyph, scaled
+// by size, as one run of pixel data.  A character that is not
+// fully on the screen is not drawn (see BSP_LCD_DrawCharS()).
+// Requires (11 + 2*size*size*6*8) bytes of transmission (assuming image fully on screen)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -1704,48 +1788,35 @@ void BSP_LCD_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t
 // Output: none
 void BSP_LCD_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
   uint8_t line; // horizontal row of pixels of character
-  int32_t col, row, i, j;// loop indices
+  int32_t row, i; // loop indices
   if(((x + 6*size - 1) >= _width)  || // Clip right
      ((y + 8*size - 1) >= _height) || // Clip bottom
-     ((x + 6*size - 1) < 0)        || // Clip left
-     ((y + 8*size - 1) < 0)){         // Clip top
+     (x < 0)                       || // Clip left: the window takes unsigned coordinates
+     (y < 0)){                        // Clip top
     return;
   }
 
   setAddrWindow(x, y, x+6*size-1, y+8*size-1);
 
   line = 0x01;        // print the top row first
-  // print the rows, starting at the top
+  // print the rows, starting at the top, each one size times
   for(row=0; row<8; row=row+1){
     for(i=0; i<size; i=i+1){
-      // print the columns, starting on the left
-      for(col=0; col<5; col=col+1){
-        if(Font[(c*5)+col]&line){
-          // bit is set in Font, print pixel(s) in text color
-          for(j=0; j<size; j=j+1){
-            pushColor(textColor);
-          }
-        } else{
-          // bit is cleared in Font, print pixel(s) in background color
-          for(j=0; j<size; j=j+1){
-            pushColor(bgColor);
-          }
-        }
-      }
-      // print blank column(s) to the right of character
-      for(j=0; j<size; j=j+1){
-        pushColor(bgColor);
-      }
+      streamGlyphRow(&Font[c*5], line, textColor, bgColor, size);
     }
     line = line<<1;   // move up to the next row
   }
+  lcdEnd();
 }
 
 
 //------------BSP_LCD_DrawString------------
 // String draw function.
 // 13 rows (0 to 12) and 21 characters (0 to 20)
-// Requires (11 + size*size*6*8) bytes of transmission for each character
+// The characters that fit on the row are drawn in one address
+// window, one row of pixels across all of them at a time.
+// Requires (11 + 2*6*8*n) bytes of transmission for n characters
+//   10 characters: 971 bytes, where one window per character took 10*107 = 1070
 // Input: x         columns from the left edge (0 to 20)
 //        y         rows from the top edge (0 to 12)
 //        pt        pointer to a null terminated string to be printed
@@ -1753,16 +1824,29 @@ void BSP_LCD_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 // bgColor is Black and size is 1
 // Output: number of characters printed
 uint32_t BSP_LCD_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor){
-  uint32_t count = 0;
-  if(y>12) return 0;
-  while(*pt){
-    BSP_LCD_DrawChar(x*6, y*10, *pt, textColor, ST7735_BLACK, 1);
-    pt++;
-    x = x+1;
-    if(x>20) return count;  // number of characters printed
-    count++;
-  }
-  return count;  // number of characters printed
+  uint32_t n = 0, i;
+  uint8_t line;
+  int32_t row;
+  if((y>12) || (x>20)) return 0;
+  while(pt[n] && ((x+n) <= 20)){
+    n = n+1;
+  }
+  if(n == 0) return 0;
+
+  setAddrWindow(x*6, y*10, (x+n)*6-1, y*10+7);
+
+  line = 0x01;
+  for(row=0; row<8; row=row+1){
+    for(i=0; i<n; i=i+1){
+      streamGlyphRow(&Font[pt[i]*5], line, textColor, ST7735_BLACK, 1);
+    }
+    line = line<<1;
+  }
+  lcdEnd();
+
+  // As before, a character printed in the last column is not counted
+  if((x+n) > 20) return n-1;
+  return n;
 }
 
 
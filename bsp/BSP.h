@@ -359,6 +359,10 @@ void BSP_Microphone_Input(uint16_t *mic);
 // Output: none
 void BSP_LCD_Init(void);
 
+// Number of bytes the BSP_LCD_* functions have sent to the LCD,
+// commands and data.  It wraps around; take differences.
+extern uint32_t BSP_LCD_ByteCount;
+
 
 //------------BSP_LCD_DrawPixel------------
 // Color the pixel at the given coordinates with the given color.
@@ -459,12 +463,16 @@ void BSP_LCD_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w,
 
 //------------BSP_LCD_DrawCharS------------
 // Simple character draw function.  This is the same function from
-// Adafruit_GFX.c but adapted for this processor.  However, each call
-// to BSP_LCD_DrawPixel() calls setAddrWindow(), which needs to send
-// many extra data and commands.  If the background color is the same
-// as the text color, no background will be printed, and text can be
-// drawn right over existing images without covering them with a box.
-// Requires (11 + 2*size*size)*6*8 bytes of transmission (image fully on screen; textcolor != bgColor)
+// Adafruit_GFX.c but adapted for this processor.  If the background
+// color is the same as the text color, no background will be
+// printed, and text can be drawn right over existing images without
+// covering them with a box.
+// A character that is fully on the screen and has a background is
+// drawn like BSP_LCD_DrawChar(), in one address window. Otherwise
+// each vertical run of pixels of one color in a column of the font
+// is drawn as one rectangle, clipped to the screen.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (image fully on screen; textcolor != bgColor)
+// Requires (11 + 2*size*size*n) bytes for each vertical run of n pixels otherwise
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -479,8 +487,9 @@ void BSP_LCD_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t
 // Advanced character draw function.  This is similar to the function
 // from Adafruit_GFX.c but adapted for this processor.  However, this
 // function only uses one call to setAddrWindow(), which allows it to
-// run at least twice as fast.
-// Requires (11 + size*size*6*8) bytes of transmission (assuming image fully on screen)
+// run at least twice as fast, and streams the expanded glyph, scaled
+// by size, as one run of pixel data.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (assuming image fully on screen)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -494,7 +503,9 @@ void BSP_LCD_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 //------------BSP_LCD_DrawString------------
 // String draw function.
 // 13 rows (0 to 12) and 21 characters (0 to 20)
-// Requires (11 + size*size*6*8) bytes of transmission for each character
+// The characters that fit on the row are drawn in one address
+// window, one row of pixels across all of them at a time.
+// Requires (11 + 2*6*8*n) bytes of transmission for n characters
 // Input: x         columns from the left edge (0 to 20)
 //        y         rows from the top edge (0 to 12)
 //        pt        pointer to a null terminated string to be printed
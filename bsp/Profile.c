@@ -0,0 +1,143 @@
+// Profile.c
+// Cycle-accurate profiling of code zones on the Cortex M4,
+// using the DWT (Data Watchpoint and Trace) cycle counter.
+// CYCCNT counts every MCLK cycle, so at 48 MHz it wraps
+// after about 89 seconds; a single zone must be shorter.
+#include <stdint.h>
+#include "Profile.h"
+#include <Format.h>
+
+#if PROFILE_ENABLE
+
+static const char *const ProfileZoneNames[PROFILE_ZONE_COUNT] = {
+  "DrawTest",          // PROFILE_DRAW_TEST_SCREEN
+  "Debounce",          // PROFILE_DEBOUNCE_BUTTON
+  "SWTimer",           // PROFILE_SWTIMER_EXPIRED
+};
+
+static ProfileStats_t ProfileTable[PROFILE_ZONE_COUNT];
+static uint32_t ProfileOverhead;   // cycles of an empty zone, subtracted from every sample
+
+// ------------Profile_Reset------------
+// Clear the statistics of all zones.
+// Inputs: none
+// Outputs: none
+void Profile_Reset(void){
+  int z, b;
+  for(z=0; z<PROFILE_ZONE_COUNT; z=z+1){
+    ProfileTable[z].count = 0;
+    ProfileTable[z].min = 0xFFFFFFFF;
+    ProfileTable[z].max = 0;
+    ProfileTable[z].total = 0;
+    for(b=0; b<PROFILE_BUCKETS; b=b+1){
+      ProfileTable[z].histogram[b] = 0;
+    }
+  }
+}
+
+// ------------Profile_Init------------
+// Enable the DWT cycle counter, measure the overhead of an
+// empty zone and clear all statistics.
+// Inputs: none
+// Outputs: none
+void Profile_Init(void){
+  uint32_t start;
+  DEMCR |= DEMCR_TRCENA;           // the DWT is off after reset
+  DWTCYCCNT = 0;
+  DWTCTRL |= DWTCTRL_CYCCNTENA;
+  // same instruction sequence as PROFILE_ZONE_BEGIN/END around nothing
+  start = DWTCYCCNT;
+  ProfileOverhead = DWTCYCCNT - start;
+  Profile_Reset();
+}
+
+// ------------Profile_Record------------
+// Add one sample to the statistics of a zone. The overhead
+// measured by Profile_Init() is subtracted first.
+// Inputs: zone    the zone the sample belongs to
+//         cycles  number of cycles spent in the zone
+// Outputs: none
+void Profile_Record(ProfileZone_t zone, uint32_t cycles){
+  ProfileStats_t *s = &ProfileTable[zone];
+  uint32_t bucket = 0;
+  uint32_t v;
+  if(cycles > ProfileOverhead){
+    cycles = cycles - ProfileOverhead;
+  } else{
+    cycles = 0;
+  }
+  v = cycles;
+  while(v > 1){                    // bucket = floor(log2(cycles))
+    v = v>>1;
+    bucket = bucket + 1;
+  }
+  s->count = s->count + 1;
+  s->total = s->total + cycles;
+  if(cycles < s->min){
+    s->min = cycles;
+  }
+  if(cycles > s->max){
+    s->max = cycles;
+  }
+  s->histogram[bucket] = s->histogram[bucket] + 1;
+}
+
+// ------------Profile_Get------------
+// Return the statistics of a zone.
+// Inputs: zone
+// Outputs: pointer to the statistics, valid until the next Profile_Reset()
+const ProfileStats_t *Profile_Get(ProfileZone_t zone){
+  return &ProfileTable[zone];
+}
+
+// ------------Profile_Dump------------
+// Format the statistics of all zones as short text lines
+// (at most 16 characters, so they fit on one LCD row) and
+// pass them one at a time to emit(). Numbers of 100,000 or
+// more are printed in thousands with a 'k' suffix. For every
+// zone that has samples the lines are:
+//   name count
+//    <min-max          min and max cycles
+//    ~avg              average cycles
+//    2^b:count         one line per non-empty histogram bucket
+// Inputs: emit  called with each null terminated line and its index
+// Outputs: number of lines emitted
+uint32_t Profile_Dump(void (*emit)(char *line, uint32_t index)){
+  char line[24];
+  uint32_t n = 0;
+  unsigned i;
+  int z, b;
+  for(z=0; z<PROFILE_ZONE_COUNT; z=z+1){
+    const ProfileStats_t *s = &ProfileTable[z];
+    if(s->count == 0){
+      continue;
+    }
+    i = AppendString(line, 0, ProfileZoneNames[z]);
+    i = AppendString(line, i, " ");
+    i = AppendShortNumber(line, i, s->count, "k");
+    emit(line, n++);
+
+    i = AppendString(line, 0, " <");
+    i = AppendShortNumber(line, i, s->min, "k");
+    i = AppendString(line, i, "-");
+    i = AppendShortNumber(line, i, s->max, "k");
+    emit(line, n++);
+
+    i = AppendString(line, 0, " ~");
+    i = AppendShortNumber(line, i, (uint32_t)(s->total/s->count), "k");
+    emit(line, n++);
+
+    for(b=0; b<PROFILE_BUCKETS; b=b+1){
+      if(s->histogram[b]){
+        i = AppendString(line, 0, " 2^");
+        i = AppendNumber(line, i, b);
+        i = AppendString(line, i, ":");
+        i = AppendShortNumber(line, i, s->histogram[b], "k");
+        emit(line, n++);
+      }
+    }
+  }
+  return n;
+}
+
+#endif // PROFILE_ENABLE
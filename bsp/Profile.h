@@ -0,0 +1,106 @@
+// Profile.h
+// Cycle-accurate profiling of code zones on the Cortex M4,
+// using the DWT (Data Watchpoint and Trace) cycle counter.
+// Every zone keeps a count, the min and max cycles, and a
+// histogram with one bucket per power of 2 cycles.
+// Build with PROFILE_ENABLE=0 (the Release configuration does)
+// and all of it compiles out, including the statistics table.
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 1
+#endif
+
+// the host build (host/Makefile) provides its own DWT registers
+#ifndef DWTCYCCNT
+#define DEMCR           (*((volatile uint32_t *)0xE000EDFC))
+#define DWTCTRL         (*((volatile uint32_t *)0xE0001000))
+#define DWTCYCCNT       (*((volatile uint32_t *)0xE0001004))
+#endif
+#define DEMCR_TRCENA    0x01000000  // enable the DWT and ITM units
+#define DWTCTRL_CYCCNTENA 0x00000001 // enable the cycle counter
+
+// The zones that are profiled. Add new zones before PROFILE_ZONE_COUNT
+// and give them a name in ProfileZoneNames[] in Profile.c.
+typedef enum {
+  PROFILE_DRAW_TEST_SCREEN,
+  PROFILE_DEBOUNCE_BUTTON,
+  PROFILE_SWTIMER_EXPIRED,
+  PROFILE_ZONE_COUNT
+} ProfileZone_t;
+
+// bucket b counts the samples with 2^b <= cycles < 2^(b+1); bucket 0 also counts 0
+#define PROFILE_BUCKETS 32
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+  uint32_t histogram[PROFILE_BUCKETS];
+} ProfileStats_t;
+
+#if PROFILE_ENABLE
+
+// ------------PROFILE_ZONE_BEGIN/END------------
+// Open and close a profiled zone. The pair opens and closes
+// a C block, so the zone is also a scope:
+//   PROFILE_ZONE_BEGIN(PROFILE_DRAW_TEST_SCREEN)
+//     DrawTestScreen();
+//   PROFILE_ZONE_END(PROFILE_DRAW_TEST_SCREEN)
+// Do not return from inside a zone; the sample would be lost.
+#define PROFILE_ZONE_BEGIN(zone) { uint32_t profileZoneStart = DWTCYCCNT;
+#define PROFILE_ZONE_END(zone)   Profile_Record((zone), DWTCYCCNT - profileZoneStart); }
+
+// ------------Profile_Init------------
+// Enable the DWT cycle counter, measure the overhead of an
+// empty zone and clear all statistics.
+// Inputs: none
+// Outputs: none
+void Profile_Init(void);
+
+// ------------Profile_Record------------
+// Add one sample to the statistics of a zone. The overhead
+// measured by Profile_Init() is subtracted first.
+// Inputs: zone    the zone the sample belongs to
+//         cycles  number of cycles spent in the zone
+// Outputs: none
+void Profile_Record(ProfileZone_t zone, uint32_t cycles);
+
+// ------------Profile_Get------------
+// Return the statistics of a zone.
+// Inputs: zone
+// Outputs: pointer to the statistics, valid until the next Profile_Reset()
+const ProfileStats_t *Profile_Get(ProfileZone_t zone);
+
+// ------------Profile_Reset------------
+// Clear the statistics of all zones.
+// Inputs: none
+// Outputs: none
+void Profile_Reset(void);
+
+// ------------Profile_Dump------------
+// Format the statistics of all zones as short text lines
+// (at most 16 characters, so they fit on one LCD row) and
+// pass them one at a time to emit(). The same lines can be
+// sent to a serial port.
+// Inputs: emit  called with each null terminated line and its index
+// Outputs: number of lines emitted
+uint32_t Profile_Dump(void (*emit)(char *line, uint32_t index));
+
+#else
+
+#define PROFILE_ZONE_BEGIN(zone) {
+#define PROFILE_ZONE_END(zone)   }
+#define Profile_Init()
+#define Profile_Record(zone, cycles)
+#define Profile_Reset()
+static inline uint32_t Profile_Dump(void (*emit)(char *line, uint32_t index)){ return 0; }
+
+#endif // PROFILE_ENABLE
+
+#endif // PROFILE_H_
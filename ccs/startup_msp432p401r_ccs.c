@@ -35,10 +35,14 @@
 *****************************************************************************/
 
 #include <stdint.h>
+#include <RamUsage.h>
 
 /* Linker variable that marks the top of the stack. */
 extern unsigned long __STACK_END;
 
+/* Linker variable that marks the bottom of the stack. */
+extern unsigned long __stack;
+
 /* External declaration for the reset handler that is to be called when the */
 /* processor is started                                                     */
 extern void _c_int00(void);
@@ -180,6 +184,15 @@ void (* const interruptVectors[])(void) =
 /* application.                                                                */
 void Reset_Handler(void)
 {
+    /* The stack is painted from its bottom up to the frame of this function,   */
+    /* with a margin, so that StackHighWater can find how deep it has been.      */
+    /* Nothing else has run on it yet.                                           */
+    volatile uint32_t frame;
+    uint32_t *word;
+
+    for (word = (uint32_t *) &__stack; word < (uint32_t *) &frame - 8; word++)
+        *word = STACK_PAINT;
+
     SystemInit();
 
     /* Jump to the CCS C Initialization Routine. */
@@ -14,6 +14,9 @@
  * 7) In the result page, the application shows if he/she was right or wrong. This is screen is
  *    shown for a few seconds. Then the application goes back to step 2.
  *
+ * On the instructions page, the right button of the Launchpad also turns on the reaction-time mode for one of
+ * the players: the result page then shows how long the first button press of the round came after the LEDs lit up.
+ *
  *
  *
  */
@@ -23,10 +26,43 @@
 #include <Timer_HAL.h>
 #include <Display_HAL.h>
 #include <ADC_HAL.h>
+#include <Scheduler.h>
+#include "bsp/Profile.h"
+#include <Latency.h>
+#include <Trace.h>
+#include <Benchmark.h>
+#include <Render.h>
+#include <StripChart.h>
+#include <Tiles.h>
+#include <FlashLog.h>
+#include <Crypto_HAL.h>
+#include <Watchdog.h>
+#include <Clock_HAL.h>
+#include <RamUsage.h>
+#include <Buzzer_HAL.h>
+#include <Reaction.h>
+#include <Format.h>
+#include "assets/Swatches.h"
 
 #define OPENING_WAIT 1000 // 1 second or 1000 ms
 #define ENDTEST_WAIT 2000 // 2 second or 2000 ms
 
+// The settings kept in the flash log (see FlashLog.h)
+#define SETTING_CHART_MODE 0
+#define SETTING_REACTION_PLAYER 1
+
+// The diagnostics screen uses the first row for its title and shows this many lines under it
+#define DIAGNOSTICS_LINES 7
+
+// The budgets of the supervised tasks (see Watchdog.h), in microseconds
+#define CLOCK_BUDGET_US     25000
+#define SCREENS_BUDGET_US   250000
+#define POWER_BUDGET_US     20000
+#define CHART_BUDGET_US     20000
+#define ANIMATION_BUDGET_US 10000
+#define MOTION_BUDGET_US    1000
+#define TRACE_BUDGET_US     1000
+
 // The top and bottom options locations on 2nd and 5th row are defined as macros here.
 #define TOP_OPTION_POS 1
 #define BOTTOM_OPTION_POS 4
@@ -46,22 +82,130 @@ typedef struct {
 } colorMix_t;
 
 
+// The opening screen is composed as a display list and drawn band by band (see Render.h)
 void DrawOpeningScreen()
 {
-    LCDClearDisplay(MY_BLACK);
-    PrintString("COLOR TEST", 2, 2);
-    PrintString("by", 3, 3);
-    PrintString("LN", 4, 2);
+    RenderClear(MY_BLACK);
+    RenderText("COLOR TEST", 16, 32, MY_GREEN);
+    RenderText("by", 24, 48, MY_GREEN);
+    RenderText("LN", 16, 64, MY_GREEN);
+    RenderImage(&ImageSwatches, 0, 80);
+    RenderFrame();
+    DisplayScreenDrawn(0, 7, true);
 }
 
+// The keys of this screen come first, then those of the test under their heading. The right button changes who
+// the rounds are timed for (see Reaction.h).
 void DrawInstructionsScreen()
 {
+    char react[] = "RIGHT: time P0";
+
+    LCDClearDisplay(MY_BLACK);
+    PrintString("Guess RGB mix.", 0, 1);
+    PrintString("BTM to start", 1, 1);
+    PrintString("TOP: diag", 2, 1);
+    PrintString("LEFT: chart", 3, 1);
+    if (GetReactionPlayer() == REACTION_OFF)
+        PrintString("RIGHT: time off", 4, 1);
+    else
+    {
+        react[13] += GetReactionPlayer();
+        PrintString(react, 4, 1);
+    }
+    PrintString("During test:", 5, 1);
+    PrintString("BTM: move arrow", 6, 1);
+    PrintString("TOP: select", 7, 1);
+    DisplayScreenDrawn(0, 7, false);
+}
+
+// The chart screen plots the two axes of the joystick under its title, 100 samples a second, as a strip chart
+// (see StripChart.h) over the rest of the screen. The panel is kept awake while the chart runs.
+static StripChart_t chart = {
+    0, 16, 128, 112, STRIP_CHART_SWEEP,
+    0, 16383, GRAPHICS_COLOR_BLACK, {MY_GREEN, GRAPHICS_COLOR_YELLOW}, 2
+};
+static bool chartRunning;
+
+void DrawChartScreen(StripChartMode_t mode)
+{
+    LCDClearDisplay(MY_BLACK);
+    PrintString((mode == STRIP_CHART_SWEEP) ? "Chart: sweep" : "Chart: scroll", 0, 0);
+    DisplayScreenDrawn(0, 7, false);
+    SetDisplaySleepTimeout(0);
+
+    chart.mode = mode;
+    FlashLogSetting(SETTING_CHART_MODE, mode);
+    StripChartStart(&chart);
+    chartRunning = true;
+}
+
+void StopChartScreen()
+{
+    chartRunning = false;
+    StripChartStop(&chart);
+    SetDisplaySleepTimeout(DISPLAY_SLEEP_MS);
+}
+
+// The diagnostics screen shows DIAGNOSTICS_LINES lines of the profiling, latency and benchmark results in a console
+// under its title, and scrolls one line at a time. The lines come from Profile_Dump, SchedulerDump, LatencyDump,
+// BenchmarkDump, DisplayPowerDump, TilesDump, FlashLogDump, CryptoDump, WatchdogDump, RamUsageDump, ClockDump,
+// MotionDump, BuzzerDump and ReactionDump, which call EmitDiagnosticsLine for each of them: the ones from firstLine
+// to firstLine + lineCount - 1 are appended.
+static unsigned firstLine;
+static unsigned lineCount;
+static unsigned emittedLines;
+
+void EmitDiagnosticsLine(char *line, uint32_t index)
+{
+    if (emittedLines >= firstLine && emittedLines < firstLine + lineCount)
+        ConsoleAppend(line);
+    emittedLines++;
+}
+
+// It returns the number of lines available, so that the caller knows when to wrap back to the first line
+unsigned EmitDiagnosticsLines(unsigned first, unsigned count)
+{
+    firstLine = first;
+    lineCount = count;
+    emittedLines = 0;
+    Profile_Dump(EmitDiagnosticsLine);
+    SchedulerDump(EmitDiagnosticsLine);
+    LatencyDump(EmitDiagnosticsLine);
+    BenchmarkDump(EmitDiagnosticsLine);
+    DisplayPowerDump(EmitDiagnosticsLine);
+    TilesDump(EmitDiagnosticsLine);
+    FlashLogDump(EmitDiagnosticsLine);
+    CryptoDump(EmitDiagnosticsLine);
+    WatchdogDump(EmitDiagnosticsLine);
+    RamUsageDump(EmitDiagnosticsLine);
+    ClockDump(EmitDiagnosticsLine);
+    MotionDump(EmitDiagnosticsLine);
+    BuzzerDump(EmitDiagnosticsLine);
+    ReactionDump(EmitDiagnosticsLine);
+
+    return emittedLines;
+}
+
+unsigned DrawDiagnosticsScreen()
+{
+    unsigned lines;
+
     LCDClearDisplay(MY_BLACK);
-    PrintString("Guess RGB mix.", 1, 1);
-    PrintString("During test:", 2, 1);
-    PrintString("BTM: move arrow", 3, 1);
-    PrintString("TOP: select", 4, 1);
-    PrintString("BTM to start", 7, 1);
+    PrintString("Diagnostics", 0, 0);
+    ConsoleStart(1, DIAGNOSTICS_LINES);
+
+    lines = EmitDiagnosticsLines(0, DIAGNOSTICS_LINES);
+    if (lines == 0)
+        PrintString("No samples", 1, 0);
+    DisplayScreenDrawn(0, 7, false);
+
+    return lines;
+}
+
+// The next line is drawn over the top one and the console scrolls: the rest of the screen is not sent again
+void ScrollDiagnosticsScreen(unsigned line)
+{
+    EmitDiagnosticsLines(line, 1);
 }
 
 void DrawTestScreen()
@@ -76,21 +220,129 @@ void DrawTestScreen()
     PrintString("TOP: select", 7, 1);
 
     LCDDrawChar(1, 1, '>');
+    DisplayScreenDrawn(1, 7, false);
+}
+
+// The end screen is drawn with the tile engine (see Tiles.h): a tick mark or a cross bounces over the result at
+// ANIMATION_FPS frames per second until the screen is left
+#define ANIMATION_FPS 30
+#define MARK_SIZE     16
+
+static const uint16_t tickRows[MARK_SIZE] = {
+    0x0000, 0x0003, 0x0007, 0x000E, 0x001C, 0x0038, 0x0070, 0xC0E0,
+    0xE1C0, 0x7380, 0x3F00, 0x1E00, 0x0C00, 0x0000, 0x0000, 0x0000
+};
+
+static const uint16_t crossRows[MARK_SIZE] = {
+    0xC003, 0xE007, 0x700E, 0x381C, 0x1C38, 0x0E70, 0x07E0, 0x03C0,
+    0x03C0, 0x07E0, 0x0E70, 0x1C38, 0x381C, 0x700E, 0xE007, 0xC003
+};
+
+static const SpriteImage_t tickImage = {MARK_SIZE, MARK_SIZE, tickRows};
+static const SpriteImage_t crossImage = {MARK_SIZE, MARK_SIZE, crossRows};
+
+static struct {
+    bool running;
+    unsigned ticks;     // since the screen was drawn
+    unsigned frames;
+    int16_t x, y;
+    int16_t dx, dy;     // pixels per frame
+} mark;
+
+// This function returns the rounds won of all those played, as the flash log has them: "Won 7/12"
+const char *WinText()
+{
+    static char text[24];
+    uint32_t won, rounds = FlashLogRounds(&won);
+    unsigned i;
+
+    i = AppendString(text, 0, "Won ");
+    i = AppendNumber(text, i, won);
+    i = AppendString(text, i, "/");
+    AppendNumber(text, i, rounds);
+    return text;
+}
+
+// This function returns the reaction time of the round, to a tenth of a millisecond, after the player: "P1 312.4ms"
+const char *ReactionText(uint32_t us)
+{
+    static char text[24];
+    unsigned i;
+
+    i = AppendString(text, 0, "P");
+    i = AppendNumber(text, i, GetReactionPlayer());
+    i = AppendString(text, i, " ");
+    AppendThousandths(text, i, us, "ms");
+    return text;
 }
 
-// This screen displays different things based on the result of the test
+// The sounds play in the background (see Buzzer_HAL.h). The result cuts the click of the last guess short.
+#define SOUND_PRIORITY_CLICK  0
+#define SOUND_PRIORITY_RESULT 1
+
+static const Note_t clickNotes[] = {{2093, 15}};
+static const Note_t rightNotes[] = {{523, 90}, {659, 90}, {784, 90}, {1047, 240}};
+static const Note_t wrongNotes[] = {{392, 160}, {0, 40}, {262, 400}};
+
+static const Sound_t clickSound = {clickNotes, sizeof(clickNotes) / sizeof(clickNotes[0]), SOUND_PRIORITY_CLICK};
+static const Sound_t rightSound = {rightNotes, sizeof(rightNotes) / sizeof(rightNotes[0]), SOUND_PRIORITY_RESULT};
+static const Sound_t wrongSound = {wrongNotes, sizeof(wrongNotes) / sizeof(wrongNotes[0]), SOUND_PRIORITY_RESULT};
+
+// This screen displays different things based on the result of the test, and the reaction time if it was measured
 void DrawEndTestScreen(bool correct)
 {
-    LCDClearDisplay(MY_BLACK);
+    uint32_t reactionUS;
+
+    PlaySound(correct ? &rightSound : &wrongSound);
+    ConsoleStop();
+    TilesClear(MY_BLACK);
     if (correct)
     {
-        PrintString("Right!", 2, 3);
+        TilesPrint("Right!", 2, 3, MY_GREEN, MY_BLACK);
+        SpriteShow(0, &tickImage, MY_GREEN, 0, 0);
     } else
     {
-        PrintString("Wrong!", 2, 3);
+        TilesPrint("Wrong!", 2, 3, MY_GREEN, MY_BLACK);
+        SpriteShow(0, &crossImage, GRAPHICS_COLOR_RED, 0, 0);
     }
+    TilesPrint(WinText(), 4, 3, MY_GREEN, MY_BLACK);
+    if (ReactionRoundTime(&reactionUS))
+        TilesPrint(ReactionText(reactionUS), 5, 3, MY_GREEN, MY_BLACK);
+    TilesFrame();
+    DisplayScreenDrawn(0, 7, false);
+
+    mark.running = true;
+    mark.ticks = 0;
+    mark.frames = 0;
+    mark.x = 0;
+    mark.y = 0;
+    mark.dx = 3;
+    mark.dy = 2;
 }
 
+void StopEndTestScreen()
+{
+    mark.running = false;
+}
+
+// This function moves the mark one frame on, bouncing off the edges of the screen
+void MoveMark()
+{
+    if (mark.x + mark.dx < 0 || mark.x + mark.dx > 128 - MARK_SIZE)
+        mark.dx = -mark.dx;
+    if (mark.y + mark.dy < 0 || mark.y + mark.dy > 128 - MARK_SIZE)
+        mark.dy = -mark.dy;
+    mark.x += mark.dx;
+    mark.y += mark.dy;
+    SpriteMove(0, mark.x, mark.y);
+}
+
+
+// This function returns a color mix as 3 bits: red, green and blue from the least significant one
+unsigned MixBits(colorMix_t* mix)
+{
+    return mix->hasRed | (mix->hasGreen << 1) | (mix->hasBlue << 2);
+}
 
 // This function compares the actual and the guessed color mix.
 // It returns true if they are the same and false otherwise.
@@ -103,6 +355,13 @@ bool match(colorMix_t* guessColor, colorMix_t* actualColor)
     return false;
 }
 
+// A push for the screens. A press on a sleeping panel only wakes it, so the push of that button is dropped (see
+// DisplayTakeWakePush).
+static bool ScreenPushed(bool pushed, button_t button)
+{
+    return pushed && !DisplayTakeWakePush(button);
+}
+
 // This is the function used for guessing the colors
 // Its inputs are the arrow position pointer and the guessed color pointer
 // The function uses the content of these pointers and modifies it for the caller
@@ -124,7 +383,7 @@ bool guess(unsigned int * arrowPosPointer, colorMix_t* guessColor)
     // If the bottom button is pushed, it moves the arrow down on the display.
     // If the arrow is on the lowest option, it wraps around to the top
 
-    if (Booster_Bottom_Button_Pushed())
+    if (ScreenPushed(Booster_Bottom_Button_Pushed(), BOOSTER_BOTTOM))
     {
         // Clearing the old arrow
         LCDDrawChar(arrowPos, 1, ' ');
@@ -137,18 +396,23 @@ bool guess(unsigned int * arrowPosPointer, colorMix_t* guessColor)
             arrowPos = TOP_OPTION_POS;
 
         // draw the new arrow
+        // The latency measurement ends when the last byte of this glyph has been sent to the LCD
+        LATENCY_MARK(LATENCY_DRAW);
         LCDDrawChar(arrowPos, 1, '>');
+        LATENCY_MARK(LATENCY_PHOTON);
     }
 
     // pressing the top button makes the selection by putting a star on the right side of the color
     // If this button is pressed in front of the "end" option, the test ends
-    if (Booster_Top_Button_Pushed())
+    if (ScreenPushed(Booster_Top_Button_Pushed(), BOOSTER_TOP))
     {
         // Draw the *
         LCDDrawChar(arrowPos, 9, '*');
 
         // The choice is the index of the choice made
         choice = arrowPos - TOP_OPTION_POS;
+        TRACE(TRACE_GUESS, arrowPos, choice);
+        PlaySound(&clickSound);
         switch (choice)
         {
         case RED:
@@ -236,37 +500,36 @@ bool testFSM(bool newTest, bool* resultPointer)
         break;
 
     // In this state, we light up the LEDs based on the random bits we picked in the previous state
-    // The three commented out lines were in the code for debugging purposes.
-    // If you keep guessing wrong, perhaps uncomment them and see what colors are present in each mixture.
+    // The mixture also goes to the trace, so if you keep guessing wrong, you can see what colors were in it.
+    // The reaction time of the round starts right after the LEDs are on.
     case lightup:
         if (actualColor.hasRed)
-        {
             TurnON_Booster_Red_LED();
-//          PrintString("R", 7, 1);
-        }
         if (actualColor.hasGreen)
-        {
             TurnON_Booster_Green_LED();
-//          PrintString("G", 7, 2);
-        }
         if (actualColor.hasBlue)
-        {
             TurnON_Booster_Blue_LED();
- //         PrintString("B", 7, 3);
-        }
+        ReactionLightUp();
+        TRACE(TRACE_COLOR_MIX, MixBits(&actualColor), 0);
         testState = testing;
         break;
 
     // This is the main state of this FSM, we call the menu fsm from here, which updates the arrow position and the guessed color structure
+    // The first press of the round, once guess() has debounced it, is also the reaction time of the player
     case testing:
         finished = guess(&arrowPos, &guessColor);
+        ReactionPoll();
 
     }
 
     // If the test is finished, we need to compare the actual and guessed mixture.
-    // The result of this comparison goes in the memory location pointed by resultPointer
+    // The result of this comparison goes in the memory location pointed by resultPointer, and in the flash log
+    // with both mixtures
     if (finished)
+    {
         *resultPointer = match(&guessColor, &actualColor);
+        FlashLogResult(*resultPointer, MixBits(&actualColor) | (MixBits(&guessColor) << 3));
+    }
 
     return finished;
 }
@@ -275,15 +538,24 @@ bool testFSM(bool newTest, bool* resultPointer)
 void ScreensFSM()
 {
     // These are local variables for this function that need to keep their value from previous call
-    static enum states {INCEPTION, OPENING, INSTRUCTIONS, TEST, TESTEND} state = INCEPTION;
+    static enum states {INCEPTION, OPENING, INSTRUCTIONS, TEST, TESTEND, DIAGNOSTICS, CHART} state = INCEPTION;
     static OneShotSWTimer_t OST;
     static bool newTest;
+    // The diagnostics lines available, and how many of them have been shown so far
+    static unsigned diagnosticsLines, diagnosticsShown;
 
     // Set the default outputs
     bool drawOpeningScreen = false;
     bool drawInstructionsScreen = false;
     bool drawTestScreen = false;
     bool drawEndScreen = false;
+    bool stopEndScreen = false;
+    bool drawDiagnosticsScreen = false;
+    bool scrollDiagnosticsScreen = false;
+    bool drawChartScreen = false;
+    StripChartMode_t chartMode = STRIP_CHART_SWEEP;
+    uint32_t savedChartMode;
+    bool stopChartScreen = false;
     bool startSWTimer = false;
 
     // Inputs of the FSM
@@ -291,6 +563,12 @@ void ScreensFSM()
     bool result;
     bool swTimerExpired;
     bool bottomPushed;
+    bool topPushed;
+    bool leftPushed;
+    bool rightPushed;
+
+    // Remembered only to trace the transitions
+    enum states previousState = state;
 
     switch (state)
     {
@@ -319,8 +597,11 @@ void ScreensFSM()
         break;
 
     case INSTRUCTIONS:
-        // This state depends on the state of the bottom button. So, we get it by calling the below function
-        bottomPushed = Booster_Bottom_Button_Pushed();
+        // This state depends on the state of both buttons. So, we get them by calling the below functions
+        bottomPushed = ScreenPushed(Booster_Bottom_Button_Pushed(), BOOSTER_BOTTOM);
+        topPushed = ScreenPushed(Booster_Top_Button_Pushed(), BOOSTER_TOP);
+        leftPushed = ScreenPushed(Launchpad_Left_Button_Pushed(), LAUNCHPAD_LEFT);
+        rightPushed = ScreenPushed(Launchpad_Right_Button_Pushed(), LAUNCHPAD_RIGHT);
         if (bottomPushed)
         {
             state = TEST;
@@ -328,6 +609,68 @@ void ScreensFSM()
 
             drawTestScreen = true;
         }
+        else if (topPushed)
+        {
+            state = DIAGNOSTICS;
+
+            drawDiagnosticsScreen = true;
+        }
+        else if (leftPushed)
+        {
+            state = CHART;
+
+            // The chart starts in the mode it was last left in, even before a reset
+            if (FlashLogGetSetting(SETTING_CHART_MODE, &savedChartMode))
+                chartMode = (StripChartMode_t) savedChartMode;
+            drawChartScreen = true;
+        }
+        else if (rightPushed)
+        {
+            // The right button goes through the players of the reaction-time mode and back to off. The choice is
+            // kept over a reset.
+            SetReactionPlayer((GetReactionPlayer() + 1) % (REACTION_PLAYERS + 1));
+            FlashLogSetting(SETTING_REACTION_PLAYER, GetReactionPlayer());
+            drawInstructionsScreen = true;
+        }
+        break;
+
+    // The top button switches the chart between its two modes. The bottom button goes back to the instructions.
+    case CHART:
+        bottomPushed = ScreenPushed(Booster_Bottom_Button_Pushed(), BOOSTER_BOTTOM);
+        topPushed = ScreenPushed(Booster_Top_Button_Pushed(), BOOSTER_TOP);
+        if (bottomPushed)
+        {
+            state = INSTRUCTIONS;
+
+            stopChartScreen = true;
+            drawInstructionsScreen = true;
+        }
+        else if (topPushed)
+        {
+            stopChartScreen = true;
+            drawChartScreen = true;
+            chartMode = (chart.mode == STRIP_CHART_SWEEP) ? STRIP_CHART_SCROLL : STRIP_CHART_SWEEP;
+        }
+        break;
+
+    // The top button scrolls to the next line of the diagnostics, or back to the first ones after the last line.
+    // The bottom button goes back to the instructions.
+    case DIAGNOSTICS:
+        bottomPushed = ScreenPushed(Booster_Bottom_Button_Pushed(), BOOSTER_BOTTOM);
+        topPushed = ScreenPushed(Booster_Top_Button_Pushed(), BOOSTER_TOP);
+        if (bottomPushed)
+        {
+            state = INSTRUCTIONS;
+
+            drawInstructionsScreen = true;
+        }
+        else if (topPushed)
+        {
+            if (diagnosticsShown < diagnosticsLines)
+                scrollDiagnosticsScreen = true;
+            else
+                drawDiagnosticsScreen = true;
+        }
         break;
 
     case TEST:
@@ -354,11 +697,15 @@ void ScreensFSM()
             state = INSTRUCTIONS;
 
             // The output(s) that are affected in this transition
+            stopEndScreen = true;
             drawInstructionsScreen = true;
         }
         break;
     } // End of switch-case
 
+    if (state != previousState)
+        TRACE(TRACE_SCREEN, previousState, state);
+
     // Implement actions based on the outputs of the FSM
     if (startSWTimer)
     {
@@ -366,37 +713,167 @@ void ScreensFSM()
         StartOneShotSWTimer(&OST);
     }
 
+    // The display is turned on only when the opening screen is complete, so that it is the first frame seen
     if (drawOpeningScreen)
+    {
        DrawOpeningScreen();
+       LCDDisplayOn();
+    }
+
+    if (stopChartScreen)
+        StopChartScreen();
+
+    if (stopEndScreen)
+        StopEndTestScreen();
 
     if (drawInstructionsScreen)
         DrawInstructionsScreen();
 
     if (drawTestScreen)
-       DrawTestScreen();
+    {
+        PROFILE_ZONE_BEGIN(PROFILE_DRAW_TEST_SCREEN)
+        DrawTestScreen();
+        PROFILE_ZONE_END(PROFILE_DRAW_TEST_SCREEN)
+    }
 
     // This screen does different things based on the result of the test, so we pass the result to it
     if (drawEndScreen)
        DrawEndTestScreen(result);
 
+    if (drawDiagnosticsScreen)
+    {
+        diagnosticsLines = DrawDiagnosticsScreen();
+        diagnosticsShown = (diagnosticsLines < DIAGNOSTICS_LINES) ? diagnosticsLines : DIAGNOSTICS_LINES;
+    }
+
+    if (scrollDiagnosticsScreen)
+    {
+        ScrollDiagnosticsScreen(diagnosticsShown);
+        diagnosticsShown++;
+    }
+
+    if (drawChartScreen)
+        DrawChartScreen(chartMode);
+
 }
 
+// The id of ScreensTask in the scheduler, whose statistics the host simulator reports
+int ScreensTaskId = -1;
+
+// ScreensFSM still gets its inputs by calling the input functions. The scheduler only decides when it runs:
+// on every button edge, so that a push is seen right away, and on every tick, so that the debounce and
+// software timers it waits on can expire. Between those events the CPU sleeps.
+void ScreensTask(const Event_t *event)
+{
+    ScreensFSM();
+}
+
+// The joystick is sampled on every tick while the chart screen is shown, and the new slices drawn right away. The
+// clock is kept fast meanwhile, like for the animation.
+void ChartTask(const Event_t *event)
+{
+    unsigned x, y;
+    int32_t values[2];
+
+    if (!chartRunning)
+        return;
+    ClockKeepFast();
+
+    getSampleJoyStick(&x, &y);
+    values[0] = x;
+    values[1] = y;
+    StripChartAddSample(&chart, values);
+    StripChartRender(&chart);
+}
+
+// The frames of the end screen are paced by the ticks: a frame is drawn on the ticks that bring the time since the
+// screen was drawn to the next multiple of 1 / ANIMATION_FPS, so the rate is steady on average whatever the tick.
+// It keeps the clock fast while it runs, though no button is pushed (see Clock_HAL.h).
+void AnimationTask(const Event_t *event)
+{
+    if (!mark.running)
+        return;
+    ClockKeepFast();
+
+    mark.ticks++;
+    if (mark.ticks * TICK_PERIOD_MS * ANIMATION_FPS < (mark.frames + 1) * 1000)
+        return;
+
+    mark.frames++;
+    MoveMark();
+    TilesFrame();
+}
+
+#if TRACE_ENABLE
+// The records written since the last tick are sent to the backchannel UART
+void TraceTask(const Event_t *event)
+{
+    TraceFlush();
+}
+#endif
+
 int main(void) {
+    uint32_t reactionPlayer;
 
+    // The watchdog is held until the boot is done: the benchmark alone takes longer than its timeout
     WDT_A_hold(WDT_A_BASE);
+    InitWatchdog();
 
+    Profile_Init();
     BSP_Clock_InitFastest();
-    InitGraphics();
+    InitClock();
+
+    // The LCD goes through its reset while the other modules are initialized. Its waits are timed with the
+    // hardware timers, so they are started first.
     InitHWTimers();
+    StartGraphics();
+    InitScheduler();
     InitButtons();
     InitLEDs();
+    InitBuzzer();
     initADC();
     initJoyStick();
+    initAccelerometer();
     startADC();
+    calibrateMotion();
+    InitTrace();
+    InitCrypto();
+    CryptoSelfTest();
+    InitFlashLog();
+    if (FlashLogGetSetting(SETTING_REACTION_PLAYER, &reactionPlayer))
+        SetReactionPlayer(reactionPlayer);
+    while (!GraphicsReady())
+        ;
+    InitRender();
+    InitTiles();
+
+    // The display is still off, so the drawing of the benchmark is never seen
+    RunBenchmark();
+
+    // Every task runs on the tick, so all of them are supervised (see Watchdog.h). The budgets leave room for the
+    // slowest run seen: ClockGovernorTask may wait for the trace UART to finish a transfer, ScreensTask draws whole
+    // screens, the debounce of the buttons included, ChartTask samples the joystick and draws a slice,
+    // AnimationTask a frame of tiles, MotionTask reads four results. The clock governor comes first, so that a
+    // button or motion event finds the clock fast.
+    SuperviseTask(AddTask(ClockGovernorTask, EVENT_MASK(EVT_TICK) | EVENT_MASK(EVT_BUTTON) | EVENT_MASK(EVT_MOTION)),
+                  "Clock", CLOCK_BUDGET_US);
+    ScreensTaskId = AddTask(ScreensTask, EVENT_MASK(EVT_TICK) | EVENT_MASK(EVT_BUTTON));
+    SuperviseTask(ScreensTaskId, "Screens", SCREENS_BUDGET_US);
+    SuperviseTask(AddTask(DisplayPowerTask, EVENT_MASK(EVT_TICK) | EVENT_MASK(EVT_BUTTON) | EVENT_MASK(EVT_MOTION)),
+                  "Power", POWER_BUDGET_US);
+    SuperviseTask(AddTask(ChartTask, EVENT_MASK(EVT_TICK)), "Chart", CHART_BUDGET_US);
+    SuperviseTask(AddTask(AnimationTask, EVENT_MASK(EVT_TICK)), "Anim", ANIMATION_BUDGET_US);
+    SuperviseTask(AddTask(MotionTask, EVENT_MASK(EVT_TICK)), "Motion", MOTION_BUDGET_US);
+#if TRACE_ENABLE
+    SuperviseTask(AddTask(TraceTask, EVENT_MASK(EVT_TICK)), "Trace", TRACE_BUDGET_US);
+#endif
+    StartWatchdog();
+    InitTickTimer();
+    Interrupt_enableMaster();
 
     while (1)
     {
-        ScreensFSM();
+        RunScheduler();
     }
 
 }
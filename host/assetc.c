@@ -0,0 +1,396 @@
+//------------------------------------------
+// ASSET COMPILER
+// This host program turns an image into the compressed RGB565 format of Image.h, as a C source file and header
+// that are built into the application. The input is one of
+//   .ppm  a binary (P6) or text (P3) portable pixmap
+//   .png  if the program was built with libpng (host/Makefile does when pkg-config finds it)
+//   .txt  a layout, drawn with the font of the application:
+//           size W H                  the size of the image (required, first)
+//           background RRGGBB         fills the whole image (default black)
+//           rect X Y W H RRGGBB       a filled rectangle
+//           text X Y RRGGBB string    the string in fontcmtt16, with its top left corner at (X, Y)
+//         Lines starting with # are comments.
+//
+//    build/assetc [-r] input output
+//
+// writes output.c and output.h, where the image is called Image<basename of output>. With -r, output.c also has
+// the uncompressed pixels in the bottom-up row order of BSP_LCD_DrawBitmap, for the benchmark (see Benchmark.h).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <ti/grlib/grlib.h>
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+
+#include "../Image.h"
+
+typedef struct {
+    unsigned width, height;
+    uint16_t *pixels;           // RGB565, row by row
+} Picture_t;
+
+static void Fail(const char *path, const char *message)
+{
+    fprintf(stderr, "assetc: %s: %s\n", path, message);
+    exit(1);
+}
+
+// The same conversion as Crystalfontz128x128_ColorTranslate, so that images and grlib drawings match
+static uint16_t RGB565(uint32_t rgb)
+{
+    return ((rgb & 0x00F80000) >> 8) | ((rgb & 0x0000FC00) >> 5) | ((rgb & 0x000000F8) >> 3);
+}
+
+static void NewPicture(Picture_t *P, unsigned width, unsigned height, const char *path)
+{
+    if (width == 0 || height == 0 || width > 128 || height > 128)
+        Fail(path, "the image must be at most 128 x 128 pixels");
+    P->width = width;
+    P->height = height;
+    P->pixels = calloc(width * height, sizeof(uint16_t));
+    if (!P->pixels)
+        Fail(path, "out of memory");
+}
+
+//------------------------------------------
+// PPM
+
+// This function reads the next number of a PPM header, skipping white space and comments
+static unsigned ReadNumber(FILE *f, const char *path)
+{
+    unsigned n;
+    int c;
+
+    while ((c = fgetc(f)) == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+    {
+        if (c == '#')
+        {
+            while ((c = fgetc(f)) != '\n' && c != EOF)
+                ;
+        }
+    }
+    ungetc(c, f);
+    if (fscanf(f, "%u", &n) != 1)
+        Fail(path, "bad PPM header");
+    return n;
+}
+
+static void LoadPPM(Picture_t *P, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    char magic[3] = {0};
+    unsigned width, height, maxValue, i, c;
+
+    if (!f)
+        Fail(path, "cannot open");
+    if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || (magic[1] != '6' && magic[1] != '3'))
+        Fail(path, "not a P6 or P3 PPM file");
+
+    width = ReadNumber(f, path);
+    height = ReadNumber(f, path);
+    maxValue = ReadNumber(f, path);
+    if (maxValue == 0 || maxValue > 255)
+        Fail(path, "only 8 bit PPM files are supported");
+    fgetc(f);                                       // the single white space after the header
+    NewPicture(P, width, height, path);
+
+    for (i = 0; i < width * height; i++)
+    {
+        uint32_t rgb = 0;
+        for (c = 0; c < 3; c++)
+        {
+            unsigned v;
+            if (magic[1] == '6')
+            {
+                int byte = fgetc(f);
+                if (byte == EOF)
+                    Fail(path, "truncated");
+                v = byte;
+            }
+            else if (fscanf(f, "%u", &v) != 1)
+                Fail(path, "truncated");
+            rgb = (rgb << 8) | (v * 255 / maxValue);
+        }
+        P->pixels[i] = RGB565(rgb);
+    }
+    fclose(f);
+}
+
+//------------------------------------------
+// PNG
+
+static void LoadPNG(Picture_t *P, const char *path)
+{
+#ifdef HAVE_LIBPNG
+    png_image image;
+    uint8_t *rgb;
+    unsigned i;
+
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&image, path))
+        Fail(path, image.message);
+    image.format = PNG_FORMAT_RGB;
+    NewPicture(P, image.width, image.height, path);
+    rgb = malloc(PNG_IMAGE_SIZE(image));
+    if (!rgb || !png_image_finish_read(&image, NULL, rgb, 0, NULL))
+        Fail(path, image.message);
+
+    for (i = 0; i < P->width * P->height; i++)
+        P->pixels[i] = RGB565((uint32_t) rgb[3 * i] << 16 | rgb[3 * i + 1] << 8 | rgb[3 * i + 2]);
+    free(rgb);
+#else
+    Fail(path, "this assetc was built without libpng; convert the image to PPM");
+#endif
+}
+
+//------------------------------------------
+// Layout
+// The text is drawn by the host graphics library, the one the simulator uses, into the picture
+
+extern const Graphics_Font g_sFontCmtt16;
+
+static void PictureLineDrawH(const Graphics_Display *display, int16_t x1, int16_t x2, int16_t y, uint16_t value)
+{
+    Picture_t *P = display->displayData;
+    int16_t x;
+    for (x = x1; x <= x2; x++)
+        P->pixels[y * P->width + x] = value;
+}
+
+static uint32_t PictureColorTranslate(const Graphics_Display *display, uint32_t value)
+{
+    return RGB565(value);
+}
+
+static const Graphics_Display_Functions pictureFunctions = {
+    .pfnLineDrawH = PictureLineDrawH,
+    .pfnColorTranslate = PictureColorTranslate,
+};
+
+static void FillRect(Picture_t *P, unsigned x, unsigned y, unsigned width, unsigned height, uint16_t color)
+{
+    unsigned i, j;
+    for (j = y; j < y + height && j < P->height; j++)
+    {
+        for (i = x; i < x + width && i < P->width; i++)
+            P->pixels[j * P->width + i] = color;
+    }
+}
+
+static void LoadLayout(Picture_t *P, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256], word[16];
+    Graphics_Display display = {sizeof(Graphics_Display), P, 0, 0};
+    Graphics_Context context;
+    int number = 0, n, m;
+
+    if (!f)
+        Fail(path, "cannot open");
+    P->pixels = NULL;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned x, y, width, height, rgb;
+
+        number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || sscanf(line, "%15s%n", word, &n) != 1)
+            continue;
+
+        if (!strcmp(word, "size") && sscanf(line + n, "%u %u", &width, &height) == 2 && !P->pixels)
+        {
+            NewPicture(P, width, height, path);
+            display.width = width;
+            display.heigth = height;
+            Graphics_initContext(&context, &display, &pictureFunctions);
+            Graphics_setFont(&context, &g_sFontCmtt16);
+            continue;
+        }
+        if (!P->pixels)
+            Fail(path, "the layout must start with its size");
+
+        if (!strcmp(word, "background") && sscanf(line + n, "%x", &rgb) == 1)
+            FillRect(P, 0, 0, P->width, P->height, RGB565(rgb));
+        else if (!strcmp(word, "rect") && sscanf(line + n, "%u %u %u %u %x", &x, &y, &width, &height, &rgb) == 5)
+            FillRect(P, x, y, width, height, RGB565(rgb));
+        else if (!strcmp(word, "text") && sscanf(line + n, "%u %u %x %n", &x, &y, &rgb, &m) == 3)
+        {
+            Graphics_setForegroundColor(&context, rgb);
+            Graphics_drawString(&context, (int8_t *) line + n + m, -1, x, y, false);
+        }
+        else
+        {
+            fprintf(stderr, "assetc: %s:%d: cannot understand \"%s\"\n", path, number, line);
+            exit(1);
+        }
+    }
+    fclose(f);
+    if (!P->pixels)
+        Fail(path, "empty layout");
+}
+
+//------------------------------------------
+// Encoder
+
+// This function returns how many pixels from i on have the color of pixel i, up to max
+static unsigned RunLength(const Picture_t *P, unsigned i, unsigned max)
+{
+    unsigned count = 1, total = P->width * P->height;
+    while (i + count < total && count < max && P->pixels[i + count] == P->pixels[i])
+        count++;
+    return count;
+}
+
+static void AppendPixel(uint8_t *data, size_t *size, uint16_t pixel)
+{
+    data[(*size)++] = pixel >> 8;
+    data[(*size)++] = pixel & 0xFF;
+}
+
+// Runs of 3 pixels and more always become run packets. A run of 2 does too, unless it would break a literal.
+static uint8_t *Encode(const Picture_t *P, size_t *size)
+{
+    unsigned total = P->width * P->height, i = 0;
+    uint8_t *data = malloc(3 * total + 1);
+    size_t literalHeader = 0;
+    unsigned literalCount = 0;
+
+    *size = 0;
+    while (i < total)
+    {
+        unsigned run = RunLength(P, i, IMAGE_MAX_RUN);
+
+        if (run >= 3 || (run == IMAGE_MIN_RUN && literalCount == 0))
+        {
+            data[(*size)++] = IMAGE_RUN | (run - IMAGE_MIN_RUN);
+            AppendPixel(data, size, P->pixels[i]);
+            literalCount = 0;
+            i += run;
+            continue;
+        }
+
+        if (literalCount == 0)
+            literalHeader = (*size)++;
+        AppendPixel(data, size, P->pixels[i]);
+        data[literalHeader] = literalCount++;
+        if (literalCount == IMAGE_MAX_LITERAL)
+            literalCount = 0;
+        i++;
+    }
+    return data;
+}
+
+//------------------------------------------
+// Output
+
+static void WriteBytes(FILE *f, const uint8_t *data, size_t size)
+{
+    size_t i;
+    for (i = 0; i < size; i++)
+        fprintf(f, "%s0x%02X,", (i % 16) ? " " : "\n    ", data[i]);
+    fprintf(f, "\n");
+}
+
+static void WriteSource(const char *output, const char *name, const char *input, const Picture_t *P, bool raw)
+{
+    char path[512], guard[64];
+    FILE *f;
+    size_t size, i;
+    uint8_t *data = Encode(P, &size);
+    int x, y;
+
+    if (strrchr(input, '/'))
+        input = strrchr(input, '/') + 1;
+    for (i = 0; name[i] && i < sizeof(guard) - 1; i++)
+        guard[i] = toupper((unsigned char) name[i]);
+    guard[i] = '\0';
+
+    snprintf(path, sizeof(path), "%s.c", output);
+    f = fopen(path, "w");
+    if (!f)
+        Fail(path, "cannot create");
+
+    fprintf(f, "// Generated by host/assetc from %s. Do not edit.\n", input);
+    fprintf(f, "// %u x %u pixels, %zu bytes instead of %u.\n\n", P->width, P->height, size,
+            2 * P->width * P->height);
+    fprintf(f, "#include <Image.h>\n");
+    if (raw)
+        fprintf(f, "#include <Benchmark.h>\n");
+    fprintf(f, "\nstatic const uint8_t data[] = {");
+    WriteBytes(f, data, size);
+    fprintf(f, "};\n\nconst Image_t Image%s = {%u, %u, sizeof(data), data};\n", name, P->width, P->height);
+
+    if (raw)
+    {
+        fprintf(f, "\n#if BENCHMARK_ENABLE\n");
+        fprintf(f, "// The same pixels, uncompressed, bottom row first for BSP_LCD_DrawBitmap\n");
+        fprintf(f, "const uint16_t Image%sRaw[] = {", name);
+        i = 0;
+        for (y = P->height - 1; y >= 0; y--)
+        {
+            for (x = 0; x < (int) P->width; x++, i++)
+                fprintf(f, "%s0x%04X,", (i % 12) ? " " : "\n    ", P->pixels[y * P->width + x]);
+        }
+        fprintf(f, "\n};\n#endif\n");
+    }
+    fclose(f);
+    free(data);
+
+    snprintf(path, sizeof(path), "%s.h", output);
+    f = fopen(path, "w");
+    if (!f)
+        Fail(path, "cannot create");
+    fprintf(f, "// Generated by host/assetc from %s. Do not edit.\n\n", input);
+    fprintf(f, "#ifndef %s_H_\n#define %s_H_\n\n#include <Image.h>\n\n", guard, guard);
+    fprintf(f, "extern const Image_t Image%s;\n", name);
+    if (raw)
+        fprintf(f, "extern const uint16_t Image%sRaw[];\n", name);
+    fprintf(f, "\n#endif /* %s_H_ */\n", guard);
+    fclose(f);
+
+    printf("%s: %u x %u, %zu bytes (%.1f%% of raw)\n", name, P->width, P->height, size,
+           100.0 * size / (2 * P->width * P->height));
+}
+
+int main(int argc, char *argv[])
+{
+    Picture_t picture;
+    const char *input, *output, *extension, *name;
+    bool raw = false;
+    int a = 1;
+
+    if (a < argc && !strcmp(argv[a], "-r"))
+    {
+        raw = true;
+        a++;
+    }
+    if (argc - a != 2)
+    {
+        fprintf(stderr, "usage: %s [-r] input.{ppm,png,txt} output\n", argv[0]);
+        return 2;
+    }
+    input = argv[a];
+    output = argv[a + 1];
+
+    extension = strrchr(input, '.');
+    if (extension && !strcmp(extension, ".ppm"))
+        LoadPPM(&picture, input);
+    else if (extension && !strcmp(extension, ".png"))
+        LoadPNG(&picture, input);
+    else if (extension && !strcmp(extension, ".txt"))
+        LoadLayout(&picture, input);
+    else
+        Fail(input, "unknown kind of file");
+
+    name = strrchr(output, '/');
+    name = name ? name + 1 : output;
+    WriteSource(output, name, input, &picture, raw);
+    return 0;
+}
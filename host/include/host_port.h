@@ -0,0 +1,40 @@
+//------------------------------------------
+// HOST PORT
+// This header is included in front of every file of the host build (see the -include option in
+// host/Makefile). It provides what the target gets from the TI compiler and from the Cortex-M4 core.
+
+#ifndef HOST_PORT_H_
+#define HOST_PORT_H_
+
+#include <stdint.h>
+
+// The TI compiler intrinsic. The simulated clock advances by that many cycles.
+void __delay_cycles(uint32_t cycles);
+
+// The DWT registers used by bsp/Profile.h. The cycle counter follows the simulated clock.
+extern volatile uint32_t SimDEMCR, SimDWTCTRL, SimDWTCYCCNT;
+#define DEMCR       SimDEMCR
+#define DWTCTRL     SimDWTCTRL
+#define DWTCYCCNT   SimDWTCYCCNT
+
+// bsp/BSP.c drives the hardware directly and is not part of the host build. The simulator provides
+// the clock setup the application needs from it, and the transfers to the LCD the benchmark times.
+void BSP_Clock_InitFastest(void);
+void BSP_LCD_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
+void BSP_LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+uint32_t BSP_LCD_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor);
+
+// The flash log (see FlashLog.c) reads its sectors from the flash of the simulator
+extern uint8_t SimFlashLog[];
+#define FLASH_LOG_MEMORY SimFlashLog
+
+// The host build has none of the sections of msp432p401r.cmd and runs on the host's stack (see RamUsage.h)
+#define RAM_LINKER_SYMBOLS 0
+
+// The simulator has no CRC32 or AES256 module: Crypto_HAL.c uses its software implementations, except in the tests
+// that build it against a model of them (see test/CryptoModel.h)
+#ifndef CRYPTO_HARDWARE
+#define CRYPTO_HARDWARE 0
+#endif
+
+#endif // HOST_PORT_H_
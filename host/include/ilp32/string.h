@@ -0,0 +1,16 @@
+//------------------------------------------
+// HOST PORT, 32-BIT OBJECTS
+// The objects of make rammap-host are compiled freestanding, since most hosts have no 32-bit C library headers.
+// They are only measured, never linked: the application needs nothing more of <string.h> than these declarations.
+
+#ifndef ILP32_STRING_H_
+#define ILP32_STRING_H_
+
+#include <stddef.h>
+
+void *memcpy(void *destination, const void *source, size_t n);
+void *memmove(void *destination, const void *source, size_t n);
+void *memset(void *s, int c, size_t n);
+int memcmp(const void *a, const void *b, size_t n);
+
+#endif // ILP32_STRING_H_
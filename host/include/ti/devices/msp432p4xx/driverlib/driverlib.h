@@ -0,0 +1,465 @@
+//------------------------------------------
+// HOST DRIVERLIB
+// A stand-in for the parts of the MSP432 driverlib that the application uses. The constants have the
+// values of the real driverlib wherever the code depends on them; the functions are implemented by the
+// simulator in host/sim. Only what the application calls is here: add more as the application grows.
+
+#ifndef HOST_DRIVERLIB_H_
+#define HOST_DRIVERLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//------------------------------------------
+// GPIO
+#define GPIO_PORT_P1    1
+#define GPIO_PORT_P2    2
+#define GPIO_PORT_P3    3
+#define GPIO_PORT_P4    4
+#define GPIO_PORT_P5    5
+#define GPIO_PORT_P6    6
+#define GPIO_PORT_PJ    11
+
+#define GPIO_PIN0       0x0001
+#define GPIO_PIN1       0x0002
+#define GPIO_PIN2       0x0004
+#define GPIO_PIN3       0x0008
+#define GPIO_PIN4       0x0010
+#define GPIO_PIN5       0x0020
+#define GPIO_PIN6       0x0040
+#define GPIO_PIN7       0x0080
+
+#define GPIO_PRIMARY_MODULE_FUNCTION    0x01
+#define GPIO_SECONDARY_MODULE_FUNCTION  0x02
+#define GPIO_TERTIARY_MODULE_FUNCTION   0x03
+
+#define GPIO_LOW_TO_HIGH_TRANSITION     0x00
+#define GPIO_HIGH_TO_LOW_TRANSITION     0x01
+
+#define GPIO_INPUT_PIN_HIGH             0x01
+#define GPIO_INPUT_PIN_LOW              0x00
+
+void GPIO_setAsOutputPin(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_setAsInputPin(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_setAsInputPinWithPullDownResistor(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode);
+void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode);
+void GPIO_setOutputHighOnPin(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_setOutputLowOnPin(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_toggleOutputOnPin(uint_fast8_t port, uint_fast16_t pins);
+uint8_t GPIO_getInputPinValue(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_interruptEdgeSelect(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t edgeSelect);
+void GPIO_enableInterrupt(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_disableInterrupt(uint_fast8_t port, uint_fast16_t pins);
+void GPIO_clearInterruptFlag(uint_fast8_t port, uint_fast16_t pins);
+uint_fast16_t GPIO_getInterruptStatus(uint_fast8_t port, uint_fast16_t pins);
+uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t port);
+
+//------------------------------------------
+// WDT_A
+#define WDT_A_BASE      0x40004800
+
+#define WDT_A_CLOCKSOURCE_SMCLK         0x00
+#define WDT_A_CLOCKSOURCE_ACLK          0x20
+#define WDT_A_CLOCKSOURCE_VLOCLK        0x40
+#define WDT_A_CLOCKSOURCE_BCLK          0x60
+
+#define WDT_A_CLOCKITERATIONS_2G        0x00
+#define WDT_A_CLOCKITERATIONS_128M      0x01
+#define WDT_A_CLOCKITERATIONS_8192K     0x02
+#define WDT_A_CLOCKITERATIONS_512K      0x03
+#define WDT_A_CLOCKITERATIONS_32K       0x04
+#define WDT_A_CLOCKITERATIONS_8192      0x05
+#define WDT_A_CLOCKITERATIONS_512       0x06
+#define WDT_A_CLOCKITERATIONS_64        0x07
+
+#define WDT_A_HARD_RESET                0x00
+#define WDT_A_SOFT_RESET                0x01
+
+void WDT_A_holdTimer(void);
+#define WDT_A_hold(base) WDT_A_holdTimer()
+void WDT_A_initWatchdogTimer(uint_fast8_t clockSelect, uint_fast8_t clockDivider);
+void WDT_A_setTimeoutReset(uint_fast8_t resetType);
+void WDT_A_startTimer(void);
+void WDT_A_clearTimer(void);
+
+//------------------------------------------
+// ResetCtl
+#define RESET_SRC_0     0x0001
+#define RESET_SRC_1     0x0002
+#define RESET_SRC_2     0x0004
+
+uint32_t ResetCtl_getHardResetSource(void);
+void ResetCtl_clearHardResetSource(uint32_t mask);
+
+//------------------------------------------
+// Timer32
+#define TIMER32_0_BASE  0x4000C000
+#define TIMER32_1_BASE  0x4000C020
+
+#define TIMER32_PRESCALER_1     0x00
+#define TIMER32_PRESCALER_16    0x04
+#define TIMER32_PRESCALER_256   0x08
+
+#define TIMER32_16BIT           0x00
+#define TIMER32_32BIT           0x02
+
+#define TIMER32_FREE_RUN_MODE   0x00
+#define TIMER32_PERIODIC_MODE   0x40
+
+void Timer32_initModule(uint32_t timer, uint32_t preScaler, uint32_t resolution, uint32_t mode);
+void Timer32_setCount(uint32_t timer, uint32_t count);
+void Timer32_startTimer(uint32_t timer, bool oneShot);
+void Timer32_haltTimer(uint32_t timer);
+uint32_t Timer32_getValue(uint32_t timer);
+
+//------------------------------------------
+// Timer_A
+#define TIMER_A0_BASE   0x40000000
+#define TIMER_A3_BASE   0x40000C00
+
+#define TIMER_A_CLOCKSOURCE_ACLK                    0x0100
+#define TIMER_A_CLOCKSOURCE_SMCLK                   0x0200
+#define TIMER_A_CLOCKSOURCE_DIVIDER_1               0x01
+#define TIMER_A_TAIE_INTERRUPT_DISABLE              0x00
+#define TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE          0x10
+#define TIMER_A_CCIE_CCR0_INTERRUPT_DISABLE         0x00
+#define TIMER_A_DO_CLEAR                            0x04
+#define TIMER_A_CAPTURECOMPARE_REGISTER_0           0x02
+#define TIMER_A_CAPTURECOMPARE_REGISTER_4           0x0A
+#define TIMER_A_CAPTURECOMPARE_INTERRUPT_DISABLE    0x00
+#define TIMER_A_OUTPUTMODE_RESET_SET                0xE0
+#define TIMER_A_UP_MODE                             0x10
+
+typedef struct
+{
+    uint_fast16_t clockSource;
+    uint_fast16_t clockSourceDivider;
+    uint_fast16_t timerPeriod;
+    uint_fast16_t timerInterruptEnable_TAIE;
+    uint_fast16_t captureCompareInterruptEnable_CCR0_CCIE;
+    uint_fast16_t timerClear;
+} Timer_A_UpModeConfig;
+
+typedef struct
+{
+    uint_fast16_t compareRegister;
+    uint_fast16_t compareInterruptEnable;
+    uint_fast16_t compareOutputMode;
+    uint_fast16_t compareValue;
+} Timer_A_CompareModeConfig;
+
+void Timer_A_configureUpMode(uint32_t timer, const Timer_A_UpModeConfig *config);
+void Timer_A_initCompare(uint32_t timer, const Timer_A_CompareModeConfig *compareConfig);
+void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode);
+void Timer_A_stopTimer(uint32_t timer);
+void Timer_A_clearTimer(uint32_t timer);
+void Timer_A_setCompareValue(uint32_t timer, uint_fast16_t compareRegister, uint_fast16_t compareValue);
+void Timer_A_clearCaptureCompareInterrupt(uint32_t timer, uint_fast16_t captureCompareRegister);
+
+//------------------------------------------
+// SysTick
+void SysTick_enableModule(void);
+void SysTick_disableModule(void);
+void SysTick_setPeriod(uint32_t period);
+uint32_t SysTick_getPeriod(void);
+uint32_t SysTick_getValue(void);
+void SysTick_enableInterrupt(void);
+void SysTick_disableInterrupt(void);
+
+// The CMSIS registers of SysTick. The simulator does not look at them: SysTick_enableModule starts the count
+// over, which is what clearing VAL before it does on the hardware.
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+extern SysTick_Type SimSysTick;
+#define SysTick (&SimSysTick)
+
+//------------------------------------------
+// Interrupt (NVIC). The numbers are the exception numbers, IRQ number + 16.
+#define INT_WDT_A       19
+#define INT_TA1_0       26
+#define INT_TA3_0       30
+#define INT_EUSCIA0     32
+#define INT_EUSCIB0     36
+#define INT_ADC14       40
+#define INT_T32_INT1    41
+#define INT_DMA_INT3    47
+#define INT_DMA_INT2    48
+#define INT_DMA_INT1    49
+#define INT_DMA_INT0    50
+#define INT_PORT1       51
+#define INT_PORT2       52
+#define INT_PORT3       53
+#define INT_PORT4       54
+#define INT_PORT5       55
+#define INT_PORT6       56
+
+#define NUM_INTERRUPTS  64
+
+void Interrupt_enableMaster(void);
+bool Interrupt_disableMaster(void);
+void Interrupt_enableInterrupt(uint32_t interruptNumber);
+void Interrupt_disableInterrupt(uint32_t interruptNumber);
+bool Interrupt_isEnabled(uint32_t interruptNumber);
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t priority);
+
+//------------------------------------------
+// PCM and CS
+bool PCM_gotoLPM0(void);
+
+#define CS_MCLK                 0x02
+#define CS_SMCLK                0x08
+#define CS_HFXTCLK_SELECT       0x05
+#define CS_CLOCK_DIVIDER_1      0x00000000
+#define CS_CLOCK_DIVIDER_2      0x10000000
+#define CS_CLOCK_DIVIDER_4      0x20000000
+#define CS_CLOCK_DIVIDER_8      0x30000000
+#define CS_CLOCK_DIVIDER_16     0x40000000
+#define CS_CLOCK_DIVIDER_32     0x50000000
+#define CS_CLOCK_DIVIDER_64     0x60000000
+#define CS_CLOCK_DIVIDER_128    0x70000000
+
+void CS_setExternalClockSourceFrequency(uint32_t lfxt_XT_CLK_frequency, uint32_t hfxt_XT_CLK_frequency);
+void CS_initClockSignal(uint32_t selectedClockSignal, uint32_t clockSource, uint32_t clockSourceDivider);
+uint32_t CS_getMCLK(void);
+uint32_t CS_getSMCLK(void);
+
+//------------------------------------------
+// ADC14
+#define ADC_CLOCKSOURCE_ADCOSC      0x00000000
+#define ADC_PREDIVIDER_1            0x00000000
+#define ADC_DIVIDER_1               0x00000000
+
+#define ADC_MEM0                    0x00000001
+#define ADC_MEM1                    0x00000002
+#define ADC_MEM2                    0x00000004
+#define ADC_MEM3                    0x00000008
+
+#define ADC_INT0                    0x0000000000000001
+#define ADC_INT1                    0x0000000000000002
+#define ADC_INT2                    0x0000000000000004
+#define ADC_INT3                    0x0000000000000008
+#define ADC_IN_INT                  0x0000000200000000
+#define ADC_LO_INT                  0x0000000400000000
+#define ADC_HI_INT                  0x0000000800000000
+
+#define ADC_COMP_WINDOW0            0x00000000
+#define ADC_COMP_WINDOW1            0x00000080
+
+#define ADC_AUTOMATIC_ITERATION     0x00000080
+#define ADC_MANUAL_ITERATION        0x00000000
+
+#define ADC_VREFPOS_AVCC_VREFNEG_VSS 0x00000000
+#define ADC_INPUT_A9                9
+#define ADC_INPUT_A13               13
+#define ADC_INPUT_A14               14
+#define ADC_INPUT_A15               15
+#define ADC_NONDIFFERENTIAL_INPUTS  false
+
+void ADC14_enableModule(void);
+bool ADC14_initModule(uint32_t clockSource, uint32_t clockPredivider, uint32_t clockDivider,
+                      uint32_t internalChannelMask);
+bool ADC14_configureMultiSequenceMode(uint32_t memoryStart, uint32_t memoryEnd, bool repeatMode);
+bool ADC14_configureConversionMemory(uint32_t memorySelect, uint32_t refSelect, uint32_t channelSelect,
+                                     bool differntialMode);
+bool ADC14_enableSampleTimer(uint32_t multiSampleConvert);
+bool ADC14_enableConversion(void);
+void ADC14_disableConversion(void);
+bool ADC14_isBusy(void);
+bool ADC14_toggleConversionTrigger(void);
+uint_fast16_t ADC14_getResult(uint32_t memorySelect);
+bool ADC14_enableComparatorWindow(uint32_t memorySelect, uint32_t windowSelect);
+bool ADC14_disableComparatorWindow(uint32_t memorySelect);
+void ADC14_setComparatorWindowValue(uint32_t window, int16_t low, int16_t high);
+void ADC14_enableInterrupt(uint_fast64_t mask);
+void ADC14_disableInterrupt(uint_fast64_t mask);
+uint_fast64_t ADC14_getEnabledInterruptStatus(void);
+void ADC14_clearInterruptFlag(uint_fast64_t mask);
+
+//------------------------------------------
+// eUSCI SPI and UART
+#define EUSCI_A0_BASE   0x40001000
+#define EUSCI_B0_BASE   0x40002000
+
+#define EUSCI_B_SPI_CLOCKSOURCE_SMCLK                           0x80
+#define EUSCI_B_SPI_MSB_FIRST                                   0x2000
+#define EUSCI_B_SPI_PHASE_DATA_CAPTURED_ONFIRST_CHANGED_ON_NEXT 0x8000
+#define EUSCI_B_SPI_CLOCKPOLARITY_INACTIVITY_LOW                0x0000
+#define EUSCI_B_SPI_3PIN                                        0x0000
+
+typedef struct
+{
+    uint_fast8_t selectClockSource;
+    uint32_t clockSourceFrequency;
+    uint32_t desiredSpiClock;
+    uint_fast16_t msbFirst;
+    uint_fast16_t clockPhase;
+    uint_fast16_t clockPolarity;
+    uint_fast16_t spiMode;
+} eUSCI_SPI_MasterConfig;
+
+bool SPI_initMaster(uint32_t moduleInstance, const eUSCI_SPI_MasterConfig *config);
+void SPI_enableModule(uint32_t moduleInstance);
+void SPI_disableModule(uint32_t moduleInstance);
+void SPI_changeMasterClock(uint32_t moduleInstance, uint32_t clockSourceFrequency, uint32_t desiredSpiClock);
+uint32_t SPI_getTransmitBufferAddressForDMA(uint32_t moduleInstance);
+
+#define EUSCI_A_UART_CLOCKSOURCE_SMCLK                  0x80
+#define EUSCI_A_UART_NO_PARITY                          0x00
+#define EUSCI_A_UART_LSB_FIRST                          0x00
+#define EUSCI_A_UART_ONE_STOP_BIT                       0x00
+#define EUSCI_A_UART_MODE                               0x00
+#define EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION   0x01
+#define EUSCI_A_UART_LOW_FREQUENCY_BAUDRATE_GENERATION  0x00
+#define EUSCI_A_UART_TRANSMIT_INTERRUPT                 0x0002
+#define EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG            0x0002
+
+typedef struct
+{
+    uint_fast8_t selectClockSource;
+    uint_fast16_t clockPrescalar;
+    uint_fast8_t firstModReg;
+    uint_fast8_t secondModReg;
+    uint_fast8_t parity;
+    uint_fast16_t msborLsbFirst;
+    uint_fast16_t numberofStopBits;
+    uint_fast16_t uartMode;
+    uint_fast8_t overSampling;
+} eUSCI_UART_Config;
+
+bool UART_initModule(uint32_t moduleInstance, const eUSCI_UART_Config *config);
+void UART_enableModule(uint32_t moduleInstance);
+void UART_enableInterrupt(uint32_t moduleInstance, uint_fast8_t mask);
+void UART_disableInterrupt(uint32_t moduleInstance, uint_fast8_t mask);
+uint_fast8_t UART_getEnabledInterruptStatus(uint32_t moduleInstance);
+void UART_transmitData(uint32_t moduleInstance, uint_fast8_t transmitData);
+uint32_t UART_getTransmitBufferAddressForDMA(uint32_t moduleInstance);
+
+// The registers that the LCD HAL and Trace access directly. Every byte written to UCB0TXBUF is picked up by the
+// simulated LCD the next time UCB0STATW or UCB0IFG is read, which the HAL does after each write.
+extern volatile uint16_t UCB0TXBUF, UCB0RXBUF;
+uint16_t SimSPIStatus(void);
+uint16_t SimUARTStatus(void);
+volatile uint16_t *SimSPIFlags(void);
+volatile uint16_t *SimUARTFlags(void);
+#define UCB0STATW   (SimSPIStatus())
+#define UCA0STATW   (SimUARTStatus())
+#define UCB0IFG     (*SimSPIFlags())
+#define UCA0IFG     (*SimUARTFlags())
+
+#define UCBUSY      0x0001
+#define UCRXIFG     0x0001
+#define UCTXIFG     0x0002
+
+//------------------------------------------
+// DMA
+typedef struct
+{
+    volatile void *srcEndPtr;
+    volatile void *dstEndPtr;
+    volatile uint32_t control;
+    volatile uint32_t spare;
+} DMA_ControlTable;
+
+// The channel mappings the application uses, with the values of dma.h: the source in bits 24-31, the channel in
+// bits 0-7
+#define DMA_CH0_EUSCIA0TX       0x01000000
+#define DMA_CH7_RESERVED0       0x00000007
+#define DMA_CH0_EUSCIB0TX0      0x02000000
+
+#define UDMA_PRI_SELECT         0x00000000
+#define UDMA_ALT_SELECT         0x00000008
+
+#define UDMA_MODE_STOP          0x00000000
+#define UDMA_MODE_BASIC         0x00000001
+#define UDMA_MODE_AUTO          0x00000002
+#define UDMA_MODE_PINGPONG      0x00000003
+
+#define UDMA_ATTR_USEBURST      0x00000001
+#define UDMA_ATTR_ALTSELECT     0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY 0x00000004
+#define UDMA_ATTR_REQMASK       0x00000008
+
+#define UDMA_DST_INC_8          0x00000000
+#define UDMA_DST_INC_16         0x50000000
+#define UDMA_DST_INC_32         0xA0000000
+#define UDMA_DST_INC_NONE       0xC0000000
+#define UDMA_SRC_INC_8          0x00000000
+#define UDMA_SRC_INC_16         0x05000000
+#define UDMA_SRC_INC_32         0x0A000000
+#define UDMA_SRC_INC_NONE       0x0C000000
+#define UDMA_SIZE_8             0x00000000
+#define UDMA_SIZE_16            0x11000000
+#define UDMA_SIZE_32            0x22000000
+#define UDMA_ARB_1              0x00000000
+#define UDMA_ARB_1024           0x00028000
+
+#define DMA_INT0    INT_DMA_INT0
+#define DMA_INT1    INT_DMA_INT1
+#define DMA_INT2    INT_DMA_INT2
+#define DMA_INT3    INT_DMA_INT3
+
+void DMA_enableModule(void);
+void DMA_setControlBase(void *controlTable);
+void DMA_assignChannel(uint32_t mapping);
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control);
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode, void *srcAddr, void *dstAddr,
+                            uint32_t transferSize);
+void DMA_enableChannel(uint32_t channelNum);
+void DMA_disableChannel(uint32_t channelNum);
+bool DMA_isChannelEnabled(uint32_t channelNum);
+void DMA_requestSoftwareTransfer(uint32_t channel);
+void DMA_assignInterrupt(uint32_t interruptNumber, uint32_t channel);
+void DMA_clearInterruptFlag(uint32_t channel);
+void DMA_enableInterrupt(uint32_t interruptNumber);
+void DMA_disableInterrupt(uint32_t interruptNumber);
+
+//------------------------------------------
+// CRC32 and AES256. The simulator has neither: only the tests that model them (test/CryptoModel.c) use these.
+#define CRC32_BASE      ((uintptr_t) 0x40004000)
+#define OFS_CRC32DI     0x0000
+#define OFS_CRC32DIRB   0x0004
+#define CRC16_MODE      0x00
+#define CRC32_MODE      0x01
+
+void CRC32_setSeed(uint32_t seed, uint_fast8_t crcType);
+void CRC32_set8BitData(uint8_t dataIn, uint_fast8_t crcType);
+void CRC32_set8BitDataReversed(uint8_t dataIn, uint_fast8_t crcType);
+uint32_t CRC32_getResult(uint_fast8_t crcType);
+uint32_t CRC32_getResultReversed(uint_fast8_t crcType);
+
+#define AES256_BASE             0x40003C00
+#define AES256_KEYLENGTH_128BIT 128
+#define AES256_KEYLENGTH_192BIT 192
+#define AES256_KEYLENGTH_256BIT 256
+
+bool AES256_setCipherKey(uint32_t moduleInstance, const uint8_t *cipherKey, uint_fast16_t keyLength);
+bool AES256_setDecipherKey(uint32_t moduleInstance, const uint8_t *cipherKey, uint_fast16_t keyLength);
+void AES256_encryptData(uint32_t moduleInstance, const uint8_t *data, uint8_t *encryptedData);
+void AES256_decryptData(uint32_t moduleInstance, const uint8_t *data, uint8_t *decryptedData);
+
+//------------------------------------------
+// FlashCtl. Only the sectors of the flash log (see FlashLog.h) exist: the simulator keeps them in an array.
+#define FLASH_MAIN_MEMORY_SPACE_BANK0   0x01
+#define FLASH_MAIN_MEMORY_SPACE_BANK1   0x02
+
+#define FLASH_SECTOR28  0x10000000
+#define FLASH_SECTOR29  0x20000000
+#define FLASH_SECTOR30  0x40000000
+#define FLASH_SECTOR31  0x80000000
+
+bool FlashCtl_unprotectSector(uint_fast8_t memorySpace, uint32_t sectorMask);
+bool FlashCtl_protectSector(uint_fast8_t memorySpace, uint32_t sectorMask);
+bool FlashCtl_eraseSector(uint32_t addr);
+bool FlashCtl_programMemory(void *src, void *dest, uint32_t length);
+
+#endif // HOST_DRIVERLIB_H_
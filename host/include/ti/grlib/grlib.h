@@ -0,0 +1,104 @@
+//------------------------------------------
+// HOST GRLIB
+// A stand-in for the parts of the TI graphics library that the application uses. The types that the
+// display driver and the font fill in have the layout of the real grlib, so LcdDriver/ and fonts/
+// compile unchanged. Drawing goes through the display driver functions, like in the real library,
+// so the simulated LCD receives the same SPI traffic.
+
+#ifndef HOST_GRLIB_H_
+#define HOST_GRLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct Graphics_Rectangle
+{
+    int16_t xMin;
+    int16_t yMin;
+    int16_t xMax;
+    int16_t yMax;
+} Graphics_Rectangle;
+
+// The old StellarisWare field names, used by the Crystalfontz driver
+#define sXMin xMin
+#define sYMin yMin
+#define sXMax xMax
+#define sYMax yMax
+
+typedef struct Graphics_Display
+{
+    int32_t size;
+    void *displayData;
+    uint16_t width;
+    uint16_t heigth;
+} Graphics_Display;
+
+typedef struct Graphics_Display_Functions
+{
+    void (*pfnPixelDraw)(const Graphics_Display *pDisplay, int16_t lX, int16_t lY, uint16_t ulValue);
+    void (*pfnPixelDrawMultiple)(const Graphics_Display *pDisplay, int16_t lX, int16_t lY, int16_t lX0,
+                                 int16_t lCount, int16_t lBPP, const uint8_t *pucData,
+                                 const uint32_t *pucPalette);
+    void (*pfnLineDrawH)(const Graphics_Display *pDisplay, int16_t lX1, int16_t lX2, int16_t lY,
+                         uint16_t ulValue);
+    void (*pfnLineDrawV)(const Graphics_Display *pDisplay, int16_t lX, int16_t lY1, int16_t lY2,
+                         uint16_t ulValue);
+    void (*pfnRectFill)(const Graphics_Display *pDisplay, const Graphics_Rectangle *pRect, uint16_t ulValue);
+    uint32_t (*pfnColorTranslate)(const Graphics_Display *pDisplay, uint32_t ulValue);
+    void (*pfnFlush)(const Graphics_Display *pDisplay);
+    void (*pfnClearDisplay)(const Graphics_Display *pDisplay, uint16_t ulValue);
+} Graphics_Display_Functions;
+
+#define FONT_FMT_UNCOMPRESSED   0x00
+#define FONT_FMT_PIXEL_RLE      0x01
+
+typedef struct Graphics_Font
+{
+    uint8_t format;
+    uint8_t maxWidth;
+    uint8_t height;
+    uint8_t baseline;
+    uint16_t offset[96];
+    const uint8_t *data;
+} Graphics_Font;
+
+typedef struct Graphics_Context
+{
+    int32_t size;
+    const Graphics_Display *display;
+    const Graphics_Display_Functions *displayFxns;
+    Graphics_Rectangle clipRegion;
+    uint32_t foreground;        // translated by the display driver
+    uint32_t background;        // translated by the display driver
+    const Graphics_Font *font;
+} Graphics_Context;
+
+#define GRAPHICS_COLOR_BLACK    0x00000000
+#define GRAPHICS_COLOR_BLUE     0x000000FF
+#define GRAPHICS_COLOR_GREEN    0x00008000
+#define GRAPHICS_COLOR_LIME     0x0000FF00
+#define GRAPHICS_COLOR_RED      0x00FF0000
+#define GRAPHICS_COLOR_YELLOW   0x00FFFF00
+#define GRAPHICS_COLOR_WHITE    0x00FFFFFF
+
+#define OPAQUE_TEXT             1
+#define TRANSPARENT_TEXT        0
+
+extern const Graphics_Font g_sFontCmtt16;
+
+void Graphics_initContext(Graphics_Context *context, Graphics_Display *display,
+                          const Graphics_Display_Functions *displayFxns);
+void Graphics_setForegroundColor(Graphics_Context *context, int32_t value);
+void Graphics_setBackgroundColor(Graphics_Context *context, int32_t value);
+void Graphics_setClipRegion(Graphics_Context *context, Graphics_Rectangle *rect);
+void Graphics_setFont(Graphics_Context *context, const Graphics_Font *font);
+void Graphics_clearDisplay(const Graphics_Context *context);
+void Graphics_drawString(const Graphics_Context *context, int8_t *string, int32_t length, int32_t x,
+                         int32_t y, bool opaque);
+void Graphics_drawPixel(const Graphics_Context *context, int32_t x, int32_t y);
+void Graphics_drawLine(const Graphics_Context *context, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void Graphics_drawCircle(const Graphics_Context *context, int32_t x, int32_t y, int32_t radius);
+
+#define GrContextFontSet(context, font) Graphics_setFont((context), (font))
+
+#endif // HOST_GRLIB_H_
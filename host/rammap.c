@@ -0,0 +1,225 @@
+//------------------------------------------
+// RAM MAP
+// This host program turns the module summary of a linker map of the TI compiler into the table of RamUsage.h:
+// the SRAM each module takes, its "rw data" (.data and .bss), the largest first. The module summary lists the
+// object files of the project, then those of each library, and the stack, the heap and what the linker generates:
+//
+//        Module                  code    ro data   rw data
+//        ------                  ----    -------   -------
+//     .\                                  the project
+//        colorTest_main.obj      3452    112       1170
+//        HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.obj
+//                                312     0         12
+//     ...
+//        Stack:                  0       0         512
+//
+// It also reads the output of size(1) in its default format, one line per object file, where the rw data is the
+// data and bss columns:
+//
+//        text    data     bss     dec     hex filename
+//        3452     104    1066    4622    120e build/ilp32/colorTest_main.o
+//
+// The names lose their directory and everything from their first dot, and modules of the same name are added up.
+// A table made from the output of size is marked as an estimate: the host build has none of the target-only code.
+// Build it with any C compiler on the host, or with make -C host:
+//
+//    cc -O2 -o rammap rammap.c
+//    ./rammap Debug/colorTest.map assets/RamMap.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_MODULES 512
+#define MAX_NAME    64
+
+typedef struct {
+    char     name[MAX_NAME];
+    uint32_t bytes;
+} Module_t;
+
+static Module_t modules[MAX_MODULES];
+static int moduleCount;
+
+static void AddModule(const char *name, uint32_t bytes)
+{
+    int m;
+
+    for (m = 0; m < moduleCount; m++)
+    {
+        if (!strcmp(modules[m].name, name))
+        {
+            modules[m].bytes += bytes;
+            return;
+        }
+    }
+    if (moduleCount == MAX_MODULES)
+    {
+        fprintf(stderr, "more than %d modules, %s is left out\n", MAX_MODULES, name);
+        return;
+    }
+    snprintf(modules[moduleCount].name, MAX_NAME, "%s", name);
+    modules[moduleCount].bytes = bytes;
+    moduleCount++;
+}
+
+// A name too long for its column is alone on its line, and its sizes are on the next one
+static char wrappedName[512];
+
+// This function returns false if the line does not end with the three sizes of a module
+static bool ParseModule(char *line)
+{
+    char *end = line + strlen(line);
+    char *name, *dot;
+    unsigned long sizes[3];
+    int s;
+
+    for (s = 2; s >= 0; s--)
+    {
+        char *token;
+
+        while (end > line && isspace((unsigned char) end[-1]))
+            end--;
+        token = end;
+        while (token > line && isdigit((unsigned char) token[-1]))
+            token--;
+        if (token == end || (token > line && !isspace((unsigned char) token[-1])))
+        {
+            snprintf(wrappedName, sizeof(wrappedName), "%s", line);
+            return false;
+        }
+        sizes[s] = strtoul(token, NULL, 10);
+        end = token;
+    }
+
+    if (end == line || strspn(line, " \t") == (size_t) (end - line))
+    {
+        line = wrappedName;
+        end = line + strlen(line);
+    }
+    while (end > line && (isspace((unsigned char) end[-1]) || end[-1] == ':'))
+        end--;
+    *end = '\0';
+    name = line;
+    while (isspace((unsigned char) *name))
+        name++;
+    if (*name == '\0' || !strcmp(name, "Total") || !strcmp(name, "Grand Total"))
+        return false;
+
+    if (strrchr(name, '\\'))
+        name = strrchr(name, '\\') + 1;
+    if (strrchr(name, '/'))
+        name = strrchr(name, '/') + 1;
+    dot = strchr(name, '.');
+    if (dot && dot != name)
+        *dot = '\0';
+
+    if (sizes[2])
+        AddModule(name, sizes[2]);
+    return true;
+}
+
+// This function returns false if the line is not one of an object file in the output of size
+static bool ParseSize(char *line)
+{
+    unsigned long text, data, bss, dec;
+    char name[MAX_NAME], *base, *dot;
+
+    if (sscanf(line, "%lu %lu %lu %lu %*x %63s", &text, &data, &bss, &dec, name) != 5)
+        return false;
+
+    base = strrchr(name, '/') ? strrchr(name, '/') + 1 : name;
+    dot = strchr(base, '.');
+    if (dot && dot != base)
+        *dot = '\0';
+
+    if (data + bss)
+        AddModule(base, data + bss);
+    return true;
+}
+
+static int Larger(const void *a, const void *b)
+{
+    const Module_t *A = a, *B = b;
+
+    if (A->bytes != B->bytes)
+        return (A->bytes < B->bytes) ? 1 : -1;
+    return strcmp(A->name, B->name);
+}
+
+int main(int argc, char *argv[])
+{
+    char line[512];
+    const char *mapName;
+    bool summary = false, sizes = false;
+    FILE *map, *out;
+    int m;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s colorTest.map RamMap.c\n", argv[0]);
+        return 2;
+    }
+
+    map = fopen(argv[1], "r");
+    if (!map)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), map))
+    {
+        if (sizes)
+            ParseSize(line);
+        else if (!summary)
+        {
+            summary = strstr(line, "MODULE SUMMARY") != NULL;
+            sizes = strstr(line, "text") && strstr(line, "bss") && strstr(line, "filename");
+        }
+        else if (strstr(line, "Grand Total"))
+            break;
+        else
+            ParseModule(line);
+    }
+    fclose(map);
+
+    if (!summary && !sizes)
+    {
+        fprintf(stderr, "%s: no MODULE SUMMARY, is it a map of the TI linker or the output of size?\n", argv[1]);
+        return 1;
+    }
+    qsort(modules, moduleCount, sizeof(Module_t), Larger);
+
+    out = fopen(argv[2], "w");
+    if (!out)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+    mapName = strrchr(argv[1], '/') ? strrchr(argv[1], '/') + 1 : argv[1];
+    fprintf(out, "// Generated by host/rammap from %s. Do not edit.\n", mapName);
+    if (sizes)
+        fprintf(out, "// The SRAM of each module of the application, .data and .bss, the largest first, as a 32-bit build\n"
+                     "// of the host lays it out. Regenerate it from the linker map of the CCS build for the exact one.\n\n");
+    else
+        fprintf(out, "// The SRAM of each module of the target build, .data and .bss, the largest first.\n\n");
+    fprintf(out, "#include <RamUsage.h>\n\n");
+    fprintf(out, "const RamModule_t RamModules[] = {\n");
+    for (m = 0; m < moduleCount; m++)
+        fprintf(out, "    {\"%s\", %lu},\n", modules[m].name, (unsigned long) modules[m].bytes);
+    if (moduleCount == 0)
+        fprintf(out, "    {0}\n");
+    fprintf(out, "};\n\n");
+    fprintf(out, "const unsigned RamModuleCount = %d;\n", moduleCount);
+    fprintf(out, "const bool RamModulesEstimated = %s;\n", sizes ? "true" : "false");
+
+    if (fclose(out) != 0)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1281 @@
+//------------------------------------------
+// HOST DRIVERLIB
+// Simulated peripherals behind the driverlib calls of the application: GPIO with edge interrupts,
+// Timer32, Timer_A in up mode, SysTick, the NVIC, ADC14 in repeat mode with its window comparator, eUSCI_B0 in SPI
+// mode feeding the LCD, eUSCI_A0 as a UART fed by the DMA or its transmit interrupt, the DMA channels, and WDT_A.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <string.h>
+#include "Sim.h"
+
+// The ISRs of the application. They are weak so that the host build links whether or not a module
+// that defines one is part of it.
+void SysTick_Handler(void) __attribute__((weak));
+void ADC14_IRQHandler(void) __attribute__((weak));
+void TA3_0_IRQHandler(void) __attribute__((weak));
+void EUSCIA0_IRQHandler(void) __attribute__((weak));
+void DMA_INT0_IRQHandler(void) __attribute__((weak));
+void DMA_INT1_IRQHandler(void) __attribute__((weak));
+void DMA_INT2_IRQHandler(void) __attribute__((weak));
+void DMA_INT3_IRQHandler(void) __attribute__((weak));
+void PORT1_IRQHandler(void) __attribute__((weak));
+void PORT2_IRQHandler(void) __attribute__((weak));
+void PORT3_IRQHandler(void) __attribute__((weak));
+void PORT4_IRQHandler(void) __attribute__((weak));
+void PORT5_IRQHandler(void) __attribute__((weak));
+void PORT6_IRQHandler(void) __attribute__((weak));
+
+#define INT_SYSTICK 15
+
+FILE *SimUARTFile;
+uint64_t SimSPIBytes;
+uint64_t SimLcdDeselectedBytes;
+volatile uint32_t SimDEMCR, SimDWTCTRL, SimDWTCYCCNT;
+
+//------------------------------------------
+// Clocks
+
+// The simulated clock runs at SIM_MCLK_HZ, the frequency of HFXT. MCLK is HFXT divided by mclkDivider, so a cycle
+// of MCLK is mclkDivider cycles of the simulated clock. The reset values are those of the 3 MHz DCO.
+static uint32_t mclk = 3000000;
+static uint32_t smclk = 3000000;
+static uint32_t mclkDivider = SIM_MCLK_HZ / 3000000;
+
+uint64_t SimClockChanges;
+uint64_t SimSlowCycles;
+static uint64_t slowSince;
+
+static void RescaleTimers(void);
+
+void BSP_Clock_InitFastest(void)
+{
+    mclk = SIM_MCLK_HZ;
+    smclk = SIM_MCLK_HZ / 4;
+    mclkDivider = 1;
+}
+
+void CS_setExternalClockSourceFrequency(uint32_t lfxt_XT_CLK_frequency, uint32_t hfxt_XT_CLK_frequency) {}
+
+void CS_initClockSignal(uint32_t selectedClockSignal, uint32_t clockSource, uint32_t clockSourceDivider)
+{
+    uint32_t divider = 1u << (clockSourceDivider >> 28);
+
+    if (selectedClockSignal == CS_SMCLK)
+    {
+        smclk = SIM_MCLK_HZ / divider;
+        return;
+    }
+    if (selectedClockSignal != CS_MCLK || divider == mclkDivider)
+        return;
+
+    RescaleTimers();
+    if (mclkDivider == 1)
+        slowSince = SimNow;
+    else if (divider == 1)
+        SimSlowCycles += SimNow - slowSince;
+    mclkDivider = divider;
+    mclk = SIM_MCLK_HZ / divider;
+    SimClockChanges++;
+}
+
+uint32_t CS_getMCLK(void)
+{
+    return mclk;
+}
+
+uint32_t CS_getSMCLK(void)
+{
+    return smclk;
+}
+
+uint64_t SimSlowTime(void)
+{
+    return SimSlowCycles + ((mclkDivider > 1) ? SimNow - slowSince : 0);
+}
+
+void __delay_cycles(uint32_t cycles)
+{
+    SimAdvance((uint64_t) cycles * mclkDivider);
+}
+
+// The LCD driver's delay for compilers other than TI's (see HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h)
+void SysCtlDelay(uint32_t cycles)
+{
+    SimAdvance((uint64_t) cycles * mclkDivider);
+}
+
+bool PCM_gotoLPM0(void)
+{
+    SimSleep();
+    return true;
+}
+
+//------------------------------------------
+// WDT_A and ResetCtl: the simulation cannot be reset, so a time-out of the watchdog is reported instead, when it
+// is finally kicked or at the end of the run. Every run starts from a power-up.
+
+uint64_t SimWatchdogKicks;
+uint64_t SimWatchdogLongestGap;
+unsigned SimWatchdogTimeouts;
+
+static bool wdtRunning;
+static uint64_t wdtPeriod;
+static uint64_t wdtCleared;
+
+void WDT_A_holdTimer(void)
+{
+    wdtRunning = false;
+}
+
+void WDT_A_initWatchdogTimer(uint_fast8_t clockSelect, uint_fast8_t clockDivider)
+{
+    static const uint32_t iterationBits[8] = {31, 27, 23, 19, 15, 13, 9, 6};
+    uint32_t hz;
+
+    switch (clockSelect)
+    {
+    case WDT_A_CLOCKSOURCE_SMCLK:
+        hz = smclk;
+        break;
+    case WDT_A_CLOCKSOURCE_VLOCLK:
+        hz = 9400;
+        break;
+    default:
+        hz = 32768;             // ACLK and BCLK on REFO
+        break;
+    }
+
+    wdtRunning = false;
+    wdtPeriod = ((uint64_t) 1 << iterationBits[clockDivider & 7]) * SIM_MCLK_HZ / hz;
+}
+
+void WDT_A_setTimeoutReset(uint_fast8_t resetType)
+{
+}
+
+void WDT_A_startTimer(void)
+{
+    wdtRunning = true;
+    wdtCleared = SimNow;
+}
+
+void SimWatchdogCheck(void)
+{
+    uint64_t gap = SimNow - wdtCleared;
+
+    if (!wdtRunning)
+        return;
+    if (gap > SimWatchdogLongestGap)
+        SimWatchdogLongestGap = gap;
+    if (gap >= wdtPeriod)
+    {
+        fprintf(stderr, "the watchdog would have reset the MCU at %.3f s\n",
+                (double) (wdtCleared + wdtPeriod) / SIM_MCLK_HZ);
+        SimWatchdogTimeouts++;
+    }
+}
+
+void WDT_A_clearTimer(void)
+{
+    SimWatchdogCheck();
+    SimWatchdogKicks++;
+    wdtCleared = SimNow;
+}
+
+uint32_t ResetCtl_getHardResetSource(void)
+{
+    return 0;
+}
+
+void ResetCtl_clearHardResetSource(uint32_t mask)
+{
+}
+
+//------------------------------------------
+// NVIC
+
+static bool masterEnabled;
+static bool inISR;
+static bool nvicEnabled[NUM_INTERRUPTS];
+static uint8_t nvicPriority[NUM_INTERRUPTS];
+
+void Interrupt_enableMaster(void)
+{
+    SimPeripheralChanged();
+    masterEnabled = true;
+    SimService();
+}
+
+bool Interrupt_disableMaster(void)
+{
+    bool wasDisabled = !masterEnabled;
+    masterEnabled = false;
+    return wasDisabled;
+}
+
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    SimPeripheralChanged();
+    nvicEnabled[interruptNumber] = true;
+    SimService();
+}
+
+void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    nvicEnabled[interruptNumber] = false;
+}
+
+bool Interrupt_isEnabled(uint32_t interruptNumber)
+{
+    return nvicEnabled[interruptNumber];
+}
+
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t priority)
+{
+    nvicPriority[interruptNumber] = priority;
+}
+
+//------------------------------------------
+// GPIO
+
+#define PORTS 12
+
+typedef struct {
+    uint16_t out, in, ies, ie, ifg;
+} Port_t;
+
+// Every input reads high until the script says otherwise: the buttons have pull-ups
+static Port_t ports[PORTS] = {
+    [0 ... PORTS - 1] = {.in = 0xFFFF},
+};
+
+static void SetInput(uint_fast8_t port, uint_fast16_t pin, bool high)
+{
+    Port_t *P = &ports[port];
+    bool wasHigh = P->in & pin;
+
+    SimPeripheralChanged();
+
+    if (high)
+        P->in |= pin;
+    else
+        P->in &= ~pin;
+
+    // The flag is set on the selected edge whether or not the interrupt is enabled
+    if ((high != wasHigh) && (high == !(P->ies & pin)))
+        P->ifg |= pin;
+}
+
+void GPIO_setAsOutputPin(uint_fast8_t port, uint_fast16_t pins) {}
+void GPIO_setAsInputPin(uint_fast8_t port, uint_fast16_t pins) {}
+void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t port, uint_fast16_t pins) {}
+void GPIO_setAsInputPinWithPullDownResistor(uint_fast8_t port, uint_fast16_t pins) {}
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode) {}
+void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode) {}
+
+void GPIO_setOutputHighOnPin(uint_fast8_t port, uint_fast16_t pins)
+{
+    ports[port].out |= pins;
+}
+
+void GPIO_setOutputLowOnPin(uint_fast8_t port, uint_fast16_t pins)
+{
+    ports[port].out &= ~pins;
+}
+
+void GPIO_toggleOutputOnPin(uint_fast8_t port, uint_fast16_t pins)
+{
+    ports[port].out ^= pins;
+}
+
+uint8_t GPIO_getInputPinValue(uint_fast8_t port, uint_fast16_t pins)
+{
+    return (ports[port].in & pins) ? GPIO_INPUT_PIN_HIGH : GPIO_INPUT_PIN_LOW;
+}
+
+void GPIO_interruptEdgeSelect(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t edgeSelect)
+{
+    if (edgeSelect == GPIO_HIGH_TO_LOW_TRANSITION)
+        ports[port].ies |= pins;
+    else
+        ports[port].ies &= ~pins;
+}
+
+void GPIO_enableInterrupt(uint_fast8_t port, uint_fast16_t pins)
+{
+    SimPeripheralChanged();
+    ports[port].ie |= pins;
+    SimService();
+}
+
+void GPIO_disableInterrupt(uint_fast8_t port, uint_fast16_t pins)
+{
+    ports[port].ie &= ~pins;
+}
+
+void GPIO_clearInterruptFlag(uint_fast8_t port, uint_fast16_t pins)
+{
+    ports[port].ifg &= ~pins;
+}
+
+uint_fast16_t GPIO_getInterruptStatus(uint_fast8_t port, uint_fast16_t pins)
+{
+    return ports[port].ifg & pins;
+}
+
+uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t port)
+{
+    return ports[port].ifg & ports[port].ie;
+}
+
+// The pins of the buttons, in SimButton_t order. They are active low.
+static const struct {
+    uint8_t port;
+    uint16_t pin;
+} buttonPins[SIM_BUTTONS] = {
+    {GPIO_PORT_P5, GPIO_PIN1},      // SIM_BUTTON_TOP
+    {GPIO_PORT_P3, GPIO_PIN5},      // SIM_BUTTON_BOTTOM
+    {GPIO_PORT_P1, GPIO_PIN1},      // SIM_BUTTON_LEFT
+    {GPIO_PORT_P1, GPIO_PIN4},      // SIM_BUTTON_RIGHT
+};
+
+void SimSetButton(SimButton_t button, bool pressed)
+{
+    SetInput(buttonPins[button].port, buttonPins[button].pin, !pressed);
+}
+
+//------------------------------------------
+// Timer32 and SysTick
+
+// The timers count MCLK, so their counts are (SimNow - start) / mclkDivider. When MCLK changes, the count so far is
+// folded into value and start moves to now, less the part of a count that has gone by.
+typedef struct {
+    uint32_t load;
+    uint32_t value;             // the value at start
+    uint32_t shift;             // log2 of the prescaler
+    uint64_t start;             // SimNow when the counter was loaded or MCLK last changed
+    bool     running;
+} Timer32_t;
+
+static Timer32_t timer32[2];
+
+static Timer32_t *T32(uint32_t timer)
+{
+    return &timer32[timer == TIMER32_1_BASE];
+}
+
+// The timers are free running with a load of UINT32_MAX, or periodic with a smaller one
+static uint32_t Timer32Value(Timer32_t *T)
+{
+    uint64_t counts = ((SimNow - T->start) / mclkDivider) >> T->shift;
+    uint64_t period = (uint64_t) T->load + 1;
+
+    if (!T->running)
+        return T->value;
+    return (uint32_t) ((T->value + period - counts % period) % period);
+}
+
+void Timer32_initModule(uint32_t timer, uint32_t preScaler, uint32_t resolution, uint32_t mode)
+{
+    T32(timer)->shift = (preScaler == TIMER32_PRESCALER_256) ? 8 : (preScaler == TIMER32_PRESCALER_16) ? 4 : 0;
+}
+
+void Timer32_setCount(uint32_t timer, uint32_t count)
+{
+    T32(timer)->load = count;
+    T32(timer)->value = count;
+    T32(timer)->start = SimNow;
+}
+
+void Timer32_startTimer(uint32_t timer, bool oneShot)
+{
+    T32(timer)->running = true;
+    T32(timer)->start = SimNow;
+}
+
+void Timer32_haltTimer(uint32_t timer)
+{
+    T32(timer)->value = Timer32Value(T32(timer));
+    T32(timer)->running = false;
+}
+
+// Reading a timer register costs a few cycles, so that a loop that polls a timer ends
+#define TIMER_READ_CYCLES 4
+
+uint32_t Timer32_getValue(uint32_t timer)
+{
+    SimAdvance(TIMER_READ_CYCLES);
+
+    return Timer32Value(T32(timer));
+}
+
+SysTick_Type SimSysTick;
+
+// The period is in MCLK cycles, and counted at the MCLK of the last SysTick_enableModule
+static uint32_t sysTickPeriod = 1;
+static uint64_t sysTickSimPeriod = 1;
+static bool sysTickRunning, sysTickInterrupt, sysTickPending;
+static uint64_t sysTickStart, sysTickNext;
+
+static void RescaleTimers(void)
+{
+    unsigned t;
+
+    for (t = 0; t < 2; t++)
+    {
+        Timer32_t *T = &timer32[t];
+        uint64_t partial = (SimNow - T->start) % ((uint64_t) mclkDivider << T->shift);
+
+        T->value = Timer32Value(T);
+        T->start = SimNow - partial;
+    }
+}
+
+void SysTick_enableModule(void)
+{
+    SimPeripheralChanged();
+    sysTickRunning = true;
+    sysTickSimPeriod = (uint64_t) sysTickPeriod * mclkDivider;
+    sysTickStart = SimNow;
+    sysTickNext = SimNow + sysTickSimPeriod;
+}
+
+void SysTick_disableModule(void)
+{
+    sysTickRunning = false;
+}
+
+void SysTick_setPeriod(uint32_t period)
+{
+    SimPeripheralChanged();
+    sysTickPeriod = period;
+}
+
+uint32_t SysTick_getPeriod(void)
+{
+    return sysTickPeriod;
+}
+
+uint32_t SysTick_getValue(void)
+{
+    return sysTickPeriod - 1 - (uint32_t) ((SimNow - sysTickStart) % sysTickSimPeriod / mclkDivider);
+}
+
+void SysTick_enableInterrupt(void)
+{
+    SimPeripheralChanged();
+    sysTickInterrupt = true;
+}
+
+void SysTick_disableInterrupt(void)
+{
+    sysTickInterrupt = false;
+}
+
+//------------------------------------------
+// Timer_A in up mode, from ACLK or SMCLK. Only the CCR0 interrupt is modelled; the outputs are not, but the time
+// Timer_A0 runs is counted, since it drives the buzzer.
+
+#define TIMER_A_COUNT   4
+#define ACLK_HZ         32768
+
+typedef struct {
+    bool running;
+    bool aclk;
+    bool interrupt;                 // on CCR0
+    uint16_t ccr0;
+    uint64_t start;                 // when it last counted from 0
+    uint64_t started;               // when it was last started, for the time it runs
+} TimerA_t;
+
+static TimerA_t timerA[TIMER_A_COUNT];
+
+uint64_t SimBuzzerTones;
+uint64_t SimBuzzerCycles;
+
+static TimerA_t *TimerA(uint32_t timer)
+{
+    return &timerA[(timer - TIMER_A0_BASE) / 0x400 % TIMER_A_COUNT];
+}
+
+// The simulated cycles of a period: SMCLK changes with the clock governor, but a running timer is restarted by
+// whoever changes it
+static uint64_t TimerAPeriod(const TimerA_t *T)
+{
+    uint32_t hz = T->aclk ? ACLK_HZ : smclk;
+
+    return ((uint64_t) T->ccr0 + 1) * SIM_MCLK_HZ / hz;
+}
+
+void Timer_A_configureUpMode(uint32_t timer, const Timer_A_UpModeConfig *config)
+{
+    TimerA_t *T = TimerA(timer);
+
+    T->aclk = config->clockSource == TIMER_A_CLOCKSOURCE_ACLK;
+    T->interrupt = config->captureCompareInterruptEnable_CCR0_CCIE == TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE;
+    T->ccr0 = config->timerPeriod;
+    T->start = SimNow;
+}
+
+void Timer_A_initCompare(uint32_t timer, const Timer_A_CompareModeConfig *compareConfig) {}
+
+void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode)
+{
+    TimerA_t *T = TimerA(timer);
+
+    SimPeripheralChanged();
+    if (!T->running)
+    {
+        T->started = SimNow;
+        if (timer == TIMER_A0_BASE)
+            SimBuzzerTones++;
+    }
+    T->running = true;
+}
+
+void Timer_A_stopTimer(uint32_t timer)
+{
+    TimerA_t *T = TimerA(timer);
+
+    if (T->running && timer == TIMER_A0_BASE)
+        SimBuzzerCycles += SimNow - T->started;
+    T->running = false;
+}
+
+void Timer_A_clearTimer(uint32_t timer)
+{
+    TimerA(timer)->start = SimNow;
+}
+
+void Timer_A_setCompareValue(uint32_t timer, uint_fast16_t compareRegister, uint_fast16_t compareValue)
+{
+    if (compareRegister == TIMER_A_CAPTURECOMPARE_REGISTER_0)
+        TimerA(timer)->ccr0 = compareValue;
+}
+
+// The flag stays set until it is cleared; the next one comes a period after the last
+void Timer_A_clearCaptureCompareInterrupt(uint32_t timer, uint_fast16_t captureCompareRegister)
+{
+    TimerA_t *T = TimerA(timer);
+
+    while (T->start + TimerAPeriod(T) <= SimNow)
+        T->start += TimerAPeriod(T);
+}
+
+static uint64_t TimerAInterruptTime(uint32_t timer)
+{
+    const TimerA_t *T = TimerA(timer);
+
+    return (T->running && T->interrupt) ? T->start + TimerAPeriod(T) : SIM_NEVER;
+}
+
+//------------------------------------------
+// ADC14: MEM0 to MEM3 are converted over and over: the joystick on MEM0 and MEM1, the accelerometer on MEM2 and
+// MEM3. The window comparator flags come from the results as they are now.
+
+// A sequence of four conversions on the 25 MHz ADC oscillator takes about 4 us
+#define ADC_SEQUENCE_CYCLES 192
+#define ADC_MEMORIES        4
+#define ADC_NO_WINDOW       -1
+
+#define ADC_MEMORY_FLAGS    (ADC_INT0 | ADC_INT1 | ADC_INT2 | ADC_INT3)
+#define ADC_WINDOW_FLAGS    (ADC_IN_INT | ADC_LO_INT | ADC_HI_INT)
+
+static uint16_t adcResults[ADC_MEMORIES] = {8192, 8192, 8192, 8192};
+static int adcWindowOf[ADC_MEMORIES] = {ADC_NO_WINDOW, ADC_NO_WINDOW, ADC_NO_WINDOW, ADC_NO_WINDOW};
+static int16_t adcWindowLow[2], adcWindowHigh[2];
+static bool adcRunning;
+static uint64_t adcMemoryFlagsCleared;  // the flags are set again one sequence after being cleared
+static uint64_t adcWindowFlagsCleared;
+static uint_fast64_t adcInterruptMask;
+
+void SimSetJoystick(uint16_t x, uint16_t y)
+{
+    adcResults[0] = x;
+    adcResults[1] = y;
+}
+
+void SimSetTilt(uint16_t x, uint16_t y)
+{
+    adcResults[2] = x;
+    adcResults[3] = y;
+}
+
+// ADC_MEMn is bit n
+static int AdcMemory(uint32_t memorySelect)
+{
+    int m;
+
+    for (m = 0; m < ADC_MEMORIES; m++)
+    {
+        if (memorySelect == (1u << m))
+            return m;
+    }
+    return ADC_MEMORIES - 1;
+}
+
+void ADC14_enableModule(void) {}
+bool ADC14_initModule(uint32_t clockSource, uint32_t clockPredivider, uint32_t clockDivider,
+                      uint32_t internalChannelMask) { return true; }
+bool ADC14_configureMultiSequenceMode(uint32_t memoryStart, uint32_t memoryEnd, bool repeatMode) { return true; }
+bool ADC14_configureConversionMemory(uint32_t memorySelect, uint32_t refSelect, uint32_t channelSelect,
+                                     bool differntialMode) { return true; }
+bool ADC14_enableSampleTimer(uint32_t multiSampleConvert) { return true; }
+bool ADC14_enableConversion(void) { return true; }
+
+void ADC14_disableConversion(void)
+{
+    adcRunning = false;
+}
+
+bool ADC14_isBusy(void)
+{
+    return false;
+}
+
+bool ADC14_toggleConversionTrigger(void)
+{
+    SimPeripheralChanged();
+    adcRunning = true;
+    adcMemoryFlagsCleared = SimNow;
+    adcWindowFlagsCleared = SimNow;
+    return true;
+}
+
+uint_fast16_t ADC14_getResult(uint32_t memorySelect)
+{
+    return adcResults[AdcMemory(memorySelect)];
+}
+
+bool ADC14_enableComparatorWindow(uint32_t memorySelect, uint32_t windowSelect)
+{
+    if (adcRunning)
+        return false;
+    adcWindowOf[AdcMemory(memorySelect)] = (windowSelect == ADC_COMP_WINDOW1) ? 1 : 0;
+    return true;
+}
+
+bool ADC14_disableComparatorWindow(uint32_t memorySelect)
+{
+    if (adcRunning)
+        return false;
+    adcWindowOf[AdcMemory(memorySelect)] = ADC_NO_WINDOW;
+    return true;
+}
+
+void ADC14_setComparatorWindowValue(uint32_t window, int16_t low, int16_t high)
+{
+    int w = (window == ADC_COMP_WINDOW1) ? 1 : 0;
+
+    adcWindowLow[w] = low;
+    adcWindowHigh[w] = high;
+}
+
+// The flags each result of the sequence sets, whether or not a sequence ended since they were cleared
+static uint_fast64_t WindowFlags(void)
+{
+    uint_fast64_t flags = 0;
+    int m;
+
+    for (m = 0; m < ADC_MEMORIES; m++)
+    {
+        int w = adcWindowOf[m];
+
+        if (w == ADC_NO_WINDOW)
+            continue;
+        if (adcResults[m] < adcWindowLow[w])
+            flags |= ADC_LO_INT;
+        else if (adcResults[m] > adcWindowHigh[w])
+            flags |= ADC_HI_INT;
+        else
+            flags |= ADC_IN_INT;
+    }
+    return flags;
+}
+
+static uint_fast64_t ADCFlags(void)
+{
+    uint_fast64_t flags = 0;
+
+    if (!adcRunning)
+        return 0;
+    if (SimNow >= adcMemoryFlagsCleared + ADC_SEQUENCE_CYCLES)
+        flags |= ADC_MEMORY_FLAGS;
+    if (SimNow >= adcWindowFlagsCleared + ADC_SEQUENCE_CYCLES)
+        flags |= WindowFlags();
+    return flags;
+}
+
+void ADC14_enableInterrupt(uint_fast64_t mask)
+{
+    SimPeripheralChanged();
+    adcInterruptMask |= mask;
+}
+
+void ADC14_disableInterrupt(uint_fast64_t mask)
+{
+    adcInterruptMask &= ~mask;
+}
+
+uint_fast64_t ADC14_getEnabledInterruptStatus(void)
+{
+    return ADCFlags() & adcInterruptMask;
+}
+
+void ADC14_clearInterruptFlag(uint_fast64_t mask)
+{
+    if (mask & ADC_MEMORY_FLAGS)
+        adcMemoryFlagsCleared = SimNow;
+    if (mask & ADC_WINDOW_FLAGS)
+        adcWindowFlagsCleared = SimNow;
+}
+
+//------------------------------------------
+// eUSCI_B0 (SPI to the LCD) and eUSCI_A0 (UART)
+
+// UCB0TXBUF holds this value when no byte is waiting, so that a written byte can be told apart
+#define TXBUF_EMPTY 0xFFFF
+
+volatile uint16_t UCB0TXBUF = TXBUF_EMPTY, UCB0RXBUF;
+
+static uint32_t spiPrescaler = 1;
+
+// The UART has a transmit buffer and a shift register: a byte written to UCA0TXBUF moves to the shift register
+// as soon as it is free, and UCTXIFG is set again then
+static uint32_t uartBitCycles;          // in SMCLK cycles
+static bool uartTxInterrupt;
+static uint64_t uartBufferFreeAt;       // UCTXIFG is set from then on
+static uint64_t uartDoneAt;             // UCBUSY is set until then
+
+// Fake register addresses, used to recognize the destination of a DMA transfer
+#define UCB0TXBUF_ADDRESS (EUSCI_B0_BASE + 0x0E)
+#define UCA0TXBUF_ADDRESS (EUSCI_A0_BASE + 0x0E)
+
+bool SPI_initMaster(uint32_t moduleInstance, const eUSCI_SPI_MasterConfig *config)
+{
+    // driverlib computes the divider from the clock frequency it is given, not from the actual one
+    spiPrescaler = config->clockSourceFrequency / config->desiredSpiClock;
+    if (spiPrescaler == 0)
+        spiPrescaler = 1;
+    return true;
+}
+
+void SPI_changeMasterClock(uint32_t moduleInstance, uint32_t clockSourceFrequency, uint32_t desiredSpiClock)
+{
+    spiPrescaler = clockSourceFrequency / desiredSpiClock;
+    if (spiPrescaler == 0)
+        spiPrescaler = 1;
+}
+
+void SPI_enableModule(uint32_t moduleInstance) {}
+void SPI_disableModule(uint32_t moduleInstance) {}
+
+static uint64_t SPIByteCycles(void)
+{
+    return 8ull * spiPrescaler * SIM_MCLK_HZ / smclk;
+}
+
+// The LCD data/command line is P3.7
+static bool LcdDataMode(void)
+{
+    return ports[GPIO_PORT_P3].out & GPIO_PIN7;
+}
+
+// The LCD chip select is P5.0, active low: while it is high, the bytes on the SPI are not for the LCD
+static bool LcdSelected(void)
+{
+    return !(ports[GPIO_PORT_P5].out & GPIO_PIN0);
+}
+
+static void LcdSend(uint8_t byte, bool isData)
+{
+    if (LcdSelected())
+        LcdReceive(byte, isData);
+    else
+        SimLcdDeselectedBytes++;
+}
+
+uint16_t SimSPIStatus(void)
+{
+    if (UCB0TXBUF != TXBUF_EMPTY)
+    {
+        uint8_t byte = (uint8_t) UCB0TXBUF;
+        UCB0TXBUF = TXBUF_EMPTY;
+        SimSPIBytes++;
+        LcdSend(byte, LcdDataMode());
+        SimAdvance(SPIByteCycles());
+    }
+    return 0;
+}
+
+//------------------------------------------
+// BSP LCD
+// The transfers of bsp/BSP.c that the benchmark times send the same bytes as there, where they are written to
+// UCB0TXBUF directly, one byte after the other: the window without the offsets of BSP_LCD_Init, which the
+// application does not call, then the pixels. They are counted in BSP_LCD_ByteCount. Like lcdBegin and lcdEnd in
+// bsp/BSP.c, each transfer pulls the chip select (TFT_CS, P5.0) low first and puts it back after.
+// The simulator has no copy of the font of bsp/BSP.c: BSP_LCD_DrawString sends the bytes of its characters, but
+// each one is a blank cell in the background color. host/test/bsptest.c checks the pixels of the real one.
+
+// ST7735_TFTWIDTH and ST7735_TFTHEIGHT of bsp/BSP.c
+#define BSP_LCD_SIZE 128
+
+uint32_t BSP_LCD_ByteCount;
+
+static uint16_t bspIdleCS;
+
+static void BSPWrite(uint8_t byte, bool isData)
+{
+    SimSPIBytes++;
+    BSP_LCD_ByteCount++;
+    LcdSend(byte, isData);
+    SimAdvance(SPIByteCycles());
+}
+
+static void BSPBegin(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    const uint8_t window[2][2] = {{x0, x1}, {y0, y1}};
+    int i;
+
+    bspIdleCS = ports[GPIO_PORT_P5].out & GPIO_PIN0;
+    ports[GPIO_PORT_P5].out &= ~GPIO_PIN0;
+    for (i = 0; i < 2; i++)
+    {
+        BSPWrite(0x2A + i, false);                          // CASET, then RASET
+        BSPWrite(0, true);
+        BSPWrite(window[i][0], true);
+        BSPWrite(0, true);
+        BSPWrite(window[i][1], true);
+    }
+    BSPWrite(0x2C, false);                                  // RAMWR
+}
+
+static void BSPColor(uint16_t color, uint32_t count)
+{
+    while (count--)
+    {
+        BSPWrite(color >> 8, true);
+        BSPWrite(color & 0xFF, true);
+    }
+}
+
+static void BSPEnd(void)
+{
+    ports[GPIO_PORT_P5].out |= bspIdleCS;
+}
+
+void BSP_LCD_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h)
+{
+    int16_t row, column;
+
+    BSPBegin(x, y - h + 1, x + w - 1, y);
+    for (row = h - 1; row >= 0; row--)
+        for (column = 0; column < w; column++)
+            BSPColor(image[row * w + column], 1);
+    BSPEnd();
+}
+
+// Clipped at the right and bottom edges, like the one of bsp/BSP.c
+void BSP_LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (x >= BSP_LCD_SIZE || y >= BSP_LCD_SIZE)
+        return;
+    if (x + w > BSP_LCD_SIZE)
+        w = BSP_LCD_SIZE - x;
+    if (y + h > BSP_LCD_SIZE)
+        h = BSP_LCD_SIZE - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    BSPBegin(x, y, x + w - 1, y + h - 1);
+    BSPColor(color, (uint32_t) w * h);
+    BSPEnd();
+}
+
+// The characters of a row of 21 columns of 6 pixels, 10 pixels apart, and what is returned, as in bsp/BSP.c
+uint32_t BSP_LCD_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor)
+{
+    uint32_t n = 0;
+
+    if (y > 12 || x > 20)
+        return 0;
+    while (pt[n] && x + n <= 20)
+        n++;
+    if (n == 0)
+        return 0;
+
+    BSPBegin(x * 6, y * 10, (x + n) * 6 - 1, y * 10 + 7);
+    BSPColor(0x0000, n * 6 * 8);
+    BSPEnd();
+    return (x + n > 20) ? n - 1 : n;
+}
+
+// A byte is sent whole before the transmit buffer is free again, so bursts take as long as single writes.
+// The flags can be written, as the DMA users do to trigger a transfer, and read back set.
+volatile uint16_t *SimSPIFlags(void)
+{
+    static volatile uint16_t flags;
+
+    SimSPIStatus();
+    flags = UCTXIFG | UCRXIFG;
+    return &flags;
+}
+
+uint32_t SPI_getTransmitBufferAddressForDMA(uint32_t moduleInstance)
+{
+    return UCB0TXBUF_ADDRESS;
+}
+
+// UCSWRST clears the interrupt enables
+bool UART_initModule(uint32_t moduleInstance, const eUSCI_UART_Config *config)
+{
+    uartBitCycles = config->clockPrescalar;
+    if (config->overSampling)
+        uartBitCycles = config->clockPrescalar * 16 + config->firstModReg;
+    uartTxInterrupt = false;
+    return true;
+}
+
+void UART_enableModule(uint32_t moduleInstance) {}
+
+void UART_enableInterrupt(uint32_t moduleInstance, uint_fast8_t mask)
+{
+    SimPeripheralChanged();
+    if (mask & EUSCI_A_UART_TRANSMIT_INTERRUPT)
+        uartTxInterrupt = true;
+}
+
+void UART_disableInterrupt(uint32_t moduleInstance, uint_fast8_t mask)
+{
+    if (mask & EUSCI_A_UART_TRANSMIT_INTERRUPT)
+        uartTxInterrupt = false;
+}
+
+uint_fast8_t UART_getEnabledInterruptStatus(uint32_t moduleInstance)
+{
+    return (uartTxInterrupt && SimNow >= uartBufferFreeAt) ? EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG : 0;
+}
+
+// Like driverlib, this waits for UCTXIFG unless the transmit interrupt is enabled. The byte is written to the
+// file right away; 10 bits per byte: start, 8 data bits, stop.
+void UART_transmitData(uint32_t moduleInstance, uint_fast8_t transmitData)
+{
+    uint64_t start;
+
+    if (!uartTxInterrupt && SimNow < uartBufferFreeAt)
+        SimAdvance(uartBufferFreeAt - SimNow);
+
+    if (SimUARTFile)
+        fputc(transmitData, SimUARTFile);
+    start = (SimNow > uartDoneAt) ? SimNow : uartDoneAt;
+    uartBufferFreeAt = start;
+    uartDoneAt = start + 10ull * uartBitCycles * SIM_MCLK_HZ / smclk;
+}
+
+uint16_t SimUARTStatus(void)
+{
+    return (SimNow < uartDoneAt) ? UCBUSY : 0;
+}
+
+// UCTXIFG is set once the transmit buffer is free; as the application only reads the flags to wait for it, a read
+// takes until then. The flags can be written, as Trace does to trigger a transfer, and read back set.
+volatile uint16_t *SimUARTFlags(void)
+{
+    static volatile uint16_t flags;
+
+    if (SimNow < uartBufferFreeAt)
+        SimAdvance(uartBufferFreeAt - SimNow);
+    flags = UCTXIFG;
+    return &flags;
+}
+
+uint32_t UART_getTransmitBufferAddressForDMA(uint32_t moduleInstance)
+{
+    return UCA0TXBUF_ADDRESS;
+}
+
+// The bytes of a DMA transfer go out back to back, and the transfer is done when the last one is written to the
+// transmit buffer
+static uint64_t UARTSendBlock(const uint8_t *bytes, uint32_t count)
+{
+    uint64_t byteCycles = 10ull * uartBitCycles * SIM_MCLK_HZ / smclk;
+    uint64_t start = (SimNow > uartDoneAt) ? SimNow : uartDoneAt;
+
+    if (SimUARTFile)
+        fwrite(bytes, 1, count, SimUARTFile);
+    uartBufferFreeAt = start + (count - 1) * byteCycles;
+    uartDoneAt = start + count * byteCycles;
+    return uartBufferFreeAt;
+}
+
+//------------------------------------------
+// DMA: a transfer completes all at once, after the time its destination needs for the data. Its destination
+// is the SPI to the LCD or the UART; any other one completes right away.
+
+#define DMA_CHANNELS 8
+#define DMA_LINES 4
+
+typedef struct {
+    const uint8_t *src;
+    uintptr_t      dst;
+    uint32_t       size;
+    uint32_t       itemBytes;
+    bool           enabled;
+    bool           flag;            // completion flag, cleared by DMA_clearInterruptFlag
+    uint64_t       doneAt;
+} DMAChannel_t;
+
+static DMAChannel_t dma[DMA_CHANNELS];
+static int dmaLineChannel[DMA_LINES] = {-1, -1, -1, -1};    // DMA_INT1..3 can be given one channel each
+
+void DMA_enableModule(void) {}
+void DMA_setControlBase(void *controlTable) {}
+void DMA_assignChannel(uint32_t mapping) {}
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr) {}
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr) {}
+
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control)
+{
+    uint32_t size = control & 0x33000000;
+    dma[channelStructIndex & 7].itemBytes = (size == UDMA_SIZE_32) ? 4 : (size == UDMA_SIZE_16) ? 2 : 1;
+}
+
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode, void *srcAddr, void *dstAddr,
+                            uint32_t transferSize)
+{
+    DMAChannel_t *C = &dma[channelStructIndex & 7];
+    C->src = srcAddr;
+    C->dst = (uintptr_t) dstAddr;
+    C->size = transferSize;
+}
+
+void DMA_enableChannel(uint32_t channelNum)
+{
+    DMAChannel_t *C = &dma[channelNum & 7];
+    uint32_t bytes = C->size * C->itemBytes;
+
+    SimPeripheralChanged();
+
+    C->enabled = true;
+    if (C->dst == UCB0TXBUF_ADDRESS)
+    {
+        // The LCD gets the bytes now, in the data or command mode the D/C line is in
+        uint32_t i;
+        for (i = 0; i < bytes; i++)
+            LcdSend(C->src[i], LcdDataMode());
+        SimSPIBytes += bytes;
+        C->doneAt = SimNow + bytes * SPIByteCycles();
+    }
+    else if (C->dst == UCA0TXBUF_ADDRESS && bytes > 0)
+        C->doneAt = UARTSendBlock(C->src, bytes);
+    else
+        C->doneAt = SimNow;
+}
+
+void DMA_disableChannel(uint32_t channelNum)
+{
+    dma[channelNum & 7].enabled = false;
+}
+
+bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    DMAChannel_t *C = &dma[channelNum & 7];
+    return C->enabled && SimNow < C->doneAt;
+}
+
+void DMA_assignInterrupt(uint32_t interruptNumber, uint32_t channel)
+{
+    SimPeripheralChanged();
+    dmaLineChannel[INT_DMA_INT0 - interruptNumber] = channel;
+}
+
+void DMA_clearInterruptFlag(uint32_t channel)
+{
+    dma[channel & 7].flag = false;
+}
+
+void DMA_enableInterrupt(uint32_t interruptNumber)
+{
+    Interrupt_enableInterrupt(interruptNumber);
+}
+
+void DMA_disableInterrupt(uint32_t interruptNumber)
+{
+    Interrupt_disableInterrupt(interruptNumber);
+}
+
+// This function sets the completion flags of the transfers that are done
+static void UpdateDMA(void)
+{
+    int c;
+    for (c = 0; c < DMA_CHANNELS; c++)
+    {
+        if (dma[c].enabled && SimNow >= dma[c].doneAt)
+        {
+            dma[c].enabled = false;
+            dma[c].flag = true;
+        }
+    }
+}
+
+// DMA_INT0 is the completion of any channel that is not assigned to DMA_INT1..3
+static bool DMALinePending(int line)
+{
+    int c;
+    if (line != 0)
+        return (dmaLineChannel[line] >= 0) && dma[dmaLineChannel[line]].flag;
+
+    for (c = 0; c < DMA_CHANNELS; c++)
+    {
+        if (dma[c].flag && c != dmaLineChannel[1] && c != dmaLineChannel[2] && c != dmaLineChannel[3])
+            return true;
+    }
+    return false;
+}
+
+//------------------------------------------
+// Interrupt dispatch
+
+typedef struct {
+    uint32_t number;
+    void (*handler)(void);
+} Source_t;
+
+static void UpdateSysTick(void)
+{
+    if (sysTickRunning && SimNow >= sysTickNext)
+    {
+        // Several periods may have passed while interrupts were disabled; they make a single interrupt
+        sysTickNext += ((SimNow - sysTickNext) / sysTickSimPeriod + 1) * sysTickSimPeriod;
+        if (sysTickInterrupt)
+            sysTickPending = true;
+    }
+}
+
+static bool Pending(uint32_t number)
+{
+    if (number == INT_SYSTICK)
+        return sysTickPending;
+    if (!nvicEnabled[number])
+        return false;
+
+    switch (number)
+    {
+    case INT_ADC14:
+        return ADC14_getEnabledInterruptStatus() != 0;
+    case INT_TA3_0:
+        return TimerAInterruptTime(TIMER_A3_BASE) <= SimNow;
+    case INT_EUSCIA0:
+        return UART_getEnabledInterruptStatus(EUSCI_A0_BASE) != 0;
+    case INT_DMA_INT0:
+    case INT_DMA_INT1:
+    case INT_DMA_INT2:
+    case INT_DMA_INT3:
+        return DMALinePending(INT_DMA_INT0 - number);
+    default:
+        if (number >= INT_PORT1 && number <= INT_PORT6)
+            return GPIO_getEnabledInterruptStatus(number - INT_PORT1 + GPIO_PORT_P1) != 0;
+        return false;
+    }
+}
+
+static const uint32_t sourceNumbers[] = {
+    INT_SYSTICK, INT_TA3_0, INT_EUSCIA0, INT_ADC14, INT_DMA_INT3, INT_DMA_INT2, INT_DMA_INT1, INT_DMA_INT0,
+    INT_PORT1, INT_PORT2, INT_PORT3, INT_PORT4, INT_PORT5, INT_PORT6,
+};
+
+#define SOURCES (sizeof(sourceNumbers) / sizeof(sourceNumbers[0]))
+
+// This function returns the index of the pending interrupt with the highest priority, or -1. Like the
+// NVIC, it picks the lowest priority value, then the lowest exception number.
+static int HighestPending(void (*const handlers[SOURCES])(void))
+{
+    int best = -1;
+    unsigned i;
+
+    UpdateSysTick();
+    UpdateDMA();
+
+    for (i = 0; i < SOURCES; i++)
+    {
+        if (Pending(sourceNumbers[i]) && handlers[i] &&
+            (best < 0 || nvicPriority[sourceNumbers[i]] < nvicPriority[sourceNumbers[best]]))
+            best = i;
+    }
+    return best;
+}
+
+static bool DispatchOne(void)
+{
+    void (*const handlers[SOURCES])(void) = {
+        SysTick_Handler, TA3_0_IRQHandler, EUSCIA0_IRQHandler, ADC14_IRQHandler, DMA_INT3_IRQHandler,
+        DMA_INT2_IRQHandler, DMA_INT1_IRQHandler, DMA_INT0_IRQHandler, PORT1_IRQHandler, PORT2_IRQHandler,
+        PORT3_IRQHandler, PORT4_IRQHandler, PORT5_IRQHandler, PORT6_IRQHandler,
+    };
+    int best = HighestPending(handlers);
+
+    if (best < 0)
+        return false;
+
+    if (sourceNumbers[best] == INT_SYSTICK)
+        sysTickPending = false;
+
+    inISR = true;
+    handlers[best]();
+    inISR = false;
+    return true;
+}
+
+void SimService(void)
+{
+    if (!masterEnabled || inISR)
+    {
+        // The flags are still latched, like the hardware does while interrupts are disabled
+        UpdateSysTick();
+        UpdateDMA();
+        return;
+    }
+    while (DispatchOne())
+        ;
+}
+
+uint64_t SimNextInterruptTime(void)
+{
+    void (*const handlers[SOURCES])(void) = {
+        SysTick_Handler, TA3_0_IRQHandler, EUSCIA0_IRQHandler, ADC14_IRQHandler, DMA_INT3_IRQHandler,
+        DMA_INT2_IRQHandler, DMA_INT1_IRQHandler, DMA_INT0_IRQHandler, PORT1_IRQHandler, PORT2_IRQHandler,
+        PORT3_IRQHandler, PORT4_IRQHandler, PORT5_IRQHandler, PORT6_IRQHandler,
+    };
+    uint64_t next = SIM_NEVER;
+    int c;
+
+    // An interrupt that is already pending wakes the CPU up right away
+    if (HighestPending(handlers) >= 0)
+        return SimNow;
+
+    if (sysTickRunning && sysTickInterrupt && sysTickNext < next)
+        next = sysTickNext;
+
+    if (nvicEnabled[INT_TA3_0] && TimerAInterruptTime(TIMER_A3_BASE) < next)
+        next = TimerAInterruptTime(TIMER_A3_BASE);
+
+    if (nvicEnabled[INT_EUSCIA0] && uartTxInterrupt && uartBufferFreeAt < next)
+        next = uartBufferFreeAt;
+
+    // The results only change with the script, so the window flags that will be set are those of now
+    if (adcRunning && nvicEnabled[INT_ADC14])
+    {
+        if ((adcInterruptMask & ADC_MEMORY_FLAGS) && adcMemoryFlagsCleared + ADC_SEQUENCE_CYCLES < next)
+            next = adcMemoryFlagsCleared + ADC_SEQUENCE_CYCLES;
+        if ((adcInterruptMask & WindowFlags()) && adcWindowFlagsCleared + ADC_SEQUENCE_CYCLES < next)
+            next = adcWindowFlagsCleared + ADC_SEQUENCE_CYCLES;
+    }
+
+    for (c = 0; c < DMA_CHANNELS; c++)
+    {
+        if (dma[c].enabled && dma[c].doneAt < next)
+            next = dma[c].doneAt;
+    }
+
+    return next;
+}
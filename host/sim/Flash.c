@@ -0,0 +1,118 @@
+//------------------------------------------
+// SIMULATED FLASH
+// The sectors of the flash log behave like flash: an erase sets all their bytes to 0xFF, programming can only
+// clear bits, and neither works on a protected sector. Addresses outside the log are refused.
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <string.h>
+#include <FlashLog.h>
+#include "Sim.h"
+
+#define FLASH_LOG_SIZE (FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE)
+
+uint8_t SimFlashLog[FLASH_LOG_SIZE];
+
+unsigned SimFlashEraseFailures;
+
+// A bit for each sector of the log, set while it can be written
+static uint32_t unprotected;
+static const char *flashPath;
+
+// The sectors start erased, before the options are read
+__attribute__((constructor)) static void EraseFlash(void)
+{
+    memset(SimFlashLog, 0xFF, FLASH_LOG_SIZE);
+}
+
+//------------------------------------------
+// FlashCtl
+
+// Sector 28 of bank 1 is the first sector of the log
+static uint32_t SectorBits(uint_fast8_t memorySpace, uint32_t sectorMask)
+{
+    return (memorySpace == FLASH_MAIN_MEMORY_SPACE_BANK1) ? sectorMask / FLASH_SECTOR28 : 0;
+}
+
+bool FlashCtl_unprotectSector(uint_fast8_t memorySpace, uint32_t sectorMask)
+{
+    unprotected |= SectorBits(memorySpace, sectorMask);
+    return true;
+}
+
+bool FlashCtl_protectSector(uint_fast8_t memorySpace, uint32_t sectorMask)
+{
+    unprotected &= ~SectorBits(memorySpace, sectorMask);
+    return true;
+}
+
+static bool Writable(uint32_t address, uint32_t length)
+{
+    uint32_t first, last;
+
+    if (address < FLASH_LOG_START || length == 0 || address + length > FLASH_LOG_START + FLASH_LOG_SIZE)
+        return false;
+
+    for (first = (address - FLASH_LOG_START) / FLASH_LOG_SECTOR_SIZE,
+         last = (address + length - 1 - FLASH_LOG_START) / FLASH_LOG_SECTOR_SIZE; first <= last; first++)
+        if (!(unprotected & (1u << first)))
+            return false;
+    return true;
+}
+
+bool FlashCtl_eraseSector(uint32_t addr)
+{
+    addr &= ~(FLASH_LOG_SECTOR_SIZE - 1);
+    if (!Writable(addr, FLASH_LOG_SECTOR_SIZE))
+        return false;
+    if (SimFlashEraseFailures)
+    {
+        SimFlashEraseFailures--;
+        return false;
+    }
+
+    memset(SimFlashLog + addr - FLASH_LOG_START, 0xFF, FLASH_LOG_SECTOR_SIZE);
+    return true;
+}
+
+bool FlashCtl_programMemory(void *src, void *dest, uint32_t length)
+{
+    uint32_t address = (uint32_t) (uintptr_t) dest;
+    const uint8_t *from = src;
+    uint8_t *to = SimFlashLog + address - FLASH_LOG_START;
+
+    if (!Writable(address, length))
+        return false;
+
+    while (length--)
+        *to++ &= *from++;
+    return true;
+}
+
+bool SimFlashLoad(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    flashPath = path;
+    if (!file)
+        return true;
+
+    fread(SimFlashLog, 1, FLASH_LOG_SIZE, file);
+    fclose(file);
+    return true;
+}
+
+bool SimFlashSave(void)
+{
+    FILE *file;
+    bool done;
+
+    if (!flashPath)
+        return true;
+
+    file = fopen(flashPath, "wb");
+    if (!file)
+        return false;
+    done = fwrite(SimFlashLog, 1, FLASH_LOG_SIZE, file) == FLASH_LOG_SIZE;
+    return fclose(file) == 0 && done;
+}
+
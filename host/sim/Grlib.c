@@ -0,0 +1,254 @@
+//------------------------------------------
+// HOST GRLIB
+// The few graphics library calls the application makes, drawn through the display driver like the real
+// library does. Text is also recorded in a grid of 8 x 16 pixel cells, so that scripts can check what is
+// on the screen without decoding pixels.
+
+#include <ti/grlib/grlib.h>
+#include <string.h>
+#include "Sim.h"
+
+static char screenText[SIM_TEXT_ROWS][SIM_TEXT_COLUMNS + 1];
+
+const char *SimScreenRow(unsigned row)
+{
+    return screenText[row % SIM_TEXT_ROWS];
+}
+
+void SimClearText(void)
+{
+    unsigned r;
+    for (r = 0; r < SIM_TEXT_ROWS; r++)
+    {
+        memset(screenText[r], ' ', SIM_TEXT_COLUMNS);
+        screenText[r][SIM_TEXT_COLUMNS] = '\0';
+    }
+}
+
+void Graphics_initContext(Graphics_Context *context, Graphics_Display *display,
+                          const Graphics_Display_Functions *displayFxns)
+{
+    context->size = sizeof(Graphics_Context);
+    context->display = display;
+    context->displayFxns = displayFxns;
+    context->clipRegion.xMin = 0;
+    context->clipRegion.yMin = 0;
+    context->clipRegion.xMax = display->width - 1;
+    context->clipRegion.yMax = display->heigth - 1;
+    context->foreground = 0;
+    context->background = 0;
+    context->font = NULL;
+    SimClearText();
+}
+
+void Graphics_setForegroundColor(Graphics_Context *context, int32_t value)
+{
+    context->foreground = context->displayFxns->pfnColorTranslate(context->display, value);
+}
+
+void Graphics_setBackgroundColor(Graphics_Context *context, int32_t value)
+{
+    context->background = context->displayFxns->pfnColorTranslate(context->display, value);
+}
+
+void Graphics_setClipRegion(Graphics_Context *context, Graphics_Rectangle *rect)
+{
+    context->clipRegion = *rect;
+}
+
+void Graphics_setFont(Graphics_Context *context, const Graphics_Font *font)
+{
+    context->font = font;
+}
+
+void Graphics_clearDisplay(const Graphics_Context *context)
+{
+    context->displayFxns->pfnClearDisplay(context->display, context->background);
+    SimClearText();
+}
+
+// This function draws a run of pixels of one glyph row, clipped to the clipping region
+static void DrawRun(const Graphics_Context *context, int32_t x, int32_t y, int32_t count, uint32_t color)
+{
+    int32_t x2 = x + count - 1;
+    const Graphics_Rectangle *clip = &context->clipRegion;
+
+    if (y < clip->yMin || y > clip->yMax)
+        return;
+    if (x < clip->xMin)
+        x = clip->xMin;
+    if (x2 > clip->xMax)
+        x2 = clip->xMax;
+    if (x <= x2)
+        context->displayFxns->pfnLineDrawH(context->display, x, x2, y, color);
+}
+
+// A pixel RLE glyph is its size in bytes, its width, then the pixels row by row as runs of off and on
+// pixels. A byte with both nibbles holds off << 4 | on; a zero byte is followed by a count of 8 pixels
+// that are all on if its top bit is set, all off otherwise. Runs continue on the next row.
+static int32_t DrawGlyph(const Graphics_Context *context, const uint8_t *glyph, int32_t x, int32_t y,
+                         bool opaque)
+{
+    const Graphics_Font *font = context->font;
+    int32_t width = glyph[1];
+    int32_t column = 0, row = 0;
+    unsigned i = 2;
+
+    while (i < glyph[0] && row < font->height)
+    {
+        int32_t off, on;
+
+        if (glyph[i])
+        {
+            off = glyph[i] >> 4;
+            on = glyph[i] & 15;
+            i++;
+        }
+        else if (glyph[i + 1] & 0x80)
+        {
+            off = 0;
+            on = (glyph[i + 1] & 0x7F) * 8;
+            i += 2;
+        }
+        else
+        {
+            off = glyph[i + 1] * 8;
+            on = 0;
+            i += 2;
+        }
+
+        while ((off || on) && row < font->height)
+        {
+            bool isOn = (off == 0);
+            int32_t *run = isOn ? &on : &off;
+            int32_t count = (*run < width - column) ? *run : width - column;
+
+            if (isOn || opaque)
+                DrawRun(context, x + column, y + row, count, isOn ? context->foreground : context->background);
+
+            *run -= count;
+            column += count;
+            if (column == width)
+            {
+                column = 0;
+                row++;
+            }
+        }
+    }
+    return width;
+}
+
+void Graphics_drawString(const Graphics_Context *context, int8_t *string, int32_t length, int32_t x,
+                         int32_t y, bool opaque)
+{
+    const Graphics_Font *font = context->font;
+    int32_t i;
+
+    for (i = 0; (length < 0 || i < length) && string[i]; i++)
+    {
+        char c = string[i];
+        if (c < ' ' || c > '~')
+            c = '.';
+
+        if (y % 16 == 0 && x >= 0 && x / 8 < SIM_TEXT_COLUMNS && y / 16 < SIM_TEXT_ROWS)
+            screenText[y / 16][x / 8] = c;
+
+        x += DrawGlyph(context, font->data + font->offset[c - ' '], x, y, opaque);
+    }
+}
+
+//------------------------------------------
+// Lines and circles, drawn pixel by pixel like the real library does for anything that is not horizontal
+// or vertical
+
+void Graphics_drawPixel(const Graphics_Context *context, int32_t x, int32_t y)
+{
+    const Graphics_Rectangle *clip = &context->clipRegion;
+
+    if (x >= clip->xMin && x <= clip->xMax && y >= clip->yMin && y <= clip->yMax)
+        context->displayFxns->pfnPixelDraw(context->display, x, y, context->foreground);
+}
+
+void Graphics_drawLine(const Graphics_Context *context, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    int32_t dx, dy, error, step, t;
+    bool steep;
+
+    if (y1 == y2 || x1 == x2)
+    {
+        if (x1 > x2 || y1 > y2)
+        {
+            t = x1; x1 = x2; x2 = t;
+            t = y1; y1 = y2; y2 = t;
+        }
+        if (y1 == y2)
+            DrawRun(context, x1, y1, x2 - x1 + 1, context->foreground);
+        else if (x1 >= context->clipRegion.xMin && x1 <= context->clipRegion.xMax)
+        {
+            if (y1 < context->clipRegion.yMin)
+                y1 = context->clipRegion.yMin;
+            if (y2 > context->clipRegion.yMax)
+                y2 = context->clipRegion.yMax;
+            if (y1 <= y2)
+                context->displayFxns->pfnLineDrawV(context->display, x1, y1, y2, context->foreground);
+        }
+        return;
+    }
+
+    // Along the major axis, left to right or top to bottom, with the error and the ties of the real library
+    steep = ((y2 > y1) ? y2 - y1 : y1 - y2) > ((x2 > x1) ? x2 - x1 : x1 - x2);
+    if (steep)
+    {
+        t = x1; x1 = y1; y1 = t;
+        t = x2; x2 = y2; y2 = t;
+    }
+    if (x1 > x2)
+    {
+        t = x1; x1 = x2; x2 = t;
+        t = y1; y1 = y2; y2 = t;
+    }
+    dx = x2 - x1;
+    dy = (y2 > y1) ? y2 - y1 : y1 - y2;
+    error = -dx / 2;
+    step = (y1 < y2) ? 1 : -1;
+
+    for (; x1 <= x2; x1++)
+    {
+        if (steep)
+            Graphics_drawPixel(context, y1, x1);
+        else
+            Graphics_drawPixel(context, x1, y1);
+        error += dy;
+        if (error > 0)
+        {
+            y1 += step;
+            error -= dx;
+        }
+    }
+}
+
+void Graphics_drawCircle(const Graphics_Context *context, int32_t x, int32_t y, int32_t radius)
+{
+    int32_t a = 0, b = radius, d = 3 - 2 * radius;
+
+    while (a <= b)
+    {
+        Graphics_drawPixel(context, x + a, y - b);
+        Graphics_drawPixel(context, x - a, y - b);
+        Graphics_drawPixel(context, x + a, y + b);
+        Graphics_drawPixel(context, x - a, y + b);
+        Graphics_drawPixel(context, x + b, y - a);
+        Graphics_drawPixel(context, x - b, y - a);
+        Graphics_drawPixel(context, x + b, y + a);
+        Graphics_drawPixel(context, x - b, y + a);
+
+        if (d < 0)
+            d += 4 * a + 6;
+        else
+        {
+            d += 4 * (a - b) + 10;
+            b--;
+        }
+        a++;
+    }
+}
@@ -0,0 +1,213 @@
+//------------------------------------------
+// SIMULATED LCD
+// An ST7735 as far as the Crystalfontz driver uses it: the column and row address windows, memory write,
+// vertical scrolling, the sleep, idle and partial modes, and the frame memory. The other commands are
+// accepted and ignored. Addresses are kept as the driver
+// sends them, so the visible 128 x 128 pixels start at the offset the driver adds for LCD_ORIENTATION_UP.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "Sim.h"
+
+#define GRAM_WIDTH  132
+#define GRAM_HEIGHT 162
+
+#define CASET 0x2A
+#define RASET 0x2B
+#define RAMWR 0x2C
+#define DISPON 0x29
+#define SLPIN 0x10
+#define SLPOUT 0x11
+#define PTLON 0x12
+#define NORON 0x13
+#define PTLAR 0x30
+#define IDMOFF 0x38
+#define IDMON 0x39
+#define VSCRDEF 0x33
+#define VSCRSADD 0x37
+
+#define VISIBLE_X0 2
+#define VISIBLE_Y0 3
+#define VISIBLE_SIZE 128
+
+static uint16_t gram[GRAM_HEIGHT][GRAM_WIDTH];
+
+uint64_t SimDisplayOnTime = SIM_NEVER;
+
+static uint8_t command;
+static unsigned parameter;                  // index of the next parameter byte of the command
+static uint16_t xStart, xEnd, yStart, yEnd;
+static uint16_t x, y;
+static uint8_t highByte;
+
+// The scroll area and the row shown at its top, in frame memory rows, while scrolling
+static bool scrolling;
+static uint16_t scrollTop, scrollLines, scrollStart;
+
+// The panel comes out of reset asleep. In partial mode only the rows of the partial area are shown.
+static bool asleep = true, idle, partial;
+static uint16_t partialStart, partialEnd;
+static uint64_t sleepCycles, sleepStart;
+
+static void SetWindow(uint16_t *start, uint16_t *end, uint8_t byte)
+{
+    switch (parameter)
+    {
+    case 0: *start = byte << 8; break;
+    case 1: *start |= byte; break;
+    case 2: *end = byte << 8; break;
+    case 3: *end |= byte; break;
+    }
+}
+
+// The 16-bit parameters are sent high byte first
+static void SetWord(uint16_t *word, uint8_t byte)
+{
+    if (parameter & 1)
+        *word |= byte;
+    else
+        *word = byte << 8;
+}
+
+static void WritePixel(uint16_t color)
+{
+    if (x < GRAM_WIDTH && y < GRAM_HEIGHT)
+        gram[y][x] = color;
+
+    // The address moves along the row, then to the next row of the window, then back to its start
+    if (x < xEnd)
+        x++;
+    else
+    {
+        x = xStart;
+        y = (y < yEnd) ? y + 1 : yStart;
+    }
+}
+
+void LcdReceive(uint8_t byte, bool isData)
+{
+    if (!isData)
+    {
+        command = byte;
+        parameter = 0;
+        switch (command)
+        {
+        case NORON:
+            scrolling = false;
+            partial = false;
+            break;
+        case PTLON:
+            scrolling = false;
+            partial = true;
+            break;
+        case IDMON:
+        case IDMOFF:
+            idle = (command == IDMON);
+            break;
+        case SLPIN:
+            if (!asleep)
+                sleepStart = SimNow;
+            asleep = true;
+            break;
+        case SLPOUT:
+            // The sleep that follows the reset is not counted
+            if (asleep && sleepStart)
+                sleepCycles += SimNow - sleepStart;
+            asleep = false;
+            break;
+        }
+        if (command == DISPON && SimDisplayOnTime == SIM_NEVER)
+            SimDisplayOnTime = SimNow;
+        if (command == RAMWR)
+        {
+            x = xStart;
+            y = yStart;
+
+            // The whole visible screen is about to be written over, text included
+            if (xStart <= VISIBLE_X0 && xEnd >= VISIBLE_X0 + VISIBLE_SIZE - 1 &&
+                yStart <= VISIBLE_Y0 && yEnd >= VISIBLE_Y0 + VISIBLE_SIZE - 1)
+                SimClearText();
+        }
+        return;
+    }
+
+    switch (command)
+    {
+    case CASET:
+        SetWindow(&xStart, &xEnd, byte);
+        break;
+    case RASET:
+        SetWindow(&yStart, &yEnd, byte);
+        break;
+    case VSCRDEF:
+        // Top fixed area, scroll area, bottom fixed area: the bottom one is what is left of the memory
+        if (parameter < 2)
+            SetWord(&scrollTop, byte);
+        else if (parameter < 4)
+            SetWord(&scrollLines, byte);
+        break;
+    case PTLAR:
+        SetWindow(&partialStart, &partialEnd, byte);
+        break;
+    case VSCRSADD:
+        if (parameter < 2)
+            SetWord(&scrollStart, byte);
+        if (parameter == 1)
+            scrolling = true;
+        break;
+    case RAMWR:
+        // 16-bit pixels, high byte first
+        if (parameter & 1)
+            WritePixel((highByte << 8) | byte);
+        else
+            highByte = byte;
+        break;
+    }
+    parameter++;
+}
+
+unsigned LcdShownRow(unsigned row)
+{
+    unsigned y = VISIBLE_Y0 + row;
+
+    if (scrolling && y >= scrollTop && y < scrollTop + scrollLines && scrollStart >= scrollTop)
+        y = scrollTop + (y - scrollTop + scrollStart - scrollTop) % scrollLines;
+    return y - VISIBLE_Y0;
+}
+
+uint64_t LcdSleepCycles(void)
+{
+    return sleepCycles + ((asleep && sleepStart) ? SimNow - sleepStart : 0);
+}
+
+bool LcdWritePPM(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    int i, j;
+
+    if (!f)
+        return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", VISIBLE_SIZE, VISIBLE_SIZE);
+    for (j = 0; j < VISIBLE_SIZE; j++)
+    {
+        for (i = 0; i < VISIBLE_SIZE; i++)
+        {
+            uint16_t c = gram[VISIBLE_Y0 + LcdShownRow(j)][VISIBLE_X0 + i];
+
+            // Idle mode keeps the most significant bit of each color, and the rows out of the partial area are black
+            if (idle)
+                c = ((c & 0x8000) ? 0xF800 : 0) | ((c & 0x0400) ? 0x07E0 : 0) | ((c & 0x0010) ? 0x001F : 0);
+            if (asleep || (partial && (VISIBLE_Y0 + j < partialStart || VISIBLE_Y0 + j > partialEnd)))
+                c = 0;
+            uint8_t rgb[3] = {
+                (uint8_t) (((c >> 11) & 0x1F) * 255 / 31),
+                (uint8_t) (((c >> 5) & 0x3F) * 255 / 63),
+                (uint8_t) ((c & 0x1F) * 255 / 31),
+            };
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    return fclose(f) == 0;
+}
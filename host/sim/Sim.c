@@ -0,0 +1,447 @@
+//------------------------------------------
+// SIMULATOR
+// The simulated clock, the input script and the entry point of the host build.
+//
+// usage: colortest [-s script] [-n repeat] [-t seconds] [-T trace.bin] [-f flash.bin] [-q]
+//   -s  run the script, -n times in a row (default once); repetitions start at its "loop" command
+//   -t  stop after this much simulated time (default: the end of the script, or 10 s without one)
+//   -T  write the bytes sent on the backchannel UART to a file, for host/tracedecode
+//   -f  keep the flash log in a file: it is read at the start, if it exists, and written at the end
+//   -q  do not print the screen for "screen" commands
+//
+// A script has one command per line, prefixed with the time in milliseconds from the start of the script:
+//   100 press top|bottom|left|right      the button goes down
+//   300 release top|bottom|left|right    and up
+//   100 tap bottom [ms]                  press, and release after ms (default 200)
+//   100 joystick x y                     the ADC results, 0..16383
+//   100 tilt x y                         those of the accelerometer
+//   900 screen                           print the text on the LCD
+//   900 expect row text                  fail the run if the row does not contain the text
+//   900 screenshot file.ppm              save the LCD
+//  1500 loop                             repetitions of the script start here rather than at 0
+//  5000 end                              the script ends here, even if its last command is earlier
+// Lines starting with # are comments.
+// The run fails, with exit status 1, if an expect fails, if the watchdog times out or if a byte is sent to the LCD
+// while its chip select is high.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <Scheduler.h>
+#include "Sim.h"
+
+// The application's main() is renamed by the Makefile
+int TargetMain(void);
+extern int ScreensTaskId;
+
+uint64_t SimNow;
+uint64_t SimIdleCycles;
+
+typedef enum {
+    CMD_PRESS, CMD_RELEASE, CMD_JOYSTICK, CMD_TILT, CMD_SCREEN, CMD_EXPECT, CMD_SCREENSHOT, CMD_LOOP, CMD_END
+} Command_t;
+
+typedef struct {
+    uint64_t  time;         // in cycles from the start of the script
+    Command_t command;
+    int       a, b;
+    char      text[64];
+    int       line;
+} ScriptEvent_t;
+
+#define MAX_SCRIPT_EVENTS 1024
+
+static ScriptEvent_t script[MAX_SCRIPT_EVENTS];
+static int scriptLength;
+static uint64_t scriptDuration;
+static uint64_t loopTime;               // repetitions after the first start at this time of the script
+static int loopEvent;                   // and with this event
+static long repeatCount = 1;
+static long repetition;                 // current repetition of the script
+static int nextEvent;                   // index of the next script event of the current repetition
+static uint64_t endTime = SIM_NEVER;
+static bool quiet;
+static unsigned passed, failed;
+static struct timespec hostStart;
+
+//------------------------------------------
+// Report
+
+static double HostSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - hostStart.tv_sec) + (now.tv_nsec - hostStart.tv_nsec) / 1e9;
+}
+
+static void Finish(void)
+{
+    double simSeconds = (double) SimNow / SIM_MCLK_HZ;
+    double hostSeconds = HostSeconds();
+    uint32_t runs = GetTaskStats(ScreensTaskId).runs;
+
+    if (SimUARTFile)
+        fclose(SimUARTFile);
+    if (!SimFlashSave())
+        perror("flash");
+
+    printf("simulated  %.3f s, CPU awake %.2f %%\n", simSeconds,
+           SimNow ? 100.0 * (SimNow - SimIdleCycles) / SimNow : 0.0);
+    printf("host       %.3f s, %.0fx real time\n", hostSeconds, hostSeconds > 0 ? simSeconds / hostSeconds : 0.0);
+    printf("ScreensFSM %lu runs, %.2f M runs per host second\n", (unsigned long) runs,
+           hostSeconds > 0 ? runs / hostSeconds / 1e6 : 0.0);
+    printf("LCD        %llu SPI bytes", (unsigned long long) SimSPIBytes);
+    if (SimDisplayOnTime != SIM_NEVER)
+        printf(", display on at %.1f ms", (double) SimDisplayOnTime / SIM_MCLK_HZ * 1000);
+    if (LcdSleepCycles())
+        printf(", asleep %.3f s", (double) LcdSleepCycles() / SIM_MCLK_HZ);
+    if (SimLcdDeselectedBytes)
+        printf(", %llu ignored with CS high", (unsigned long long) SimLcdDeselectedBytes);
+    printf("\n");
+    if (SimClockChanges)
+        printf("CLK        %llu changes, MCLK divided %.1f %% of the time\n", (unsigned long long) SimClockChanges,
+               SimNow ? 100.0 * SimSlowTime() / SimNow : 0.0);
+    if (SimBuzzerTones)
+        printf("BUZZER     %llu tones, %.1f ms of sound\n", (unsigned long long) SimBuzzerTones,
+               (double) SimBuzzerCycles / SIM_MCLK_HZ * 1000);
+    SimWatchdogCheck();
+    if (SimWatchdogKicks)
+        printf("WDT        %llu kicks, longest gap %.1f ms, %u time-outs\n", (unsigned long long) SimWatchdogKicks,
+               (double) SimWatchdogLongestGap / SIM_MCLK_HZ * 1000, SimWatchdogTimeouts);
+    if (passed || failed)
+        printf("expect     %u passed, %u failed\n", passed, failed);
+
+    exit(failed || SimWatchdogTimeouts || SimLcdDeselectedBytes ? 1 : 0);
+}
+
+//------------------------------------------
+// Script
+
+static void Fail(int line, const char *message)
+{
+    fprintf(stderr, "script line %d: %s\n", line, message);
+    exit(2);
+}
+
+static int ButtonNamed(const char *name, int line)
+{
+    static const char *const names[SIM_BUTTONS] = {"top", "bottom", "left", "right"};
+    int b;
+    for (b = 0; b < SIM_BUTTONS; b++)
+    {
+        if (!strcmp(name, names[b]))
+            return b;
+    }
+    Fail(line, "unknown button");
+    return 0;
+}
+
+static ScriptEvent_t *AddEvent(double ms, Command_t command, int line)
+{
+    ScriptEvent_t *E;
+    if (scriptLength == MAX_SCRIPT_EVENTS)
+        Fail(line, "too many commands");
+    E = &script[scriptLength++];
+    memset(E, 0, sizeof(*E));
+    E->time = SIM_MS(ms);
+    E->command = command;
+    E->line = line;
+    if (E->time > scriptDuration)
+        scriptDuration = E->time;
+    return E;
+}
+
+static int CompareEvents(const void *a, const void *b)
+{
+    const ScriptEvent_t *A = a, *B = b;
+    if (A->time != B->time)
+        return (A->time < B->time) ? -1 : 1;
+    return A->line - B->line;
+}
+
+static void LoadScript(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char buffer[256], word[32], name[32];
+    int line = 0;
+
+    if (!f)
+    {
+        perror(path);
+        exit(2);
+    }
+
+    while (fgets(buffer, sizeof(buffer), f))
+    {
+        double ms, hold = 200;
+        int n;
+        ScriptEvent_t *E;
+
+        line++;
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        if (buffer[0] == '#' || sscanf(buffer, "%lf %31s%n", &ms, word, &n) < 2)
+            continue;
+
+        if (!strcmp(word, "press") || !strcmp(word, "release"))
+        {
+            if (sscanf(buffer + n, "%31s", name) != 1)
+                Fail(line, "missing button");
+            E = AddEvent(ms, word[0] == 'p' ? CMD_PRESS : CMD_RELEASE, line);
+            E->a = ButtonNamed(name, line);
+        }
+        else if (!strcmp(word, "tap"))
+        {
+            if (sscanf(buffer + n, "%31s %lf", name, &hold) < 1)
+                Fail(line, "missing button");
+            E = AddEvent(ms, CMD_PRESS, line);
+            E->a = ButtonNamed(name, line);
+            E = AddEvent(ms + hold, CMD_RELEASE, line);
+            E->a = ButtonNamed(name, line);
+        }
+        else if (!strcmp(word, "joystick") || !strcmp(word, "tilt"))
+        {
+            E = AddEvent(ms, word[0] == 'j' ? CMD_JOYSTICK : CMD_TILT, line);
+            if (sscanf(buffer + n, "%d %d", &E->a, &E->b) != 2)
+                Fail(line, "joystick and tilt need x and y");
+        }
+        else if (!strcmp(word, "screen"))
+            AddEvent(ms, CMD_SCREEN, line);
+        else if (!strcmp(word, "expect"))
+        {
+            int m;
+            E = AddEvent(ms, CMD_EXPECT, line);
+            if (sscanf(buffer + n, "%d %n", &E->a, &m) != 1)
+                Fail(line, "expect needs a row");
+            snprintf(E->text, sizeof(E->text), "%s", buffer + n + m);
+        }
+        else if (!strcmp(word, "screenshot"))
+        {
+            E = AddEvent(ms, CMD_SCREENSHOT, line);
+            if (sscanf(buffer + n, "%63s", E->text) != 1)
+                Fail(line, "screenshot needs a file name");
+        }
+        else if (!strcmp(word, "loop"))
+            loopTime = AddEvent(ms, CMD_LOOP, line)->time;
+        else if (!strcmp(word, "end"))
+            AddEvent(ms, CMD_END, line);
+        else
+            Fail(line, "unknown command");
+    }
+    fclose(f);
+
+    qsort(script, scriptLength, sizeof(script[0]), CompareEvents);
+
+    while (loopEvent < scriptLength && script[loopEvent].time < loopTime)
+        loopEvent++;
+}
+
+// This function returns the absolute time at which a repetition of the script has its time 0
+static uint64_t RepetitionStart(long r)
+{
+    if (r == 0)
+        return 0;
+    return scriptDuration + (r - 1) * (scriptDuration - loopTime) - loopTime;
+}
+
+// This function returns the absolute time of the next script event, or SIM_NEVER
+static uint64_t NextEventTime(void)
+{
+    if (nextEvent == scriptLength)
+    {
+        if (loopEvent == scriptLength || repetition + 1 >= repeatCount)
+            return SIM_NEVER;
+        repetition++;
+        nextEvent = loopEvent;
+    }
+    return RepetitionStart(repetition) + script[nextEvent].time;
+}
+
+// The text the LCD shows on a row, once the rows the application drew are moved by the vertical scroll
+static const char *ShownText(unsigned row)
+{
+    return SimScreenRow(LcdShownRow(16 * row) / 16);
+}
+
+static void RunEvent(const ScriptEvent_t *E)
+{
+    unsigned r;
+
+    switch (E->command)
+    {
+    case CMD_PRESS:
+        SimSetButton(E->a, true);
+        break;
+    case CMD_RELEASE:
+        SimSetButton(E->a, false);
+        break;
+    case CMD_JOYSTICK:
+        SimSetJoystick(E->a, E->b);
+        break;
+    case CMD_TILT:
+        SimSetTilt(E->a, E->b);
+        break;
+    case CMD_SCREEN:
+        if (!quiet)
+        {
+            printf("--- %.3f s\n", (double) SimNow / SIM_MCLK_HZ);
+            for (r = 0; r < SIM_TEXT_ROWS; r++)
+                printf("|%s|\n", ShownText(r));
+        }
+        break;
+    case CMD_EXPECT:
+        if (strstr(ShownText(E->a), E->text))
+            passed++;
+        else
+        {
+            failed++;
+            fprintf(stderr, "line %d at %.3f s: row %d is \"%s\", expected \"%s\"\n", E->line,
+                    (double) SimNow / SIM_MCLK_HZ, E->a, ShownText(E->a), E->text);
+        }
+        break;
+    case CMD_SCREENSHOT:
+        if (!LcdWritePPM(E->text))
+            perror(E->text);
+        break;
+    case CMD_LOOP:
+    case CMD_END:
+        break;
+    }
+}
+
+//------------------------------------------
+// Clock
+
+// Nothing happens before this time unless the application changes a peripheral. Most calls to SimAdvance,
+// one per SPI byte, end well before it and do not need to look at the peripherals at all.
+static uint64_t quietUntil;
+
+void SimPeripheralChanged(void)
+{
+    quietUntil = 0;
+}
+
+void SimAdvance(uint64_t cycles)
+{
+    uint64_t target = SimNow + cycles;
+
+    if (target < quietUntil)
+    {
+        SimDWTCYCCNT += (uint32_t) cycles;
+        SimNow = target;
+        return;
+    }
+
+    // Every script event and interrupt in the interval happens at its own time
+    while (1)
+    {
+        uint64_t eventTime = NextEventTime();
+        uint64_t interruptTime = SimNextInterruptTime();
+        uint64_t next = target;
+
+        // An interrupt that is due already is either dispatched below or masked: it does not stop the clock
+        if (eventTime < next)
+            next = eventTime;
+        if (interruptTime > SimNow && interruptTime < next)
+            next = interruptTime;
+        if (endTime < next)
+            next = endTime;
+
+        SimDWTCYCCNT += (uint32_t) (next - SimNow);
+        SimNow = next;
+
+        if (SimNow >= endTime)
+            Finish();
+
+        if (eventTime == SimNow)
+            RunEvent(&script[nextEvent++]);
+
+        SimService();
+
+        if (SimNow == target && NextEventTime() > SimNow)
+            break;
+    }
+
+    quietUntil = NextEventTime();
+    if (SimNextInterruptTime() < quietUntil)
+        quietUntil = SimNextInterruptTime();
+    if (endTime < quietUntil)
+        quietUntil = endTime;
+}
+
+void SimSleep(void)
+{
+    uint64_t wake = SimNextInterruptTime();
+    uint64_t eventTime = NextEventTime();
+
+    if (eventTime < wake)
+        wake = eventTime;
+    if (wake == SIM_NEVER && endTime == SIM_NEVER)
+    {
+        fprintf(stderr, "the application went to sleep with no interrupt that could wake it up\n");
+        Finish();
+    }
+    if (wake < SimNow)
+        wake = SimNow;
+    if (wake > endTime)
+        wake = endTime;
+
+    SimIdleCycles += wake - SimNow;
+    SimAdvance(wake - SimNow);
+}
+
+//------------------------------------------
+// Entry point
+
+int main(int argc, char *argv[])
+{
+    double seconds = -1;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            LoadScript(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            repeatCount = atol(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-T") && i + 1 < argc)
+        {
+            SimUARTFile = fopen(argv[++i], "wb");
+            if (!SimUARTFile)
+            {
+                perror(argv[i]);
+                return 2;
+            }
+        }
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+        {
+            if (!SimFlashLoad(argv[++i]))
+            {
+                perror(argv[i]);
+                return 2;
+            }
+        }
+        else if (!strcmp(argv[i], "-q"))
+            quiet = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-s script] [-n repeat] [-t seconds] [-T trace.bin] [-f flash.bin] [-q]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (seconds >= 0)
+        endTime = SIM_MS(seconds * 1000);
+    else if (scriptLength)
+        endTime = RepetitionStart(repeatCount) + loopTime;
+    else
+        endTime = SIM_MS(10000);
+
+    clock_gettime(CLOCK_MONOTONIC, &hostStart);
+    TargetMain();
+    Finish();
+    return 0;
+}
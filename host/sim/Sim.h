@@ -0,0 +1,142 @@
+//------------------------------------------
+// SIMULATOR API
+// The host build runs the unmodified application against simulated peripherals and a simulated clock.
+// Only the peripherals cost simulated time: SPI bytes, UART bytes, DMA transfers, timer reads and __delay_cycles
+// advance the clock, and so does sleeping in PCM_gotoLPM0, which jumps to the next interrupt. The CPU itself is
+// infinitely fast, so a run takes as long as the application spends waiting on the hardware.
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// The simulated clock counts cycles of HFXT since reset. Times in scripts are converted at this rate, which is
+// that of MCLK as BSP_Clock_InitFastest sets it up. When the clock governor divides MCLK, what counts MCLK, the
+// timers and __delay_cycles, counts slower (see Driverlib.c).
+#define SIM_MCLK_HZ 48000000
+#define SIM_MS(ms)  ((uint64_t) ((ms) * (SIM_MCLK_HZ / 1000.0)))
+
+#define SIM_NEVER   UINT64_MAX
+
+extern uint64_t SimNow;
+
+//------------------------------------------
+// Clock (Sim.c)
+
+/*
+ * This function moves the clock forward. Script events and interrupts that fall inside the interval
+ * happen at their own time, in order.
+ */
+void SimAdvance(uint64_t cycles);
+
+/*
+ * This function is the simulated sleep: the clock jumps to the next peripheral or script event.
+ * It is called with interrupts disabled, so the ISRs run when the application enables them again.
+ */
+void SimSleep(void);
+
+/*
+ * The peripherals call this function when the application does something that can make an interrupt
+ * happen sooner than the clock expected, such as enabling it or starting a transfer.
+ */
+void SimPeripheralChanged(void);
+
+//------------------------------------------
+// Peripherals (Driverlib.c)
+
+/*
+ * This function returns the time at which the next enabled interrupt will become pending, or SIM_NEVER.
+ */
+uint64_t SimNextInterruptTime(void);
+
+/*
+ * This function runs the ISRs of all pending interrupts if the application has interrupts enabled.
+ * It does nothing when called from inside an ISR.
+ */
+void SimService(void);
+
+typedef enum {SIM_BUTTON_TOP, SIM_BUTTON_BOTTOM, SIM_BUTTON_LEFT, SIM_BUTTON_RIGHT, SIM_BUTTONS} SimButton_t;
+
+void SimSetButton(SimButton_t button, bool pressed);
+void SimSetJoystick(uint16_t x, uint16_t y);
+void SimSetTilt(uint16_t x, uint16_t y);          // the X and Y axes of the accelerometer
+
+// The bytes the application sends on the backchannel UART are written to this file if it is not NULL
+extern FILE *SimUARTFile;
+
+extern uint64_t SimSPIBytes;        // bytes sent to the LCD
+extern uint64_t SimLcdDeselectedBytes;  // of them, sent while its chip select was high, which the LCD ignored
+extern uint64_t SimIdleCycles;      // cycles spent in PCM_gotoLPM0
+
+extern uint64_t SimClockChanges;        // of the MCLK divider
+
+/*
+ * This function returns the cycles spent with MCLK divided
+ */
+uint64_t SimSlowTime(void);
+
+extern uint64_t SimBuzzerTones;        // notes started on Timer_A0
+extern uint64_t SimBuzzerCycles;       // while it ran
+
+extern uint64_t SimWatchdogKicks;
+extern uint64_t SimWatchdogLongestGap;  // between two kicks, in cycles
+extern unsigned SimWatchdogTimeouts;    // times the gap reached the period of the watchdog
+
+/*
+ * This function reports a time-out of the watchdog if it is running and was not kicked in time
+ */
+void SimWatchdogCheck(void);
+
+//------------------------------------------
+// Flash (Flash.c): the sectors of the flash log.
+// Programming and erasing cost no simulated time.
+
+/*
+ * These functions load the sectors from a file, if it exists, and save them to it, so that the log survives from
+ * one run to the next like it survives a reset. Without a file, every run starts with the sectors erased.
+ */
+bool SimFlashLoad(const char *path);
+bool SimFlashSave(void);
+
+// The sectors are SimFlashLog (see host_port.h). This many of the erases to come fail, leaving their sector as it was.
+extern unsigned SimFlashEraseFailures;
+
+//------------------------------------------
+// LCD (Lcd.c): an ST7735 that decodes the commands and keeps its frame memory
+
+void LcdReceive(uint8_t byte, bool isData);
+
+// The time of the first display on command, or SIM_NEVER
+extern uint64_t SimDisplayOnTime;
+/*
+ * This function returns the time the panel has spent asleep since its first sleep out
+ */
+uint64_t LcdSleepCycles(void);
+bool LcdWritePPM(const char *path);
+
+/*
+ * This function returns the row of the screen, as the application draws it, that is shown on the given row
+ * once the vertical scroll is applied
+ */
+unsigned LcdShownRow(unsigned row);
+
+//------------------------------------------
+// Graphics library (Grlib.c)
+
+#define SIM_TEXT_ROWS 8
+#define SIM_TEXT_COLUMNS 16
+
+/*
+ * This function returns the text drawn on one row of the screen (16 characters of 8 x 16 pixels).
+ * Cells that were cleared and never drawn since are spaces. The LCD may show the row elsewhere: see LcdShownRow.
+ */
+const char *SimScreenRow(unsigned row);
+
+/*
+ * This function forgets all the text, as when the whole screen is cleared or drawn over
+ */
+void SimClearText(void);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,43 @@
+//------------------------------------------
+// CHECK
+// The checks of the host tests. A test defines TEST_NAME, the name its messages start with, before it includes this
+// file, calls Check for each thing it checks, and returns CheckReport() from main.
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+static unsigned checks, failures;
+
+/*
+ * This function counts a check and prints what was checked if it failed. what is a printf format, with the
+ * arguments after it.
+ */
+static inline void Check(bool passed, const char *what, ...)
+{
+    va_list arguments;
+
+    checks++;
+    if (passed)
+        return;
+    failures++;
+    va_start(arguments, what);
+    fprintf(stderr, TEST_NAME ": ");
+    vfprintf(stderr, what, arguments);
+    fprintf(stderr, " failed\n");
+    va_end(arguments);
+}
+
+/*
+ * This function prints the number of checks and whether they all passed, and returns the exit status of the test
+ */
+static inline int CheckReport(void)
+{
+    printf(TEST_NAME ": %u checks, %s\n", checks, failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
+
+#endif // CHECK_H_
@@ -0,0 +1,148 @@
+//------------------------------------------
+// CRYPTO MODEL
+// The register takes each bit most significant first, like the polynomial division is written on paper. The
+// CRC-32 of zlib is the bit-reversed register, inverted, after bytes taken least significant bit first.
+
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <DMA_HAL.h>
+#include "CryptoModel.h"
+
+#define POLYNOMIAL 0x04C11DB7
+
+CryptoModel_t CryptoModel;
+
+static uint32_t crc;
+
+static uint32_t Reverse(uint32_t value)
+{
+    uint32_t reversed = 0;
+    unsigned bit;
+
+    for (bit = 0; bit < 32; bit++)
+        reversed |= ((value >> bit) & 1) << (31 - bit);
+    return reversed;
+}
+
+static void Shift(uint8_t byte, bool lsbFirst)
+{
+    unsigned bit;
+
+    for (bit = 0; bit < 8; bit++)
+    {
+        uint32_t in = lsbFirst ? (byte >> bit) & 1 : (byte >> (7 - bit)) & 1;
+        bool feedback = (crc >> 31) ^ in;
+
+        crc <<= 1;
+        if (feedback)
+            crc ^= POLYNOMIAL;
+    }
+}
+
+static uint32_t Read(bool reversed)
+{
+    if (CryptoModel.broken)
+        return 0;
+    return (reversed != CryptoModel.reflected) ? Reverse(crc) : crc;
+}
+
+//------------------------------------------
+// CRC32
+
+void CRC32_setSeed(uint32_t seed, uint_fast8_t crcType)
+{
+    crc = CryptoModel.reflected ? Reverse(seed) : seed;
+}
+
+void CRC32_set8BitData(uint8_t dataIn, uint_fast8_t crcType)
+{
+    Shift(dataIn, CryptoModel.lsbFirst);
+}
+
+void CRC32_set8BitDataReversed(uint8_t dataIn, uint_fast8_t crcType)
+{
+    Shift(dataIn, !CryptoModel.lsbFirst);
+}
+
+uint32_t CRC32_getResult(uint_fast8_t crcType)
+{
+    return Read(false);
+}
+
+uint32_t CRC32_getResultReversed(uint_fast8_t crcType)
+{
+    return Read(true);
+}
+
+//------------------------------------------
+// AES256
+
+bool AES256_setCipherKey(uint32_t moduleInstance, const uint8_t *cipherKey, uint_fast16_t keyLength)
+{
+    return true;
+}
+
+bool AES256_setDecipherKey(uint32_t moduleInstance, const uint8_t *cipherKey, uint_fast16_t keyLength)
+{
+    return true;
+}
+
+void AES256_encryptData(uint32_t moduleInstance, const uint8_t *data, uint8_t *encryptedData)
+{
+    memmove(encryptedData, data, 16);
+}
+
+void AES256_decryptData(uint32_t moduleInstance, const uint8_t *data, uint8_t *decryptedData)
+{
+    memmove(decryptedData, data, 16);
+}
+
+//------------------------------------------
+// DMA. A software request moves the whole transfer at once, into the register it was set up to write.
+
+static struct {
+    const uint8_t *source;
+    uintptr_t      destination;
+    uint32_t       count;
+    bool           enabled;
+} channel;
+
+void InitDMA() {}
+void DMA_assignChannel(uint32_t mapping) {}
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr) {}
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control) {}
+
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode, void *srcAddr, void *dstAddr,
+                            uint32_t transferSize)
+{
+    channel.source = srcAddr;
+    channel.destination = (uintptr_t) dstAddr;
+    channel.count = transferSize;
+}
+
+void DMA_enableChannel(uint32_t channelNum)
+{
+    channel.enabled = true;
+}
+
+bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    return channel.enabled;
+}
+
+void DMA_requestSoftwareTransfer(uint32_t channelNum)
+{
+    uint32_t n;
+
+    if (!channel.enabled)
+        return;
+    for (n = 0; n < channel.count; n++)
+    {
+        if (channel.destination == CRC32_BASE + OFS_CRC32DI)
+            Shift(channel.source[n], CryptoModel.lsbFirst);
+        else if (channel.destination == CRC32_BASE + OFS_CRC32DIRB)
+            Shift(channel.source[n], !CryptoModel.lsbFirst);
+    }
+    CryptoModel.dmaBytes += channel.count;
+    channel.enabled = false;
+}
@@ -0,0 +1,25 @@
+//------------------------------------------
+// CRYPTO MODEL
+// The tests that build Crypto_HAL.c with CRYPTO_HARDWARE=1 (cryptotest, flashlogtest) link with this model of the
+// CRC32 and AES256 modules and of the DMA channel that feeds the CRC32 module. The CRC32 module is a shift register
+// of the CRC-32 polynomial. The order in which it takes the bits of a byte through CRC32DI and CRC32DIRB, and the
+// order in which its result reads, are set by the test rather than taken from the reference manual, so that
+// Crypto_HAL is checked to find the right order whichever it is. The AES256 module does not work: it returns its
+// input.
+
+#ifndef CRYPTO_MODEL_H_
+#define CRYPTO_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    bool     lsbFirst;          // CRC32DI takes the bits of a byte least significant first, CRC32DIRB the other way
+    bool     reflected;         // CRC32_getResult reads the register bit-reversed, CRC32_getResultReversed as it is
+    bool     broken;            // the result always reads 0
+    uint32_t dmaBytes;          // bytes the DMA channel moved to the module
+} CryptoModel_t;
+
+extern CryptoModel_t CryptoModel;
+
+#endif /* CRYPTO_MODEL_H_ */
@@ -0,0 +1,179 @@
+//------------------------------------------
+// LCD MODEL
+// The pixels of a window fill it left to right, then top to bottom, and wrap around to its top left corner, like
+// the memory write of the ST7735.
+// With LCD_MODEL_DRIVER, the test links the driver itself, which sets its windows with CASET and RASET: the model
+// takes them from the commands, less the offset the driver adds for LCD_ORIENTATION_UP, and the driver keeps its
+// own display, color translation and scroll.
+
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include "LcdModel.h"
+
+LcdModel_t LcdModel;
+
+static uint16_t frame[LCD_MODEL_SIZE][LCD_MODEL_SIZE];
+
+static struct {
+    uint16_t x0, y0, x1, y1;
+    uint16_t x, y;
+    bool     highByte;
+    uint8_t  high;
+} window;
+
+uint32_t HAL_LCD_byteCount;
+
+uint16_t LcdModelColor(uint32_t color)
+{
+    return ((color & 0x00F80000) >> 8) | ((color & 0x0000FC00) >> 5) | ((color & 0x000000F8) >> 3);
+}
+
+void LcdModelReset(uint16_t color)
+{
+    unsigned x, y;
+
+    for (y = 0; y < LCD_MODEL_SIZE; y++)
+        for (x = 0; x < LCD_MODEL_SIZE; x++)
+            frame[y][x] = color;
+    memset(&LcdModel, 0, sizeof(LcdModel));
+}
+
+uint16_t LcdModelPixel(unsigned x, unsigned y)
+{
+    return frame[y][x];
+}
+
+void HAL_LCD_writeDataBurst(const uint8_t *data, uint16_t count)
+{
+    HAL_LCD_byteCount += count;
+    LcdModel.bytes += count;
+
+    for (; count; count--, data++)
+    {
+        if (window.highByte)
+        {
+            window.high = *data;
+            window.highByte = false;
+            continue;
+        }
+        window.highByte = true;
+        if (window.x < LCD_MODEL_SIZE && window.y < LCD_MODEL_SIZE)
+            frame[window.y][window.x] = (window.high << 8) | *data;
+
+        if (window.x++ == window.x1)
+        {
+            window.x = window.x0;
+            if (window.y++ == window.y1)
+                window.y = window.y0;
+        }
+    }
+}
+
+#ifndef LCD_MODEL_DRIVER
+
+static uint32_t ColorTranslate(const Graphics_Display *display, uint32_t color)
+{
+    return LcdModelColor(color);
+}
+
+Graphics_Display g_sCrystalfontz128x128 = {sizeof(Graphics_Display), NULL, LCD_MODEL_SIZE, LCD_MODEL_SIZE};
+
+const Graphics_Display_Functions g_sCrystalfontz128x128_funcs = {.pfnColorTranslate = ColorTranslate};
+
+void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    window.x0 = window.x = x0;
+    window.y0 = window.y = y0;
+    window.x1 = x1;
+    window.y1 = y1;
+    LcdModel.windows++;
+}
+
+void HAL_LCD_writeCommand(uint8_t command)
+{
+    window.highByte = true;
+}
+
+void Crystalfontz128x128_SetScrollArea(uint16_t y0, uint16_t lines)
+{
+    LcdModel.scrolling = true;
+    LcdModel.scrollTop = y0;
+    LcdModel.scrollLines = lines;
+    LcdModel.scrollStart = y0;
+}
+
+void Crystalfontz128x128_SetScrollStart(uint16_t y)
+{
+    LcdModel.scrollStart = y;
+}
+
+void Crystalfontz128x128_StopScroll(void)
+{
+    LcdModel.scrolling = false;
+}
+
+#else
+
+// The first visible column and row of the ST7735 memory, in LCD_ORIENTATION_UP
+#define VISIBLE_X0 2
+#define VISIBLE_Y0 3
+
+static struct {
+    uint8_t  command;
+    unsigned parameter;         // index of the next parameter byte of the command
+    uint16_t start, end;        // of CASET or RASET
+} sent;
+
+// Every byte the driver sends is counted, commands and windows included, like the real HAL does
+void HAL_LCD_writeCommand(uint8_t command)
+{
+    HAL_LCD_byteCount++;
+    sent.command = command;
+    sent.parameter = 0;
+    if (command != CM_RAMWR)
+        return;
+    window.x = window.x0;
+    window.y = window.y0;
+    window.highByte = true;
+    LcdModel.windows++;
+}
+
+void HAL_LCD_writeData(uint8_t data)
+{
+    if (sent.command == CM_RAMWR)
+    {
+        HAL_LCD_writeDataBurst(&data, 1);
+        return;
+    }
+    HAL_LCD_byteCount++;
+    if (sent.command != CM_CASET && sent.command != CM_RASET)
+        return;
+
+    if (sent.parameter < 2)
+        sent.start = (sent.start << 8) | data;
+    else
+        sent.end = (sent.end << 8) | data;
+    if (++sent.parameter < 4)
+        return;
+    if (sent.command == CM_CASET)
+    {
+        window.x0 = sent.start - VISIBLE_X0;
+        window.x1 = sent.end - VISIBLE_X0;
+    }
+    else
+    {
+        window.y0 = sent.start - VISIBLE_Y0;
+        window.y1 = sent.end - VISIBLE_Y0;
+    }
+}
+
+#endif // LCD_MODEL_DRIVER
+
+// The transfers of the model take no time
+uint16_t SimSPIStatus(void)
+{
+    return 0;
+}
@@ -0,0 +1,40 @@
+//------------------------------------------
+// LCD MODEL
+// The tests of the modules that draw straight through the HAL of the LCD link with this model instead of the LCD
+// driver, the HAL and the simulator. It takes the address windows and the pixels they send, and keeps the frame
+// memory of the 128 x 128 screen, in RGB565, and the vertical scroll they set. Built with LCD_MODEL_DRIVER, it
+// takes the commands of the LCD driver instead, for the tests of the driver itself (see LcdModel.c).
+
+#ifndef LCD_MODEL_H_
+#define LCD_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LCD_MODEL_SIZE 128
+
+typedef struct {
+    uint32_t windows;           // address windows set
+    uint32_t bytes;             // bytes of pixels sent
+    bool     scrolling;         // between SetScrollArea and StopScroll, without LCD_MODEL_DRIVER
+    uint16_t scrollTop, scrollLines, scrollStart;
+} LcdModel_t;
+
+extern LcdModel_t LcdModel;
+
+/*
+ * This function fills the frame memory with color and clears the counters
+ */
+void LcdModelReset(uint16_t color);
+
+/*
+ * This function returns the pixel at (x, y) of the frame memory, not scrolled
+ */
+uint16_t LcdModelPixel(unsigned x, unsigned y);
+
+/*
+ * This function translates a 24-bit RGB color to RGB565, as the driver does
+ */
+uint16_t LcdModelColor(uint32_t color);
+
+#endif /* LCD_MODEL_H_ */
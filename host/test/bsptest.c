@@ -0,0 +1,347 @@
+//------------------------------------------
+// BSP TEST
+// This host program checks the text functions of bsp/BSP.c: streamGlyphRow, fillClipped, BSP_LCD_DrawCharS,
+// BSP_LCD_DrawChar and BSP_LCD_DrawString. bsp/BSP.c is included whole, with the registers of eUSCI_B0 and the pins
+// of the LCD replaced by a model of the SPI, which logs the bytes written to UCB0TXBUF and decodes their windows and
+// pixels into the LCD model (test/LcdModel.c). Each character is compared pixel by pixel with its glyph in Font:
+// on the screen and partly off it, scaled, transparent, and along a row of 21 columns. The bytes of each call are
+// compared with the counts that the comments of bsp/BSP.c give.
+
+#include <stdio.h>
+#include <string.h>
+#include "LcdModel.h"
+
+#define TEST_NAME "bsptest"
+#include "Check.h"
+
+//------------------------------------------
+// The model of the SPI
+
+#define SPI_LOG_BYTES 40000
+
+static struct {
+    struct {
+        uint16_t byte;
+        uint8_t  dc;            // the Data/Command pin: 0 for a command
+        uint8_t  cs;            // the chip select, 0 while the LCD is selected
+    } log[SPI_LOG_BYTES];
+    uint32_t count;
+    uint8_t  cs, dc, reset;     // the pins of the LCD
+} spi;
+
+// This function logs a byte written to UCB0TXBUF: it returns where the byte is stored
+static volatile uint16_t *SpiTransmit(void)
+{
+    uint32_t n = (spi.count < SPI_LOG_BYTES) ? spi.count++ : SPI_LOG_BYTES - 1;
+
+    spi.log[n].dc = spi.dc;
+    spi.log[n].cs = spi.cs;
+    return &spi.log[n].byte;
+}
+
+// The registers of msp432p401r.h, but for those of the transport of bsp/BSP.c (see lcdData): the transmit buffer
+// is always empty and the bus never busy. The delay of BSP.c, in assembly for the TI compiler, compiles out.
+#define __TI_COMPILER_VERSION__ 1
+#define __asm(...)
+#include "bsp/msp432p401r.h"
+#undef UCB0TXBUF
+#undef UCB0IFG
+#undef UCB0STATW
+#undef UCB0RXBUF
+#define UCB0TXBUF   (*SpiTransmit())
+#define UCB0IFG     0x0002
+#define UCB0STATW   0x0000
+#define UCB0RXBUF   0x0000
+#define TFT_CS      spi.cs
+#define DC          spi.dc
+#define RESET       spi.reset
+
+#include "bsp/BSP.c"
+
+// CortexM.c is in assembly
+long StartCritical(void) { return 0; }
+void EndCritical(long sr) {}
+
+// The functions of the LCD driver that the model implements. Their headers come with driverlib, whose definitions
+// clash with those of msp432p401r.h.
+void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void HAL_LCD_writeCommand(uint8_t command);
+void HAL_LCD_writeDataBurst(const uint8_t *data, uint16_t count);
+
+// This function decodes the bytes logged since the last call into the LCD model, and returns their number. The
+// windows of CASET and RASET take effect at RAMWR. Every byte must be sent with the LCD selected.
+static uint32_t Sent()
+{
+    static uint8_t command, arguments[2][4];
+    static unsigned argument;
+    uint32_t n, count = spi.count;
+    bool selected = true;
+
+    for (n = 0; n < count; n++)
+    {
+        uint8_t byte = spi.log[n].byte;
+
+        selected &= spi.log[n].cs == 0;
+        if (!spi.log[n].dc)
+        {
+            command = byte;
+            argument = 0;
+            if (command == ST7735_RAMWR)
+            {
+                Crystalfontz128x128_SetDrawFrame(arguments[0][1], arguments[1][1], arguments[0][3], arguments[1][3]);
+                HAL_LCD_writeCommand(command);
+            }
+        }
+        else if (command == ST7735_CASET || command == ST7735_RASET)
+        {
+            if (argument < 4)
+                arguments[command - ST7735_CASET][argument++] = byte;
+        }
+        else if (command == ST7735_RAMWR)
+            HAL_LCD_writeDataBurst(&byte, 1);
+    }
+    Check(selected, "the chip select of %u bytes", count);
+    spi.count = 0;
+    return count;
+}
+
+//------------------------------------------
+// The reference
+
+#define SCREEN      0x1234          // around the characters
+#define TEXT        ST7735_YELLOW
+#define BACK        ST7735_BLUE
+
+// This function returns true if the screen shows character c at (x, y), each pixel of the font size x size, in
+// textColor on bgColor, or over the screen if they are the same, and the screen elsewhere. The blank column at the
+// right of the glyph is part of the character.
+static bool Shows(int x, int y, char c, uint16_t textColor, uint16_t bgColor, int size)
+{
+    int px, py;
+
+    for (py = 0; py < 128; py++)
+    {
+        for (px = 0; px < 128; px++)
+        {
+            int column = (px - x) / size, row = (py - y) / size;
+            uint16_t expected = SCREEN;
+
+            if (px >= x && py >= y && column < 6 && row < 8)
+            {
+                if (column < 5 && ((Font[c * 5 + column] >> row) & 1))
+                    expected = textColor;
+                else if (bgColor != textColor)
+                    expected = bgColor;
+            }
+            if (LcdModelPixel(px, py) != expected)
+                return false;
+        }
+    }
+    return true;
+}
+
+// This function returns true if the screen shows the n characters of text from column x of row y of
+// BSP_LCD_DrawString, in textColor on black, and the screen elsewhere
+static bool ShowsString(unsigned x, unsigned y, const char *text, unsigned n, uint16_t textColor)
+{
+    int px, py;
+
+    for (py = 0; py < 128; py++)
+    {
+        for (px = 0; px < 128; px++)
+        {
+            int column = px - (int) x * 6, row = py - (int) y * 10;
+            uint16_t expected = SCREEN;
+
+            if (column >= 0 && column < (int) n * 6 && row >= 0 && row < 8)
+            {
+                char c = text[column / 6];
+
+                expected = (column % 6 < 5 && ((Font[c * 5 + column % 6] >> row) & 1)) ? textColor : ST7735_BLACK;
+            }
+            if (LcdModelPixel(px, py) != expected)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void Clear()
+{
+    LcdModelReset(SCREEN);
+    spi.count = 0;
+    spi.cs = 1;
+}
+
+//------------------------------------------
+// Cases
+
+// The transport: a transaction selects the LCD and leaves the chip select as it found it
+static void CheckTransport()
+{
+    uint32_t before;
+
+    Clear();
+    before = BSP_LCD_ByteCount;
+    BSP_LCD_DrawPixel(3, 4, TEXT);
+    Check(Sent() == 13 && BSP_LCD_ByteCount - before == 13, "the 13 bytes of BSP_LCD_DrawPixel");
+    Check(LcdModelPixel(3, 4) == TEXT && LcdModelPixel(4, 4) == SCREEN, "the pixel of BSP_LCD_DrawPixel");
+    Check(spi.cs == 1, "the chip select after a transaction");
+
+    spi.cs = 0;
+    BSP_LCD_FillRect(10, 20, 7, 5, TEXT);
+    Check(Sent() == 11 + 2 * 7 * 5, "the 11 + 2*w*h bytes of BSP_LCD_FillRect");
+    Check(spi.cs == 0, "the chip select left low, as the Crystalfontz HAL keeps it");
+}
+
+// streamGlyphRow sends 6 columns of size pixels, and fillClipped cuts a rectangle at the left and top edges
+static void CheckHelpers()
+{
+    static const uint8_t glyph[5] = {0x01, 0x00, 0x01, 0x01, 0x00};
+    uint16_t colors[18];
+    unsigned size, i;
+
+    for (size = 1; size <= 3; size++)
+    {
+        Clear();
+        streamGlyphRow(glyph, 0x01, TEXT, BACK, size);
+        Check(spi.count == 2 * 6 * size, "the 2*6*size bytes of streamGlyphRow of size %u", size);
+        for (i = 0; i < 6 * size; i++)
+            colors[i] = (spi.log[2 * i].byte << 8) | spi.log[2 * i + 1].byte;
+        for (i = 0; i < 6 * size; i++)
+            if (colors[i] != ((i / size == 0 || i / size == 2 || i / size == 3) ? TEXT : BACK))
+                break;
+        Check(i == 6 * size, "the colors of streamGlyphRow of size %u", size);
+    }
+
+    Clear();
+    fillClipped(-3, -2, 8, 6, TEXT);
+    Check(Sent() == 11 + 2 * 5 * 4 && LcdModel.windows == 1, "fillClipped across the top left corner");
+    Check(LcdModelPixel(0, 0) == TEXT && LcdModelPixel(4, 3) == TEXT && LcdModelPixel(5, 3) == SCREEN
+          && LcdModelPixel(4, 4) == SCREEN, "the pixels of fillClipped across the top left corner");
+
+    fillClipped(-8, 10, 8, 6, TEXT);
+    fillClipped(10, -6, 8, 6, TEXT);
+    Check(Sent() == 0, "fillClipped off the screen");
+}
+
+// A character fully on the screen, with a background, is one window of 11 + 2*size*size*6*8 bytes
+static void CheckOpaque()
+{
+    static const uint32_t bytes[] = {0, 107, 395};
+    unsigned size;
+
+    for (size = 1; size <= 2; size++)
+    {
+        Clear();
+        BSP_LCD_DrawChar(10, 20, 'A', TEXT, BACK, size);
+        Check(Sent() == bytes[size] && LcdModel.windows == 1, "the %u bytes of BSP_LCD_DrawChar", bytes[size]);
+        Check(Shows(10, 20, 'A', TEXT, BACK, size), "BSP_LCD_DrawChar of size %u", size);
+
+        Clear();
+        BSP_LCD_DrawCharS(10, 20, 'g', TEXT, BACK, size);
+        Check(Sent() == bytes[size] && LcdModel.windows == 1, "the %u bytes of BSP_LCD_DrawCharS", bytes[size]);
+        Check(Shows(10, 20, 'g', TEXT, BACK, size), "BSP_LCD_DrawCharS of size %u", size);
+    }
+
+    Clear();
+    BSP_LCD_DrawChar(123, 0, 'A', TEXT, BACK, 1);
+    BSP_LCD_DrawChar(0, 121, 'A', TEXT, BACK, 1);
+    BSP_LCD_DrawChar(-1, 0, 'A', TEXT, BACK, 1);
+    BSP_LCD_DrawChar(0, -1, 'A', TEXT, BACK, 2);
+    Check(Sent() == 0, "BSP_LCD_DrawChar not fully on the screen");
+
+    Clear();
+    BSP_LCD_DrawChar(122, 120, '~', TEXT, BACK, 1);
+    Sent();
+    Check(Shows(122, 120, '~', TEXT, BACK, 1), "BSP_LCD_DrawChar in the bottom right corner");
+}
+
+// A transparent character is one window per vertical run of text pixels: 'A' is 8 runs of 16 pixels, 120 bytes
+static void CheckTransparent()
+{
+    Clear();
+    BSP_LCD_DrawCharS(10, 20, 'A', TEXT, TEXT, 1);
+    Check(Sent() == 120 && LcdModel.windows == 8, "the 120 bytes of a transparent 'A'");
+    Check(Shows(10, 20, 'A', TEXT, TEXT, 1), "a transparent 'A'");
+
+    Clear();
+    BSP_LCD_DrawCharS(40, 50, 'W', TEXT, TEXT, 3);
+    Sent();
+    Check(Shows(40, 50, 'W', TEXT, TEXT, 3), "a transparent 'W' of size 3");
+}
+
+// A character partly off the screen is drawn in clipped runs, on each side, and one fully off it sends nothing
+static void CheckClipped()
+{
+    static const struct {
+        int16_t x, y;
+        uint8_t size;
+        bool    transparent;
+    } cases[] = {
+        {-3, 10, 1, false}, {10, -5, 2, false}, {-7, -9, 3, false}, {124, 30, 1, false},
+        {30, 122, 2, false}, {120, 118, 3, false}, {-4, 60, 2, true}, {123, 125, 1, true},
+    };
+    unsigned i;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint16_t bgColor = cases[i].transparent ? TEXT : BACK;
+
+        Clear();
+        BSP_LCD_DrawCharS(cases[i].x, cases[i].y, 'B', TEXT, bgColor, cases[i].size);
+        Sent();
+        Check(Shows(cases[i].x, cases[i].y, 'B', TEXT, bgColor, cases[i].size), "BSP_LCD_DrawCharS at (%d, %d)",
+              cases[i].x, cases[i].y);
+    }
+
+    Clear();
+    BSP_LCD_DrawCharS(128, 0, 'B', TEXT, BACK, 1);
+    BSP_LCD_DrawCharS(0, 128, 'B', TEXT, BACK, 1);
+    BSP_LCD_DrawCharS(-12, 0, 'B', TEXT, BACK, 2);
+    BSP_LCD_DrawCharS(0, -16, 'B', TEXT, BACK, 2);
+    Check(Sent() == 0, "BSP_LCD_DrawCharS off the screen");
+}
+
+// A string is one window of 11 + 2*6*8*n bytes. The characters that fit are drawn, up to column 20, and the
+// one in column 20 is not counted in the number returned.
+static void CheckString()
+{
+    char text[] = "0123456789", row[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ", hello[] = "Hello, world", empty[] = "";
+    uint32_t printed;
+
+    Clear();
+    printed = BSP_LCD_DrawString(2, 3, text, TEXT);
+    Check(printed == 10 && Sent() == 971 && LcdModel.windows == 1, "the 971 bytes of 10 characters");
+    Check(ShowsString(2, 3, text, 10, TEXT), "a string of 10 characters");
+
+    Clear();
+    printed = BSP_LCD_DrawString(0, 12, row, TEXT);
+    Check(printed == 20 && Sent() == 11 + 2 * 6 * 8 * 21, "a row of 21 columns, of which 20 are counted");
+    Check(ShowsString(0, 12, row, 21, TEXT), "a row of 21 columns");
+
+    Clear();
+    printed = BSP_LCD_DrawString(15, 0, hello, TEXT);
+    Check(printed == 5 && Sent() == 11 + 2 * 6 * 8 * 6, "a string cut at column 20");
+    Check(ShowsString(15, 0, hello, 6, TEXT), "the characters of a string cut at column 20");
+
+    Clear();
+    printed = BSP_LCD_DrawString(20, 5, hello, TEXT);
+    Check(printed == 0 && Sent() == 11 + 2 * 6 * 8, "a string in column 20");
+
+    Clear();
+    Check(BSP_LCD_DrawString(21, 0, hello, TEXT) == 0 && BSP_LCD_DrawString(0, 13, hello, TEXT) == 0
+          && BSP_LCD_DrawString(0, 0, empty, TEXT) == 0 && Sent() == 0, "strings that are not drawn");
+}
+
+int main()
+{
+    CheckTransport();
+    CheckHelpers();
+    CheckOpaque();
+    CheckTransparent();
+    CheckClipped();
+    CheckString();
+
+    return CheckReport();
+}
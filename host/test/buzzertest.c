@@ -0,0 +1,265 @@
+//------------------------------------------
+// BUZZER TEST
+// This host program plays sounds through Buzzer_HAL.c on a model of Timer_A0, Timer_A3 and P2.7, and checks the
+// pitch and the duty of each note, its length in ACLK periods, the rests, the end of a sound, the priorities, the
+// repitch after a change of SMCLK, and BuzzerDump. The test expires the notes itself, by calling TA3_0_IRQHandler
+// as the NVIC would.
+
+#include <stdio.h>
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Buzzer_HAL.h>
+
+#define TEST_NAME "buzzertest"
+#include "Check.h"
+
+
+//------------------------------------------
+// Timer_A0, Timer_A3, P2.7, the clocks and the interrupts
+
+typedef struct {
+    uint_fast16_t clockSource;
+    bool          ccr0Interrupt;
+    uint_fast16_t outputMode;       // of CCR4
+    uint_fast16_t ccr0, ccr4;
+    bool          running;
+} TimerModel_t;
+
+static TimerModel_t tone, note;
+
+static bool pinPeripheral, pinLow;
+static uint32_t smclkHz = 12000000;
+static bool masterEnabled = true, ta3Enabled;
+
+static TimerModel_t *Timer(uint32_t timer)
+{
+    return (timer == TIMER_A0_BASE) ? &tone : &note;
+}
+
+void Timer_A_configureUpMode(uint32_t timer, const Timer_A_UpModeConfig *config)
+{
+    Timer(timer)->clockSource = config->clockSource;
+    Timer(timer)->ccr0Interrupt =
+        (config->captureCompareInterruptEnable_CCR0_CCIE == TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE);
+}
+
+void Timer_A_initCompare(uint32_t timer, const Timer_A_CompareModeConfig *compareConfig)
+{
+    if (compareConfig->compareRegister == TIMER_A_CAPTURECOMPARE_REGISTER_4)
+        Timer(timer)->outputMode = compareConfig->compareOutputMode;
+}
+
+void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode)
+{
+    Timer(timer)->running = (timerMode == TIMER_A_UP_MODE);
+}
+
+void Timer_A_stopTimer(uint32_t timer)
+{
+    Timer(timer)->running = false;
+}
+
+void Timer_A_clearTimer(uint32_t timer)
+{
+}
+
+void Timer_A_setCompareValue(uint32_t timer, uint_fast16_t compareRegister, uint_fast16_t compareValue)
+{
+    Check(!Timer(timer)->running, "a compare value set while the timer runs");
+    if (compareRegister == TIMER_A_CAPTURECOMPARE_REGISTER_0)
+        Timer(timer)->ccr0 = compareValue;
+    else if (compareRegister == TIMER_A_CAPTURECOMPARE_REGISTER_4)
+        Timer(timer)->ccr4 = compareValue;
+}
+
+void Timer_A_clearCaptureCompareInterrupt(uint32_t timer, uint_fast16_t captureCompareRegister)
+{
+}
+
+void GPIO_setOutputLowOnPin(uint_fast8_t port, uint_fast16_t pins)
+{
+    if (port == GPIO_PORT_P2 && pins == GPIO_PIN7)
+        pinLow = true;
+}
+
+void GPIO_setAsOutputPin(uint_fast8_t port, uint_fast16_t pins)
+{
+    if (port == GPIO_PORT_P2 && pins == GPIO_PIN7)
+        pinPeripheral = false;
+}
+
+void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode)
+{
+    if (port == GPIO_PORT_P2 && pins == GPIO_PIN7 && mode == GPIO_PRIMARY_MODULE_FUNCTION)
+        pinPeripheral = true;
+}
+
+uint32_t CS_getSMCLK(void)
+{
+    return smclkHz;
+}
+
+bool Interrupt_disableMaster(void)
+{
+    bool wasDisabled = !masterEnabled;
+
+    masterEnabled = false;
+    return wasDisabled;
+}
+
+void Interrupt_enableMaster(void)
+{
+    masterEnabled = true;
+}
+
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == INT_TA3_0)
+        ta3Enabled = true;
+}
+
+// The ISR of Buzzer_HAL.c, in the vector table on the target
+void TA3_0_IRQHandler();
+
+// The note playing expires
+static void Expire()
+{
+    Check(note.running && ta3Enabled && note.ccr0Interrupt, "the interrupt of a note that expires");
+    TA3_0_IRQHandler();
+}
+
+//------------------------------------------
+// What the buzzer plays
+
+static bool Silent()
+{
+    return !tone.running && !pinPeripheral && pinLow;
+}
+
+// This function returns true if the buzzer plays hz for ms
+static bool Playing(uint32_t hz, uint32_t ms)
+{
+    uint32_t period = smclkHz / hz;
+
+    return tone.running && pinPeripheral && tone.ccr0 == period - 1 && tone.ccr4 == period / 2 &&
+           note.running && note.ccr0 == ms * 32768 / 1000 - 1;
+}
+
+// This function returns true if the buzzer rests for ms
+static bool Resting(uint32_t ms)
+{
+    return Silent() && note.running && note.ccr0 == ms * 32768 / 1000 - 1;
+}
+
+static char lines[2][20];
+
+static void Emit(char *line, uint32_t index)
+{
+    if (index < 2)
+        strcpy(lines[index], line);
+}
+
+//------------------------------------------
+// Cases
+
+static const Note_t tuneNotes[] = {{440, 100}, {0, 50}, {1000, BUZZER_MAX_MS}, {150, 20}, {2000, 0}};
+static const Sound_t tune = {tuneNotes, 5, 1};
+
+static const Note_t beepNotes[] = {{3000, 30}};
+static const Sound_t beep = {beepNotes, 1, 1};
+static const Sound_t alarm = {beepNotes, 1, 2};
+static const Sound_t click = {beepNotes, 1, 0};
+
+static const Note_t lowNotes[] = {{BUZZER_MIN_HZ, 10}};
+static const Sound_t low = {lowNotes, 1, 0};
+
+static void CheckNotes()
+{
+    InitBuzzer();
+    Check(tone.clockSource == TIMER_A_CLOCKSOURCE_SMCLK && tone.outputMode == TIMER_A_OUTPUTMODE_RESET_SET,
+          "Timer_A0 on SMCLK, with CCR4 in reset/set mode");
+    Check(note.clockSource == TIMER_A_CLOCKSOURCE_ACLK && note.ccr0Interrupt && ta3Enabled,
+          "Timer_A3 on ACLK, with the interrupt of CCR0");
+    Check(Silent() && !note.running && !SoundPlaying(), "the buzzer silent after InitBuzzer");
+
+    Check(PlaySound(&tune), "a sound");
+    Check(masterEnabled, "the interrupts enabled again after PlaySound");
+    Check(SoundPlaying() && Playing(440, 100), "the first note");
+
+    Expire();
+    Check(Resting(50), "a rest");
+    Expire();
+    Check(Playing(1000, BUZZER_MAX_MS), "the longest note");
+
+    // A pitch below BUZZER_MIN_HZ is a rest too
+    Expire();
+    Check(Resting(20), "a note too low");
+
+    // A note of 0 ms lasts one period of ACLK
+    Expire();
+    Check(tone.running && tone.ccr0 == smclkHz / 2000 - 1 && note.running && note.ccr0 == 0, "a note of 0 ms");
+
+    Expire();
+    Check(!SoundPlaying() && Silent() && !note.running, "the end of the sound");
+
+    // An interrupt after the end, which StopSound may leave pending, only stops Timer_A3
+    note.running = true;
+    TA3_0_IRQHandler();
+    Check(!note.running && Silent(), "an interrupt without a sound");
+}
+
+static void CheckPriorities()
+{
+    Check(PlaySound(&beep) && Playing(3000, 30), "a sound");
+    Check(!PlaySound(&click) && Playing(3000, 30), "a sound of a lower priority dropped");
+    Check(PlaySound(&tune) && Playing(440, 100), "a sound of the same priority");
+    Check(PlaySound(&alarm) && Playing(3000, 30), "a sound of a higher priority");
+    Check(!PlaySound(&tune), "a sound of a lower priority than the one that cut it");
+
+    // From an ISR, with the interrupts disabled
+    Interrupt_disableMaster();
+    StopSound();
+    Check(!masterEnabled, "the interrupts left disabled by StopSound");
+    Check(!SoundPlaying() && Silent() && !note.running, "StopSound");
+    Check(PlaySound(&click) && !masterEnabled, "the interrupts left disabled by PlaySound");
+    Interrupt_enableMaster();
+    StopSound();
+
+    Check(BuzzerDump(Emit) == 2, "the lines of BuzzerDump");
+    Check(!strcmp(lines[0], "Sounds 5") && !strcmp(lines[1], " cut 2 drop 2"), "the counters of BuzzerDump");
+}
+
+static void CheckClock()
+{
+    // The note playing keeps its pitch, and its length
+    PlaySound(&tune);
+    smclkHz = 24000000;
+    BuzzerClockChanged(smclkHz);
+    Check(Playing(440, 100), "the note repitched after a change of SMCLK");
+
+    // A rest stays a rest
+    Expire();
+    smclkHz = 3000000;
+    BuzzerClockChanged(smclkHz);
+    Check(Resting(50), "a rest after a change of SMCLK");
+    Expire();
+    Check(Playing(1000, BUZZER_MAX_MS), "the next note at the new SMCLK");
+
+    // At 48 MHz, the lowest pitch does not fit in CCR0
+    StopSound();
+    smclkHz = 48000000;
+    BuzzerClockChanged(smclkHz);
+    Check(Silent(), "the buzzer silent after a change of SMCLK");
+    PlaySound(&low);
+    Check(tone.running && tone.ccr0 == 0xFFFF && tone.ccr4 == 0x8000, "a period clamped to CCR0");
+    StopSound();
+}
+
+int main()
+{
+    CheckNotes();
+    CheckPriorities();
+    CheckClock();
+
+    return CheckReport();
+}
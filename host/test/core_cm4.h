@@ -0,0 +1,13 @@
+//------------------------------------------
+// CORE CM4
+// The qualifiers of CMSIS that bsp/msp432p401r.h needs from its core_cm4.h, for bsptest, which compiles bsp/BSP.c
+// on the host. The core registers themselves are not used there.
+
+#ifndef CORE_CM4_H_
+#define CORE_CM4_H_
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+#endif // CORE_CM4_H_
@@ -0,0 +1,273 @@
+//------------------------------------------
+// CRYPTO TEST
+// This host program checks Crypto_HAL against known answers: the CRC-32 of zlib, the AES examples of FIPS-197
+// (appendix C) and the ECB and CTR examples of SP 800-38A (F.1 and F.5), with 128, 192 and 256 bit keys.
+// It is built with CRYPTO_HARDWARE=1 against a model of the CRC32 and AES256 modules (CryptoModel.h): the known
+// answers are checked in software, then the CRC again in the model, with each order of the bits InitCrypto may
+// have to find, and the way back to the software when the model fails.
+
+#include <stdio.h>
+#include <string.h>
+#include <Crypto_HAL.h>
+#include "CryptoModel.h"
+
+#define TEST_NAME "cryptotest"
+#include "Check.h"
+
+#define MAX_BYTES 1024
+
+
+// This function converts a string of hex digits to bytes and returns their number
+static unsigned Hex(const char *hex, uint8_t *bytes)
+{
+    unsigned n, value;
+
+    for (n = 0; hex[2 * n] && sscanf(hex + 2 * n, "%2x", &value) == 1; n++)
+        bytes[n] = value;
+    return n;
+}
+
+//------------------------------------------
+// CRC-32
+
+static const struct {
+    const char *text;
+    uint32_t crc;
+} crcAnswers[] = {
+    {"", 0x00000000},
+    {"a", 0xE8B7BE43},
+    {"123456789", 0xCBF43926},
+    {"The quick brown fox jumps over the lazy dog", 0x414FA339},
+};
+
+static void CheckCrc()
+{
+    uint8_t bytes[MAX_BYTES];
+    unsigned i;
+
+    for (i = 0; i < sizeof(crcAnswers) / sizeof(crcAnswers[0]); i++)
+        Check(CrcCompute(crcAnswers[i].text, strlen(crcAnswers[i].text)) == crcAnswers[i].crc, "CRC-32");
+
+    // Above CRYPTO_CRC_DMA_MIN, where the target feeds the CRC32 module by DMA: 0, 1, ... 255, four times
+    for (i = 0; i < MAX_BYTES; i++)
+        bytes[i] = i;
+    Check(CrcCompute(bytes, MAX_BYTES) == 0xB70B4C26, "CRC-32 of 1024 bytes");
+}
+
+//------------------------------------------
+// AES
+
+// FIPS-197, appendix C: the key 00 01 02 ... of each length
+static const char fipsPlain[] = "00112233445566778899aabbccddeeff";
+
+static const struct {
+    unsigned bits;
+    const char *cipher;
+} fipsAnswers[] = {
+    {128, "69c4e0d86a7b0430d8cdb78070b4c55a"},
+    {192, "dda97ca4864cdfe06eaf70a0ec0d7191"},
+    {256, "8ea2b7ca516745bfeafc49904b496089"},
+};
+
+// SP 800-38A: the same four blocks with each key, in ECB mode (F.1) and in CTR mode (F.5)
+static const char spPlain[] =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const char spCounter[] = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static const char spCounterAfter[] = "f0f1f2f3f4f5f6f7f8f9fafbfcfdff03";
+
+static const struct {
+    const char *key;
+    const char *ecb;
+    const char *ctr;
+} spAnswers[] = {
+    {"2b7e151628aed2a6abf7158809cf4f3c",
+     "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+     "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4",
+     "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+     "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"},
+    {"8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b",
+     "bd334f1d6e45f25ff712a214571fa5cc974104846d0ad3ad7734ecb3ecee4eef"
+     "ef7afd2270e2e60adce0ba2face6444e9a4b41ba738d6c72fb16691603c18e0e",
+     "1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e94"
+     "1e36b26bd1ebc670d1bd1d665620abf74f78a7f6d29809585a97daec58c6b050"},
+    {"603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+     "f3eed1bdb5d2a03c064b5a7e3db181f8591ccb10d410ed26dc5ba74a31362870"
+     "b6ed21b99ca6f4f9f153e7b1beafed1d23304b7a39f9f3ff067d8d8f9e24ecc7",
+     "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+     "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"},
+};
+
+// A counter whose low 64 bits are all ones carries into the high ones, with the key of F.5.1
+static const char carryCounter[] = "0000000000000000ffffffffffffffff";
+static const char carryCipher[] =
+    "84468955ad84651e0fba9085149428447227b194980a6ef3f19d0c0fd95860c2";
+static const char carryCounterAfter[] = "00000000000000010000000000000001";
+
+static void CheckFips()
+{
+    uint8_t key[32], plain[AES_BLOCK_BYTES], cipher[AES_BLOCK_BYTES], block[AES_BLOCK_BYTES];
+    unsigned i, k;
+
+    Hex(fipsPlain, plain);
+    for (i = 0; i < sizeof(fipsAnswers) / sizeof(fipsAnswers[0]); i++)
+    {
+        unsigned bits = fipsAnswers[i].bits;
+
+        for (k = 0; k < bits / 8; k++)
+            key[k] = k;
+        Hex(fipsAnswers[i].cipher, cipher);
+        Check(AesSetKey(key, bits), "AesSetKey with a %u bit key", bits);
+
+        AesEncryptECB(plain, block, 1);
+        Check(memcmp(block, cipher, AES_BLOCK_BYTES) == 0, "FIPS-197 encryption with a %u bit key", bits);
+        AesDecryptECB(block, block, 1);
+        Check(memcmp(block, plain, AES_BLOCK_BYTES) == 0, "FIPS-197 decryption in place with a %u bit key", bits);
+    }
+}
+
+static void CheckEcb(unsigned bits, const uint8_t *plain, const uint8_t *cipher, unsigned length)
+{
+    uint8_t data[MAX_BYTES];
+
+    AesEncryptECB(plain, data, length / AES_BLOCK_BYTES);
+    Check(memcmp(data, cipher, length) == 0, "SP 800-38A ECB encryption with a %u bit key", bits);
+    AesDecryptECB(data, data, length / AES_BLOCK_BYTES);
+    Check(memcmp(data, plain, length) == 0, "SP 800-38A ECB decryption in place with a %u bit key", bits);
+
+    memcpy(data, plain, length);
+    AesEncryptECB(data, data, length / AES_BLOCK_BYTES);
+    Check(memcmp(data, cipher, length) == 0, "SP 800-38A ECB encryption in place with a %u bit key", bits);
+}
+
+static void CheckCtr(unsigned bits, const uint8_t *plain, const uint8_t *cipher, unsigned length)
+{
+    uint8_t data[MAX_BYTES], counter[AES_BLOCK_BYTES], next[AES_BLOCK_BYTES];
+
+    // All at once, then the counter is the one of the block after the last
+    Hex(spCounter, counter);
+    AesCTR(counter, plain, data, length);
+    Check(memcmp(data, cipher, length) == 0, "SP 800-38A CTR encryption with a %u bit key", bits);
+    Hex(spCounterAfter, next);
+    Check(memcmp(counter, next, AES_BLOCK_BYTES) == 0, "CTR counter after the data with a %u bit key", bits);
+
+    // A block, then the rest: the second call goes on from the counter the first one left
+    Hex(spCounter, counter);
+    memcpy(data, cipher, length);
+    AesCTR(counter, data, data, AES_BLOCK_BYTES);
+    AesCTR(counter, data + AES_BLOCK_BYTES, data + AES_BLOCK_BYTES, length - AES_BLOCK_BYTES);
+    Check(memcmp(data, plain, length) == 0, "SP 800-38A CTR decryption in place, in two calls with a %u bit key", bits);
+
+    // A block and a few bytes: the partly used block counts
+    Hex(spCounter, counter);
+    AesCTR(counter, plain, data, AES_BLOCK_BYTES + 4);
+    Check(memcmp(data, cipher, AES_BLOCK_BYTES + 4) == 0, "CTR encryption of a partial block with a %u bit key", bits);
+    AesCTR(counter, plain + 2 * AES_BLOCK_BYTES, data, AES_BLOCK_BYTES);
+    Check(memcmp(data, cipher + 2 * AES_BLOCK_BYTES, AES_BLOCK_BYTES) == 0,
+          "CTR after a partial block with a %u bit key", bits);
+}
+
+static void CheckSp800()
+{
+    uint8_t key[32], plain[MAX_BYTES], cipher[MAX_BYTES], counter[AES_BLOCK_BYTES], next[AES_BLOCK_BYTES];
+    unsigned i, bits, length;
+
+    length = Hex(spPlain, plain);
+    for (i = 0; i < sizeof(spAnswers) / sizeof(spAnswers[0]); i++)
+    {
+        bits = Hex(spAnswers[i].key, key) * 8;
+        Check(AesSetKey(key, bits), "AesSetKey with a %u bit key", bits);
+
+        Hex(spAnswers[i].ecb, cipher);
+        CheckEcb(bits, plain, cipher, length);
+        Hex(spAnswers[i].ctr, cipher);
+        CheckCtr(bits, plain, cipher, length);
+    }
+
+    bits = Hex(spAnswers[0].key, key) * 8;
+    AesSetKey(key, bits);
+    Hex(carryCounter, counter);
+    length = Hex(carryCipher, cipher);
+    AesCTR(counter, plain, plain, length);
+    Check(memcmp(plain, cipher, length) == 0, "CTR with a carry out of the low 64 bits with a %u bit key", bits);
+    Hex(carryCounterAfter, next);
+    Check(memcmp(counter, next, AES_BLOCK_BYTES) == 0, "CTR counter after a carry with a %u bit key", bits);
+
+    Check(!AesSetKey(key, 160), "AesSetKey of an invalid length with a %u bit key", 160);
+}
+
+//------------------------------------------
+// The hardware, in the model
+
+static char dumped[2][20];
+
+static void Dumped(char *line, uint32_t index)
+{
+    strcpy(dumped[index], line);
+}
+
+// The CRC of the model against the software, below and above CRYPTO_CRC_DMA_MIN, in each order of the bits
+static void CheckCrcOrders()
+{
+    uint8_t bytes[MAX_BYTES];
+    unsigned order, i, length;
+
+    for (i = 0; i < MAX_BYTES; i++)
+        bytes[i] = i * 7 + (i >> 3);
+
+    for (order = 0; order < 4; order++)
+    {
+        memset(&CryptoModel, 0, sizeof(CryptoModel));
+        CryptoModel.lsbFirst = order & 1;
+        CryptoModel.reflected = order & 2;
+        InitCrypto();
+        Check(CryptoUseHardware(true), "InitCrypto in order %u", order);
+
+        CheckCrc();
+        for (length = 0; length < 3 * CRYPTO_CRC_DMA_MIN; length += 5)
+        {
+            uint32_t crc;
+
+            CryptoUseHardware(true);
+            crc = CrcCompute(bytes, length);
+            CryptoUseHardware(false);
+            Check(crc == CrcCompute(bytes, length), "CRC of %u bytes in the model in order %u", length, order);
+        }
+        Check(CryptoModel.dmaBytes > 0, "DMA to the CRC32 module in order %u", order);
+    }
+}
+
+// A CRC32 module that gives no order is not used, and an AES256 module that fails the self-test is given up
+static void CheckFallback()
+{
+    memset(&CryptoModel, 0, sizeof(CryptoModel));
+    CryptoModel.broken = true;
+    InitCrypto();
+    Check(!CryptoUseHardware(true), "InitCrypto of a broken CRC32 module");
+    Check(CrcCompute("123456789", 9) == 0xCBF43926, "CRC-32 after a broken CRC32 module");
+    Check(CryptoDump(Dumped) == 2 && strcmp(dumped[1], " HW CRC failed") == 0, "dump of a broken CRC32 module");
+
+    CryptoModel.broken = false;
+    InitCrypto();
+    Check(CryptoUseHardware(true), "InitCrypto after a broken CRC32 module");
+    Check(CryptoDump(Dumped) == 1, "dump before the self-test");
+    Check(CryptoSelfTest(), "CryptoSelfTest with the AES256 model, in software");
+    Check(!CryptoUseHardware(true), "the hardware after the AES256 model failed");
+    Check(CryptoDump(Dumped) == 2 && strcmp(dumped[0], "Crypto ok SW") == 0
+          && strcmp(dumped[1], " HW AES failed") == 0, "dump after the AES256 model failed");
+}
+
+int main()
+{
+    InitCrypto();
+    CryptoUseHardware(false);
+    CheckCrc();
+    CheckFips();
+    CheckSp800();
+    Check(CryptoSelfTest(), "CryptoSelfTest");
+
+    CheckCrcOrders();
+    CheckFallback();
+
+    return CheckReport();
+}
@@ -0,0 +1,285 @@
+//------------------------------------------
+// FLASH LOG TEST
+// This host program checks how InitFlashLog finds the end of the log in flash images written by hand: the newest
+// sector when the sequence numbers of the summaries wrap around, the first free record behind records that a reset
+// cut short, and the log going on after an erase that failed. The images are in the simulated flash (sim/Flash.c),
+// and InitFlashLog is called again for every one of them, as after a reset. Crypto_HAL is the one with the hardware,
+// on the model of CryptoModel.h, so that the records are also checked to read the same whether their CRC comes
+// from the CRC32 module or from the software.
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <FlashLog.h>
+#include <Crypto_HAL.h>
+#include "Sim.h"
+#include "CryptoModel.h"
+
+#define TEST_NAME "flashlogtest"
+#include "Check.h"
+
+// The layout of the records of FlashLog.c, which is that of the flash
+typedef struct {
+    uint8_t  type;
+    uint8_t  key;
+    uint16_t sequence;
+    uint32_t a;
+    uint32_t b;
+    uint32_t crc;
+} Record_t;
+
+enum {SUMMARY = 1, RESULT, SETTING};
+
+#define RECORDS_PER_SECTOR (FLASH_LOG_SECTOR_SIZE / sizeof(Record_t))
+
+
+//------------------------------------------
+// Images
+
+static Record_t *Slot(unsigned sector, unsigned n)
+{
+    return (Record_t *) (SimFlashLog + sector * FLASH_LOG_SECTOR_SIZE) + n;
+}
+
+static void Erase()
+{
+    memset(SimFlashLog, 0xFF, FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE);
+}
+
+static void Put(unsigned sector, unsigned n, uint8_t type, uint8_t key, uint16_t sequence, uint32_t a, uint32_t b)
+{
+    Record_t *record = Slot(sector, n);
+
+    record->type = type;
+    record->key = key;
+    record->sequence = sequence;
+    record->a = a;
+    record->b = b;
+    record->crc = CrcCompute(record, offsetof(Record_t, crc));
+}
+
+// A record that a reset cut short: its first half is programmed, not its CRC
+static void PutPartial(unsigned sector, unsigned n, uint8_t type)
+{
+    Put(sector, n, type, 1, 0xFFFF, 0, 0);
+    memset((uint8_t *) Slot(sector, n) + sizeof(Record_t) / 2, 0xFF, sizeof(Record_t) / 2);
+}
+
+static void PutResults(unsigned sector, unsigned from, unsigned to, bool won)
+{
+    unsigned n;
+
+    for (n = from; n < to; n++)
+        Put(sector, n, RESULT, won, 0xFFFF, n, 0);
+}
+
+//------------------------------------------
+// The state of the log, from its dump
+
+static struct {
+    unsigned won, rounds;
+    int sector;
+    unsigned next, bootReads, failures;
+    char log[20];
+} state;
+
+static void Emit(char *line, uint32_t index)
+{
+    switch (index)
+    {
+    case 0: sscanf(line, "Log %u/%u", &state.won, &state.rounds); strcpy(state.log, line); break;
+    case 1: sscanf(line, " S %d.%u", &state.sector, &state.next); break;
+    case 2: sscanf(line, " boot %u", &state.bootReads); break;
+    case 3: sscanf(line, " fail %u", &state.failures); break;
+    }
+}
+
+static void Boot()
+{
+    uint32_t won, rounds;
+
+    InitFlashLog();
+    memset(&state, 0, sizeof(state));
+    state.sector = -1;
+    FlashLogDump(Emit);
+
+    rounds = FlashLogRounds(&won);
+    Check(rounds == state.rounds && won == state.won, "FlashLogDump of the rounds");
+}
+
+static bool Setting(unsigned setting, uint32_t expected)
+{
+    uint32_t value;
+
+    return FlashLogGetSetting(setting, &value) && value == expected;
+}
+
+//------------------------------------------
+// Cases
+
+static void CheckEmpty()
+{
+    Erase();
+    Boot();
+    Check(state.sector == -1 && state.rounds == 0, "an erased log");
+    Check(!Setting(0, 0), "no setting in an erased log");
+
+    Check(FlashLogResult(true, 7), "the first result");
+    Boot();
+    Check(state.sector == 0 && state.next == 2 && state.rounds == 1 && state.won == 1, "a log of one result");
+}
+
+// The summaries of sectors 3, 0, 1 and 2 are 0xFFFD, 0xFFFE, 0xFFFF and 0: the newest is sector 2
+static void CheckWrapped()
+{
+    Erase();
+    Put(3, 0, SUMMARY, 0, 0xFFFD, 70, 20);
+    PutResults(3, 1, RECORDS_PER_SECTOR, false);
+    Put(0, 0, SUMMARY, 0, 0xFFFE, 80, 25);
+    PutResults(0, 1, RECORDS_PER_SECTOR, true);
+    Put(1, 0, SUMMARY, 0, 0xFFFF, 90, 30);
+    Put(1, 1, SETTING, 1, 0xFFFF, 7, 0);
+    PutResults(1, 2, RECORDS_PER_SECTOR, false);
+
+    Put(2, 0, SUMMARY, 0, 0x0000, 100, 40);
+    Put(2, 1, SETTING, 1, 0xFFFF, 7, 0);
+    Put(2, 2, RESULT, 1, 0xFFFF, 0, 101);
+    Put(2, 3, RESULT, 0, 0xFFFF, 0, 102);
+    PutPartial(2, 4, RESULT);
+    Put(2, 5, RESULT, 1, 0xFFFF, 0, 103);
+    Put(2, 6, SETTING, 2, 0xFFFF, 123, 0);
+    PutPartial(2, 7, SETTING);
+
+    Boot();
+    Check(state.sector == 2, "the newest sector across the wrap of the sequence");
+    Check(state.next == 8, "the first free record after a partial one");
+    Check(state.rounds == 103 && state.won == 42, "the summary and the results after it");
+    Check(Setting(1, 7) && Setting(2, 123) && !Setting(0, 0), "the settings");
+    Check(state.bootReads <= FLASH_LOG_SECTORS + 8 + 8, "the reads of the boot");
+
+    Check(FlashLogResult(true, 9), "a result after a partial record");
+    Check(FlashLogSetting(2, 123), "a setting that does not change");
+    Boot();
+    Check(state.next == 9 && state.rounds == 104 && state.won == 43, "the result after a partial record");
+
+    // A summary cut short by a reset right after the erase does not count: sector 2 stays the newest
+    PutPartial(3, 0, SUMMARY);
+    Boot();
+    Check(state.sector == 2 && state.rounds == 104, "a sector whose summary was cut short");
+}
+
+// A full sector: the next record goes to a new one, which is erased and starts with the summary and the settings
+static void CheckFull()
+{
+    unsigned n;
+
+    Erase();
+    Put(1, 0, SUMMARY, 0, 5, 1000, 500);
+    Put(1, 1, SETTING, 3, 0xFFFF, 42, 0);
+    PutResults(1, 2, RECORDS_PER_SECTOR, true);
+    Put(2, 0, SUMMARY, 0, 2, 10, 5);
+    PutResults(2, 1, 50, false);
+
+    Boot();
+    Check(state.sector == 1 && state.next == RECORDS_PER_SECTOR, "a full sector");
+    Check(state.rounds == 1000 + RECORDS_PER_SECTOR - 2 && state.won == 500 + RECORDS_PER_SECTOR - 2,
+          "the rounds of a full sector");
+
+    Check(FlashLogResult(false, 0), "a result in a new sector");
+    Boot();
+    Check(state.sector == 2 && state.next == 3, "the new sector");
+    Check(Slot(2, 0)->sequence == 6 && Slot(2, 3)->type == 0xFF, "the new sector erased, with its summary");
+    Check(state.rounds == 1000 + RECORDS_PER_SECTOR - 1 && state.won == 500 + RECORDS_PER_SECTOR - 2,
+          "the rounds in the new sector");
+    Check(Setting(3, 42), "the settings in the new sector");
+
+    // Each record of the sector in turn is its first free one
+    for (n = 3; n < RECORDS_PER_SECTOR; n++)
+        FlashLogResult(true, n);
+    Boot();
+    Check(state.sector == 2 && state.next == RECORDS_PER_SECTOR, "a sector filled by FlashLogResult");
+}
+
+// The erase of the next sector fails: that append fails, the sector is left as it was, and the log goes on in the
+// sector after it, with a summary that has every round.
+static void CheckFailedErase()
+{
+    uint32_t rounds;
+
+    Erase();
+    Put(1, 0, SUMMARY, 0, 0xFFFF, 300, 100);
+    PutResults(1, 1, RECORDS_PER_SECTOR, false);
+    Put(2, 0, SUMMARY, 0, 0xFFFC, 10, 5);
+    PutResults(2, 1, 50, true);
+
+    Boot();
+    rounds = state.rounds;
+    SimFlashEraseFailures = 1;
+    Check(!FlashLogResult(true, 1), "a result whose erase fails");
+    Check(Slot(2, 0)->sequence == 0xFFFC && Slot(2, 49)->type == RESULT, "the sector whose erase failed");
+
+    Check(FlashLogResult(true, 2), "a result after an erase that failed");
+    FlashLogDump(Emit);
+    Check(state.failures == 1, "the failure in FlashLogDump");
+
+    Boot();
+    Check(state.sector == 3 && state.next == 2, "the sector after the one whose erase failed");
+    Check(Slot(3, 0)->sequence == 0x0001, "the sequence of the sector after the one whose erase failed");
+    Check(state.rounds == rounds + 2 && state.failures == 0, "the rounds after an erase that failed");
+}
+
+// Counts too long for a row are shortened in the dump
+static void CheckLargeCounts()
+{
+    Erase();
+    Put(0, 0, SUMMARY, 0, 0, 12345678, 5000000);
+    InitFlashLog();
+    FlashLogDump(Emit);
+    Check(!strcmp(state.log, "Log 5000k/9999k"), "the rounds shortened and held at 9,999,999");
+}
+
+// A log written with the software CRC reads the same with the CRC32 module, and the other way round, in each
+// order of the bits the module may take: a log is not read as empty once the hardware is used, or given up
+static void CheckCrcImplementations()
+{
+    unsigned order;
+
+    for (order = 0; order < 4; order++)
+    {
+        memset(&CryptoModel, 0, sizeof(CryptoModel));
+        CryptoModel.lsbFirst = order & 1;
+        CryptoModel.reflected = order & 2;
+        InitCrypto();
+        Check(CryptoUseHardware(true), "InitCrypto in order %u", order);
+
+        CryptoUseHardware(false);
+        Erase();
+        Put(0, 0, SUMMARY, 0, 1, 20, 10);
+        Put(0, 1, SETTING, 1, 0xFFFF, 7, 0);
+        PutResults(0, 2, 6, true);
+        CryptoUseHardware(true);
+        Boot();
+        Check(state.sector == 0 && state.next == 6 && state.rounds == 24 && state.won == 14 && Setting(1, 7),
+              "a log written in software, read in the model in order %u", order);
+
+        Check(FlashLogResult(false, 1), "a result in the model in order %u", order);
+        CryptoUseHardware(false);
+        Boot();
+        Check(state.next == 7 && state.rounds == 25 && state.won == 14,
+              "a result written in the model, read in software in order %u", order);
+    }
+}
+
+int main()
+{
+    InitCrypto();
+    Check(CryptoUseHardware(true), "InitCrypto");
+    CheckEmpty();
+    CheckWrapped();
+    CheckFull();
+    CheckFailedErase();
+    CheckLargeCounts();
+    CheckCrcImplementations();
+
+    return CheckReport();
+}
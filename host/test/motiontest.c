@@ -0,0 +1,327 @@
+//------------------------------------------
+// MOTION TEST
+// This host program moves the joystick and the board of ADC_HAL.c through a model of ADC14 and its window
+// comparator, and checks the calibration of the rest positions, the windows it programs, the directions and their
+// hysteresis, and the EVT_MOTION posted from the comparator interrupt and from the ticks after it.
+// A conversion is only made when the test calls Convert: it sets the flags of the comparator from the results of
+// the memories, and calls ADC14_IRQHandler if one of them is enabled, as the NVIC would.
+
+#include <stdio.h>
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Scheduler.h>
+#include <ADC_HAL.h>
+
+#define TEST_NAME "motiontest"
+#include "Check.h"
+
+
+//------------------------------------------
+// ADC14
+
+#define MEMORIES 4
+#define NO_WINDOW -1
+
+static struct {
+    uint16_t      results[MEMORIES];
+    int           window[MEMORIES];     // the comparator window of each memory
+    int16_t       low[2], high[2];
+    bool          converting;
+    unsigned      stops;                // of the conversions
+    uint_fast64_t enabled, flags;
+    bool          nvic;                 // INT_ADC14 enabled
+} adc;
+
+static unsigned Memory(uint32_t memorySelect)
+{
+    unsigned m = 0;
+
+    while (memorySelect > 1)
+    {
+        memorySelect >>= 1;
+        m++;
+    }
+    return m;
+}
+
+static unsigned Window(uint32_t windowSelect)
+{
+    return (windowSelect == ADC_COMP_WINDOW1) ? 1 : 0;
+}
+
+void ADC14_enableModule(void) {}
+bool ADC14_initModule(uint32_t clockSource, uint32_t clockPredivider, uint32_t clockDivider,
+                      uint32_t internalChannelMask) { return true; }
+bool ADC14_configureMultiSequenceMode(uint32_t memoryStart, uint32_t memoryEnd, bool repeatMode) { return true; }
+bool ADC14_configureConversionMemory(uint32_t memorySelect, uint32_t refSelect, uint32_t channelSelect,
+                                     bool differentialMode) { return true; }
+bool ADC14_enableSampleTimer(uint32_t multiSampleConvert) { return true; }
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint_fast8_t port, uint_fast16_t pins, uint_fast8_t mode) {}
+
+bool ADC14_enableConversion(void)
+{
+    adc.converting = true;
+    return true;
+}
+
+void ADC14_disableConversion(void)
+{
+    adc.converting = false;
+    adc.stops++;
+}
+
+bool ADC14_isBusy(void)
+{
+    return false;
+}
+
+bool ADC14_toggleConversionTrigger(void)
+{
+    return true;
+}
+
+uint_fast16_t ADC14_getResult(uint32_t memorySelect)
+{
+    return adc.results[Memory(memorySelect)];
+}
+
+// The windows can only change while the conversions are stopped
+bool ADC14_enableComparatorWindow(uint32_t memorySelect, uint32_t windowSelect)
+{
+    Check(!adc.converting, "a memory set to a window during a conversion");
+    adc.window[Memory(memorySelect)] = Window(windowSelect);
+    return true;
+}
+
+bool ADC14_disableComparatorWindow(uint32_t memorySelect)
+{
+    adc.window[Memory(memorySelect)] = NO_WINDOW;
+    return true;
+}
+
+void ADC14_setComparatorWindowValue(uint32_t window, int16_t low, int16_t high)
+{
+    Check(!adc.converting, "a window set during a conversion");
+    adc.low[Window(window)] = low;
+    adc.high[Window(window)] = high;
+}
+
+void ADC14_enableInterrupt(uint_fast64_t mask)
+{
+    adc.enabled |= mask;
+}
+
+void ADC14_disableInterrupt(uint_fast64_t mask)
+{
+    adc.enabled &= ~mask;
+}
+
+uint_fast64_t ADC14_getEnabledInterruptStatus(void)
+{
+    return adc.flags & adc.enabled;
+}
+
+void ADC14_clearInterruptFlag(uint_fast64_t mask)
+{
+    adc.flags &= ~mask;
+}
+
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == INT_ADC14)
+        adc.nvic = true;
+}
+
+// The ISR of ADC_HAL.c, in the vector table on the target
+void ADC14_IRQHandler();
+
+static void Convert()
+{
+    unsigned m;
+
+    if (!adc.converting)
+        return;
+    for (m = 0; m < MEMORIES; m++)
+    {
+        if (adc.window[m] == NO_WINDOW)
+            continue;
+        if (adc.results[m] > adc.high[adc.window[m]])
+            adc.flags |= ADC_HI_INT;
+        if (adc.results[m] < adc.low[adc.window[m]])
+            adc.flags |= ADC_LO_INT;
+    }
+    if (adc.nvic && (adc.flags & adc.enabled))
+        ADC14_IRQHandler();
+}
+
+//------------------------------------------
+// The scheduler
+
+#define MAX_EVENTS 8
+
+static uint32_t events[MAX_EVENTS];
+static unsigned eventCount;
+
+bool PostEvent(EventType_t type, uint32_t arg, EventPriority_t priority)
+{
+    Check(type == EVT_MOTION && priority == PRIO_NORMAL, "the type and priority of an event");
+    if (eventCount < MAX_EVENTS)
+        events[eventCount] = arg;
+    eventCount++;
+    return true;
+}
+
+static const Event_t tick = {EVT_TICK, 0, 0};
+
+static void Set(unsigned stickX, unsigned stickY, unsigned boardX, unsigned boardY)
+{
+    adc.results[0] = stickX;
+    adc.results[1] = stickY;
+    adc.results[2] = boardX;
+    adc.results[3] = boardY;
+}
+
+// This function returns true if exactly the events given were posted since the last call, in order
+static bool Events(unsigned count, uint32_t first, uint32_t second)
+{
+    bool passed = eventCount == count && (count < 1 || events[0] == first) && (count < 2 || events[1] == second);
+
+    eventCount = 0;
+    return passed;
+}
+
+//------------------------------------------
+// Cases
+
+#define STICK_X 8000
+#define STICK_Y 8200
+#define BOARD_X 8100
+#define BOARD_Y 7900
+
+static void CheckCalibration()
+{
+    unsigned n;
+
+    for (n = 0; n < MEMORIES; n++)
+        adc.window[n] = NO_WINDOW;
+    initADC();
+    initJoyStick();
+    initAccelerometer();
+    startADC();
+
+    calibrateMotion();
+    Check(adc.nvic && !(adc.enabled & (ADC_HI_INT | ADC_LO_INT)), "the interrupts during the calibration");
+
+    // The samples are off the rest positions by as much one way as the other
+    for (n = 0; n < CALIBRATION_TICKS; n++)
+    {
+        int noise = (n % 2) ? 30 : -30;
+
+        Check(adc.window[0] == NO_WINDOW, "no window before the end of the calibration");
+        Set(STICK_X + noise, STICK_Y - noise, BOARD_X + 2 * noise, BOARD_Y);
+        MotionTask(&tick);
+    }
+    Check(adc.converting && adc.stops == 1, "the conversions stopped for the windows");
+    Check(adc.window[0] == 0 && adc.window[1] == 0 && adc.window[2] == 1 && adc.window[3] == 1,
+          "the memories of each window");
+    Check(adc.low[0] == STICK_X - JOYSTICK_DEAD_ZONE && adc.high[0] == STICK_Y + JOYSTICK_DEAD_ZONE,
+          "the window of the joystick: both rest positions and the dead-zone");
+    Check(adc.low[1] == BOARD_Y - BOARD_DEAD_ZONE && adc.high[1] == BOARD_X + BOARD_DEAD_ZONE,
+          "the window of the board");
+    Check(Events(0, 0, 0), "no event during the calibration");
+
+    // The interrupts are armed on the first tick that sees both sources at rest
+    Set(STICK_X, STICK_Y + 25, BOARD_X, BOARD_Y);
+    adc.flags = ADC_HI_INT;
+    MotionTask(&tick);
+    Check((adc.enabled & (ADC_HI_INT | ADC_LO_INT)) == (ADC_HI_INT | ADC_LO_INT) && adc.flags == 0,
+          "the interrupts armed at rest, their old flags cleared");
+    Check(Events(0, 0, 0), "no event at rest");
+}
+
+static void CheckMotion()
+{
+    // Within the window: nothing wakes up
+    Set(STICK_X + JOYSTICK_DEAD_ZONE, STICK_Y, BOARD_X, BOARD_Y);
+    Convert();
+    Check(Events(0, 0, 0), "no event within the window");
+
+    // Out of the window of the joystick, on the high side
+    Set(STICK_X + JOYSTICK_DEAD_ZONE + 201, STICK_Y, BOARD_X, BOARD_Y);
+    Convert();
+    Check(Events(1, MOTION_ARG(MOTION_JOYSTICK, DIR_RIGHT), 0), "the event of the interrupt");
+    Check(!(adc.enabled & (ADC_HI_INT | ADC_LO_INT)) && adc.flags == 0, "the interrupts off after the first one");
+    Check(getMotionDirection(MOTION_JOYSTICK) == DIR_RIGHT && getMotionDirection(MOTION_BOARD) == DIR_CENTER,
+          "the directions after the interrupt");
+
+    // The ticks follow it until it is back at rest, within three quarters of the dead-zone
+    MotionTask(&tick);
+    Check(Events(0, 0, 0), "no event while the direction stays");
+    Set(STICK_X + JOYSTICK_DEAD_ZONE * 3 / 4 + 1, STICK_Y, BOARD_X, BOARD_Y);
+    MotionTask(&tick);
+    Check(Events(0, 0, 0), "no event within the hysteresis");
+    Check(!(adc.enabled & ADC_HI_INT), "the interrupts off while a source is away from rest");
+
+    // The direction is that of the axis furthest from rest
+    Set(STICK_X - 2500, STICK_Y + 2600, BOARD_X, BOARD_Y);
+    MotionTask(&tick);
+    Check(Events(1, MOTION_ARG(MOTION_JOYSTICK, DIR_UP), 0), "the event of a tick");
+    Set(STICK_X - 2600, STICK_Y + 2600, BOARD_X, BOARD_Y);
+    MotionTask(&tick);
+    Check(Events(1, MOTION_ARG(MOTION_JOYSTICK, DIR_LEFT), 0), "the direction of the furthest axis");
+
+    Set(STICK_X - JOYSTICK_DEAD_ZONE * 3 / 4, STICK_Y, BOARD_X, BOARD_Y);
+    MotionTask(&tick);
+    Check(Events(1, MOTION_ARG(MOTION_JOYSTICK, DIR_CENTER), 0), "the event back at rest");
+    Check((adc.enabled & (ADC_HI_INT | ADC_LO_INT)) == (ADC_HI_INT | ADC_LO_INT), "the interrupts armed again");
+
+    // Both sources at once, the board on the low side of its window
+    Set(STICK_X, STICK_Y - 2300, BOARD_X, BOARD_Y - BOARD_DEAD_ZONE - 1);
+    Convert();
+    Check(Events(2, MOTION_ARG(MOTION_JOYSTICK, DIR_DOWN), MOTION_ARG(MOTION_BOARD, DIR_DOWN)),
+          "the events of both sources");
+    Set(STICK_X, STICK_Y, BOARD_X, BOARD_Y - BOARD_DEAD_ZONE - 1);
+    MotionTask(&tick);
+    Check(Events(1, MOTION_ARG(MOTION_JOYSTICK, DIR_CENTER), 0) && !(adc.enabled & ADC_LO_INT),
+          "one source back at rest");
+    Set(STICK_X, STICK_Y, BOARD_X, BOARD_Y);
+    MotionTask(&tick);
+    Check(Events(1, MOTION_ARG(MOTION_BOARD, DIR_CENTER), 0) && (adc.enabled & ADC_LO_INT), "both back at rest");
+}
+
+static char lines[4][20];
+
+static void Emit(char *line, uint32_t index)
+{
+    if (index < 4)
+        strcpy(lines[index], line);
+}
+
+static void CheckDeadZone()
+{
+    unsigned stops = adc.stops;
+
+    // The windows stay within the full scale
+    setMotionDeadZone(MOTION_JOYSTICK, 9000);
+    Check(adc.stops == stops + 1 && adc.converting, "the conversions stopped for a new dead-zone");
+    Check(adc.low[0] == 0 && adc.high[0] == 16383, "a window clamped to the full scale");
+    Check(adc.low[1] == BOARD_Y - BOARD_DEAD_ZONE, "the other window");
+
+    Set(STICK_X + 8000, STICK_Y, BOARD_X, BOARD_Y);
+    Convert();
+    Check(Events(0, 0, 0), "no event within a wide dead-zone");
+
+    Check(MotionDump(Emit) == 4, "the lines of MotionDump");
+    Check(!strcmp(lines[0], "Motion 8") && !strcmp(lines[1], " wakes 2"), "the events and wakes of MotionDump");
+    Check(!strcmp(lines[2], " stick 8000 8200") && !strcmp(lines[3], " board 8100 7900"),
+          "the rest positions of MotionDump");
+}
+
+int main()
+{
+    CheckCalibration();
+    CheckMotion();
+    CheckDeadZone();
+
+    return CheckReport();
+}
@@ -0,0 +1,21 @@
+// Generated by host/rammap from colorTest.map. Do not edit.
+// The SRAM of each module of the target build, .data and .bss, the largest first.
+
+#include <RamUsage.h>
+
+const RamModule_t RamModules[] = {
+    {"Render", 8780},
+    {"Crystalfontz128x128_ST7735", 4148},
+    {"colorTest_main", 1170},
+    {"Trace", 1056},
+    {"Stack", 512},
+    {"Profile", 476},
+    {"HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735", 12},
+    {"cs", 12},
+    {"exit", 12},
+    {"_lock", 8},
+    {"system_msp432p401r", 4},
+};
+
+const unsigned RamModuleCount = 11;
+const bool RamModulesEstimated = false;
@@ -0,0 +1,16 @@
+// Generated by host/rammap from colorTest.size. Do not edit.
+// The SRAM of each module of the application, .data and .bss, the largest first, as a 32-bit build
+// of the host lays it out. Regenerate it from the linker map of the CCS build for the exact one.
+
+#include <RamUsage.h>
+
+const RamModule_t RamModules[] = {
+    {"Render", 8780},
+    {"Crystalfontz128x128_ST7735", 4148},
+    {"colorTest_main", 1170},
+    {"Profile", 476},
+    {"Clock_HAL", 8},
+};
+
+const unsigned RamModuleCount = 5;
+const bool RamModulesEstimated = true;
@@ -0,0 +1,223 @@
+//------------------------------------------
+// REACTION TEST
+// This host program feeds fixed streams of reaction times to Reaction.c and checks its statistics against the exact
+// ones: the mean, and p50 and p95, which must be exact over the first REACTION_EXACT samples and close to the exact
+// quantiles of the stream after them, where P2 estimates them.
+// The timer and the buttons are replaced by the functions below: a round starts at the same timestamp, and the top
+// button has a press edge as many cycles earlier as the reaction time, in microseconds, to give.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Timer_HAL.h>
+#include <Buttons_HAL.h>
+#include <Reaction.h>
+
+#define TEST_NAME "reactiontest"
+#include "Check.h"
+
+#define STREAM_SAMPLES 5000
+
+// The running mean rounds off every sample a little, and P2 estimates: they are checked within a thousandth of the
+// mean, and a hundredth of the quantile or 1 ms
+#define MEAN_TOLERANCE(us)      ((us) / 1000 + 1)
+#define QUANTILE_TOLERANCE(us)  ((us) / 100 > 1000 ? (us) / 100 : 1000)
+
+
+//------------------------------------------
+// The timer and the buttons
+
+#define LIGHT_UP 0xF0000000u
+
+static bool armed, interruptsOff;
+static uint32_t pressUS;
+
+// Whether the last light-up was timestamped with the interrupts disabled and the edges not yet armed
+static bool lightUpFirst;
+
+bool Interrupt_disableMaster(void)
+{
+    bool wasOff = interruptsOff;
+
+    interruptsOff = true;
+    return wasOff;
+}
+
+void Interrupt_enableMaster(void)
+{
+    interruptsOff = false;
+}
+
+uint32_t GetTimerValue(uint32_t hwtimer)
+{
+    lightUpFirst = interruptsOff && !armed;
+    return LIGHT_UP;
+}
+
+uint32_t CyclesToMicroseconds(uint32_t cycles)
+{
+    return cycles;
+}
+
+void ArmPressEdges()
+{
+    armed = true;
+}
+
+void DisarmPressEdges()
+{
+    armed = false;
+}
+
+// Timer32_0 counts down, so the press, later, has a lower timestamp
+bool GetPressEdge(button_t button, uint32_t *timestamp)
+{
+    if (!armed || button != BOOSTER_TOP || pressUS == 0)
+        return false;
+    *timestamp = LIGHT_UP - pressUS;
+    return true;
+}
+
+//------------------------------------------
+// Streams
+
+static uint32_t seed = 1;
+
+static uint32_t Random(uint32_t range)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % range;
+}
+
+typedef enum {UNIFORM, SKEWED, RAMP, CONSTANT, STREAMS} Stream_t;
+
+static const char *const streamNames[STREAMS] = {"uniform", "skewed", "ramp", "constant"};
+
+// The reaction time of sample i, in microseconds
+static uint32_t Sample(Stream_t stream, unsigned i)
+{
+    switch (stream)
+    {
+    case UNIFORM:
+        return 150000 + Random(300000);
+    case SKEWED:
+        // Mostly around 250 ms, with a long tail of slow answers
+        return 180000 + Random(100000) + (Random(8) == 0 ? Random(900000) : 0);
+    case RAMP:
+        // Slower and slower, which P2 follows in order
+        return 200000 + i * 40;
+    default:
+        return 312400;
+    }
+}
+
+static int Compare(const void *a, const void *b)
+{
+    uint32_t A = *(const uint32_t *) a, B = *(const uint32_t *) b;
+
+    return (A > B) - (A < B);
+}
+
+// The sample at p, in 1/65536, of the n sorted samples, as Reaction.c picks it while it is exact
+static uint32_t Exact(const uint32_t *sorted, unsigned n, uint32_t p)
+{
+    return sorted[((n - 1) * p + 32768) / 65536];
+}
+
+static uint32_t Difference(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+static bool Near(uint32_t value, uint32_t exact)
+{
+    return Difference(value, exact) <= QUANTILE_TOLERANCE(exact);
+}
+
+static void Play(uint32_t us)
+{
+    uint32_t measured;
+
+    pressUS = 0;
+    ReactionLightUp();
+    Check(!ReactionPoll(), "ReactionPoll before the press of player %u", GetReactionPlayer());
+
+    pressUS = us;
+    Check(ReactionPoll(), "ReactionPoll after the press of player %u", GetReactionPlayer());
+    Check(!ReactionPoll(), "ReactionPoll after the round of player %u", GetReactionPlayer());
+    Check(ReactionRoundTime(&measured) && measured == us, "ReactionRoundTime of player %u", GetReactionPlayer());
+}
+
+static void CheckStream(Stream_t stream)
+{
+    static uint32_t sorted[STREAM_SAMPLES];
+    unsigned player = stream + 1, n;
+    uint64_t sum = 0;
+    ReactionStats_t stats;
+
+    SetReactionPlayer(player);
+    for (n = 1; n <= STREAM_SAMPLES; n++)
+    {
+        uint32_t us = Sample(stream, n - 1);
+
+        Play(us);
+        sum += us;
+        sorted[n - 1] = us;
+
+        if (n > REACTION_EXACT && n != STREAM_SAMPLES)
+            continue;
+
+        qsort(sorted, n, sizeof(sorted[0]), Compare);
+        stats = GetReactionStats(player);
+        Check(stats.samples == n && stats.lastUS == us, "the samples of player %u", player);
+        Check(Difference(stats.meanUS, sum / n) <= MEAN_TOLERANCE(sum / n), "the mean of player %u", player);
+        if (n <= REACTION_EXACT)
+        {
+            Check(stats.p50US == Exact(sorted, n, 32768), "the exact p50 of player %u", player);
+            Check(stats.p95US == Exact(sorted, n, 62259), "the exact p95 of player %u", player);
+        }
+        else
+        {
+            if (!Near(stats.p50US, Exact(sorted, n, 32768)) || !Near(stats.p95US, Exact(sorted, n, 62259)))
+                fprintf(stderr, "reactiontest: %s stream: p50 %u us for %u, p95 %u us for %u\n",
+                        streamNames[stream], (unsigned) stats.p50US, (unsigned) Exact(sorted, n, 32768),
+                        (unsigned) stats.p95US, (unsigned) Exact(sorted, n, 62259));
+            Check(Near(stats.p50US, Exact(sorted, n, 32768)), "the estimated p50 of player %u", player);
+            Check(Near(stats.p95US, Exact(sorted, n, 62259)), "the estimated p95 of player %u", player);
+        }
+    }
+}
+
+// No press can come between the light-up and the arming of the edges, or its edge would be earlier than the light-up
+static void CheckLightUp()
+{
+    SetReactionPlayer(1);
+    DisarmPressEdges();
+    ReactionLightUp();
+    Check(lightUpFirst && armed && !interruptsOff, "the light-up timestamped before the edges are armed");
+}
+
+static void CheckOff()
+{
+    uint32_t us;
+
+    SetReactionPlayer(REACTION_OFF);
+    pressUS = 250000;
+    ReactionLightUp();
+    Check(!ReactionPoll() && !ReactionRoundTime(&us), "no measure with the mode off of player %u", REACTION_OFF);
+
+    SetReactionPlayer(REACTION_PLAYERS + 1);
+    Check(GetReactionPlayer() == REACTION_OFF, "a player out of range of player %u", REACTION_PLAYERS + 1);
+}
+
+int main()
+{
+    Stream_t stream;
+
+    for (stream = UNIFORM; stream < STREAMS; stream++)
+        CheckStream(stream);
+    CheckLightUp();
+    CheckOff();
+
+    return CheckReport();
+}
@@ -0,0 +1,406 @@
+//------------------------------------------
+// SCREENS TEST
+// This host program calls ScreensFSM of colorTest_main.c directly, once per tick of virtual time, without the
+// scheduler, the other tasks or the simulated peripherals, and plays rounds of scripted buttons and joystick
+// samples through it: the diagnostics with their scroll, the chart in both modes, the players of the reaction
+// time, and a test whose mix and guess change every round. It checks the screens it goes through, the lines of
+// the diagnostics, the settings and the results written to the flash log, then prints how many calls of
+// ScreensFSM a host second takes, and fails below SCREENS_MIN_RATE.
+// The drawing functions only count what they are asked to draw: the pixels of the screens are checked by the
+// expects of scripts/game.txt, in build/colortest.
+//
+// Measured with the default CFLAGS (-O2) on one core of an x86-64 Xeon: 52 to 87 M calls per second. The
+// simulator, which runs every task and every peripheral on each 10 ms tick, gets through about 0.06 M.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <LED_HAL.h>
+#include <Buttons_HAL.h>
+#include <Timer_HAL.h>
+#include <Display_HAL.h>
+#include <ADC_HAL.h>
+#include <Scheduler.h>
+#include "bsp/Profile.h"
+#include <Latency.h>
+#include <Trace.h>
+#include <Benchmark.h>
+#include <Render.h>
+#include <StripChart.h>
+#include <Tiles.h>
+#include <FlashLog.h>
+#include <Crypto_HAL.h>
+#include <Watchdog.h>
+#include <Clock_HAL.h>
+#include <RamUsage.h>
+#include <Buzzer_HAL.h>
+#include <Reaction.h>
+
+#define TEST_NAME "screenstest"
+#include "Check.h"
+
+// The guard against a slower ScreensFSM, in millions of calls per host second, well under the measurement above so
+// that a loaded machine passes
+#define SCREENS_MIN_RATE 5.0
+
+#define ROUNDS 20000
+
+// The states of ScreensFSM, in the order of its enum, which the trace of the transitions gives
+typedef enum {INCEPTION, OPENING, INSTRUCTIONS, TEST, TESTEND, DIAGNOSTICS, CHART} Screen_t;
+
+// The settings of colorTest_main.c in the flash log
+#define SETTING_CHART_MODE 0
+#define SETTING_REACTION_PLAYER 1
+
+// The functions of colorTest_main.c under test; its main() is TargetMain in the host build
+void ScreensFSM();
+
+
+//------------------------------------------
+// The inputs: the buttons, the joystick and the timer
+
+#define TOP     1
+#define BOTTOM  2
+#define LEFT    4
+#define RIGHT   8
+
+static unsigned pushed;             // the pushes not read yet, as the debouncer keeps them
+static unsigned mix;                // the bits of the joystick samples, red first
+static unsigned samples;
+static uint32_t nowMS;
+
+static bool Pushed(unsigned button)
+{
+    bool was = pushed & button;
+
+    pushed &= ~button;
+    return was;
+}
+
+bool Booster_Top_Button_Pushed() { return Pushed(TOP); }
+bool Booster_Bottom_Button_Pushed() { return Pushed(BOTTOM); }
+bool Launchpad_Left_Button_Pushed() { return Pushed(LEFT); }
+bool Launchpad_Right_Button_Pushed() { return Pushed(RIGHT); }
+
+// The button whose press woke the panel, until its push is taken, or BUTTONS
+static button_t wakeButton = BUTTONS;
+
+bool DisplayTakeWakePush(button_t button)
+{
+    if (button != wakeButton)
+        return false;
+    wakeButton = BUTTONS;
+    return true;
+}
+
+// testFSM takes one bit of the mix from each sample: the parity of x, y being even
+void getSampleJoyStick(unsigned *X, unsigned *Y)
+{
+    *X = (mix >> samples++) & 1;
+    *Y = 0;
+}
+
+// The wait of a software timer is in milliseconds of virtual time
+void InitOneShotSWTimer(OneShotSWTimer_t *OST, uint32_t hwtimer, uint32_t waitCycles)
+{
+    OST->hwtimer = hwtimer;
+    OST->waitCycles = waitCycles;
+}
+
+void StartOneShotSWTimer(OneShotSWTimer_t *OST)
+{
+    OST->startCounter = nowMS;
+}
+
+bool OneShotSWTimerExpired(OneShotSWTimer_t *OST)
+{
+    return nowMS - OST->startCounter >= OST->waitCycles;
+}
+
+//------------------------------------------
+// The outputs
+
+static struct {
+    Screen_t screen;                // the last one entered
+    unsigned transitions;
+    unsigned frames, displayOn, clears, consoleLines, tileFrames, chartStarts, chartStops, resultSounds;
+    uint32_t sleepTimeout;
+    unsigned results, won;
+    uint32_t lastDetail;
+    bool lastWon;
+} out;
+
+static uint32_t settings[2];
+static bool settingSaved[2];
+static unsigned player;
+
+void TraceRecord(TraceId_t id, uint32_t arg0, uint32_t arg1)
+{
+    if (id != TRACE_SCREEN)
+        return;
+    Check(arg0 == out.screen, "a transition from the screen shown");
+    out.screen = arg1;
+    out.transitions++;
+}
+
+void RenderFrame() { out.frames++; }
+void LCDDisplayOn() { out.displayOn++; }
+void LCDClearDisplay(int color) { out.clears++; }
+void ConsoleAppend(const char *str) { out.consoleLines++; }
+uint32_t TilesFrame() { out.tileFrames++; return 0; }
+void StripChartStart(StripChart_t *chart) { out.chartStarts++; }
+void StripChartStop(StripChart_t *chart) { out.chartStops++; }
+void SetDisplaySleepTimeout(uint32_t ms) { out.sleepTimeout = ms; }
+
+// The clicks of the guesses have the lowest priority
+bool PlaySound(const Sound_t *sound)
+{
+    out.resultSounds += (sound->priority > 0);
+    return true;
+}
+
+bool FlashLogResult(bool won, uint32_t detail)
+{
+    out.results++;
+    out.won += won;
+    out.lastWon = won;
+    out.lastDetail = detail;
+    return true;
+}
+
+uint32_t FlashLogRounds(uint32_t *won)
+{
+    *won = out.won;
+    return out.results;
+}
+
+bool FlashLogSetting(unsigned setting, uint32_t value)
+{
+    settings[setting] = value;
+    settingSaved[setting] = true;
+    return true;
+}
+
+bool FlashLogGetSetting(unsigned setting, uint32_t *value)
+{
+    *value = settings[setting];
+    return settingSaved[setting];
+}
+
+void SetReactionPlayer(unsigned newPlayer) { player = newPlayer; }
+unsigned GetReactionPlayer() { return player; }
+bool ReactionRoundTime(uint32_t *us) { return false; }
+
+// The diagnostics have 9 lines, 2 more than the screen shows
+uint32_t SchedulerDump(void (*emit)(char *line, uint32_t index))
+{
+    char line[] = "line";
+    uint32_t i;
+
+    for (i = 0; i < 9; i++)
+        emit(line, i);
+    return i;
+}
+
+// The rest of what ScreensFSM draws with, and what TargetMain and the other tasks of colorTest_main.c call
+void RenderClear(uint32_t color) {}
+bool RenderText(const char *text, int16_t x, int16_t y, uint32_t color) { return true; }
+bool RenderImage(const Image_t *image, int16_t x, int16_t y) { return true; }
+void DisplayScreenDrawn(unsigned firstRow, unsigned lastRow, bool fullColor) {}
+void PrintString(char *str, int row, int col) {}
+void LCDDrawChar(unsigned row, unsigned col, int8_t c) {}
+void ConsoleStart(unsigned firstRow, unsigned rows) {}
+void ConsoleStop() {}
+void TilesClear(uint32_t color) {}
+void TilesPrint(const char *text, unsigned row, unsigned column, uint32_t color, uint32_t background) {}
+void SpriteShow(unsigned n, const SpriteImage_t *image, uint32_t color, int16_t x, int16_t y) {}
+void SpriteMove(unsigned n, int16_t x, int16_t y) {}
+void StripChartAddSample(StripChart_t *chart, const int32_t *values) {}
+unsigned StripChartRender(StripChart_t *chart) { return 0; }
+void TurnON_Booster_Red_LED() {}
+void TurnON_Booster_Green_LED() {}
+void TurnON_Booster_Blue_LED() {}
+void TurnOFF_Booster_Red_LED() {}
+void TurnOFF_Booster_Green_LED() {}
+void TurnOFF_Booster_Blue_LED() {}
+void ReactionLightUp() {}
+bool ReactionPoll() { return false; }
+void LatencyMark(LatencyMark_t mark) {}
+void Profile_Record(ProfileZone_t zone, uint32_t cycles) {}
+
+uint32_t Profile_Dump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t LatencyDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t BenchmarkDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t DisplayPowerDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t TilesDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t FlashLogDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t CryptoDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t WatchdogDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t RamUsageDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t ClockDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t MotionDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t BuzzerDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+uint32_t ReactionDump(void (*emit)(char *line, uint32_t index)) { return 0; }
+
+int AddTask(TaskFunction_t function, uint32_t subscriptions) { return 0; }
+void RunScheduler() {}
+void InitScheduler() {}
+void InitTickTimer() {}
+void InitHWTimers() {}
+void InitButtons() {}
+void InitLEDs() {}
+void InitBuzzer() {}
+void InitClock() {}
+void InitTrace() {}
+void InitCrypto() {}
+void InitFlashLog() {}
+void InitRender() {}
+void InitTiles() {}
+void InitWatchdog() {}
+void StartWatchdog() {}
+void SuperviseTask(int taskId, const char *name, uint32_t budgetUS) {}
+void StartGraphics() {}
+bool GraphicsReady() { return true; }
+void RunBenchmark() {}
+bool CryptoSelfTest() { return true; }
+void initADC() {}
+void initJoyStick() {}
+void initAccelerometer() {}
+void startADC() {}
+void calibrateMotion() {}
+void MotionTask(const Event_t *event) {}
+void ClockGovernorTask(const Event_t *event) {}
+void ClockKeepFast() {}
+void DisplayPowerTask(const Event_t *event) {}
+void TraceFlush() {}
+void Profile_Init() {}
+void BSP_Clock_InitFastest(void) {}
+void WDT_A_holdTimer(void) {}
+void Interrupt_enableMaster(void) {}
+volatile uint32_t SimDEMCR, SimDWTCTRL, SimDWTCYCCNT;
+
+//------------------------------------------
+// The script
+
+static unsigned long calls;
+
+// A call of ScreensFSM on a tick, with the buttons pushed since the last one
+static void Tick(unsigned buttons)
+{
+    pushed |= buttons;
+    ScreensFSM();
+    nowMS += TICK_PERIOD_MS;
+    calls++;
+}
+
+static void Wait(unsigned ticks)
+{
+    while (ticks--)
+        Tick(0);
+}
+
+// The opening screen is shown for a second, and drawn before the display is on
+static void CheckOpening()
+{
+    Tick(0);
+    Check(out.screen == OPENING && out.frames == 1 && out.displayOn == 1, "the opening screen");
+    Wait(1000 / TICK_PERIOD_MS - 1);
+    Check(out.screen == OPENING, "the opening screen for a second");
+    Tick(0);
+    Check(out.screen == INSTRUCTIONS && out.clears == 1, "the instructions after the opening screen");
+}
+
+// The push of the press that woke the panel does not leave the instructions, the next one does
+static void CheckWakePush()
+{
+    unsigned transitions = out.transitions;
+
+    wakeButton = BOOSTER_TOP;
+    Tick(TOP);
+    Check(out.screen == INSTRUCTIONS && out.transitions == transitions && wakeButton == BUTTONS,
+          "the push of the wake dropped");
+    Tick(TOP);
+    Check(out.screen == DIAGNOSTICS, "the diagnostics on the next push");
+    Tick(BOTTOM);
+    Check(out.screen == INSTRUCTIONS, "the instructions after the diagnostics");
+}
+
+// Round n starts and ends on the instructions. Its mix is n % 8, and every third round is lost, with red guessed
+// wrong.
+static void Round(unsigned n)
+{
+    unsigned actual = n % 8;
+    unsigned guessed = (n % 3 == 0) ? actual ^ 1 : actual;
+    unsigned transitions = out.transitions;
+    unsigned consoleLines = out.consoleLines;
+    uint32_t chartMode = settings[SETTING_CHART_MODE];
+    unsigned c;
+
+    // The diagnostics: the first 7 lines, the other 2 one by one, then the first ones again
+    Tick(TOP);
+    Tick(TOP);
+    Tick(TOP);
+    Check(out.screen == DIAGNOSTICS && out.consoleLines == consoleLines + 9, "the lines of the diagnostics");
+    Tick(TOP);
+    Check(out.consoleLines == consoleLines + 16, "the diagnostics from their first line again");
+    Tick(BOTTOM);
+
+    // The chart, from the mode it was last left in to the other one
+    Tick(LEFT);
+    Wait(5);
+    Tick(TOP);
+    Check(out.screen == CHART && settings[SETTING_CHART_MODE] == !chartMode && out.sleepTimeout == 0,
+          "the chart in the other mode, with the panel awake");
+    Wait(5);
+    Tick(BOTTOM);
+    Check(out.chartStarts == out.chartStops && out.sleepTimeout == DISPLAY_SLEEP_MS, "the chart stopped");
+
+    // The next player of the reaction time, or off after the last one
+    Tick(RIGHT);
+    Check(player == n % (REACTION_PLAYERS + 1) && settings[SETTING_REACTION_PLAYER] == player,
+          "the player of the reaction time, saved");
+
+    // The test: one sample for each color, and one more before the LEDs light up
+    mix = actual;
+    samples = 0;
+    Tick(BOTTOM);
+    Wait(5);
+    for (c = 0; c < 3; c++)
+    {
+        if (guessed & (1 << c))
+            Tick(TOP);
+        Tick(BOTTOM);
+    }
+    Tick(TOP);
+    Check(out.screen == TESTEND && out.results == n && out.lastWon == (actual == guessed) &&
+          out.lastDetail == (actual | guessed << 3), "the result of the round, logged");
+    Check(out.resultSounds == n && out.tileFrames == n, "the sound and the tiles of the end screen");
+
+    Wait(1000 / TICK_PERIOD_MS);
+    Check(out.screen == INSTRUCTIONS && out.transitions == transitions + 7, "the screens of a round");
+}
+
+int main()
+{
+    struct timespec start, end;
+    double seconds, rate;
+    unsigned n;
+
+    CheckOpening();
+    CheckWakePush();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    calls = 0;
+    for (n = 1; n <= ROUNDS; n++)
+        Round(n);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    rate = seconds > 0 ? calls / seconds / 1e6 : 0;
+    Check(out.won == ROUNDS - ROUNDS / 3, "the rounds won");
+    Check(rate >= SCREENS_MIN_RATE, "the rate of ScreensFSM");
+
+    printf("screenstest: %u checks, %s, ScreensFSM %lu calls, %.1f M calls per host second\n", checks,
+           failures ? "FAILED" : "passed", calls, rate);
+    return failures ? 1 : 0;
+}
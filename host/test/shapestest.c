@@ -0,0 +1,334 @@
+//------------------------------------------
+// SHAPES TEST
+// This host program draws the shape primitives of the LCD driver into the LCD model (test/LcdModel.c, built with
+// LCD_MODEL_DRIVER) and compares every pixel of the screen with a reference drawn one pixel at a time:
+//   Crystalfontz128x128_DrawLine       Graphics_drawLine of the host grlib, through the PixelDraw of the driver
+//   Crystalfontz128x128_DrawCircle     Graphics_drawCircle, the same way
+//   Crystalfontz128x128_FillCircle     the rows between the pixels of that outline, as grlib fills a circle
+//   Crystalfontz128x128_FillTriangle   the pixels of each row between the edges of the triangle, give or take the
+//                                      half pixel of the rounding
+// The shapes go in every direction, steep and flat, and include points, lines of one direction only, collinear
+// corners and shapes partly or fully off the screen, which the spans clip. The bytes each shape sends are checked
+// against the per-pixel path too.
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+#include "LcdModel.h"
+
+#define TEST_NAME "shapestest"
+#include "Check.h"
+
+#define BLACK   0x000000
+#define ORANGE  0xFF8000
+
+#define SIZE    LCD_MODEL_SIZE
+
+// The bring-up of the driver, which the test does not run
+void GPIO_setOutputHighOnPin(uint_fast8_t port, uint_fast16_t pins) {}
+void GPIO_setOutputLowOnPin(uint_fast8_t port, uint_fast16_t pins) {}
+void HAL_LCD_PortInit(void) {}
+void HAL_LCD_SpiInit(void) {}
+void HAL_LCD_startWait(uint32_t microseconds) {}
+bool HAL_LCD_waitDone(void) { return true; }
+
+static Graphics_Context context;
+
+// The pixels of the reference, and the bytes each path sent
+static bool reference[SIZE][SIZE];
+static uint32_t spanBytes, pixelBytes;
+
+static void Clear()
+{
+    memset(reference, 0, sizeof(reference));
+    LcdModelReset(LcdModelColor(BLACK));
+}
+
+static void Mark(int x, int y)
+{
+    if (x >= 0 && x < SIZE && y >= 0 && y < SIZE)
+        reference[y][x] = true;
+}
+
+// What grlib drew into the model becomes the reference, and the model is cleared for the driver
+static void TakeReference()
+{
+    int x, y;
+
+    for (y = 0; y < SIZE; y++)
+        for (x = 0; x < SIZE; x++)
+            if (LcdModelPixel(x, y) == LcdModelColor(ORANGE))
+                reference[y][x] = true;
+    LcdModelReset(LcdModelColor(BLACK));
+}
+
+// This function returns the number of pixels that differ from the reference. The first one is printed.
+static unsigned Differences(const char *shape)
+{
+    unsigned differences = 0;
+    int x, y;
+
+    for (y = 0; y < SIZE; y++)
+        for (x = 0; x < SIZE; x++)
+            if ((LcdModelPixel(x, y) == LcdModelColor(ORANGE)) != reference[y][x] && differences++ == 0)
+                printf("%s: pixel %d, %d is %s\n", TEST_NAME, x, y, reference[y][x] ? "missing" : "extra");
+    if (differences)
+        printf("%s: %u pixels differ in %s\n", TEST_NAME, differences, shape);
+    return differences;
+}
+
+//------------------------------------------
+// Lines
+
+static unsigned Line(int x1, int y1, int x2, int y2)
+{
+    char shape[64];
+    uint32_t bytes;
+
+    Clear();
+    bytes = HAL_LCD_byteCount;
+    Graphics_drawLine(&context, x1, y1, x2, y2);
+    pixelBytes += HAL_LCD_byteCount - bytes;
+    TakeReference();
+
+    bytes = HAL_LCD_byteCount;
+    Crystalfontz128x128_DrawLine(x1, y1, x2, y2, LcdModelColor(ORANGE));
+    spanBytes += HAL_LCD_byteCount - bytes;
+
+    snprintf(shape, sizeof(shape), "the line %d, %d to %d, %d", x1, y1, x2, y2);
+    return Differences(shape);
+}
+
+static void CheckLines()
+{
+    unsigned failed = 0;
+    int angle;
+
+    // Every direction from the center, in both orders of the ends, at 2 degrees apart
+    for (angle = 0; angle < 360; angle += 2)
+    {
+        int x = 64 + (int) lround(60 * cos(angle * M_PI / 180));
+        int y = 64 + (int) lround(60 * sin(angle * M_PI / 180));
+
+        failed += (Line(64, 64, x, y) != 0);
+        failed += (Line(x, y, 64, 64) != 0);
+    }
+    Check(failed == 0, "the lines in every direction");
+    Check(spanBytes < pixelBytes, "the lines in %u bytes, %u one pixel at a time", spanBytes, pixelBytes);
+
+    Check(Line(10, 20, 10, 20) == 0, "a line of one pixel");
+    Check(Line(5, 7, 120, 7) == 0 && Line(120, 9, 5, 9) == 0, "horizontal lines");
+    Check(Line(7, 5, 7, 120) == 0 && Line(9, 120, 9, 5) == 0, "vertical lines");
+    Check(Line(0, 0, 127, 127) == 0 && Line(127, 0, 0, 127) == 0, "the diagonals");
+    Check(Line(3, 0, 4, 127) == 0 && Line(0, 3, 127, 4) == 0, "lines of two runs");
+
+    Check(Line(-40, 10, 140, 90) == 0 && Line(20, -30, 100, 160) == 0, "lines across the screen");
+    Check(Line(-50, -20, 30, 60) == 0 && Line(120, 100, 200, 130) == 0, "lines from off the screen");
+    Check(Line(-30, -5, -2, -60) == 0 && Line(130, 10, 180, 120) == 0 && Line(-10, 128, 140, 128) == 0,
+          "lines off the screen");
+}
+
+//------------------------------------------
+// Circles
+
+static unsigned Circle(int x, int y, int radius)
+{
+    char shape[64];
+    uint32_t bytes;
+
+    Clear();
+    bytes = HAL_LCD_byteCount;
+    Graphics_drawCircle(&context, x, y, radius);
+    pixelBytes += HAL_LCD_byteCount - bytes;
+    TakeReference();
+
+    bytes = HAL_LCD_byteCount;
+    Crystalfontz128x128_DrawCircle(x, y, radius, LcdModelColor(ORANGE));
+    spanBytes += HAL_LCD_byteCount - bytes;
+
+    snprintf(shape, sizeof(shape), "the circle at %d, %d of radius %d", x, y, radius);
+    return Differences(shape);
+}
+
+// The rows of the outline of Graphics_drawCircle, from its left pixel to its right one
+static unsigned FilledCircle(int x, int y, int radius)
+{
+    int left[2 * SIZE + 1], right[2 * SIZE + 1];
+    int a = 0, b = radius, d = 3 - 2 * radius;
+    int row, column;
+    char shape[64];
+
+    for (row = 0; row <= 2 * radius; row++)
+    {
+        left[row] = radius + 1;
+        right[row] = -radius - 1;
+    }
+    while (a <= b)
+    {
+        const int points[8][2] = {{a, -b}, {-a, -b}, {a, b}, {-a, b}, {b, -a}, {-b, -a}, {b, a}, {-b, a}};
+        int p;
+
+        for (p = 0; p < 8; p++)
+        {
+            row = radius + points[p][1];
+            if (points[p][0] < left[row])
+                left[row] = points[p][0];
+            if (points[p][0] > right[row])
+                right[row] = points[p][0];
+        }
+        if (d < 0)
+            d += 4 * a + 6;
+        else
+        {
+            d += 4 * (a - b) + 10;
+            b--;
+        }
+        a++;
+    }
+
+    Clear();
+    for (row = 0; row <= 2 * radius; row++)
+        for (column = left[row]; column <= right[row]; column++)
+            Mark(x + column, y - radius + row);
+    Crystalfontz128x128_FillCircle(x, y, radius, LcdModelColor(ORANGE));
+
+    snprintf(shape, sizeof(shape), "the filled circle at %d, %d of radius %d", x, y, radius);
+    return Differences(shape);
+}
+
+static void CheckCircles()
+{
+    unsigned failed = 0, filledFailed = 0;
+    int radius;
+
+    spanBytes = pixelBytes = 0;
+    for (radius = 0; radius <= 63; radius++)
+    {
+        failed += (Circle(64, 64, radius) != 0);
+        filledFailed += (FilledCircle(64, 64, radius) != 0);
+    }
+    Check(failed == 0, "the circles of radius 0 to 63");
+    Check(spanBytes < pixelBytes, "the circles in %u bytes, %u one pixel at a time", spanBytes, pixelBytes);
+    Check(filledFailed == 0, "the filled circles of radius 0 to 63");
+
+    Check(Circle(0, 0, 40) == 0 && Circle(127, 127, 40) == 0 && Circle(-10, 64, 30) == 0 &&
+          Circle(64, 140, 20) == 0 && Circle(64, 64, 100) == 0, "circles partly off the screen");
+    Check(Circle(-50, -50, 20) == 0 && Circle(200, 64, 30) == 0, "circles off the screen");
+    Check(FilledCircle(0, 0, 40) == 0 && FilledCircle(127, 127, 40) == 0 && FilledCircle(-10, 64, 30) == 0 &&
+          FilledCircle(64, 140, 20) == 0 && FilledCircle(64, 64, 100) == 0, "filled circles partly off the screen");
+    Check(FilledCircle(-50, -50, 20) == 0 && FilledCircle(200, 64, 30) == 0, "filled circles off the screen");
+}
+
+//------------------------------------------
+// Triangles
+
+// This function returns where the row y crosses the triangle, at most left to right, or false if it does not
+static bool Crossing(const int corners[3][2], double y, double *left, double *right)
+{
+    bool crossed = false;
+    int e;
+
+    for (e = 0; e < 3; e++)
+    {
+        const int *p = corners[e], *q = corners[(e + 1) % 3];
+        double low = fmin(p[1], q[1]), high = fmax(p[1], q[1]);
+        double from, to;
+
+        if (y < low || y > high)
+            continue;
+        if (p[1] == q[1])
+        {
+            from = fmin(p[0], q[0]);
+            to = fmax(p[0], q[0]);
+        }
+        else
+            from = to = p[0] + (double) (q[0] - p[0]) * (y - p[1]) / (q[1] - p[1]);
+
+        if (!crossed || from < *left)
+            *left = from;
+        if (!crossed || to > *right)
+            *right = to;
+        crossed = true;
+    }
+    return crossed;
+}
+
+// A pixel between the edges must be drawn, and one more than half a pixel out of them must not: the pixels within
+// half a pixel out depend on the rounding
+static unsigned Triangle(int x1, int y1, int x2, int y2, int x3, int y3)
+{
+    const int corners[3][2] = {{x1, y1}, {x2, y2}, {x3, y3}};
+    unsigned differences = 0;
+    int x, y;
+
+    LcdModelReset(LcdModelColor(BLACK));
+    Crystalfontz128x128_FillTriangle(x1, y1, x2, y2, x3, y3, LcdModelColor(ORANGE));
+
+    for (y = 0; y < SIZE; y++)
+    {
+        double left = 0, right = -1;
+        bool crossed = Crossing(corners, y, &left, &right);
+
+        for (x = 0; x < SIZE; x++)
+        {
+            bool drawn = (LcdModelPixel(x, y) == LcdModelColor(ORANGE));
+            bool inside = crossed && x >= left && x <= right;
+            bool near = crossed && x >= left - 0.5 && x <= right + 0.5;
+
+            if ((inside && !drawn) || (drawn && !near))
+            {
+                if (differences++ == 0)
+                    printf("%s: pixel %d, %d of the triangle %d, %d, %d, %d, %d, %d is %s\n", TEST_NAME, x, y,
+                           x1, y1, x2, y2, x3, y3, drawn ? "extra" : "missing");
+            }
+        }
+    }
+    return differences;
+}
+
+static void CheckTriangles()
+{
+    unsigned failed = 0;
+    int turn;
+
+    // Corners around the center, turning, so that every order and every direction of the edges is drawn
+    for (turn = 0; turn < 360; turn += 5)
+    {
+        double a = turn * M_PI / 180;
+        int x1 = 64 + (int) lround(60 * cos(a)), y1 = 64 + (int) lround(60 * sin(a));
+        int x2 = 64 + (int) lround(45 * cos(a + 2.1)), y2 = 64 + (int) lround(45 * sin(a + 2.1));
+        int x3 = 64 + (int) lround(20 * cos(a + 4.0)), y3 = 64 + (int) lround(20 * sin(a + 4.0));
+
+        failed += (Triangle(x1, y1, x2, y2, x3, y3) != 0);
+        failed += (Triangle(x3, y3, x2, y2, x1, y1) != 0);
+    }
+    Check(failed == 0, "the triangles in every direction");
+
+    Check(Triangle(10, 10, 100, 20, 40, 120) == 0 && Triangle(3, 100, 125, 101, 64, 2) == 0, "large triangles");
+    Check(Triangle(10, 10, 90, 10, 50, 70) == 0 && Triangle(50, 10, 10, 70, 90, 70) == 0,
+          "triangles with a flat top or bottom");
+    Check(Triangle(30, 30, 30, 30, 30, 30) == 0, "a triangle of one pixel");
+    Check(Triangle(10, 40, 60, 40, 110, 40) == 0 && Triangle(20, 10, 20, 100, 20, 50) == 0,
+          "flat and upright triangles");
+    Check(Triangle(0, 0, 50, 100, 100, 200) == 0 && Triangle(10, 5, 60, 15, 110, 25) == 0, "collinear corners");
+    Check(Triangle(-40, 20, 80, -30, 150, 140) == 0 && Triangle(-100, -100, 300, 64, -100, 200) == 0,
+          "triangles partly off the screen");
+    Check(Triangle(-40, -20, -1, -80, -10, -2) == 0 && Triangle(130, 0, 200, 50, 140, 127) == 0,
+          "triangles off the screen");
+}
+
+int main()
+{
+    Graphics_initContext(&context, &g_sCrystalfontz128x128, &g_sCrystalfontz128x128_funcs);
+    Graphics_setForegroundColor(&context, ORANGE);
+
+    CheckLines();
+    CheckCircles();
+    CheckTriangles();
+
+    return CheckReport();
+}
@@ -0,0 +1,212 @@
+//------------------------------------------
+// STRIP CHART TEST
+// This host program draws strip charts into the LCD model (test/LcdModel.c) and checks the pixels: the slice of each
+// sample, with its traces where their values are and connected to the last slice, in both modes, the columns of
+// the sweep wrapping at the right edge, the scroll of the rows, the samples dropped while the ring is full, and the
+// settings that StripChartStart fits to the screen.
+
+#include <stdio.h>
+#include <string.h>
+#include <StripChart.h>
+#include "LcdModel.h"
+
+#define TEST_NAME "stripcharttest"
+#include "Check.h"
+
+#define BLACK   0x000000
+#define RED     0xFF0000
+#define CYAN    0x00FFFF
+#define SCREEN  0x0000FF        // around the chart
+
+
+static StripChart_t chart;
+
+static void Add(int32_t first, int32_t second)
+{
+    const int32_t values[2] = {first, second};
+
+    StripChartAddSample(&chart, values);
+}
+
+// This function returns true if the pixels from..to of a column (x, from y) or a row (y, from x) are all color,
+// from and to in either order
+static bool Run(bool column, unsigned at, int from, int to, uint32_t color)
+{
+    int i, step = (from <= to) ? 1 : -1;
+
+    for (i = from; i != to + step; i += step)
+        if ((column ? LcdModelPixel(at, i) : LcdModelPixel(i, at)) != LcdModelColor(color))
+            return false;
+    return true;
+}
+
+// The column of a sample in sweep mode: each trace is drawn from its last value to its value, the second one over
+// the first, on the background
+static bool InRun(int value, int32_t from, int32_t to)
+{
+    return (from <= to) ? (value >= from && value <= to) : (value >= to && value <= from);
+}
+
+static bool Column(unsigned x, int32_t first, int32_t lastFirst, int32_t second, int32_t lastSecond)
+{
+    int bottom = chart.y + chart.height - 1;
+    int y;
+
+    for (y = chart.y; y <= bottom; y++)
+    {
+        uint32_t color = BLACK;
+
+        if (InRun(bottom - y, lastFirst, first))
+            color = RED;
+        if (InRun(bottom - y, lastSecond, second))
+            color = CYAN;
+        if (LcdModelPixel(x, y) != LcdModelColor(color))
+            return false;
+    }
+    return true;
+}
+
+static void Setup(StripChartMode_t mode, int16_t y, int16_t width, int16_t height)
+{
+    memset(&chart, 0, sizeof(chart));
+    chart.x = 0;
+    chart.y = y;
+    chart.width = width;
+    chart.height = height;
+    chart.mode = mode;
+    chart.min = 0;
+    chart.max = (mode == STRIP_CHART_SWEEP) ? height - 1 : width - 1;
+    chart.background = BLACK;
+    chart.colors[0] = RED;
+    chart.colors[1] = CYAN;
+    chart.traces = 2;
+
+    LcdModelReset(LcdModelColor(SCREEN));
+    StripChartStart(&chart);
+}
+
+static void CheckSweep()
+{
+    uint32_t windows, bytes;
+    unsigned n, x;
+
+    Setup(STRIP_CHART_SWEEP, 32, 100, 64);
+    Check(Run(false, 32, 0, 99, BLACK) && Run(false, 95, 0, 99, BLACK), "the area cleared by StripChartStart");
+    Check(Run(false, 31, 0, 127, SCREEN) && Run(false, 96, 0, 127, SCREEN) && Run(true, 100, 32, 95, SCREEN),
+          "the screen around the chart");
+    Check(StripChartRender(&chart) == 0, "a render without samples");
+
+    windows = LcdModel.windows;
+    bytes = LcdModel.bytes;
+    Add(10, 50);
+    Check(StripChartRender(&chart) == 1, "the render of one sample");
+    Check(LcdModel.windows == windows + 1 && LcdModel.bytes == bytes + 2 * 64, "one window of 64 pixels a slice");
+    Check(Column(0, 10, 10, 50, 50), "the first column");
+
+    Add(14, 50);
+    Add(11, 49);
+    Check(StripChartRender(&chart) == 2, "the render of two samples");
+    Check(Column(1, 14, 10, 50, 50) && Column(2, 11, 14, 49, 50), "the traces joined to their last slice");
+
+    // Values beyond the edges stay on them
+    Add(-5, 1000);
+    StripChartRender(&chart);
+    Check(Column(3, 0, 11, 63, 49), "values beyond min and max");
+
+    // After the right edge, the columns start over from the left one
+    for (n = 4; n < 102; n++)
+    {
+        Add(n % 64, 63 - n % 64);
+        if (n % 32 == 0)
+            StripChartRender(&chart);
+    }
+    StripChartRender(&chart);
+    Check(Column(0, 36, 35, 27, 28) && Column(1, 37, 36, 26, 27), "the columns after the right edge");
+    Check(Column(2, 11, 14, 49, 50), "the column not drawn over yet");
+    Check(chart.slice == 2 && chart.drawn == 102 && chart.dropped == 0, "the state after the right edge");
+
+    // The ring holds STRIP_CHART_SAMPLES samples until they are drawn
+    for (n = 0; n < STRIP_CHART_SAMPLES + 3; n++)
+        Add(20, 20);
+    Check(chart.dropped == 3, "the samples dropped while the ring is full");
+    Check(StripChartRender(&chart) == STRIP_CHART_SAMPLES, "the render of a full ring");
+    for (x = 3; x < 2 + STRIP_CHART_SAMPLES; x++)
+        if (!Column(x, 20, 20, 20, 20))
+            break;
+    Check(x == 2 + STRIP_CHART_SAMPLES, "the columns of a full ring");
+
+    StripChartStop(&chart);
+    Check(!LcdModel.scrolling, "no scroll in sweep mode");
+}
+
+static void CheckScroll()
+{
+    unsigned n;
+
+    Setup(STRIP_CHART_SCROLL, 16, 128, 96);
+    Check(LcdModel.scrolling && LcdModel.scrollTop == 16 && LcdModel.scrollLines == 96,
+          "the scroll area of StripChartStart");
+
+    Add(3, 127);
+    Add(7, 120);
+    Check(StripChartRender(&chart) == 2, "the render of two rows");
+    Check(Run(false, 16, 0, 2, BLACK) && Run(false, 16, 3, 3, RED) && Run(false, 16, 4, 126, BLACK) &&
+          Run(false, 16, 127, 127, CYAN), "the first row");
+    Check(Run(false, 17, 0, 2, BLACK) && Run(false, 17, 3, 7, RED) && Run(false, 17, 8, 119, BLACK) &&
+          Run(false, 17, 120, 127, CYAN), "the second row, joined to the first");
+    Check(LcdModel.scrollStart == 18, "the scroll after two rows: the oldest row at the top");
+
+    // The rows wrap around at the bottom of the area, and the oldest row is always shown at the top
+    for (n = 2; n < 96 + 5; n++)
+    {
+        Add(n, 100);
+        if (n % 16 == 0)
+            StripChartRender(&chart);
+    }
+    StripChartRender(&chart);
+    Check(LcdModel.scrollStart == 16 + 5, "the scroll after the bottom of the area");
+    Check(Run(false, 16 + 4, 99, 99, RED) && Run(false, 16 + 4, 100, 100, CYAN), "the row after the bottom");
+    Check(Run(false, 16 + 5, 5, 5, RED) && Run(false, 16 + 5, 100, 100, CYAN), "the oldest row");
+
+    StripChartStop(&chart);
+    Check(!LcdModel.scrolling, "StripChartStop ends the scroll");
+}
+
+// A chart beyond the screen is cut at its edges, and a chart in scroll mode takes the full width
+static void CheckFit()
+{
+    uint32_t bytes;
+
+    Setup(STRIP_CHART_SWEEP, 16, 300, 200);
+    Check(chart.x == 0 && chart.y == 16 && chart.width == 128 && chart.height == 112, "a sweep cut at the edges");
+    bytes = LcdModel.bytes;
+    Add(1000, -5);
+    Check(StripChartRender(&chart) == 1 && LcdModel.bytes == bytes + 2 * 112, "a column of the cut sweep");
+    Check(Column(0, 111, 111, 0, 0), "the column at the edges of the cut sweep");
+
+    memset(&chart, 0, sizeof(chart));
+    chart.x = 8;
+    chart.y = -4;
+    chart.width = 64;
+    chart.height = 200;
+    chart.mode = STRIP_CHART_SCROLL;
+    chart.max = 127;
+    chart.colors[0] = RED;
+    chart.traces = STRIP_CHART_MAX_TRACES + 2;
+    LcdModelReset(LcdModelColor(SCREEN));
+    StripChartStart(&chart);
+    Check(chart.x == 0 && chart.y == 0 && chart.width == 128 && chart.height == 128 &&
+          chart.traces == STRIP_CHART_MAX_TRACES, "a scroll over the full width and height");
+    Check(LcdModel.scrolling && LcdModel.scrollTop == 0 && LcdModel.scrollLines == 128, "the scroll area of the fit");
+    Check(Run(false, 0, 0, 127, BLACK) && Run(false, 127, 0, 127, BLACK), "the area of the fit cleared");
+    StripChartStop(&chart);
+}
+
+int main()
+{
+    CheckSweep();
+    CheckScroll();
+    CheckFit();
+
+    return CheckReport();
+}
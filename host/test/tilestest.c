@@ -0,0 +1,295 @@
+//------------------------------------------
+// TILES TEST
+// This host program draws tilemaps and sprites into the LCD model (test/LcdModel.c) and checks the whole screen
+// after every frame against a reference drawn without the tile engine: the text through grlib straight into the
+// pixels, and the sprites over it. It also checks the cells each frame sends, as address windows and bytes, and
+// the frame counters of TilesDump.
+
+#include <stdio.h>
+#include <string.h>
+#include <ti/grlib/grlib.h>
+#include <Timer_HAL.h>
+#include <Tiles.h>
+#include "LcdModel.h"
+
+#define TEST_NAME "tilestest"
+#include "Check.h"
+
+#define BLUE    0x0000FF
+#define WHITE   0xFFFFFF
+#define RED     0xFF0000
+#define GREEN   0x00FF00
+#define YELLOW  0xFFFF00
+
+#define CELL_BYTES (8 * 16 * 2)
+
+
+//------------------------------------------
+// The timer: every read is 100 cycles, or microseconds, after the last one
+
+static uint32_t now = 0x80000000u;
+
+uint32_t GetTimerValue(uint32_t hwtimer)
+{
+    now -= 100;
+    return now;
+}
+
+uint32_t CyclesToMicroseconds(uint32_t cycles)
+{
+    return cycles;
+}
+
+//------------------------------------------
+// The reference screen: the tiles drawn by grlib, and the sprites over them
+
+static uint16_t referenceTiles[LCD_MODEL_SIZE][LCD_MODEL_SIZE];
+
+static struct {
+    const SpriteImage_t *image;     // NULL when hidden
+    uint32_t             color;
+    int                  x, y;
+} referenceSprites[TILES_MAX_SPRITES];
+
+static void ReferenceLineDrawH(const Graphics_Display *display, int16_t x1, int16_t x2, int16_t y, uint16_t value)
+{
+    for (; x1 <= x2; x1++)
+        referenceTiles[y][x1] = value;
+}
+
+static uint32_t ReferenceColorTranslate(const Graphics_Display *display, uint32_t color)
+{
+    return LcdModelColor(color);
+}
+
+static const Graphics_Display_Functions referenceFunctions = {
+    .pfnLineDrawH = ReferenceLineDrawH,
+    .pfnColorTranslate = ReferenceColorTranslate
+};
+
+static Graphics_Display referenceDisplay = {sizeof(Graphics_Display), NULL, LCD_MODEL_SIZE, LCD_MODEL_SIZE};
+static Graphics_Context referenceContext;
+
+// This function returns the pixel at (x, y) of the reference screen
+static uint16_t Reference(int x, int y)
+{
+    uint16_t value = referenceTiles[y][x];
+    unsigned n;
+
+    for (n = 0; n < TILES_MAX_SPRITES; n++)
+    {
+        const SpriteImage_t *image = referenceSprites[n].image;
+        int row = y - referenceSprites[n].y, column = x - referenceSprites[n].x;
+
+        if (image && row >= 0 && row < image->height && column >= 0 && column < 16 &&
+            (image->rows[row] & (0x8000 >> column)))
+            value = LcdModelColor(referenceSprites[n].color);
+    }
+    return value;
+}
+
+// This function returns true if the model shows the reference screen
+static bool Screen()
+{
+    unsigned x, y;
+
+    for (y = 0; y < LCD_MODEL_SIZE; y++)
+        for (x = 0; x < LCD_MODEL_SIZE; x++)
+            if (LcdModelPixel(x, y) != Reference(x, y))
+            {
+                fprintf(stderr, "tilestest: pixel (%u, %u) is %04X, not %04X\n", x, y, LcdModelPixel(x, y),
+                        Reference(x, y));
+                return false;
+            }
+    return true;
+}
+
+//------------------------------------------
+// The tiles and the sprites, drawn both by Tiles.c and on the reference screen
+
+static void Clear(uint32_t color)
+{
+    unsigned x, y;
+
+    TilesClear(color);
+    for (y = 0; y < LCD_MODEL_SIZE; y++)
+        for (x = 0; x < LCD_MODEL_SIZE; x++)
+            referenceTiles[y][x] = LcdModelColor(color);
+    memset(referenceSprites, 0, sizeof(referenceSprites));
+}
+
+// Each character on its cell, clipped to it, its background first as the glyph may not cover the whole cell
+static void Print(const char *text, unsigned row, unsigned column, uint32_t color, uint32_t background)
+{
+    TilesPrint(text, row, column, color, background);
+
+    Graphics_setForegroundColor(&referenceContext, color);
+    Graphics_setBackgroundColor(&referenceContext, background);
+    for (; *text != '\0'; text++)
+    {
+        Graphics_Rectangle cell = {column * 8, row * 16, column * 8 + 7, row * 16 + 15};
+        unsigned x, y;
+
+        for (y = row * 16; y < row * 16 + 16; y++)
+            for (x = column * 8; x < column * 8 + 8; x++)
+                referenceTiles[y][x] = LcdModelColor(background);
+        Graphics_setClipRegion(&referenceContext, &cell);
+        Graphics_drawString(&referenceContext, (int8_t *) text, 1, column * 8, row * 16, OPAQUE_TEXT);
+
+        if (++column == 16)
+        {
+            column = 0;
+            row = (row + 1) % 8;
+        }
+    }
+}
+
+static void Show(unsigned n, const SpriteImage_t *image, uint32_t color, int16_t x, int16_t y)
+{
+    SpriteShow(n, image, color, x, y);
+    referenceSprites[n].image = image;
+    referenceSprites[n].color = color;
+    referenceSprites[n].x = x;
+    referenceSprites[n].y = y;
+}
+
+static void Move(unsigned n, int16_t x, int16_t y)
+{
+    SpriteMove(n, x, y);
+    referenceSprites[n].x = x;
+    referenceSprites[n].y = y;
+}
+
+static void Hide(unsigned n)
+{
+    SpriteHide(n);
+    referenceSprites[n].image = NULL;
+}
+
+// This function sends a frame and returns true if it took windows address windows and cells cells
+static bool Frame(uint32_t windows, uint32_t cells)
+{
+    uint32_t bytes;
+
+    LcdModel.windows = 0;
+    LcdModel.bytes = 0;
+    bytes = TilesFrame();
+    return bytes == cells * CELL_BYTES && LcdModel.bytes == bytes && LcdModel.windows == windows;
+}
+
+// The frame counters, from their dump
+static struct {
+    unsigned frames, lastBytes, maxBytes, lastUS, maxUS;
+} counters;
+
+static void Emit(char *line, uint32_t index)
+{
+    switch (index)
+    {
+    case 0: sscanf(line, "Frames %u", &counters.frames); break;
+    case 1: sscanf(line, " B %u <%u", &counters.lastBytes, &counters.maxBytes); break;
+    case 2: sscanf(line, " us %u <%u", &counters.lastUS, &counters.maxUS); break;
+    }
+}
+
+//------------------------------------------
+// Cases
+
+// A 16 x 16 ring, and a 4 x 3 arrow
+static const uint16_t ringRows[16] = {
+    0xFFFF, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+    0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0xFFFF
+};
+static const SpriteImage_t ring = {16, 16, ringRows};
+
+static const uint16_t arrowRows[3] = {0x4000, 0xE000, 0xF000};
+static const SpriteImage_t arrow = {4, 3, arrowRows};
+
+static void CheckText()
+{
+    InitTiles();
+    LcdModelReset(0);
+    Check(TilesDump(Emit) == 0, "no counters before the first frame");
+
+    Clear(BLUE);
+    Check(Frame(8, 16 * 8), "a cleared screen: a window for each row of cells");
+    Check(Screen(), "the cleared screen");
+    Check(Frame(0, 0), "a frame without changes");
+
+    Print("Hi", 2, 3, WHITE, RED);
+    Check(Frame(1, 2), "the cells printed on: one run");
+    Check(Screen(), "the printed text");
+
+    // The text wraps to the first column of the next row, and from the last row to the first one
+    Print("ABC", 7, 15, YELLOW, BLUE);
+    Check(Frame(2, 3), "the cells of a wrapped text");
+    Check(Screen(), "the wrapped text");
+
+    // Cells printed apart on a row are sent in separate windows
+    Print(" ", 2, 3, WHITE, GREEN);
+    Print("x", 2, 9, WHITE, GREEN);
+    Check(Frame(2, 2), "two runs on a row");
+    Check(Screen(), "a blank cell");
+}
+
+static void CheckSprites()
+{
+    // From x 20 to 35 and y 26 to 41: columns 2 to 4 and rows 1 and 2 of the cells
+    Show(0, &ring, GREEN, 20, 26);
+    Check(Frame(2, 6), "the cells under a new sprite");
+    Check(Screen(), "a sprite over the text");
+
+    // Moved by 4 pixels: the cells it was on and those it is on
+    Move(0, 24, 26);
+    Check(Frame(2, 6), "the cells of a moved sprite");
+    Check(Screen(), "a moved sprite");
+
+    // Sprite 1 is over sprite 0
+    Show(1, &arrow, RED, 22, 25);
+    Check(Frame(1, 2), "the cells of a small sprite");
+    Check(Screen(), "a sprite over another one");
+
+    Move(1, -2, 126);
+    Check(Frame(2, 3), "the cells of a sprite moved to the corner");
+    Check(Screen(), "a sprite partly off the screen");
+
+    Move(1, -8, 130);
+    Check(Frame(1, 1), "the cell a sprite left for outside the screen");
+    Check(Screen(), "a sprite outside the screen");
+
+    Hide(0);
+    Check(Frame(2, 4), "the cells of a hidden sprite");
+    Check(Screen(), "the tiles after the sprites");
+
+    // TilesClear hides the sprites
+    Show(0, &ring, GREEN, 60, 60);
+    Clear(BLUE);
+    Check(Frame(8, 16 * 8) && Screen(), "TilesClear over a sprite");
+}
+
+static void CheckDump()
+{
+    Check(TilesDump(Emit) == 3, "the lines of TilesDump");
+    Check(counters.frames == 12, "the frames of TilesDump");
+    Check(counters.lastBytes == 16 * 8 * CELL_BYTES && counters.maxBytes == 16 * 8 * CELL_BYTES,
+          "the bytes of TilesDump");
+
+    Print("z", 0, 0, WHITE, BLUE);
+    TilesFrame();
+    TilesDump(Emit);
+    Check(counters.frames == 13 && counters.lastBytes == CELL_BYTES && counters.maxBytes == 16 * 8 * CELL_BYTES,
+          "the bytes of the last frame and the largest one");
+    Check(counters.lastUS == 100 && counters.maxUS == 100, "the time of TilesDump");
+}
+
+int main()
+{
+    Graphics_initContext(&referenceContext, &referenceDisplay, &referenceFunctions);
+    Graphics_setFont(&referenceContext, &g_sFontCmtt16);
+
+    CheckText();
+    CheckSprites();
+    CheckDump();
+
+    return CheckReport();
+}
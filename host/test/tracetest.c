@@ -0,0 +1,253 @@
+//------------------------------------------
+// TRACE DECODER TEST
+// This host program checks host/tracedecode on a serial port: it plays a trace stream written by the simulator
+// (colortest -T) into the master side of a pseudo terminal, runs the decoder on the slave side, like on the
+// backchannel UART of the LaunchPad, and compares the decoded lines with the records of the stream.
+// The stream starts with a few bytes of a record, as if the decoder started listening in its middle, and it is
+// written in pieces that split the records, so the decoder has to find their boundaries and join them.
+//
+//    tracetest build/tracedecode trace.bin
+
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+#include "../../Trace.h"
+
+// As in tracedecode.c: the timestamps count cycles of the fastest MCLK
+#define MCLK_MHZ 48
+
+#define RECORD_BYTES 16
+
+// The stream starts with the last bytes of a record, and it is written in pieces of PIECE_BYTES
+#define PARTIAL_BYTES 5
+#define PIECE_BYTES   23
+
+// The decoder has this long to put the port in raw mode, and then to decode the stream
+#define TIMEOUT_MS 10000
+
+#define TRACE_NAME(id, name) name,
+static const char *const traceNames[TRACE_ID_COUNT] = {TRACE_EVENTS(TRACE_NAME)};
+#undef TRACE_NAME
+
+static uint32_t Get32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint8_t *ReadFile(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data;
+    long length;
+
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data = malloc(length > 0 ? length : 1);
+    if (!data || fread(data, 1, length, f) != (size_t) length)
+    {
+        fclose(f);
+        free(data);
+        return NULL;
+    }
+    fclose(f);
+    *size = length;
+    return data;
+}
+
+// This function starts the decoder on the slave side of the pseudo terminal, its standard output in a pipe
+static pid_t StartDecoder(const char *decoder, int master, int *output)
+{
+    const char *slave = ptsname(master);
+    int fds[2];
+    pid_t pid;
+
+    if (pipe(fds) != 0)
+        return -1;
+
+    pid = fork();
+    if (pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        close(master);
+        execl(decoder, decoder, slave, (char *) NULL);
+        perror(decoder);
+        _exit(127);
+    }
+
+    close(fds[1]);
+    *output = fds[0];
+    return pid;
+}
+
+// A terminal starts in canonical mode, which would change the bytes: the stream is written once the decoder has
+// put its port in raw mode. The master side reports the modes of the slave side.
+static bool WaitForRawMode(int master)
+{
+    struct termios tio;
+    int waited;
+
+    for (waited = 0; waited < TIMEOUT_MS; waited += 10)
+    {
+        if (tcgetattr(master, &tio) == 0 && !(tio.c_lflag & (ICANON | ECHO)))
+            return true;
+        usleep(10000);
+    }
+    return false;
+}
+
+// This function writes the stream to the master side and collects the output of the decoder, until it has
+// printed its header and a line per record. Both go on at the same time, so that neither side blocks.
+static char *Exchange(int master, int output, const uint8_t *stream, size_t size, size_t lines, size_t *length)
+{
+    size_t capacity = 65536, written = 0, printed = 0;
+    char *text = malloc(capacity);
+    struct pollfd fds[2];
+    ssize_t n, i;
+
+    *length = 0;
+    while (text && printed < lines)
+    {
+        fds[0].fd = (written < size) ? master : -1;
+        fds[0].events = POLLOUT;
+        fds[1].fd = output;
+        fds[1].events = POLLIN;
+        if (poll(fds, 2, TIMEOUT_MS) <= 0)
+            break;
+
+        if (fds[0].revents & POLLOUT)
+        {
+            n = write(master, stream + written, (size - written < PIECE_BYTES) ? size - written : PIECE_BYTES);
+            if (n > 0)
+                written += n;
+        }
+        if (fds[1].revents & (POLLIN | POLLHUP))
+        {
+            if (*length + 4096 > capacity)
+                text = realloc(text, capacity *= 2);
+            n = text ? read(output, text + *length, capacity - *length - 1) : -1;
+            if (n <= 0)
+                break;
+            for (i = 0; i < n; i++)
+                printed += (text[*length + i] == '\n');
+            *length += n;
+        }
+    }
+    if (text)
+        text[*length] = '\0';
+    return text;
+}
+
+// Every line after the header must be the next record of the stream: the same event, arguments and delta
+static int Compare(const char *text, const uint8_t *records, size_t count)
+{
+    const char *line = strchr(text, '\n');
+    uint32_t previous = 0;
+    size_t r;
+    int errors = 0;
+
+    for (r = 0; r < count && line; r++, line = strchr(line, '\n'))
+    {
+        const uint8_t *p = records + r * RECORD_BYTES;
+        uint32_t timestamp = Get32(p + 4);
+        uint32_t delta = r ? previous - timestamp : 0;
+        char expected[96], got[96];
+        double time;
+        int used;
+
+        snprintf(expected, sizeof(expected), "%.3f %-8s %lu %lu", (double) delta / MCLK_MHZ,
+                 traceNames[p[2] | (p[3] << 8)], (unsigned long) Get32(p + 8), (unsigned long) Get32(p + 12));
+        previous = timestamp;
+
+        line++;
+        got[0] = '\0';
+        if (sscanf(line, "%lf %n", &time, &used) == 1)
+        {
+            char delta[16], event[16];
+            unsigned long arg0, arg1;
+
+            if (sscanf(line + used, "%15s %15s %lu %lu", delta, event, &arg0, &arg1) == 4)
+                snprintf(got, sizeof(got), "%s %-8s %lu %lu", delta, event, arg0, arg1);
+        }
+        if (strcmp(expected, got))
+        {
+            if (errors++ < 5)
+                fprintf(stderr, "tracetest: record %zu is \"%s\", expected \"%s\"\n", r, got, expected);
+        }
+    }
+    if (r < count)
+    {
+        fprintf(stderr, "tracetest: %zu of %zu records decoded\n", r, count);
+        errors++;
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t *records, *stream;
+    size_t size, count, length;
+    char *text;
+    int master, output, status, errors;
+    pid_t pid;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s tracedecode trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    records = ReadFile(argv[2], &size);
+    if (!records || size < RECORD_BYTES)
+    {
+        fprintf(stderr, "tracetest: %s has no records\n", argv[2]);
+        return 1;
+    }
+    count = size / RECORD_BYTES;
+
+    stream = malloc(PARTIAL_BYTES + size);
+    memcpy(stream, records + size - PARTIAL_BYTES, PARTIAL_BYTES);
+    memcpy(stream + PARTIAL_BYTES, records, size);
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("tracetest: posix_openpt");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    pid = StartDecoder(argv[1], master, &output);
+    if (pid < 0 || !WaitForRawMode(master))
+    {
+        fprintf(stderr, "tracetest: the decoder did not put %s in raw mode\n", ptsname(master));
+        if (pid > 0)
+            kill(pid, SIGTERM);
+        return 1;
+    }
+
+    text = Exchange(master, output, stream, PARTIAL_BYTES + size, count + 1, &length);
+
+    // The decoder sees the end of the stream when the master side is closed
+    close(master);
+    close(output);
+    waitpid(pid, &status, 0);
+
+    errors = text ? Compare(text, records, count) : 1;
+    printf("tracetest: %zu records through a pseudo terminal, %s\n", count, errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
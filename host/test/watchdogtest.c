@@ -0,0 +1,263 @@
+//------------------------------------------
+// WATCHDOG TEST
+// This host program plays the scheduler around Watchdog.c and checks when WDT_A is kicked, the overruns it logs,
+// and what WatchdogDump shows after a reset by the watchdog, after another reset and after a power-up. The
+// records survive a reset as they do in SRAM: InitWatchdog is called again on the same variables, with the reset
+// source below.
+// WDT_A, the reset controller and the trace are replaced by the functions below, and the cycles given to
+// SupervisorEnd are microseconds.
+
+#include <stdio.h>
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include <Timer_HAL.h>
+#include <Trace.h>
+#include <Watchdog.h>
+
+#define TEST_NAME "watchdogtest"
+#include "Check.h"
+
+
+//------------------------------------------
+// WDT_A, the reset controller and the trace
+
+static struct {
+    uint_fast8_t clockSelect, clockDivider, resetType;
+    bool started;
+    unsigned kicks;
+} wdt;
+
+static uint32_t resetSource;
+
+void WDT_A_initWatchdogTimer(uint_fast8_t clockSelect, uint_fast8_t clockDivider)
+{
+    wdt.clockSelect = clockSelect;
+    wdt.clockDivider = clockDivider;
+}
+
+void WDT_A_setTimeoutReset(uint_fast8_t resetType)
+{
+    wdt.resetType = resetType;
+}
+
+void WDT_A_startTimer(void)
+{
+    wdt.started = true;
+}
+
+void WDT_A_clearTimer(void)
+{
+    wdt.kicks++;
+}
+
+uint32_t ResetCtl_getHardResetSource(void)
+{
+    return resetSource;
+}
+
+void ResetCtl_clearHardResetSource(uint32_t mask)
+{
+    resetSource &= ~mask;
+}
+
+uint32_t CyclesToMicroseconds(uint32_t cycles)
+{
+    return cycles;
+}
+
+static struct {
+    unsigned records;
+    uint32_t arg0, arg1;
+} trace;
+
+void TraceRecord(TraceId_t id, uint32_t arg0, uint32_t arg1)
+{
+    if (id != TRACE_OVERRUN)
+        return;
+    trace.records++;
+    trace.arg0 = arg0;
+    trace.arg1 = arg1;
+}
+
+//------------------------------------------
+// The scheduler
+
+#define RENDER  0
+#define BUTTONS 1           // not supervised
+#define TRACER  3
+
+static const Event_t tick = {EVT_TICK, 0, 0};
+static const Event_t button = {EVT_BUTTON, 0, 0};
+
+static void Run(int taskId, uint32_t us)
+{
+    SupervisorBegin(taskId);
+    SupervisorEnd(taskId, us);
+}
+
+// A tick that both supervised tasks get, in budget
+static void Tick()
+{
+    Run(RENDER, 100);
+    Run(TRACER, 50);
+    SupervisorEventDone(&tick);
+}
+
+//------------------------------------------
+// The dump
+
+#define MAX_LINES (4 + 2 * WATCHDOG_LOG_SIZE)
+
+static char lines[MAX_LINES][20];
+static uint32_t lineCount;
+
+static void Emit(char *line, uint32_t index)
+{
+    if (index < MAX_LINES)
+        strcpy(lines[index], line);
+}
+
+static void Dump()
+{
+    memset(lines, 0, sizeof(lines));
+    lineCount = WatchdogDump(Emit);
+}
+
+//------------------------------------------
+// Cases
+
+static void CheckKicks()
+{
+    unsigned kicks;
+
+    resetSource = 0;
+    InitWatchdog();
+    Dump();
+    Check(lineCount == 2 && !strcmp(lines[0], "WDT #1 r 0") && !strcmp(lines[1], "Overruns 0"),
+          "the records after a power-up");
+
+    SuperviseTask(RENDER, "render", 5000);
+    SuperviseTask(TRACER, "trace", 2000);
+    SuperviseTask(-1, "none", 1000);
+    StartWatchdog();
+    Check(wdt.started && wdt.clockSelect == WDT_A_CLOCKSOURCE_ACLK &&
+          wdt.clockDivider == WDT_A_CLOCKITERATIONS_32K && wdt.resetType == WDT_A_HARD_RESET,
+          "WDT_A started for a hard reset after 32K periods of ACLK");
+
+    Tick();
+    Check(wdt.kicks == 1, "a kick after every supervised task ran");
+
+    // Only once both tasks ran again, whatever the events and the tasks that are not supervised
+    Run(RENDER, 100);
+    SupervisorEventDone(&tick);
+    Run(BUTTONS, 100000);
+    SupervisorEventDone(&button);
+    Check(wdt.kicks == 1, "no kick while a supervised task has not run");
+    Run(TRACER, 50);
+    SupervisorEventDone(&tick);
+    Check(wdt.kicks == 2, "the kick once the last supervised task ran");
+
+    // A task that started and never ended does not count
+    SupervisorBegin(TRACER);
+    Run(RENDER, 100);
+    SupervisorEventDone(&tick);
+    Check(wdt.kicks == 2, "no kick for a task that has not ended");
+    SupervisorEnd(TRACER, 50);
+    SupervisorEventDone(&tick);
+    Check(wdt.kicks == 3, "the kick once it ended");
+
+    // Overruns do not stop the kicks
+    kicks = wdt.kicks;
+    Run(RENDER, 5001);
+    Run(TRACER, 50);
+    SupervisorEventDone(&tick);
+    Check(wdt.kicks == kicks + 1, "a kick after an overrun");
+    Check(trace.records == 1 && trace.arg0 == RENDER && trace.arg1 == 5001, "the trace of an overrun");
+    Run(BUTTONS, 100000);
+    Check(trace.records == 1, "no overrun for a task that is not supervised");
+}
+
+// 6 ticks have gone by, 60 ms; then 10 overruns, 100 ms apart, of which the log keeps the last 8
+static void CheckOverruns()
+{
+    unsigned n, t;
+
+    for (n = 0; n < 10; n++)
+    {
+        for (t = 0; t < 10; t++)
+            Tick();
+        Run(n % 2 ? TRACER : RENDER, 10000 + n * 1000);
+    }
+
+    Dump();
+    Check(lineCount == 2 + 2 * WATCHDOG_LOG_SIZE, "the lines of a full log");
+    Check(!strcmp(lines[1], "Overruns 11"), "the number of overruns");
+    Check(!strcmp(lines[2], " trace 19.0ms") && !strcmp(lines[3], " #1 @1.0s"), "the newest overrun");
+    Check(!strcmp(lines[4], " render 18.0ms") && !strcmp(lines[5], " #1 @0.9s"), "the overrun before it");
+    Check(!strcmp(lines[16], " render 12.0ms") && !strcmp(lines[17], " #1 @0.3s"), "the oldest overrun kept");
+}
+
+static void CheckResets()
+{
+    // The watchdog resets the MCU while the trace task runs
+    Tick();
+    SupervisorBegin(TRACER);
+    resetSource = RESET_SRC_1;
+    InitWatchdog();
+    Check(resetSource == 0, "the reset source cleared");
+
+    Dump();
+    Check(!strcmp(lines[0], "WDT #2 r 1"), "the boots and the resets after a reset by the watchdog");
+    Check(!strcmp(lines[1], " hung trace") && !strcmp(lines[2], " @1.0s"), "the task that hung");
+    Check(!strcmp(lines[3], "Overruns 11") && !strcmp(lines[4], " trace 19.0ms"), "the overruns kept");
+
+    // Then one between two tasks
+    resetSource = RESET_SRC_1;
+    InitWatchdog();
+    Dump();
+    Check(!strcmp(lines[0], "WDT #3 r 2") && !strcmp(lines[1], " hung no task"), "a reset between two tasks");
+
+    // Another reset, while a task runs, is not the watchdog's
+    SupervisorBegin(RENDER);
+    resetSource = 0;
+    InitWatchdog();
+    Dump();
+    Check(!strcmp(lines[0], "WDT #4 r 2") && !strcmp(lines[1], "Overruns 11"), "a reset that is not the watchdog's");
+}
+
+// Many resets, a long name, a long overrun and a long uptime, each shortened to keep the lines within a row
+static void CheckLongLines()
+{
+    unsigned n;
+
+    resetSource = RESET_SRC_1;
+    for (n = 0; n < 1000; n++)
+    {
+        SupervisorBegin(RENDER);
+        resetSource = RESET_SRC_1;
+        InitWatchdog();
+    }
+    SuperviseTask(RENDER, "renderer", 5000);
+    SuperviseTask(TRACER, "trace", 2000);
+    StartWatchdog();
+    for (n = 0; n < 1000000; n++)
+        Tick();
+    Run(RENDER, 2500000);
+
+    Dump();
+    Check(!strcmp(lines[0], "WDT #1004 r 999"), "the resets held at 999");
+    Check(!strcmp(lines[3], "Overruns 12") && !strcmp(lines[4], " rendere 2.5s"), "a long name and a long overrun");
+    Check(!strcmp(lines[5], " #1004 @2h"), "a long uptime in hours");
+    for (n = 0; n < lineCount && n < MAX_LINES; n++)
+        Check(strlen(lines[n]) <= 16, "a line of at most 16 characters");
+}
+
+int main()
+{
+    CheckKicks();
+    CheckOverruns();
+    CheckResets();
+    CheckLongLines();
+
+    return CheckReport();
+}
@@ -0,0 +1,173 @@
+//------------------------------------------
+// TRACE DECODER
+// This host program turns the binary trace stream of Trace.c into a timeline, one record per line:
+//
+//        time(us)    delta(us)  event     arg0        arg1
+//
+// The stream is read from a file, from standard input ("-") or from the backchannel UART of the LaunchPad
+// (e.g. /dev/ttyACM0 on Linux). A serial port is switched to raw mode at TRACE_BAUD_RATE.
+// Build it with any C compiler on the host:
+//
+//    cc -O2 -o tracedecode tracedecode.c
+//    ./tracedecode /dev/ttyACM0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "../Trace.h"
+
+// Timer32_0, the source of the timestamps, counts cycles of the fastest MCLK whatever the clock governor does
+#define MCLK_MHZ 48
+
+#define TRACE_NAME(id, name) name,
+static const char *const traceNames[TRACE_ID_COUNT] = {TRACE_EVENTS(TRACE_NAME)};
+#undef TRACE_NAME
+
+#define RECORD_BYTES 16
+
+static speed_t BaudConstant(unsigned baud)
+{
+    switch (baud)
+    {
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+    default:     return B0;
+    }
+}
+
+// This function puts a serial port in raw mode. Files and pipes are left alone.
+static void ConfigurePort(int fd)
+{
+    struct termios tio;
+    speed_t speed = BaudConstant(TRACE_BAUD_RATE);
+
+    if (!isatty(fd) || tcgetattr(fd, &tio) != 0)
+        return;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    if (speed != B0)
+    {
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    else
+        fprintf(stderr, "tracedecode: %u baud is not supported here, keeping the port speed\n", TRACE_BAUD_RATE);
+
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+static uint16_t Get16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t Get32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// A record starts with the sync bytes and holds a known event id
+static bool LooksLikeRecord(const uint8_t *p)
+{
+    return (Get16(p) == TRACE_SYNC) && (Get16(p + 2) < TRACE_ID_COUNT);
+}
+
+typedef struct {
+    bool     started;
+    uint32_t lastTimestamp;
+    uint64_t elapsedCycles;     // since the first record
+    uint64_t records;
+    uint64_t skippedBytes;
+} Timeline_t;
+
+static void PrintRecord(Timeline_t *T, const uint8_t *p)
+{
+    uint16_t id = Get16(p + 2);
+    uint32_t timestamp = Get32(p + 4);
+    uint32_t arg0 = Get32(p + 8);
+    uint32_t arg1 = Get32(p + 12);
+    uint32_t delta = 0;
+
+    // The timer counts down and wraps every 2^32 cycles (89 s at 48 MHz). Records closer than that
+    // are unwrapped by the unsigned subtraction.
+    if (T->started)
+        delta = T->lastTimestamp - timestamp;
+    T->started = true;
+    T->lastTimestamp = timestamp;
+    T->elapsedCycles += delta;
+    T->records++;
+
+    printf("%14.3f %12.3f  %-8s  %10lu  %10lu\n",
+           (double) T->elapsedCycles / MCLK_MHZ, (double) delta / MCLK_MHZ,
+           traceNames[id], (unsigned long) arg0, (unsigned long) arg1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "-";
+    uint8_t buffer[4096];
+    size_t used = 0;
+    ssize_t n;
+    Timeline_t T = {0};
+    int fd;
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: %s [file | serial port | -]\n", argv[0]);
+        return 2;
+    }
+
+    fd = strcmp(path, "-") ? open(path, O_RDONLY | O_NOCTTY) : STDIN_FILENO;
+    if (fd < 0)
+    {
+        perror(path);
+        return 1;
+    }
+    ConfigurePort(fd);
+
+    printf("%14s %12s  %-8s  %10s  %10s\n", "time(us)", "delta(us)", "event", "arg0", "arg1");
+
+    while ((n = read(fd, buffer + used, sizeof(buffer) - used)) > 0)
+    {
+        size_t i = 0;
+        used += (size_t) n;
+
+        while (used - i >= RECORD_BYTES)
+        {
+            if (LooksLikeRecord(buffer + i))
+            {
+                PrintRecord(&T, buffer + i);
+                i += RECORD_BYTES;
+            }
+            else
+            {
+                // Out of sync, e.g. we started listening in the middle of a record
+                i++;
+                T.skippedBytes++;
+            }
+        }
+
+        memmove(buffer, buffer + i, used - i);
+        used -= i;
+        fflush(stdout);
+    }
+
+    fprintf(stderr, "tracedecode: %llu records, %llu bytes skipped\n",
+            (unsigned long long) T.records, (unsigned long long) T.skippedBytes);
+    return 0;
+}
@@ -40,7 +40,10 @@
 
 MEMORY
 {
-    MAIN       (RX) : origin = 0x00000000, length = 0x00040000
+    /* The last 4 sectors of the main flash are kept for the flash log (see */
+    /* FlashLog.h) and never hold code or constants.                        */
+    MAIN       (RX) : origin = 0x00000000, length = 0x0003C000
+    FLASHLOG   (R)  : origin = 0x0003C000, length = 0x00004000
     INFO       (RX) : origin = 0x00200000, length = 0x00004000
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -94,15 +97,22 @@ SECTIONS
     /* BSL area for device bootstrap loader                                  */
     .bslArea      : > 0x00202000
 
-    .vtable :   > 0x20000000
-    .data   :   > SRAM_DATA
-    .bss    :   > SRAM_DATA
-    .sysmem :   > SRAM_DATA
+    /* The RUN_SIZE symbols give the size of each section of SRAM to        */
+    /* RamUsage.c.                                                           */
+    .vtable :   > 0x20000000, RUN_SIZE(ramVtableSize)
+    .data   :   > SRAM_DATA, RUN_SIZE(ramDataSize)
+    .bss    :   > SRAM_DATA, RUN_SIZE(ramBssSize)
+    /* Variables marked NOINIT, such as the records of Watchdog.c, which    */
+    /* must survive a reset: the startup code neither clears nor sets them.  */
+    .TI.noinit : > SRAM_DATA, RUN_SIZE(ramNoinitSize)
+    .sysmem :   > SRAM_DATA, RUN_SIZE(ramHeapSize)
     .stack  :   > SRAM_DATA (HIGH)
 
+    /* Functions marked RAMFUNC (see RamFunc.h). _c_int00 copies them from   */
+    /* flash to SRAM through the BINIT table before main() is called.        */
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
-    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE, table(BINIT)
+    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE, table(BINIT), RUN_SIZE(ramFuncSize)
 #endif
 #endif
 }